@@ -17,4 +17,18 @@ typedef struct __attribute__((packed)) {
     uint32_t crc32;             // CRC32 of compressed payload
 } log_block_header_t;
 
+#define LOG_SECTOR_MAGIC 0x4C4F4753 // 'LOGS'
+#define LOG_SECTOR_NO_ENTRY 0xFFFF  // first_entry when no entry starts in the sector
+
+// Written at the start of every 4 KB flash sector of the logging partition.
+// Entries (session headers, blocks) fill the rest of the sector and may
+// continue into the next one after its header.
+typedef struct __attribute__((packed)) {
+    uint32_t magic;           // LOG_SECTOR_MAGIC
+    uint32_t sequence;        // +1 for each sector opened, never resets
+    uint16_t first_entry;     // offset of the first entry starting in this sector, or LOG_SECTOR_NO_ENTRY
+    uint16_t reserved;        // 0xFFFF
+    uint32_t crc32;           // CRC32 of the preceding 12 bytes
+} log_sector_header_t;
+
 #endif // LOG_BLOCK_H
@@ -48,14 +48,21 @@ struct logging_config_t {
     // Main loop rate (5, 10, 20, 50, 100 Hz)
     uint16_t main_loop_hz;
     
-    // Individual sensor rates (can be lower than or equal to main loop rate)
-    uint16_t gps_hz;        // GPS update rate
-    uint16_t imu_hz;        // IMU (accel/gyro/compass) update rate
+    // Individual sensor rates (each paced by its own hardware timer)
+    uint16_t gps_hz;        // GPS fix rate, sent to the module with PMTK220 (1-10 Hz)
+    uint16_t imu_hz;        // IMU (accel/gyro/compass) update rate (1-1000 Hz, >100 uses the IMU FIFO)
     uint16_t obd_hz;        // OBD global max update rate
+    uint16_t battery_hz;    // Battery monitor update rate (1-10 Hz)
     
     // OBD-II BLE configuration
     bool obd_ble_enabled;   // Enable/disable BLE scanning for OBD-II devices
     
+    // Raw CAN capture through the adapter (ELM327 ATMA); PID polling pauses while it runs
+    bool can_monitor_enabled;
+    uint32_t can_filter_id;     // A frame is captured when (frame_id & mask) == (id & mask)
+    uint32_t can_filter_mask;   // 0 = every frame (rarely sustainable over BLE)
+    bool can_filter_extended;   // 29-bit identifiers
+    
     // Network configuration
     network_config_t network;
     
@@ -64,7 +71,9 @@ struct logging_config_t {
     
     // Default constructor with 10Hz across the board
     logging_config_t() 
-        : main_loop_hz(10), gps_hz(10), imu_hz(10), obd_hz(10), obd_ble_enabled(true) {
+        : main_loop_hz(10), gps_hz(10), imu_hz(10), obd_hz(10), battery_hz(1), obd_ble_enabled(true),
+          can_monitor_enabled(false), can_filter_id(0x000), can_filter_mask(0x700),  // IDs 0x000-0x0FF
+          can_filter_extended(false) {
         // Initialize core PIDs (enabled by default at 10Hz)
         pid_configs[0x0C] = pid_config_t(0x0C, 10, true, "Engine RPM");
         pid_configs[0x0D] = pid_config_t(0x0D, 10, true, "Vehicle Speed");
@@ -147,7 +156,12 @@ private:
     static const char* KEY_GPS_HZ;
     static const char* KEY_IMU_HZ;
     static const char* KEY_OBD_HZ;
+    static const char* KEY_BATTERY_HZ;
     static const char* KEY_OBD_BLE_ENABLED;
+    static const char* KEY_CAN_MONITOR_ENABLED;
+    static const char* KEY_CAN_FILTER_ID;
+    static const char* KEY_CAN_FILTER_MASK;
+    static const char* KEY_CAN_FILTER_EXTENDED;
     static const char* KEY_NET_SSID;
     static const char* KEY_NET_PASSWORD;
     static const char* KEY_NET_IP;
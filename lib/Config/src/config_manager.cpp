@@ -12,7 +12,12 @@ const char* ConfigManager::KEY_MAIN_LOOP_HZ = "main_loop_hz";
 const char* ConfigManager::KEY_GPS_HZ = "gps_hz";
 const char* ConfigManager::KEY_IMU_HZ = "imu_hz";
 const char* ConfigManager::KEY_OBD_HZ = "obd_hz";
+const char* ConfigManager::KEY_BATTERY_HZ = "battery_hz";
 const char* ConfigManager::KEY_OBD_BLE_ENABLED = "obd_ble_en";
+const char* ConfigManager::KEY_CAN_MONITOR_ENABLED = "can_mon_en";
+const char* ConfigManager::KEY_CAN_FILTER_ID = "can_flt_id";
+const char* ConfigManager::KEY_CAN_FILTER_MASK = "can_flt_mask";
+const char* ConfigManager::KEY_CAN_FILTER_EXTENDED = "can_flt_ext";
 const char* ConfigManager::KEY_NET_SSID = "net_ssid";
 const char* ConfigManager::KEY_NET_PASSWORD = "net_password";
 const char* ConfigManager::KEY_NET_IP = "net_ip";
@@ -60,7 +65,12 @@ logging_config_t ConfigManager::load() {
     config.gps_hz = prefs.getUShort(KEY_GPS_HZ, 10);
     config.imu_hz = prefs.getUShort(KEY_IMU_HZ, 10);
     config.obd_hz = prefs.getUShort(KEY_OBD_HZ, 10);
+    config.battery_hz = prefs.getUShort(KEY_BATTERY_HZ, 1);
     config.obd_ble_enabled = prefs.getBool(KEY_OBD_BLE_ENABLED, true);
+    config.can_monitor_enabled = prefs.getBool(KEY_CAN_MONITOR_ENABLED, config.can_monitor_enabled);
+    config.can_filter_id = prefs.getUInt(KEY_CAN_FILTER_ID, config.can_filter_id);
+    config.can_filter_mask = prefs.getUInt(KEY_CAN_FILTER_MASK, config.can_filter_mask);
+    config.can_filter_extended = prefs.getBool(KEY_CAN_FILTER_EXTENDED, config.can_filter_extended);
     
     // Load network configuration with safety checks
     size_t ssid_len = prefs.getString(KEY_NET_SSID, config.network.ssid, sizeof(config.network.ssid));
@@ -129,7 +139,12 @@ bool ConfigManager::save(const logging_config_t& config) {
     prefs.putUShort(KEY_GPS_HZ, config.gps_hz);
     prefs.putUShort(KEY_IMU_HZ, config.imu_hz);
     prefs.putUShort(KEY_OBD_HZ, config.obd_hz);
+    prefs.putUShort(KEY_BATTERY_HZ, config.battery_hz);
     prefs.putBool(KEY_OBD_BLE_ENABLED, config.obd_ble_enabled);
+    prefs.putBool(KEY_CAN_MONITOR_ENABLED, config.can_monitor_enabled);
+    prefs.putUInt(KEY_CAN_FILTER_ID, config.can_filter_id);
+    prefs.putUInt(KEY_CAN_FILTER_MASK, config.can_filter_mask);
+    prefs.putBool(KEY_CAN_FILTER_EXTENDED, config.can_filter_extended);
     
     // Save network configuration
     prefs.putString(KEY_NET_SSID, config.network.ssid);
@@ -182,22 +197,32 @@ bool ConfigManager::validate(const logging_config_t& config) {
         return false;
     }
     
-    // Sensor rates must be <= main loop rate and within valid range (1-100 Hz)
-    if (config.gps_hz < 1 || config.gps_hz > config.main_loop_hz || config.gps_hz > 100) {
-        Serial.printf("[Config] ERROR: Invalid gps_hz: %d (must be 1-%d)\n", 
-                     config.gps_hz, config.main_loop_hz);
+    // Sensor rates run on their own timers, independent of the main loop rate
+    if (config.gps_hz < 1 || config.gps_hz > 10) {
+        Serial.printf("[Config] ERROR: Invalid gps_hz: %d (must be 1-10)\n", config.gps_hz);
         return false;
     }
     
-    if (config.imu_hz < 1 || config.imu_hz > config.main_loop_hz || config.imu_hz > 100) {
-        Serial.printf("[Config] ERROR: Invalid imu_hz: %d (must be 1-%d)\n", 
-                     config.imu_hz, config.main_loop_hz);
+    if (config.imu_hz < 1 || config.imu_hz > 1000) {
+        Serial.printf("[Config] ERROR: Invalid imu_hz: %d (must be 1-1000)\n", config.imu_hz);
         return false;
     }
     
-    if (config.obd_hz < 1 || config.obd_hz > config.main_loop_hz || config.obd_hz > 100) {
-        Serial.printf("[Config] ERROR: Invalid obd_hz: %d (must be 1-%d)\n", 
-                     config.obd_hz, config.main_loop_hz);
+    if (config.obd_hz < 1 || config.obd_hz > 100) {
+        Serial.printf("[Config] ERROR: Invalid obd_hz: %d (must be 1-100)\n", config.obd_hz);
+        return false;
+    }
+    
+    if (config.battery_hz < 1 || config.battery_hz > 10) {
+        Serial.printf("[Config] ERROR: Invalid battery_hz: %d (must be 1-10)\n", config.battery_hz);
+        return false;
+    }
+    
+    uint32_t max_can_id = config.can_filter_extended ? 0x1FFFFFFF : 0x7FF;
+    if (config.can_filter_id > max_can_id || config.can_filter_mask > max_can_id) {
+        Serial.printf("[Config] ERROR: Invalid CAN filter: id 0x%lX mask 0x%lX (must be <= 0x%lX)\n",
+                      (unsigned long)config.can_filter_id, (unsigned long)config.can_filter_mask,
+                      (unsigned long)max_can_id);
         return false;
     }
     
@@ -1,5 +1,10 @@
 #include "icar_ble_driver.h"
+#include "config_manager.h"
+#include <Preferences.h>
+#include <esp_timer.h>
 #include <cstring>
+#include <cctype>
+#include <cmath>
 #include <algorithm>
 
 // Static member initialization
@@ -11,13 +16,100 @@ char IcarBleDriver::m_vin[18] = "";
 char IcarBleDriver::m_ecm_name[20] = "";
 NimBLERemoteCharacteristic* IcarBleDriver::m_rx_char = nullptr;
 NimBLERemoteCharacteristic* IcarBleDriver::m_tx_char = nullptr;
+NimBLEClient* IcarBleDriver::m_client = nullptr;
+TaskHandle_t IcarBleDriver::m_link_task = nullptr;
+volatile obd_link_state_t IcarBleDriver::m_link_state = OBD_LINK_IDLE;
+uint32_t IcarBleDriver::m_state_since_ms = 0;
+uint32_t IcarBleDriver::m_backoff_ms = OBD_BACKOFF_MIN_MS;
+uint8_t IcarBleDriver::m_connect_attempts = 0;
+volatile bool IcarBleDriver::m_scan_running = false;
+char IcarBleDriver::m_scan_address[18] = "";
+obd_link_params_t IcarBleDriver::m_link_params = {};
+bool IcarBleDriver::m_params_checked = false;
+uint32_t IcarBleDriver::m_params_requested_ms = 0;
+uint32_t IcarBleDriver::m_rx_bytes = 0;
+uint32_t IcarBleDriver::m_tx_bytes = 0;
+uint32_t IcarBleDriver::m_rate_window_rx_bytes = 0;
+uint32_t IcarBleDriver::m_rate_window_tx_bytes = 0;
 std::vector<obd_pid_config_t> IcarBleDriver::m_configured_pids = {};
+portMUX_TYPE IcarBleDriver::m_lock = portMUX_INITIALIZER_UNLOCKED;
+IcarBleDriver::obd_command_t IcarBleDriver::m_cmd_queue[OBD_COMMAND_QUEUE_SIZE] = {};
+uint8_t IcarBleDriver::m_cmd_head = 0;
+uint8_t IcarBleDriver::m_cmd_count = 0;
+bool IcarBleDriver::m_cmd_active = false;
+uint32_t IcarBleDriver::m_cmd_sent_ms = 0;
+char IcarBleDriver::m_rx_buffer[OBD_RESPONSE_MAX_LEN] = "";
+size_t IcarBleDriver::m_rx_len = 0;
+char IcarBleDriver::m_response[OBD_RESPONSE_MAX_LEN] = "";
+uint32_t IcarBleDriver::m_pending_pids[8] = {};
+bool IcarBleDriver::m_pid_updated = false;
+bool IcarBleDriver::m_batching_enabled = true;
+uint8_t IcarBleDriver::m_batch_failures = 0;
+uint8_t IcarBleDriver::m_mode01_outstanding = 0;
+uint16_t IcarBleDriver::m_pid_update_counts[256] = {};
+bool IcarBleDriver::m_saturated = false;
+float IcarBleDriver::m_capacity = OBD_DEFAULT_CAPACITY;
+float IcarBleDriver::m_saved_capacity = OBD_DEFAULT_CAPACITY;
+uint32_t IcarBleDriver::m_capacity_saved_ms = 0;
+bool IcarBleDriver::m_monitor_enabled = false;
+bool IcarBleDriver::m_monitor_buffer_full = false;
+bool IcarBleDriver::m_monitor_requested = false;
+obd_can_filter_t IcarBleDriver::m_requested_filter = {};
+int64_t IcarBleDriver::m_requested_session_us = 0;
+uint32_t IcarBleDriver::m_monitor_retry_ms = 0;
+obd_can_filter_t IcarBleDriver::m_can_filter = {};
+int64_t IcarBleDriver::m_session_start_us = 0;
+log_record_ring_t IcarBleDriver::m_can_ring;
+obd_link_stats_t IcarBleDriver::m_stats = {};
+uint32_t IcarBleDriver::m_rate_window_start_ms = 0;
+uint32_t IcarBleDriver::m_rate_window_pids = 0;
 
 // vgate iCar 2 Pro BLE UUIDs
 static const char* SERVICE_UUID = "0000ffe0-0000-1000-8000-00805f9b34fb";
 static const char* RX_CHAR_UUID = "0000ffe1-0000-1000-8000-00805f9b34fb";  // Read/Notify from device
 static const char* TX_CHAR_UUID = "0000ffe2-0000-1000-8000-00805f9b34fb";  // Write to device
 
+// Adapter setup after connecting: echo, linefeeds, spaces and headers off, automatic protocol
+static const char* const ELM327_INIT_COMMANDS[] = { "ATE0", "ATL0", "ATS0", "ATH0", "ATSP0" };
+
+// Window for the PIDs/sec measurement
+#define PID_RATE_WINDOW_MS      1000
+
+// Polling-mode settings restored after the CAN monitor: ISO-TP formatting,
+// no DLC, headers off, receive filters cleared
+static const char* const ELM327_MONITOR_RESTORE_COMMANDS[] = { "ATCAF1", "ATD0", "ATH0", "ATCRA" };
+
+// can_record_t flags
+#define CAN_FLAG_EXTENDED_ID    0x01
+#define CAN_FLAG_REMOTE_FRAME   0x02
+
+// Fastest rate the scheduler plans for a single PID (interval 0 = "as fast as possible")
+#define OBD_MIN_POLL_INTERVAL_MS    10
+
+// Weight of a saturated window in the capacity estimate
+#define OBD_CAPACITY_GAIN       0.3f
+
+// Weight of the newest Mode 01 round trip in the smoothed RTT
+#define OBD_RTT_GAIN            0.125f
+
+// NVS location of the learned adapter capacity
+static const char* NVS_NAMESPACE = "obd";
+static const char* KEY_CAPACITY = "capacity";
+static const char* KEY_LAST_ADDRESS = "last_addr";
+
+// Link parameter keys are "lp" + the address without colons (NVS keys max 15 chars)
+static void link_params_key(const char* address, char* key, size_t key_size) {
+    size_t n = 0;
+    key[n++] = 'l';
+    key[n++] = 'p';
+    for (const char* p = address; *p && n < key_size - 1; p++) {
+        if (*p != ':') {
+            key[n++] = (char)tolower((unsigned char)*p);
+        }
+    }
+    key[n] = '\0';
+}
+
 bool IcarBleDriver::init() {
     Serial.println("[OBD] Initializing NimBLE central...");
     
@@ -25,10 +117,240 @@ bool IcarBleDriver::init() {
     NimBLEDevice::init("");
     NimBLEDevice::setPower(ESP_PWR_LVL_P9);  // Max power for range
     
+    // Start from what this adapter managed last time
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, true)) {
+        m_capacity = prefs.getFloat(KEY_CAPACITY, OBD_DEFAULT_CAPACITY);
+        prefs.end();
+    }
+    if (!(m_capacity >= 1.0f)) {
+        m_capacity = OBD_DEFAULT_CAPACITY;
+    }
+    m_saved_capacity = m_capacity;
+    Serial.printf("[OBD] Adapter capacity estimate: %.1f PIDs/s\n", m_capacity);
+    plan_rates();
+    
     Serial.println("[OBD] NimBLE initialized successfully");
     return true;
 }
 
+bool IcarBleDriver::start_link_task() {
+    if (m_link_task) {
+        return true;
+    }
+    
+    // Reconnect to the adapter used last time, if any
+    Preferences prefs;
+    if (!m_device_address[0] && prefs.begin(NVS_NAMESPACE, true)) {
+        prefs.getString(KEY_LAST_ADDRESS, m_device_address, sizeof(m_device_address));
+        prefs.end();
+    }
+    
+    m_backoff_ms = OBD_BACKOFF_MIN_MS;
+    m_connect_attempts = 0;
+    uint32_t now = millis();
+    if (m_device_address[0]) {
+        enter_state(OBD_LINK_CONNECT, now);
+    } else {
+        // The scan state only waits on a running scan, so start the first one here
+        enter_state(OBD_LINK_SCAN, now);
+        if (!start_scan()) {
+            connect_failed(now);
+        }
+    }
+    
+    BaseType_t result = xTaskCreatePinnedToCore(
+        link_task, "OBDLink", OBD_LINK_TASK_STACK, nullptr,
+        OBD_LINK_TASK_PRIORITY, &m_link_task, OBD_LINK_TASK_CORE);
+    if (result != pdPASS) {
+        Serial.println("[OBD] ERROR: Failed to create link task");
+        if (m_scan_running) {
+            stop_scan();
+        }
+        m_link_task = nullptr;
+        m_link_state = OBD_LINK_IDLE;
+        return false;
+    }
+    
+    Serial.printf("[OBD] Link task started (%s %s)\n", link_state_name(m_link_state),
+                  m_device_address[0] ? m_device_address : "");
+    return true;
+}
+
+obd_link_state_t IcarBleDriver::get_link_state() {
+    return m_link_state;
+}
+
+const char* IcarBleDriver::link_state_name(obd_link_state_t state) {
+    switch (state) {
+        case OBD_LINK_IDLE:     return "idle";
+        case OBD_LINK_SCAN:     return "scan";
+        case OBD_LINK_CONNECT:  return "connect";
+        case OBD_LINK_DISCOVER: return "discover";
+        case OBD_LINK_INIT:     return "init";
+        case OBD_LINK_STREAM:   return "stream";
+        case OBD_LINK_BACKOFF:  return "backoff";
+        default:                return "unknown";
+    }
+}
+
+void IcarBleDriver::link_task(void* param) {
+    (void)param;
+    while (true) {
+        run_link(millis());
+        vTaskDelay(pdMS_TO_TICKS(m_link_state == OBD_LINK_STREAM ? OBD_LINK_STREAM_PERIOD_MS
+                                                                  : OBD_LINK_IDLE_PERIOD_MS));
+    }
+}
+
+void IcarBleDriver::enter_state(obd_link_state_t state, uint32_t now) {
+    m_link_state = state;
+    m_state_since_ms = now;
+}
+
+bool IcarBleDriver::link_alive() {
+    return m_connected && m_client && m_client->isConnected();
+}
+
+void IcarBleDriver::connect_failed(uint32_t now) {
+    portENTER_CRITICAL(&m_lock);
+    m_stats.connect_failures++;
+    portEXIT_CRITICAL(&m_lock);
+    
+    if (m_connect_attempts < 255) {
+        m_connect_attempts++;
+    }
+    Serial.printf("[OBD] Connection attempt %u failed, retrying in %u ms\n",
+                  m_connect_attempts, m_backoff_ms);
+    enter_state(OBD_LINK_BACKOFF, now);
+}
+
+void IcarBleDriver::run_link(uint32_t now) {
+    switch (m_link_state) {
+        case OBD_LINK_SCAN:
+            // Scan runs in the NimBLE host; wait for it to find an adapter or time out
+            if (m_scan_running) {
+                break;
+            }
+            if (m_scan_address[0]) {
+                set_device_address(m_scan_address);
+                m_scan_address[0] = '\0';
+                m_connect_attempts = 0;
+                enter_state(OBD_LINK_CONNECT, now);
+            } else {
+                Serial.println("[OBD] No adapter found");
+                connect_failed(now);
+            }
+            break;
+        
+        case OBD_LINK_CONNECT:
+            if (open_connection(m_device_address)) {
+                enter_state(OBD_LINK_DISCOVER, now);
+            } else {
+                connect_failed(now);
+            }
+            break;
+        
+        case OBD_LINK_DISCOVER:
+            if (discover_services()) {
+                enter_state(OBD_LINK_INIT, now);
+            } else {
+                m_client->disconnect();
+                connect_failed(now);
+            }
+            break;
+        
+        case OBD_LINK_INIT:
+            // Setup commands and vehicle info are queued; stream once they drain
+            if (!link_alive()) {
+                disconnect();
+                connect_failed(now);
+                break;
+            }
+            service_timeouts();
+            if (m_cmd_count == 0) {
+                Serial.printf("[OBD] Link ready after %u ms\n", now - m_state_since_ms);
+                m_backoff_ms = OBD_BACKOFF_MIN_MS;
+                m_connect_attempts = 0;
+                enter_state(OBD_LINK_STREAM, now);
+            } else if (now - m_state_since_ms >= OBD_INIT_TIMEOUT_MS) {
+                Serial.println("[OBD] Adapter setup did not finish");
+                disconnect();
+                connect_failed(now);
+            }
+            break;
+        
+        case OBD_LINK_STREAM:
+            if (!link_alive()) {
+                Serial.println("[OBD] Link lost");
+                portENTER_CRITICAL(&m_lock);
+                m_stats.link_losses++;
+                portEXIT_CRITICAL(&m_lock);
+                disconnect();
+                enter_state(OBD_LINK_BACKOFF, now);   // First retry after the minimum backoff
+                break;
+            }
+            service_can_monitor(now);
+            update();
+            break;
+        
+        case OBD_LINK_BACKOFF:
+            if (now - m_state_since_ms < m_backoff_ms) {
+                break;
+            }
+            if (m_connect_attempts > 0) {
+                m_backoff_ms = std::min<uint32_t>(m_backoff_ms * 2, OBD_BACKOFF_MAX_MS);
+            }
+            // The last adapter may be gone (or swapped); look around again
+            if (!m_device_address[0] || m_connect_attempts >= OBD_RESCAN_AFTER_FAILURES) {
+                m_connect_attempts = 0;
+                enter_state(OBD_LINK_SCAN, now);
+                if (!start_scan()) {
+                    connect_failed(now);
+                }
+            } else {
+                enter_state(OBD_LINK_CONNECT, now);
+            }
+            break;
+        
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Scan callbacks forwarded to IcarBleDriver (runs in the NimBLE host task)
+ */
+class ObdScanCallbacks : public NimBLEAdvertisedDeviceCallbacks {
+    void onResult(NimBLEAdvertisedDevice* device) override {
+        IcarBleDriver::on_advertised(device);
+    }
+};
+
+static ObdScanCallbacks s_scan_callbacks;
+
+void IcarBleDriver::on_advertised(NimBLEAdvertisedDevice* device) {
+    if (m_scan_address[0]) {
+        return;  // Already have one; the scan is stopping
+    }
+    std::string name = device->haveName() ? device->getName() : std::string();
+    if (!device->isAdvertisingService(NimBLEUUID(SERVICE_UUID)) &&
+        name.find("iCar") == std::string::npos && name.find("vgate") == std::string::npos) {
+        return;
+    }
+    
+    std::string address = device->getAddress().toString();
+    strncpy(m_scan_address, address.c_str(), sizeof(m_scan_address) - 1);
+    m_scan_address[sizeof(m_scan_address) - 1] = '\0';
+    Serial.printf("[OBD] Found adapter %s (%s)\n", m_scan_address, name.c_str());
+    NimBLEDevice::getScan()->stop();
+}
+
+void IcarBleDriver::on_scan_complete(NimBLEScanResults results) {
+    (void)results;
+    m_scan_running = false;
+}
+
 bool IcarBleDriver::start_scan() {
     Serial.println("[OBD] Starting BLE scan for iCar device...");
     
@@ -39,14 +361,19 @@ bool IcarBleDriver::start_scan() {
     }
     
     // Configure scan parameters
+    scan->setAdvertisedDeviceCallbacks(&s_scan_callbacks, false);
     scan->setInterval(97);   // Interval in 0.625ms units (~60ms)
     scan->setWindow(32);     // Window in 0.625ms units (~20ms)
     scan->setActiveScan(true);
     scan->setDuplicateFilter(true);
     
-    // Start scan and get results
-    scan->start(10, nullptr, false);
-    
+    // Runs in the background; on_scan_complete() fires when it ends or is stopped
+    m_scan_address[0] = '\0';
+    m_scan_running = true;
+    if (!scan->start(OBD_SCAN_DURATION_S, on_scan_complete, false)) {
+        m_scan_running = false;
+        return false;
+    }
     return true;
 }
 
@@ -55,36 +382,78 @@ void IcarBleDriver::stop_scan() {
     if (scan) {
         scan->stop();
     }
+    m_scan_running = false;
 }
 
 bool IcarBleDriver::connect(const char* address) {
-    if (!address) return false;
+    if (!open_connection(address)) {
+        return false;
+    }
+    if (!discover_services()) {
+        m_client->disconnect();
+        return false;
+    }
+    return true;
+}
+
+bool IcarBleDriver::open_connection(const char* address) {
+    if (!address || !address[0]) return false;
     
     Serial.printf("[OBD] Attempting to connect to %s\n", address);
     
-    // Create client
-    NimBLEClient* pClient = NimBLEDevice::createClient();
-    if (!pClient) {
-        Serial.println("[OBD] Failed to create client");
-        return false;
+    // One client is reused for every attempt
+    if (!m_client) {
+        m_client = NimBLEDevice::createClient();
+        if (!m_client) {
+            Serial.println("[OBD] Failed to create client");
+            return false;
+        }
+        m_client->setConnectTimeout(OBD_CONNECT_TIMEOUT_S);
     }
+    NimBLEClient* pClient = m_client;
+    
+    // Ask for a large MTU and a short connection interval; NimBLE exchanges
+    // the MTU as soon as the link is up
+    obd_link_params_t params = load_link_params(address);
+    NimBLEDevice::setMTU(params.mtu);
+    pClient->setConnectionParams(params.interval_min, params.interval_max, 0, OBD_BLE_SUPERVISION_TIMEOUT);
     
     // Connect to address
     NimBLEAddress addr(address);
     bool connected = pClient->connect(addr);
     
+    // Some adapters drop connection requests they do not like; retry once
+    // with conservative parameters and remember them if that works
+    if (!connected && params.interval_min < OBD_BLE_FALLBACK_INTERVAL_MIN) {
+        Serial.println("[OBD] Connect failed, retrying with default link parameters");
+        params = { OBD_BLE_DEFAULT_MTU, OBD_BLE_FALLBACK_INTERVAL_MIN, OBD_BLE_FALLBACK_INTERVAL_MAX };
+        NimBLEDevice::setMTU(params.mtu);
+        pClient->setConnectionParams(params.interval_min, params.interval_max, 0, OBD_BLE_SUPERVISION_TIMEOUT);
+        connected = pClient->connect(addr);
+        if (connected) {
+            save_link_params(address, params);
+        }
+    }
+    
     if (!connected) {
         Serial.println("[OBD] Failed to connect to remote device");
-        NimBLEDevice::deleteClient(pClient);
         return false;
     }
     
+    // Store address for future reconnection
+    strncpy(m_device_address, address, sizeof(m_device_address) - 1);
+    m_device_address[sizeof(m_device_address) - 1] = '\0';
+    m_link_params = params;
+    return true;
+}
+
+bool IcarBleDriver::discover_services() {
+    NimBLEClient* pClient = m_client;
+    
     // Get the service
     NimBLERemoteService* pRemoteSvc = pClient->getService(SERVICE_UUID);
     if (!pRemoteSvc) {
         Serial.println("[OBD] Service not found, disconnecting");
-        pClient->disconnect();
-        NimBLEDevice::deleteClient(pClient);
         return false;
     }
     
@@ -92,8 +461,6 @@ bool IcarBleDriver::connect(const char* address) {
     m_rx_char = pRemoteSvc->getCharacteristic(RX_CHAR_UUID);
     if (!m_rx_char) {
         Serial.println("[OBD] RX characteristic not found");
-        pClient->disconnect();
-        NimBLEDevice::deleteClient(pClient);
         return false;
     }
     
@@ -101,41 +468,70 @@ bool IcarBleDriver::connect(const char* address) {
     m_tx_char = pRemoteSvc->getCharacteristic(TX_CHAR_UUID);
     if (!m_tx_char) {
         Serial.println("[OBD] TX characteristic not found");
-        pClient->disconnect();
-        NimBLEDevice::deleteClient(pClient);
         return false;
     }
     
-    // Subscribe to notifications if available
-    if (m_rx_char->canNotify()) {
-        // Use lambda function instead of callback class
-        m_rx_char->subscribe(true, [](NimBLERemoteCharacteristic* pChar, 
-                                      uint8_t* pData, size_t length, bool isNotify) {
-            if (length > 0) {
-                Serial.printf("[OBD] Received %d bytes: ", length);
-                for (int i = 0; i < length && i < 16; i++) {
-                    Serial.printf("%02X ", pData[i]);
-                }
-                Serial.println();
-            }
-        });
-        Serial.println("[OBD] Subscribed to RX notifications");
+    // Responses arrive only as notifications; without them the command engine cannot run
+    if (!m_rx_char->canNotify() || !m_rx_char->subscribe(true, on_notify)) {
+        Serial.println("[OBD] RX notifications unavailable");
+        m_rx_char = nullptr;
+        m_tx_char = nullptr;
+        return false;
     }
+    Serial.println("[OBD] Subscribed to RX notifications");
     
-    // Store address for future reconnection
-    strncpy(m_device_address, address, sizeof(m_device_address) - 1);
-    m_device_address[sizeof(m_device_address) - 1] = '\0';
+    // Remember this adapter for the next boot
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, false)) {
+        char saved[18] = "";
+        prefs.getString(KEY_LAST_ADDRESS, saved, sizeof(saved));
+        if (strcmp(saved, m_device_address) != 0) {
+            prefs.putString(KEY_LAST_ADDRESS, m_device_address);
+        }
+        prefs.end();
+    }
     
     // Get and store device name from address (BLE address is the identifier)
     // Most adapters advertise as "vgate iCar2Pro" or similar during scan
     // We'll store the address as the name for now
+    const char* address = m_device_address;
     snprintf(m_device_name, sizeof(m_device_name), "OBD2 %s", address + strlen(address) - 5);
     
+    m_params_checked = false;
+    m_params_requested_ms = millis();
+    
     m_connected = true;
     m_data.connected = true;
     m_data.last_update_ms = millis();
     
-    Serial.printf("[OBD] Connected to %s successfully!\n", m_device_name);
+    Serial.printf("[OBD] Connected to %s successfully! (MTU %u)\n", m_device_name, pClient->getMTU());
+    
+    portENTER_CRITICAL(&m_lock);
+    m_rx_len = 0;
+    memset(m_pending_pids, 0, sizeof(m_pending_pids));
+    m_batching_enabled = true;      // A different vehicle may accept batches
+    m_batch_failures = 0;
+    m_mode01_outstanding = 0;
+    m_stats.mtu = pClient->getMTU();
+    m_stats.conn_interval_ms = pClient->getConnInfo().getConnInterval() * 1.25f;
+    m_stats.rx_bytes_per_sec = 0.0f;
+    m_stats.tx_bytes_per_sec = 0.0f;
+    m_stats.rtt_ms = 0.0f;
+    m_stats.max_rtt_ms = 0;
+    portEXIT_CRITICAL(&m_lock);
+    m_saturated = false;
+    for (auto& pid_config : m_configured_pids) {
+        pid_config.deadline_ms = millis();
+    }
+    m_rate_window_start_ms = millis();
+    m_rate_window_pids = 0;
+    m_rate_window_rx_bytes = m_rx_bytes;
+    m_rate_window_tx_bytes = m_tx_bytes;
+    
+    // Put the adapter into compact ELM327 mode; the queue keeps them in order
+    for (const char* cmd : ELM327_INIT_COMMANDS) {
+        queue_command(cmd, nullptr, nullptr);
+    }
     
     // Request VIN and ECM name once connected
     request_vehicle_info();
@@ -149,12 +545,19 @@ void IcarBleDriver::disconnect() {
     m_rx_char = nullptr;
     m_tx_char = nullptr;
     
+    // Anything still queued can never complete now
+    m_monitor_enabled = false;
+    flush_queue();
+    
     // Clear device info
     m_device_name[0] = '\0';
     m_vin[0] = '\0';
     m_ecm_name[0] = '\0';
     
-    NimBLEDevice::deinit(false);
+    // The BLE stack stays up and the client is reused for the next attempt
+    if (m_client && m_client->isConnected()) {
+        m_client->disconnect();
+    }
     Serial.println("[OBD] Disconnected from device");
 }
 
@@ -165,13 +568,116 @@ bool IcarBleDriver::is_connected() {
 bool IcarBleDriver::update() {
     if (!m_connected) return false;
     
-    // Query common PIDs
-    // PID 0x0C = RPM, 0x0D = Speed, 0x05 = Coolant Temp, etc.
-    return request_pid(0x0C);  // Start with RPM
+    service_timeouts();
+    
+    uint32_t now = millis();
+    
+    // The adapter is busy streaming; PIDs resume once the monitor stops. The
+    // rate window restarts so the pause is not learned as lost capacity.
+    if (m_monitor_enabled) {
+        m_rate_window_start_ms = now;
+        m_saturated = false;
+        return false;
+    }
+    portENTER_CRITICAL(&m_lock);
+    bool batching = m_batching_enabled;
+    uint8_t outstanding = m_mode01_outstanding;
+    portEXIT_CRITICAL(&m_lock);
+    
+    // Due PIDs not already outstanding, earliest deadline first (ties to the higher priority)
+    static std::vector<obd_pid_config_t*> due;
+    due.clear();
+    for (auto& pid_config : m_configured_pids) {
+        uint8_t pid = pid_config.pid;
+        bool pending = (m_pending_pids[pid >> 5] >> (pid & 31)) & 1;
+        if (!pending && (int32_t)(now - pid_config.deadline_ms) >= 0) {
+            due.push_back(&pid_config);
+        }
+    }
+    std::sort(due.begin(), due.end(), [](const obd_pid_config_t* a, const obd_pid_config_t* b) {
+        int32_t diff = (int32_t)(a->deadline_ms - b->deadline_ms);
+        return diff != 0 ? diff < 0 : a->priority < b->priority;
+    });
+    
+    // Top up the short Mode 01 queue. The most urgent PID leads each request and
+    // the next most urgent PIDs with a known data length ride along with it.
+    size_t next = 0;
+    while (next < due.size() && outstanding < OBD_MODE01_MAX_OUTSTANDING) {
+        obd_pid_config_t* batch[OBD_MAX_PIDS_PER_REQUEST];
+        size_t count = 0;
+        batch[count++] = due[next];
+        due[next] = nullptr;
+        if (batching && obd_mode01_data_length(batch[0]->pid) != 0) {
+            for (size_t i = next + 1; i < due.size() && count < OBD_MAX_PIDS_PER_REQUEST; i++) {
+                if (due[i] && obd_mode01_data_length(due[i]->pid) != 0) {
+                    batch[count++] = due[i];
+                    due[i] = nullptr;
+                }
+            }
+        }
+        if (!queue_batch(batch, count, now)) {
+            break;  // Command queue full: try again on the next update
+        }
+        outstanding++;
+        while (next < due.size() && !due[next]) next++;
+    }
+    if (next < due.size()) {
+        m_saturated = true;
+    }
+    
+    check_link_params(now);
+    
+    // Achieved rates, link throughput, capacity estimate and rate plan
+    uint32_t elapsed = now - m_rate_window_start_ms;
+    if (elapsed >= PID_RATE_WINDOW_MS) {
+        uint16_t interval = m_client ? m_client->getConnInfo().getConnInterval() : 0;
+        uint16_t mtu = m_client ? m_client->getMTU() : 0;
+        
+        portENTER_CRITICAL(&m_lock);
+        uint32_t pids = m_stats.pid_updates - m_rate_window_pids;
+        m_rate_window_pids = m_stats.pid_updates;
+        m_stats.pids_per_sec = pids * 1000.0f / elapsed;
+        m_stats.rx_bytes_per_sec = (m_rx_bytes - m_rate_window_rx_bytes) * 1000.0f / elapsed;
+        m_stats.tx_bytes_per_sec = (m_tx_bytes - m_rate_window_tx_bytes) * 1000.0f / elapsed;
+        m_rate_window_rx_bytes = m_rx_bytes;
+        m_rate_window_tx_bytes = m_tx_bytes;
+        m_stats.mtu = mtu;
+        m_stats.conn_interval_ms = interval * 1.25f;
+        m_stats.saturated = m_saturated;
+        for (auto& pid_config : m_configured_pids) {
+            uint16_t count = m_pid_update_counts[pid_config.pid];
+            pid_config.achieved_hz = (uint16_t)(count - pid_config.window_updates) * 1000.0f / elapsed;
+            pid_config.window_updates = count;
+        }
+        float pids_per_sec = m_stats.pids_per_sec;
+        portEXIT_CRITICAL(&m_lock);
+        
+        learn_capacity(pids_per_sec, m_saturated, now);
+        plan_rates();
+        m_saturated = false;
+        m_rate_window_start_ms = now;
+    }
+    
+    portENTER_CRITICAL(&m_lock);
+    bool updated = m_pid_updated;
+    m_pid_updated = false;
+    portEXIT_CRITICAL(&m_lock);
+    return updated;
 }
 
 obd_data_t IcarBleDriver::get_data() {
-    return m_data;
+    portENTER_CRITICAL(&m_lock);
+    obd_data_t data = m_data;
+    portEXIT_CRITICAL(&m_lock);
+    return data;
+}
+
+obd_link_stats_t IcarBleDriver::get_link_stats() {
+    portENTER_CRITICAL(&m_lock);
+    obd_link_stats_t stats = m_stats;
+    stats.batching = m_batching_enabled;
+    portEXIT_CRITICAL(&m_lock);
+    return stats;
 }
 
 bool IcarBleDriver::request_pid(uint8_t pid) {
@@ -180,19 +686,721 @@ bool IcarBleDriver::request_pid(uint8_t pid) {
         return false;
     }
     
-    // Construct OBD-II request: 62 01 <PID>
-    // 62 = Service 01 (read data by identifier)
-    // 01 = PID mode
-    uint8_t request[3] = {0x62, 0x01, pid};
+    // ELM327 Mode 01 request: "01" + PID in hex
+    char command[8];
+    snprintf(command, sizeof(command), "01%02X", pid);
+    
+    portENTER_CRITICAL(&m_lock);
+    m_pending_pids[pid >> 5] |= (1UL << (pid & 31));
+    portEXIT_CRITICAL(&m_lock);
+    
+    if (!queue_command(command, on_pid_response, nullptr)) {
+        portENTER_CRITICAL(&m_lock);
+        m_pending_pids[pid >> 5] &= ~(1UL << (pid & 31));
+        portEXIT_CRITICAL(&m_lock);
+        return false;
+    }
+    
+    portENTER_CRITICAL(&m_lock);
+    m_mode01_outstanding++;
+    portEXIT_CRITICAL(&m_lock);
+    return true;
+}
+
+bool IcarBleDriver::request_pids(const uint8_t* pids, size_t count) {
+    if (!pids || count == 0 || count > OBD_MAX_PIDS_PER_REQUEST) return false;
+    if (count == 1) return request_pid(pids[0]);
+    if (!m_connected || !m_tx_char) return false;
+    
+    // "01" followed by each PID; the callback recovers the PIDs from the command text
+    char command[OBD_COMMAND_MAX_LEN];
+    size_t len = snprintf(command, sizeof(command), "01");
+    for (size_t i = 0; i < count; i++) {
+        len += snprintf(command + len, sizeof(command) - len, "%02X", pids[i]);
+    }
+    
+    portENTER_CRITICAL(&m_lock);
+    for (size_t i = 0; i < count; i++) {
+        m_pending_pids[pids[i] >> 5] |= (1UL << (pids[i] & 31));
+    }
+    portEXIT_CRITICAL(&m_lock);
+    
+    if (!queue_command(command, on_pid_response, nullptr)) {
+        portENTER_CRITICAL(&m_lock);
+        for (size_t i = 0; i < count; i++) {
+            m_pending_pids[pids[i] >> 5] &= ~(1UL << (pids[i] & 31));
+        }
+        portEXIT_CRITICAL(&m_lock);
+        return false;
+    }
+    
+    portENTER_CRITICAL(&m_lock);
+    m_stats.batch_requests++;
+    m_mode01_outstanding++;
+    portEXIT_CRITICAL(&m_lock);
+    return true;
+}
+
+bool IcarBleDriver::queue_batch(obd_pid_config_t* const* batch, size_t count, uint32_t now) {
+    uint8_t pids[OBD_MAX_PIDS_PER_REQUEST];
+    for (size_t i = 0; i < count; i++) {
+        pids[i] = batch[i]->pid;
+    }
+    if (!request_pids(pids, count)) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        obd_pid_config_t* pid_config = batch[i];
+        pid_config->last_poll_ms = now;
+        
+        // Keep the phase while on time; a PID more than an interval late starts over
+        pid_config->deadline_ms += pid_config->scheduled_interval_ms;
+        if ((int32_t)(now - pid_config->deadline_ms) >= 0) {
+            pid_config->deadline_ms = now + pid_config->scheduled_interval_ms;
+        }
+    }
+    return true;
+}
+
+obd_pid_priority_t IcarBleDriver::default_priority(uint8_t pid) {
+    switch (pid) {
+        case 0x0C:  // Engine RPM
+        case 0x0D:  // Vehicle speed
+        case 0x11:  // Throttle position
+            return OBD_PRIORITY_HIGH;
+        case 0x01:  // Monitor status / DTC count
+        case 0x03:  // Fuel system status
+        case 0x05:  // Coolant temperature
+        case 0x0F:  // Intake air temperature
+        case 0x1F:  // Run time since start
+        case 0x21:  // Distance with MIL on
+        case 0x2F:  // Fuel tank level
+        case 0x33:  // Barometric pressure
+            return OBD_PRIORITY_LOW;
+        default:
+            return OBD_PRIORITY_NORMAL;
+    }
+}
+
+void IcarBleDriver::plan_rates() {
+    float budget = m_capacity * OBD_CAPACITY_PROBE;
+    float demand_total = 0.0f;
+    
+    portENTER_CRITICAL(&m_lock);
+    for (uint8_t priority = 0; priority < OBD_PRIORITY_COUNT; priority++) {
+        float demand = 0.0f;
+        for (const auto& pid_config : m_configured_pids) {
+            if (pid_config.priority == priority) {
+                demand += 1000.0f / std::max<uint32_t>(pid_config.poll_interval_ms, OBD_MIN_POLL_INTERVAL_MS);
+            }
+        }
+        demand_total += demand;
+        
+        // Full rates while the class fits; otherwise share what is left in proportion
+        float scale = (demand <= budget) ? 1.0f : budget / demand;
+        budget = (demand <= budget) ? budget - demand : 0.0f;
+        
+        for (auto& pid_config : m_configured_pids) {
+            if (pid_config.priority != priority) {
+                continue;
+            }
+            float requested_hz = 1000.0f / std::max<uint32_t>(pid_config.poll_interval_ms, OBD_MIN_POLL_INTERVAL_MS);
+            float hz = std::max(requested_hz * scale, std::min(requested_hz, OBD_MIN_DEGRADED_HZ));
+            pid_config.scheduled_interval_ms = (uint32_t)(1000.0f / hz);
+            
+            // A PID granted more rate should not sit out the old, longer interval
+            uint32_t due = pid_config.last_poll_ms + pid_config.scheduled_interval_ms;
+            if ((int32_t)(pid_config.deadline_ms - due) > 0) {
+                pid_config.deadline_ms = due;
+            }
+        }
+    }
+    m_stats.demand_pids_per_sec = demand_total;
+    m_stats.capacity_pids_per_sec = m_capacity;
+    portEXIT_CRITICAL(&m_lock);
+}
+
+void IcarBleDriver::learn_capacity(float pids_per_sec, bool saturated, uint32_t now) {
+    if (pids_per_sec <= 0.0f) {
+        return;  // Idle window: says nothing about the adapter
+    }
     
-    try {
-        m_tx_char->writeValue(request, sizeof(request), false);
-        Serial.printf("[OBD] Requested PID 0x%02X\n", pid);
+    // A saturated adapter shows its capacity; otherwise it can do at least what it did
+    if (saturated) {
+        m_capacity += OBD_CAPACITY_GAIN * (pids_per_sec - m_capacity);
+    } else if (pids_per_sec > m_capacity) {
+        m_capacity = pids_per_sec;
+    }
+    if (m_capacity < 1.0f) {
+        m_capacity = 1.0f;
+    }
+    
+    if (fabsf(m_capacity - m_saved_capacity) > OBD_CAPACITY_SAVE_DELTA * m_saved_capacity &&
+        now - m_capacity_saved_ms >= OBD_CAPACITY_SAVE_MIN_MS) {
+        Preferences prefs;
+        if (prefs.begin(NVS_NAMESPACE, false)) {
+            prefs.putFloat(KEY_CAPACITY, m_capacity);
+            prefs.end();
+            m_saved_capacity = m_capacity;
+            m_capacity_saved_ms = now;
+            Serial.printf("[OBD] Saved adapter capacity: %.1f PIDs/s\n", m_capacity);
+        }
+    }
+}
+
+obd_link_params_t IcarBleDriver::load_link_params(const char* address) {
+    obd_link_params_t params = { OBD_BLE_PREFERRED_MTU, OBD_BLE_INTERVAL_MIN, OBD_BLE_INTERVAL_MAX };
+    char key[16];
+    link_params_key(address, key, sizeof(key));
+    
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, true)) {
+        obd_link_params_t saved;
+        if (prefs.getBytes(key, &saved, sizeof(saved)) == sizeof(saved) &&
+            saved.mtu >= OBD_BLE_DEFAULT_MTU && saved.interval_min >= OBD_BLE_INTERVAL_MIN &&
+            saved.interval_max >= saved.interval_min) {
+            params = saved;
+        }
+        prefs.end();
+    }
+    return params;
+}
+
+void IcarBleDriver::save_link_params(const char* address, const obd_link_params_t& params) {
+    char key[16];
+    link_params_key(address, key, sizeof(key));
+    
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, false)) {
+        prefs.putBytes(key, &params, sizeof(params));
+        prefs.end();
+        Serial.printf("[OBD] Saved link parameters for %s: MTU %u, interval %.2f-%.2f ms\n", address,
+                      params.mtu, params.interval_min * 1.25f, params.interval_max * 1.25f);
+    }
+}
+
+void IcarBleDriver::check_link_params(uint32_t now) {
+    if (m_params_checked || !m_client || now - m_params_requested_ms < OBD_BLE_PARAM_SETTLE_MS) {
+        return;
+    }
+    m_params_checked = true;
+    
+    // The adapter may cap the MTU or answer with its own interval; ask for
+    // what it actually grants next time so the first connection event is right
+    obd_link_params_t accepted = m_link_params;
+    uint16_t mtu = m_client->getMTU();
+    uint16_t interval = m_client->getConnInfo().getConnInterval();
+    if (mtu >= OBD_BLE_DEFAULT_MTU && mtu < accepted.mtu) {
+        accepted.mtu = mtu;
+    }
+    if (interval != 0 && (interval < accepted.interval_min || interval > accepted.interval_max)) {
+        Serial.printf("[OBD] Adapter chose a %.2f ms connection interval (asked %.2f-%.2f ms)\n",
+                      interval * 1.25f, accepted.interval_min * 1.25f, accepted.interval_max * 1.25f);
+        accepted.interval_min = interval < OBD_BLE_INTERVAL_MIN ? OBD_BLE_INTERVAL_MIN : interval;
+        accepted.interval_max = accepted.interval_min;
+    }
+    
+    if (memcmp(&accepted, &m_link_params, sizeof(accepted)) != 0) {
+        m_link_params = accepted;
+        save_link_params(m_device_address, accepted);
+    }
+}
+
+bool IcarBleDriver::queue_command(const char* command, obd_command_cb_t callback, void* ctx,
+                                  uint32_t timeout_ms) {
+    if (!command || strlen(command) >= OBD_COMMAND_MAX_LEN - 1 || !m_connected) {
+        return false;
+    }
+    
+    portENTER_CRITICAL(&m_lock);
+    if (m_cmd_count >= OBD_COMMAND_QUEUE_SIZE) {
+        m_stats.queue_full++;
+        portEXIT_CRITICAL(&m_lock);
+        return false;
+    }
+    obd_command_t& slot = m_cmd_queue[(m_cmd_head + m_cmd_count) % OBD_COMMAND_QUEUE_SIZE];
+    strncpy(slot.text, command, sizeof(slot.text) - 1);
+    slot.text[sizeof(slot.text) - 1] = '\0';
+    slot.callback = callback;
+    slot.ctx = ctx;
+    slot.timeout_ms = timeout_ms;
+    m_cmd_count++;
+    if (m_cmd_count > m_stats.max_queue_depth) {
+        m_stats.max_queue_depth = m_cmd_count;
+    }
+    portEXIT_CRITICAL(&m_lock);
+    
+    // Starts immediately if the adapter is idle
+    issue_next();
+    return true;
+}
+
+void IcarBleDriver::issue_next() {
+    NimBLERemoteCharacteristic* tx = m_tx_char;
+    char line[OBD_COMMAND_MAX_LEN + 1];
+    
+    portENTER_CRITICAL(&m_lock);
+    if (m_cmd_active || m_cmd_count == 0 || !tx) {
+        portEXIT_CRITICAL(&m_lock);
+        return;
+    }
+    m_cmd_active = true;
+    m_cmd_sent_ms = millis();
+    m_rx_len = 0;
+    size_t len = strlen(m_cmd_queue[m_cmd_head].text);
+    memcpy(line, m_cmd_queue[m_cmd_head].text, len);
+    m_stats.commands_sent++;
+    m_tx_bytes += len + 1;
+    portEXIT_CRITICAL(&m_lock);
+    
+    line[len++] = '\r';
+    if (!tx->writeValue((const uint8_t*)line, len, false)) {
+        complete_active(OBD_COMMAND_DISCONNECTED, "");
+    }
+}
+
+void IcarBleDriver::on_notify(NimBLERemoteCharacteristic* chr, uint8_t* data, size_t length, bool is_notify) {
+    (void)chr;
+    (void)is_notify;
+    
+    bool prompt = false;
+    bool streaming = false;
+    portENTER_CRITICAL(&m_lock);
+    m_rx_bytes += length;
+    if (m_cmd_active) {
+        streaming = (m_cmd_queue[m_cmd_head].timeout_ms == OBD_COMMAND_STREAMING);
+        for (size_t i = 0; i < length; i++) {
+            if (data[i] == '>') {
+                prompt = true;
+                break;
+            }
+            if (m_rx_len < sizeof(m_rx_buffer) - 1) {
+                m_rx_buffer[m_rx_len++] = (char)data[i];
+            }
+        }
+    }
+    portEXIT_CRITICAL(&m_lock);
+    
+    // Streaming lines are handled as they arrive; only this task touches the
+    // buffer while the command is active
+    if (streaming) {
+        consume_stream_lines();
+    }
+    
+    if (!prompt) {
+        return;
+    }
+    
+    // Only this task completes prompted commands, so m_response has one writer
+    portENTER_CRITICAL(&m_lock);
+    memcpy(m_response, m_rx_buffer, m_rx_len);
+    m_response[m_rx_len] = '\0';
+    portEXIT_CRITICAL(&m_lock);
+    
+    // Trim leading/trailing whitespace (CR-separated lines stay intact)
+    char* text = m_response;
+    while (*text == '\r' || *text == '\n' || *text == ' ') text++;
+    size_t len = strlen(text);
+    while (len > 0 && (text[len - 1] == '\r' || text[len - 1] == '\n' || text[len - 1] == ' ')) {
+        text[--len] = '\0';
+    }
+    
+    obd_command_status_t status = OBD_COMMAND_OK;
+    if (strstr(text, "NO DATA")) {
+        status = OBD_COMMAND_NO_DATA;
+    } else if (strchr(text, '?') || strstr(text, "ERROR") || strstr(text, "UNABLE") ||
+               strstr(text, "STOPPED")) {
+        status = OBD_COMMAND_ERROR;
+    }
+    complete_active(status, text);
+}
+
+void IcarBleDriver::complete_active(obd_command_status_t status, const char* response) {
+    obd_command_t done;
+    uint32_t rtt_ms;
+    
+    portENTER_CRITICAL(&m_lock);
+    if (!m_cmd_active || m_cmd_count == 0) {
+        portEXIT_CRITICAL(&m_lock);
+        return;
+    }
+    done = m_cmd_queue[m_cmd_head];
+    m_cmd_head = (m_cmd_head + 1) % OBD_COMMAND_QUEUE_SIZE;
+    m_cmd_count--;
+    m_cmd_active = false;
+    rtt_ms = millis() - m_cmd_sent_ms;
+    switch (status) {
+        case OBD_COMMAND_OK:      m_stats.responses++; break;
+        case OBD_COMMAND_NO_DATA: m_stats.responses++; m_stats.no_data++; break;
+        case OBD_COMMAND_ERROR:   m_stats.responses++; m_stats.errors++; break;
+        case OBD_COMMAND_TIMEOUT: m_stats.timeouts++; break;
+        default: break;
+    }
+    // Mode 01 round trips show what the link and ECU cost per request
+    if (status == OBD_COMMAND_OK && strncmp(done.text, "01", 2) == 0) {
+        m_stats.rtt_ms = m_stats.rtt_ms > 0.0f ? m_stats.rtt_ms + OBD_RTT_GAIN * (rtt_ms - m_stats.rtt_ms)
+                                               : (float)rtt_ms;
+        if (rtt_ms > m_stats.max_rtt_ms) {
+            m_stats.max_rtt_ms = rtt_ms;
+        }
+    }
+    portEXIT_CRITICAL(&m_lock);
+    
+    // Keep the adapter busy: the next request goes out before the callback runs
+    if (status != OBD_COMMAND_DISCONNECTED) {
+        issue_next();
+    }
+    
+    if (done.callback) {
+        obd_command_result_t result = { done.text, response, status, rtt_ms };
+        done.callback(result, done.ctx);
+    }
+}
+
+void IcarBleDriver::service_timeouts() {
+    portENTER_CRITICAL(&m_lock);
+    bool expired = m_cmd_active && m_cmd_count > 0 &&
+                   m_cmd_queue[m_cmd_head].timeout_ms != OBD_COMMAND_STREAMING &&
+                   millis() - m_cmd_sent_ms >= m_cmd_queue[m_cmd_head].timeout_ms;
+    portEXIT_CRITICAL(&m_lock);
+    
+    // A late prompt from the abandoned command may still arrive; the ELM327
+    // aborts on the next command's first byte, so that costs one stray response
+    if (expired) {
+        complete_active(OBD_COMMAND_TIMEOUT, "");
+    }
+}
+
+void IcarBleDriver::flush_queue() {
+    for (;;) {
+        portENTER_CRITICAL(&m_lock);
+        bool empty = (m_cmd_count == 0);
+        if (!empty) {
+            m_cmd_active = true;  // Let complete_active() pop the head
+        }
+        portEXIT_CRITICAL(&m_lock);
+        if (empty) {
+            break;
+        }
+        complete_active(OBD_COMMAND_DISCONNECTED, "");
+    }
+}
+
+bool IcarBleDriver::start_can_monitor(const obd_can_filter_t& filter, int64_t session_start_us) {
+    if (!m_connected) {
+        return false;
+    }
+    if (m_monitor_enabled) {
         return true;
-    } catch (const std::exception& e) {
-        Serial.printf("[OBD] Write failed: %s\n", e.what());
+    }
+    
+    m_can_filter = filter;
+    m_session_start_us = session_start_us;
+    m_monitor_buffer_full = false;
+    m_monitor_enabled = true;
+    
+    // Headers and DLC on, raw frames instead of ISO-TP payloads
+    bool queued = queue_command("ATH1", nullptr, nullptr) &&
+                  queue_command("ATD1", nullptr, nullptr) &&
+                  queue_command("ATCAF0", nullptr, nullptr);
+    
+    if (filter.mask != 0) {
+        char command[OBD_COMMAND_MAX_LEN];
+        const char* format = filter.extended ? "%s %08lX" : "%s %03lX";
+        uint32_t id_mask = filter.extended ? 0x1FFFFFFF : 0x7FF;
+        snprintf(command, sizeof(command), format, "ATCF", (unsigned long)(filter.id & id_mask));
+        queued = queued && queue_command(command, nullptr, nullptr);
+        snprintf(command, sizeof(command), format, "ATCM", (unsigned long)(filter.mask & id_mask));
+        queued = queued && queue_command(command, nullptr, nullptr);
+    } else {
+        Serial.println("[OBD] WARNING: CAN monitor without a filter; a busy bus will overrun BLE");
+        queued = queued && queue_command("ATCRA", nullptr, nullptr);
+    }
+    queued = queued && queue_command("ATMA", on_monitor_done, nullptr, OBD_COMMAND_STREAMING);
+    
+    if (!queued) {
+        Serial.println("[OBD] Failed to queue CAN monitor commands");
+        m_monitor_enabled = false;
+        for (const char* cmd : ELM327_MONITOR_RESTORE_COMMANDS) {
+            queue_command(cmd, nullptr, nullptr);
+        }
         return false;
     }
+    
+    Serial.printf("[OBD] CAN monitor started (filter %lX mask %lX%s)\n",
+                  (unsigned long)filter.id, (unsigned long)filter.mask, filter.extended ? ", 29-bit" : "");
+    return true;
+}
+
+void IcarBleDriver::stop_can_monitor() {
+    if (!m_monitor_enabled) {
+        return;
+    }
+    m_monitor_enabled = false;
+    
+    // Any character interrupts ATMA; the prompt then completes it through
+    // on_monitor_done(), which restores polling mode
+    portENTER_CRITICAL(&m_lock);
+    bool streaming = m_cmd_active && m_cmd_count > 0 &&
+                     m_cmd_queue[m_cmd_head].timeout_ms == OBD_COMMAND_STREAMING;
+    portEXIT_CRITICAL(&m_lock);
+    NimBLERemoteCharacteristic* tx = m_tx_char;
+    if (streaming && tx) {
+        const uint8_t interrupt = '\r';
+        tx->writeValue(&interrupt, 1, false);
+    }
+}
+
+bool IcarBleDriver::is_can_monitor_active() {
+    return m_monitor_enabled;
+}
+
+void IcarBleDriver::load_can_monitor_config(const logging_config_t& config, int64_t session_start_us) {
+    obd_can_filter_t filter;
+    filter.id = config.can_filter_id;
+    filter.mask = config.can_filter_mask;
+    filter.extended = config.can_filter_extended;
+    
+    portENTER_CRITICAL(&m_lock);
+    m_monitor_requested = config.can_monitor_enabled;
+    m_requested_filter = filter;
+    m_requested_session_us = session_start_us;
+    m_monitor_retry_ms = millis();     // Apply on the next link task pass
+    portEXIT_CRITICAL(&m_lock);
+}
+
+void IcarBleDriver::service_can_monitor(uint32_t now) {
+    portENTER_CRITICAL(&m_lock);
+    bool requested = m_monitor_requested;
+    obd_can_filter_t filter = m_requested_filter;
+    int64_t session_start_us = m_requested_session_us;
+    bool retry_due = (int32_t)(now - m_monitor_retry_ms) >= 0;
+    portEXIT_CRITICAL(&m_lock);
+    
+    if (m_monitor_enabled) {
+        bool filter_changed = filter.id != m_can_filter.id || filter.mask != m_can_filter.mask ||
+                              filter.extended != m_can_filter.extended;
+        if (!requested || filter_changed || session_start_us != m_session_start_us) {
+            stop_can_monitor();     // Restarted with the new settings once polling mode is restored
+        }
+        return;
+    }
+    
+    if (!requested || !retry_due) {
+        return;
+    }
+
+    // A stopped monitor's ATMA must complete (and queue its restore commands)
+    // before the next one starts, or its completion would end the new monitor
+    portENTER_CRITICAL(&m_lock);
+    for (uint8_t i = 0; i < m_cmd_count; i++) {
+        if (m_cmd_queue[(m_cmd_head + i) % OBD_COMMAND_QUEUE_SIZE].timeout_ms == OBD_COMMAND_STREAMING) {
+            portEXIT_CRITICAL(&m_lock);
+            return;
+        }
+    }
+    m_monitor_retry_ms = now + OBD_CAN_MONITOR_RETRY_MS;
+    portEXIT_CRITICAL(&m_lock);
+    start_can_monitor(filter, session_start_us);
+}
+
+log_record_ring_t* IcarBleDriver::get_can_ring() {
+    return &m_can_ring;
+}
+
+void IcarBleDriver::on_monitor_done(const obd_command_result_t& result, void* ctx) {
+    (void)ctx;
+    if (result.status == OBD_COMMAND_DISCONNECTED) {
+        m_monitor_enabled = false;
+        return;
+    }
+    
+    // The adapter drops out of ATMA when its buffer overruns; pick up where it left off
+    if (m_monitor_enabled && m_monitor_buffer_full) {
+        m_monitor_buffer_full = false;
+        portENTER_CRITICAL(&m_lock);
+        m_stats.can_buffer_full++;
+        portEXIT_CRITICAL(&m_lock);
+        if (queue_command("ATMA", on_monitor_done, nullptr, OBD_COMMAND_STREAMING)) {
+            return;
+        }
+    }
+    
+    if (m_monitor_enabled) {
+        Serial.printf("[OBD] CAN monitor ended: %s\n", result.response);
+        m_monitor_enabled = false;
+    }
+    for (const char* cmd : ELM327_MONITOR_RESTORE_COMMANDS) {
+        queue_command(cmd, nullptr, nullptr);
+    }
+}
+
+void IcarBleDriver::consume_stream_lines() {
+    size_t start = 0;
+    for (size_t i = 0; i < m_rx_len; i++) {
+        if (m_rx_buffer[i] == '\r' || m_rx_buffer[i] == '\n') {
+            parse_can_line(m_rx_buffer + start, i - start);
+            start = i + 1;
+        }
+    }
+    
+    portENTER_CRITICAL(&m_lock);
+    if (start > 0) {
+        memmove(m_rx_buffer, m_rx_buffer + start, m_rx_len - start);
+        m_rx_len -= start;
+    } else if (m_rx_len >= sizeof(m_rx_buffer) - 1) {
+        m_rx_len = 0;  // A "line" this long is noise
+        m_stats.can_malformed++;
+    }
+    portEXIT_CRITICAL(&m_lock);
+}
+
+static inline int can_hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+void IcarBleDriver::parse_can_line(const char* line, size_t len) {
+    int64_t now_us = esp_timer_get_time();
+    
+    // Compact the line (ATS0 should already have removed the spaces)
+    char text[40];
+    size_t n = 0;
+    for (size_t i = 0; i < len && n < sizeof(text) - 1; i++) {
+        if (line[i] != ' ') {
+            text[n++] = line[i];
+        }
+    }
+    text[n] = '\0';
+    if (n == 0) {
+        return;
+    }
+    
+    if (strstr(text, "BUFFERFULL")) {
+        m_monitor_buffer_full = true;
+        return;
+    }
+    
+    size_t id_digits = m_can_filter.extended ? 8 : 3;
+    bool valid = n > id_digits;
+    uint32_t id = 0;
+    for (size_t i = 0; valid && i < id_digits; i++) {
+        int v = can_hex_value(text[i]);
+        valid = v >= 0;
+        id = (id << 4) | (uint32_t)(v & 0xF);
+    }
+    int dlc = valid ? can_hex_value(text[id_digits]) : -1;
+    if (!valid || dlc < 0 || dlc > 8) {
+        // Status text ("STOPPED", "SEARCHING...") is expected; "<RX ERROR" and garbage are not
+        if (text[0] == '<' || can_hex_value(text[0]) >= 0) {
+            portENTER_CRITICAL(&m_lock);
+            m_stats.can_malformed++;
+            portEXIT_CRITICAL(&m_lock);
+        }
+        return;
+    }
+    
+    log_record_any_t slot;
+    can_record_t& record = slot.can;
+    memset(&record, 0, sizeof(record));
+    record.msg_type = LOG_RECORD_CAN;
+    record.timestamp_offset_us = (uint64_t)(now_us - m_session_start_us);
+    record.can_id = id;
+    record.dlc = (uint8_t)dlc;
+    record.flags = m_can_filter.extended ? CAN_FLAG_EXTENDED_ID : 0;
+    
+    const char* payload = text + id_digits + 1;
+    size_t payload_len = n - id_digits - 1;
+    if (payload_len == 3 && strncmp(payload, "RTR", 3) == 0) {
+        record.flags |= CAN_FLAG_REMOTE_FRAME;
+    } else if (payload_len == (size_t)dlc * 2) {
+        for (int i = 0; i < dlc; i++) {
+            int hi = can_hex_value(payload[2 * i]);
+            int lo = can_hex_value(payload[2 * i + 1]);
+            if (hi < 0 || lo < 0) {
+                valid = false;
+                break;
+            }
+            record.data[i] = (uint8_t)((hi << 4) | lo);
+        }
+    } else {
+        valid = false;
+    }
+    
+    bool pushed = valid && m_can_ring.push(slot);
+    portENTER_CRITICAL(&m_lock);
+    if (!valid) {
+        m_stats.can_malformed++;
+    } else if (pushed) {
+        m_stats.can_frames++;
+    } else {
+        m_stats.can_dropped++;
+    }
+    portEXIT_CRITICAL(&m_lock);
+}
+
+void IcarBleDriver::on_pid_response(const obd_command_result_t& result, void* ctx) {
+    (void)ctx;
+    
+    // Requested PIDs follow the "01" in the command text
+    uint8_t pids[OBD_MAX_PIDS_PER_REQUEST];
+    size_t count = 0;
+    for (const char* p = result.command + 2; p[0] && p[1] && count < OBD_MAX_PIDS_PER_REQUEST; p += 2) {
+        char hex[3] = { p[0], p[1], '\0' };
+        pids[count++] = (uint8_t)strtoul(hex, nullptr, 16);
+    }
+    
+    size_t decoded = 0;
+    if (result.status == OBD_COMMAND_OK) {
+        static elm327_messages_t messages;  // Only touched from completion callbacks
+        decoded = obd_walk_mode01_response(result.response, pids, count, &messages,
+                                           [](uint8_t pid, const uint8_t* data, size_t len, void*) {
+                                               decode_pid(pid, data, len);
+                                           }, nullptr);
+    }
+    
+    portENTER_CRITICAL(&m_lock);
+    for (size_t i = 0; i < count; i++) {
+        m_pending_pids[pids[i] >> 5] &= ~(1UL << (pids[i] & 31));
+    }
+    if (m_mode01_outstanding > 0) {
+        m_mode01_outstanding--;
+    }
+    
+    // A batch that comes back with nothing usable (rejected, "NO DATA" or
+    // only unrelated bytes) counts against batching; timeouts and link loss
+    // say nothing about the ECU
+    bool fall_back = false;
+    if (count > 1 && result.status != OBD_COMMAND_TIMEOUT && result.status != OBD_COMMAND_DISCONNECTED) {
+        if (decoded == 0) {
+            m_stats.batch_failures++;
+            if (++m_batch_failures >= OBD_BATCH_MAX_FAILURES && m_batching_enabled) {
+                m_batching_enabled = false;
+                fall_back = true;
+            }
+        } else {
+            m_batch_failures = 0;
+        }
+    }
+    portEXIT_CRITICAL(&m_lock);
+    
+    if (fall_back) {
+        Serial.println("[OBD] ECU rejects multi-PID requests, polling one PID per request");
+    }
+}
+
+void IcarBleDriver::decode_pid(uint8_t pid, const uint8_t* d, size_t len) {
+    portENTER_CRITICAL(&m_lock);
+    if (obd_decode_pid(pid, d, len, m_data)) {
+        m_data.valid = true;
+        m_data.last_update_ms = millis();
+        m_stats.pid_updates++;
+        m_pid_update_counts[pid]++;
+        m_pid_updated = true;
+    }
+    portEXIT_CRITICAL(&m_lock);
 }
 
 const char* IcarBleDriver::get_device_address() {
@@ -206,31 +1414,75 @@ void IcarBleDriver::set_device_address(const char* address) {
     }
 }
 
-bool IcarBleDriver::add_pid(uint8_t pid, uint32_t poll_interval_ms, const char* description) {
+bool IcarBleDriver::add_pid(uint8_t pid, uint32_t poll_interval_ms, const char* description,
+                            obd_pid_priority_t priority) {
     // Check if PID already exists
     for (auto& pid_config : m_configured_pids) {
         if (pid_config.pid == pid) {
             // Update existing PID
             pid_config.poll_interval_ms = poll_interval_ms;
             pid_config.description = description;
+            pid_config.priority = priority;
+            plan_rates();
             Serial.printf("[OBD] Updated PID 0x%02X polling interval to %u ms\n", pid, poll_interval_ms);
             return true;
         }
     }
     
-    // Add new PID
+    // Add new PID, due immediately
     obd_pid_config_t new_pid = {
         .pid = pid,
         .poll_interval_ms = poll_interval_ms,
         .last_poll_ms = 0,
-        .description = description
+        .description = description,
+        .priority = priority,
+        .scheduled_interval_ms = poll_interval_ms,
+        .deadline_ms = (uint32_t)millis(),
+        .achieved_hz = 0.0f,
+        .window_updates = m_pid_update_counts[pid]
     };
     
     m_configured_pids.push_back(new_pid);
+    plan_rates();
     Serial.printf("[OBD] Added PID 0x%02X (%s) with interval %u ms\n", pid, description, poll_interval_ms);
     return true;
 }
 
+bool IcarBleDriver::add_pid(uint8_t pid, uint32_t poll_interval_ms, const char* description) {
+    return add_pid(pid, poll_interval_ms, description, default_priority(pid));
+}
+
+void IcarBleDriver::load_pid_configs(const logging_config_t& config) {
+    clear_all_pids();
+    uint16_t max_hz = config.obd_hz > 0 ? config.obd_hz : 1;
+    for (const auto& entry : config.pid_configs) {
+        const pid_config_t& pid_config = entry.second;
+        if (!pid_config.enabled || pid_config.rate_hz == 0) {
+            continue;
+        }
+        uint16_t rate_hz = std::min(pid_config.rate_hz, max_hz);
+        add_pid(pid_config.pid, 1000 / rate_hz, pid_config.name);
+    }
+}
+
+size_t IcarBleDriver::get_pid_stats(obd_pid_stats_t* out, size_t max_count) {
+    size_t n = 0;
+    portENTER_CRITICAL(&m_lock);
+    for (const auto& pid_config : m_configured_pids) {
+        if (n >= max_count) {
+            break;
+        }
+        out[n].pid = pid_config.pid;
+        out[n].priority = pid_config.priority;
+        out[n].requested_hz = 1000.0f / std::max<uint32_t>(pid_config.poll_interval_ms, OBD_MIN_POLL_INTERVAL_MS);
+        out[n].scheduled_hz = 1000.0f / std::max<uint32_t>(pid_config.scheduled_interval_ms, OBD_MIN_POLL_INTERVAL_MS);
+        out[n].achieved_hz = pid_config.achieved_hz;
+        n++;
+    }
+    portEXIT_CRITICAL(&m_lock);
+    return n;
+}
+
 void IcarBleDriver::remove_pid(uint8_t pid) {
     auto it = std::find_if(m_configured_pids.begin(), m_configured_pids.end(),
                           [pid](const obd_pid_config_t& config) { return config.pid == pid; });
@@ -238,6 +1490,7 @@ void IcarBleDriver::remove_pid(uint8_t pid) {
     if (it != m_configured_pids.end()) {
         Serial.printf("[OBD] Removed PID 0x%02X\n", pid);
         m_configured_pids.erase(it);
+        plan_rates();
     }
 }
 
@@ -247,6 +1500,7 @@ const std::vector<obd_pid_config_t>& IcarBleDriver::get_configured_pids() {
 
 void IcarBleDriver::clear_all_pids() {
     m_configured_pids.clear();
+    plan_rates();
     Serial.println("[OBD] Cleared all configured PIDs");
 }
 
@@ -274,185 +1528,77 @@ void IcarBleDriver::request_vehicle_info() {
     m_vin[0] = '\0';
     m_ecm_name[0] = '\0';
     
-    static EXT_RAM_ATTR char response[512];
-    
-    // Request VIN (Mode 09, PID 02)
-    Serial.println("[OBD] Sending VIN request (09 02)...");
-    if (send_obd_command("09 02\r", response, sizeof(response), 3000)) {
-        Serial.printf("[OBD] VIN response: %s\n", response);
-        if (parse_vin_response(response, m_vin)) {
-            Serial.printf("[OBD] VIN retrieved: %s\n", m_vin);
-        } else {
-            Serial.println("[OBD] Failed to parse VIN");
-            strncpy(m_vin, "N/A", sizeof(m_vin) - 1);
-        }
-    } else {
-        Serial.println("[OBD] No response for VIN request");
-        strncpy(m_vin, "N/A", sizeof(m_vin) - 1);
-    }
-    
-    // Small delay between requests
-    delay(500);
+    // Mode 09 PID 02 (VIN) and 0A (ECM name); multi-frame answers take longer
+    queue_command("0902", on_vehicle_info, nullptr, 3000);
+    queue_command("090A", on_vehicle_info, nullptr, 3000);
+}
+
+void IcarBleDriver::on_vehicle_info(const obd_command_result_t& result, void* ctx) {
+    (void)ctx;
+    bool vin = strcmp(result.command, "0902") == 0;
+    char* out = vin ? m_vin : m_ecm_name;
+    size_t out_size = vin ? sizeof(m_vin) : sizeof(m_ecm_name);
+    const char* what = vin ? "VIN" : "ECM name";
     
-    // Request ECM name (Mode 09, PID 0A)
-    Serial.println("[OBD] Sending ECM name request (09 0A)...");
-    if (send_obd_command("09 0A\r", response, sizeof(response), 3000)) {
-        Serial.printf("[OBD] ECM response: %s\n", response);
-        if (parse_ecm_response(response, m_ecm_name)) {
-            Serial.printf("[OBD] ECM name retrieved: %s\n", m_ecm_name);
-        } else {
-            Serial.println("[OBD] Failed to parse ECM name");
-            strncpy(m_ecm_name, "N/A", sizeof(m_ecm_name) - 1);
-        }
+    if (result.status != OBD_COMMAND_OK || result.response[0] == '\0') {
+        Serial.printf("[OBD] No response for %s request\n", what);
+    } else if (vin ? parse_vin_response(result.response, out) : parse_ecm_response(result.response, out)) {
+        Serial.printf("[OBD] %s retrieved: %s\n", what, out);
+        return;
     } else {
-        Serial.println("[OBD] No response for ECM request");
-        strncpy(m_ecm_name, "N/A", sizeof(m_ecm_name) - 1);
-    }
-}
-
-bool IcarBleDriver::send_obd_command(const char* command, char* response, size_t max_len, uint32_t timeout_ms) {
-    if (!m_tx_char || !m_rx_char || !command || !response) return false;
-    
-    // Clear response buffer
-    response[0] = '\0';
-    
-    // Send command - cast to const uint8_t* and specify response expected
-    size_t cmd_len = strlen(command);
-    m_tx_char->writeValue((const uint8_t*)command, cmd_len, true);
-    
-    // Wait for response with timeout
-    uint32_t start_time = millis();
-    size_t response_len = 0;
-    bool received_data = false;
-    
-    while ((millis() - start_time) < timeout_ms) {
-        if (m_rx_char->canRead()) {
-            std::string value = m_rx_char->readValue();
-            if (value.length() > 0) {
-                received_data = true;
-                size_t copy_len = min(value.length(), max_len - response_len - 1);
-                memcpy(response + response_len, value.c_str(), copy_len);
-                response_len += copy_len;
-                response[response_len] = '\0';
-                
-                // Check if we got a complete response (ends with '>' prompt or contains error)
-                if (strstr(response, ">") || strstr(response, "NO DATA") || 
-                    strstr(response, "ERROR") || strstr(response, "?")) {
-                    break;
-                }
-            }
-        }
-        delay(50);
+        Serial.printf("[OBD] Failed to parse %s: %s\n", what, result.response);
     }
-    
-    return received_data && response_len > 0;
+    strncpy(out, "N/A", out_size - 1);
+    out[out_size - 1] = '\0';
 }
 
-bool IcarBleDriver::parse_vin_response(const char* response, char* vin) {
-    if (!response || !vin) return false;
-    
-    // VIN response format: "49 02 01 XX XX XX..." where XX are hex ASCII codes
-    // Response is split across multiple lines for long data
-    // 49 = response to mode 09, 02 = PID 02 (VIN)
-    
-    // Look for "49 02" in response
-    const char* data_start = strstr(response, "49 02");
-    if (!data_start) {
-        // Try alternate format without space
-        data_start = strstr(response, "4902");
-        if (!data_start) return false;
+/**
+ * @brief Collect the ASCII payload of a Mode 09 answer
+ * CAN ECUs send one ISO-TP message "49 <pid> <count> <text...>"; older
+ * protocols send one "49 <pid> <seq> <4 bytes>" line per chunk. Both carry
+ * three header bytes per message, and leading NUL padding is dropped.
+ * @return Characters written (NUL-terminated)
+ */
+static size_t parse_mode09_ascii(const char* response, uint8_t pid, char* out, size_t max_len) {
+    static elm327_messages_t messages;  // Only used from vehicle-info completions
+    size_t n = 0;
+    if (elm327_parse_messages(response, &messages) == 0) {
+        out[0] = '\0';
+        return 0;
     }
-    
-    // Extract hex bytes and convert to ASCII
-    char vin_buffer[18];
-    int vin_idx = 0;
-    const char* ptr = data_start;
-    
-    // Skip past "49 02" and frame counter
-    while (*ptr && vin_idx < 17) {
-        // Look for hex pairs (e.g., "31" = '1', "41" = 'A')
-        while (*ptr && !isxdigit(*ptr)) ptr++;
-        if (!*ptr) break;
-        
-        // Skip the mode/PID bytes (49, 02, frame counter)
-        if (ptr == data_start || (ptr - data_start) < 10) {
-            while (*ptr && (isxdigit(*ptr) || *ptr == ' ')) ptr++;
+    for (size_t m = 0; m < messages.count; m++) {
+        const uint8_t* msg = messages.data + messages.offset[m];
+        size_t len = messages.length[m];
+        if (len < 4 || msg[0] != 0x49 || msg[1] != pid) {
             continue;
         }
-        
-        // Read hex pair
-        char hex_str[3] = {0};
-        if (isxdigit(*ptr)) {
-            hex_str[0] = *ptr++;
-            if (isxdigit(*ptr)) {
-                hex_str[1] = *ptr++;
-                
-                // Convert hex to char
-                int char_code = strtol(hex_str, NULL, 16);
-                if (char_code >= 32 && char_code < 127) {  // Printable ASCII
-                    vin_buffer[vin_idx++] = (char)char_code;
-                }
+        for (size_t i = 3; i < len && n + 1 < max_len; i++) {
+            if (msg[i] >= 32 && msg[i] < 127) {  // Printable ASCII
+                out[n++] = (char)msg[i];
             }
         }
     }
+    out[n] = '\0';
+    return n;
+}
+
+bool IcarBleDriver::parse_vin_response(const char* response, char* vin) {
+    if (!response || !vin) return false;
     
-    if (vin_idx >= 17) {
-        memcpy(vin, vin_buffer, 17);
-        vin[17] = '\0';
-        return true;
+    // VIN: Mode 09 PID 02, exactly 17 characters
+    char buffer[32];
+    size_t n = parse_mode09_ascii(response, 0x02, buffer, sizeof(buffer));
+    if (n < 17) {
+        return false;
     }
-    
-    return false;
+    memcpy(vin, buffer + n - 17, 17);
+    vin[17] = '\0';
+    return true;
 }
 
 bool IcarBleDriver::parse_ecm_response(const char* response, char* ecm_name) {
     if (!response || !ecm_name) return false;
     
-    // ECM name response format: "49 0A ..." where ... are hex ASCII codes
-    const char* data_start = strstr(response, "49 0A");
-    if (!data_start) {
-        data_start = strstr(response, "490A");
-        if (!data_start) return false;
-    }
-    
-    // Extract hex bytes and convert to ASCII
-    char ecm_buffer[20];
-    int ecm_idx = 0;
-    const char* ptr = data_start;
-    
-    // Skip past "49 0A" and frame counter
-    while (*ptr && ecm_idx < 19) {
-        // Look for hex pairs
-        while (*ptr && !isxdigit(*ptr)) ptr++;
-        if (!*ptr) break;
-        
-        // Skip the mode/PID bytes
-        if (ptr == data_start || (ptr - data_start) < 10) {
-            while (*ptr && (isxdigit(*ptr) || *ptr == ' ')) ptr++;
-            continue;
-        }
-        
-        // Read hex pair
-        char hex_str[3] = {0};
-        if (isxdigit(*ptr)) {
-            hex_str[0] = *ptr++;
-            if (isxdigit(*ptr)) {
-                hex_str[1] = *ptr++;
-                
-                // Convert hex to char
-                int char_code = strtol(hex_str, NULL, 16);
-                if (char_code >= 32 && char_code < 127) {  // Printable ASCII
-                    ecm_buffer[ecm_idx++] = (char)char_code;
-                }
-            }
-        }
-    }
-    
-    if (ecm_idx > 0) {
-        memcpy(ecm_name, ecm_buffer, ecm_idx);
-        ecm_name[ecm_idx] = '\0';
-        return true;
-    }
-    
-    return false;
+    // ECU name: Mode 09 PID 0A, truncated to the 19 characters m_ecm_name holds
+    return parse_mode09_ascii(response, 0x0A, ecm_name, 20) > 0;
 }
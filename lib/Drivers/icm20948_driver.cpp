@@ -1,5 +1,7 @@
 #include "icm20948_driver.h"
 #include <Arduino.h>
+#include <esp_timer.h>
+#include <cmath>
 
 // ICM20948 Register Map
 // ICM20948 uses register banks - must select bank before accessing registers
@@ -7,12 +9,23 @@
 
 // Bank 0 registers
 #define ICM20948_REG_WHO_AM_I        0x00  // Bank 0
+#define ICM20948_REG_USER_CTRL       0x03  // Bank 0 (bit6 FIFO_EN, bit5 I2C_MST_EN)
 #define ICM20948_REG_PWR_MGMT_1      0x06  // Bank 0
+#define ICM20948_REG_I2C_MST_STATUS  0x17  // Bank 0 (bit6 I2C_SLV4_DONE)
+#define ICM20948_REG_INT_STATUS_2    0x1B  // Bank 0 (FIFO overflow flags)
+#define ICM20948_REG_FIFO_EN_2       0x67  // Bank 0 (accel/gyro/temp FIFO enables)
+#define ICM20948_REG_FIFO_RST        0x68  // Bank 0
+#define ICM20948_REG_FIFO_MODE       0x69  // Bank 0 (0 = stream)
+#define ICM20948_REG_FIFO_COUNTH     0x70  // Bank 0 (FIFO_COUNTL follows)
+#define ICM20948_REG_FIFO_R_W        0x72  // Bank 0
 #define ICM20948_REG_TEMP_OUT_H      0x39  // Bank 0 (temperature)
 #define ICM20948_REG_TEMP_OUT_L      0x3A  // Bank 0 (temperature)
 #define ICM20948_REG_ACCEL_XOUT_H    0x2D  // Bank 0
 #define ICM20948_REG_GYRO_XOUT_H     0x33  // Bank 0
-#define ICM20948_REG_MAG_XOUT_L      0x49  // Bank 0 (mag data)
+#define ICM20948_REG_EXT_SLV_SENS_DATA_00 0x3B  // Bank 0 (I2C master slave data)
+
+// Accel (6) + gyro (6) + temp (2) output registers, 0x2D-0x3A
+#define ICM20948_MOTION_BURST_LEN    14
 
 // Bank 2 registers (sensor configuration)
 #define ICM20948_REG_GYRO_SMPLRT_DIV 0x00  // Bank 2
@@ -21,12 +34,65 @@
 #define ICM20948_REG_ACCEL_SMPLRT_DIV_2 0x11  // Bank 2  
 #define ICM20948_REG_ACCEL_CONFIG    0x14  // Bank 2
 
+// Bank 3 registers (I2C master)
+#define ICM20948_REG_I2C_MST_CTRL    0x01  // Bank 3
+#define ICM20948_REG_I2C_SLV0_ADDR   0x03  // Bank 3
+#define ICM20948_REG_I2C_SLV0_REG    0x04  // Bank 3
+#define ICM20948_REG_I2C_SLV0_CTRL   0x05  // Bank 3
+#define ICM20948_REG_I2C_SLV4_ADDR   0x13  // Bank 3
+#define ICM20948_REG_I2C_SLV4_REG    0x14  // Bank 3
+#define ICM20948_REG_I2C_SLV4_CTRL   0x15  // Bank 3
+#define ICM20948_REG_I2C_SLV4_DO     0x16  // Bank 3
+#define ICM20948_REG_I2C_SLV4_DI     0x17  // Bank 3
+
+// AK09916 magnetometer (on the ICM20948 auxiliary I2C bus)
+#define AK09916_I2C_ADDR             0x0C
+#define AK09916_REG_WIA2             0x01  // Device ID
+#define AK09916_REG_ST1              0x10  // bit0 DRDY
+#define AK09916_REG_CNTL2            0x31  // Operating mode
+#define AK09916_REG_CNTL3            0x32  // bit0 SRST
+#define AK09916_WIA2_VALUE           0x09
+#define AK09916_MODE_CONT_100HZ      0x08
+#define AK09916_ST2_HOFL             0x08  // Magnetic sensor overflow
+#define AK09916_UT_PER_LSB           0.15f
+// ST1, HXL..HZH, TMPS, ST2 - reading ST2 releases the data latch
+#define AK09916_READ_LEN             9
+
 // ICM20948 Expected WHO_AM_I value
 #define ICM20948_WHO_AM_I_VALUE      0xEA
 
+// Register bank select values (bank number in bits [5:4])
+#define ICM20948_BANK_0              0x00
+#define ICM20948_BANK_2              0x20
+#define ICM20948_BANK_3              0x30
+
+// FIFO configuration
+#define ICM20948_USER_CTRL_FIFO_EN   0x40
+#define ICM20948_USER_CTRL_I2C_MST_EN  0x20
+#define ICM20948_USER_CTRL_I2C_MST_RST 0x02
+#define ICM20948_I2C_MST_CLK_345KHZ  0x07  // Recommended I2C_MST_CLK for 400 kHz-class slaves
+#define ICM20948_I2C_SLV_EN          0x80
+#define ICM20948_I2C_SLV_READ        0x80
+#define ICM20948_I2C_SLV4_DONE       0x40
+#define ICM20948_SLV4_TIMEOUT_MS     20
+#define ICM20948_FIFO_EN_2_ACCEL_GYRO 0x1E  // ACCEL_FIFO_EN | GYRO_{Z,Y,X}_FIFO_EN
+#define ICM20948_FIFO_SIZE           512
+#define ICM20948_FIFO_FRAME_SIZE     12    // accel XYZ + gyro XYZ, 16-bit big-endian
+#define ICM20948_FIFO_BURST_FRAMES   10    // 120 bytes per read (fits the 128-byte Wire buffer)
+#define ICM20948_BASE_ODR_HZ         1125  // Internal sample rate with DLPF enabled
+
+// Sensor config with DLPF enabled (FCHOICE=1) so SMPLRT_DIV applies
+// ACCEL_CONFIG: DLPFCFG=1 (246 Hz), ±4g, FCHOICE=1
+// GYRO_CONFIG_1: DLPFCFG=1 (197 Hz), ±250dps, FCHOICE=1
+#define ICM20948_ACCEL_CONFIG_FIFO   0x0B
+#define ICM20948_GYRO_CONFIG_FIFO    0x09
+
 ICM20948Driver::ICM20948Driver(TwoWire& wire, uint8_t i2c_addr)
     : m_wire(wire), m_addr(i2c_addr),
-      m_accel_valid(false), m_gyro_valid(false), m_compass_valid(false) {
+      m_accel_valid(false), m_gyro_valid(false), m_compass_valid(false),
+      m_fifo_enabled(false), m_fifo_rate_hz(0), m_fifo_period_us(0), m_fifo_overflows(0),
+      m_batch_count(0), m_mag_present(false) {
+    memset(&m_bus_stats, 0, sizeof(m_bus_stats));
     memset(&m_accel_data, 0, sizeof(m_accel_data));
     memset(&m_gyro_data, 0, sizeof(m_gyro_data));
     memset(&m_compass_data, 0, sizeof(m_compass_data));
@@ -57,27 +123,29 @@ bool ICM20948Driver::init() {
 bool ICM20948Driver::update() {
     // Always return true - I2C bus communication is OK
     // Individual sensor validity is tracked separately
+    uint32_t tx_before = m_bus_stats.transactions;
+    uint32_t bytes_before = m_bus_stats.bytes;
     
-    if (!read_accel_raw()) {
-        m_accel_valid = false;
-    } else {
-        m_accel_valid = true;
-    }
-    
-    // Also read temperature with accelerometer
-    read_temperature();
-    
-    if (!read_gyro_raw()) {
-        m_gyro_valid = false;
+    if (m_fifo_enabled) {
+        bool ok = drain_fifo();
+        if (m_batch_count > 0) {
+            m_accel_valid = ok;
+            m_gyro_valid = ok;
+        }
+        m_compass_valid = read_compass_raw();
     } else {
-        m_gyro_valid = true;
+        // Accel, gyro, temperature (and compass) share one burst
+        bool ok = read_motion_burst();
+        m_accel_valid = ok;
+        m_gyro_valid = ok;
+        if (!ok) {
+            m_compass_valid = false;
+        }
     }
     
-    if (!read_compass_raw()) {
-        m_compass_valid = false;
-    } else {
-        m_compass_valid = true;
-    }
+    m_bus_stats.updates++;
+    m_bus_stats.last_update_transactions = (uint16_t)(m_bus_stats.transactions - tx_before);
+    m_bus_stats.last_update_bytes = (uint16_t)(m_bus_stats.bytes - bytes_before);
     
     return true;  // Update attempt succeeded, even if individual reads failed
 }
@@ -90,6 +158,34 @@ bool ICM20948Driver::is_valid() const {
     return m_accel_valid;
 }
 
+uint16_t ICM20948Driver::get_batch_rate_hz() const {
+    return m_fifo_enabled ? m_fifo_rate_hz : 0;
+}
+
+size_t ICM20948Driver::read_batch(accel_sample_t* out, size_t max_samples) {
+    size_t n = m_batch_count < max_samples ? m_batch_count : max_samples;
+    memcpy(out, m_accel_batch, n * sizeof(accel_sample_t));
+    return n;
+}
+
+size_t ICM20948Driver::read_gyro_batch(gyro_sample_t* out, size_t max_samples) const {
+    size_t n = m_batch_count < max_samples ? m_batch_count : max_samples;
+    memcpy(out, m_gyro_batch, n * sizeof(gyro_sample_t));
+    return n;
+}
+
+bool ICM20948Driver::is_fifo_enabled() const {
+    return m_fifo_enabled;
+}
+
+uint32_t ICM20948Driver::get_fifo_overflows() const {
+    return m_fifo_overflows;
+}
+
+icm20948_bus_stats_t ICM20948Driver::get_bus_stats() const {
+    return m_bus_stats;
+}
+
 gyro_data_t ICM20948Driver::get_gyro() const {
     return m_gyro_data;
 }
@@ -110,27 +206,26 @@ bool ICM20948Driver::write_register(uint8_t reg, uint8_t value) {
     m_wire.beginTransmission(m_addr);
     m_wire.write(reg);
     m_wire.write(value);
+    m_bus_stats.transactions++;
+    m_bus_stats.bytes += 2;
     return m_wire.endTransmission() == 0;
 }
 
 uint8_t ICM20948Driver::read_register(uint8_t reg) {
-    m_wire.beginTransmission(m_addr);
-    m_wire.write(reg);
-    m_wire.endTransmission();
-    
-    m_wire.requestFrom(m_addr, (uint8_t)1);
-    if (m_wire.available()) {
-        return m_wire.read();
-    }
-    return 0;
+    uint8_t value = 0;
+    read_registers(reg, &value, 1);
+    return value;
 }
 
 bool ICM20948Driver::read_registers(uint8_t reg, uint8_t* data, uint8_t len) {
+    // Register address write, then repeated START for the read
     m_wire.beginTransmission(m_addr);
     m_wire.write(reg);
-    m_wire.endTransmission();
+    m_wire.endTransmission(false);
     
     m_wire.requestFrom(m_addr, len);
+    m_bus_stats.transactions += 2;
+    m_bus_stats.bytes += 1 + len;
     
     for (uint8_t i = 0; i < len; i++) {
         if (m_wire.available()) {
@@ -180,77 +275,270 @@ bool ICM20948Driver::configure_gyro() {
 }
 
 bool ICM20948Driver::configure_compass() {
-    // TODO: Implement AK09916 magnetometer configuration
-    // The ICM20948's internal magnetometer (AK09916) requires:
-    // 1. Enable I2C master mode in Bank 0
-    // 2. Configure I2C master to communicate with AK09916 (I2C addr 0x0C)
-    // 3. Set AK09916 to continuous measurement mode
-    // 4. Read data through EXT_SLV_SENS_DATA registers
-    // For now, compass is disabled
-    Serial.println("WARNING: Compass not yet implemented - requires AK09916 init");
+    // The AK09916 sits on the ICM20948's auxiliary bus (bypass disabled), so it
+    // is reached through the internal I2C master rather than the host bus
+    m_mag_present = false;
+    
+    uint8_t user_ctrl = read_register(ICM20948_REG_USER_CTRL);
+    write_register(ICM20948_REG_USER_CTRL, user_ctrl | ICM20948_USER_CTRL_I2C_MST_RST);
+    delay(10);
+    user_ctrl = read_register(ICM20948_REG_USER_CTRL);
+    write_register(ICM20948_REG_USER_CTRL, user_ctrl | ICM20948_USER_CTRL_I2C_MST_EN);
+    
+    write_register(ICM20948_REG_BANK_SEL, ICM20948_BANK_3);
+    write_register(ICM20948_REG_I2C_MST_CTRL, ICM20948_I2C_MST_CLK_345KHZ);
+    write_register(ICM20948_REG_BANK_SEL, ICM20948_BANK_0);
+    delay(10);
+    
+    uint8_t wia2 = 0;
+    if (!mag_read(AK09916_REG_WIA2, &wia2) || wia2 != AK09916_WIA2_VALUE) {
+        Serial.printf("WARNING: AK09916 not found (WIA2=0x%02X) - compass disabled\n", wia2);
+        return true;  // Compass is optional, keep accel/gyro running
+    }
+    
+    // Soft reset, then continuous measurement at 100 Hz
+    mag_write(AK09916_REG_CNTL3, 0x01);
+    delay(10);
+    if (!mag_write(AK09916_REG_CNTL2, AK09916_MODE_CONT_100HZ)) {
+        Serial.println("WARNING: AK09916 mode set failed - compass disabled");
+        return true;
+    }
+    
+    // Slave 0: copy ST1..ST2 into EXT_SLV_SENS_DATA_00..08 every sample cycle
+    write_register(ICM20948_REG_BANK_SEL, ICM20948_BANK_3);
+    write_register(ICM20948_REG_I2C_SLV0_ADDR, ICM20948_I2C_SLV_READ | AK09916_I2C_ADDR);
+    write_register(ICM20948_REG_I2C_SLV0_REG, AK09916_REG_ST1);
+    bool success = write_register(ICM20948_REG_I2C_SLV0_CTRL, ICM20948_I2C_SLV_EN | AK09916_READ_LEN);
+    write_register(ICM20948_REG_BANK_SEL, ICM20948_BANK_0);
+    
+    m_mag_present = success;
+    Serial.println(success ? "Compass config OK (AK09916 @ 100Hz via I2C master)" : "Compass config FAILED");
     return true;
 }
 
-bool ICM20948Driver::read_temperature() {
-    // Temperature register is 16-bit signed value at 0x39 (high) and 0x3A (low)
-    uint8_t high = read_register(ICM20948_REG_TEMP_OUT_H);
-    uint8_t low = read_register(ICM20948_REG_TEMP_OUT_L);
+bool ICM20948Driver::wait_slv4_done() {
+    uint32_t start = millis();
+    while (millis() - start < ICM20948_SLV4_TIMEOUT_MS) {
+        if (read_register(ICM20948_REG_I2C_MST_STATUS) & ICM20948_I2C_SLV4_DONE) {
+            return true;
+        }
+        delay(1);
+    }
+    return false;
+}
+
+bool ICM20948Driver::mag_write(uint8_t reg, uint8_t value) {
+    write_register(ICM20948_REG_BANK_SEL, ICM20948_BANK_3);
+    write_register(ICM20948_REG_I2C_SLV4_ADDR, AK09916_I2C_ADDR);
+    write_register(ICM20948_REG_I2C_SLV4_REG, reg);
+    write_register(ICM20948_REG_I2C_SLV4_DO, value);
+    write_register(ICM20948_REG_I2C_SLV4_CTRL, ICM20948_I2C_SLV_EN);
+    write_register(ICM20948_REG_BANK_SEL, ICM20948_BANK_0);
+    return wait_slv4_done();
+}
+
+bool ICM20948Driver::mag_read(uint8_t reg, uint8_t* value) {
+    write_register(ICM20948_REG_BANK_SEL, ICM20948_BANK_3);
+    write_register(ICM20948_REG_I2C_SLV4_ADDR, ICM20948_I2C_SLV_READ | AK09916_I2C_ADDR);
+    write_register(ICM20948_REG_I2C_SLV4_REG, reg);
+    write_register(ICM20948_REG_I2C_SLV4_CTRL, ICM20948_I2C_SLV_EN);
+    write_register(ICM20948_REG_BANK_SEL, ICM20948_BANK_0);
+    if (!wait_slv4_done()) {
+        return false;
+    }
+    write_register(ICM20948_REG_BANK_SEL, ICM20948_BANK_3);
+    *value = read_register(ICM20948_REG_I2C_SLV4_DI);
+    write_register(ICM20948_REG_BANK_SEL, ICM20948_BANK_0);
+    return true;
+}
+
+bool ICM20948Driver::enable_fifo(uint16_t odr_hz) {
+    if (odr_hz == 0) {
+        return false;
+    }
     
-    // Conversion: Temp [°C] = (RAW / 333.87) + 21
-    int16_t raw_temp = (high << 8) | low;
-    m_accel_data.temperature = (raw_temp / 333.87f) + 21.0f;
+    // ODR = 1125 / (1 + div), pick the closest divider
+    uint32_t div = (ICM20948_BASE_ODR_HZ + odr_hz / 2) / odr_hz;
+    div = div > 0 ? div - 1 : 0;
+    if (div > 255) {
+        div = 255;  // GYRO_SMPLRT_DIV is 8-bit
+    }
+    
+    write_register(ICM20948_REG_BANK_SEL, ICM20948_BANK_2);
+    bool success = write_register(ICM20948_REG_GYRO_SMPLRT_DIV, (uint8_t)div);
+    success &= write_register(ICM20948_REG_GYRO_CONFIG_1, ICM20948_GYRO_CONFIG_FIFO);
+    success &= write_register(ICM20948_REG_ACCEL_SMPLRT_DIV_1, (uint8_t)(div >> 8));
+    success &= write_register(ICM20948_REG_ACCEL_SMPLRT_DIV_2, (uint8_t)(div & 0xFF));
+    success &= write_register(ICM20948_REG_ACCEL_CONFIG, ICM20948_ACCEL_CONFIG_FIFO);
+    write_register(ICM20948_REG_BANK_SEL, ICM20948_BANK_0);
+    
+    // Stream mode, accel + gyro only (12-byte frames)
+    success &= write_register(ICM20948_REG_FIFO_MODE, 0x00);
+    success &= write_register(ICM20948_REG_FIFO_EN_2, ICM20948_FIFO_EN_2_ACCEL_GYRO);
+    uint8_t user_ctrl = read_register(ICM20948_REG_USER_CTRL);
+    success &= write_register(ICM20948_REG_USER_CTRL, user_ctrl | ICM20948_USER_CTRL_FIFO_EN);
+    
+    if (!success) {
+        Serial.println("[IMU] ERROR: FIFO configuration failed");
+        disable_fifo();
+        return false;
+    }
+    
+    reset_fifo();
+    
+    m_fifo_period_us = (uint32_t)((div + 1) * 1000000UL / ICM20948_BASE_ODR_HZ);
+    m_fifo_rate_hz = (uint16_t)(ICM20948_BASE_ODR_HZ / (div + 1));
+    m_batch_count = 0;
+    m_fifo_enabled = true;
     
+    Serial.printf("[IMU] FIFO enabled at %u Hz (requested %u Hz, div %u)\n",
+                  m_fifo_rate_hz, odr_hz, (unsigned)div);
     return true;
 }
 
-bool ICM20948Driver::read_accel_raw() {
-    uint8_t data[6];
-    if (!read_registers(ICM20948_REG_ACCEL_XOUT_H, data, 6)) {
+void ICM20948Driver::disable_fifo() {
+    write_register(ICM20948_REG_FIFO_EN_2, 0x00);
+    uint8_t user_ctrl = read_register(ICM20948_REG_USER_CTRL);
+    write_register(ICM20948_REG_USER_CTRL, user_ctrl & ~ICM20948_USER_CTRL_FIFO_EN);
+    m_fifo_enabled = false;
+    m_fifo_rate_hz = 0;
+    m_batch_count = 0;
+}
+
+void ICM20948Driver::reset_fifo() {
+    write_register(ICM20948_REG_FIFO_RST, 0x1F);
+    write_register(ICM20948_REG_FIFO_RST, 0x00);
+}
+
+bool ICM20948Driver::drain_fifo() {
+    m_batch_count = 0;
+    
+    // Newest FIFO frame corresponds to (approximately) now
+    int64_t now_us = esp_timer_get_time();
+    
+    // Overflow: the oldest samples were overwritten, frame alignment is lost
+    if (read_register(ICM20948_REG_INT_STATUS_2) & 0x1F) {
+        m_fifo_overflows++;
+        reset_fifo();
         return false;
     }
     
-    int16_t raw_x = (data[0] << 8) | data[1];
-    int16_t raw_y = (data[2] << 8) | data[3];
-    int16_t raw_z = (data[4] << 8) | data[5];
+    uint8_t count_bytes[2];
+    if (!read_registers(ICM20948_REG_FIFO_COUNTH, count_bytes, 2)) {
+        return false;
+    }
+    uint16_t fifo_count = ((count_bytes[0] & 0x1F) << 8) | count_bytes[1];
+    size_t frames = fifo_count / ICM20948_FIFO_FRAME_SIZE;
+    if (frames > IMU_BATCH_MAX_SAMPLES) {
+        frames = IMU_BATCH_MAX_SAMPLES;
+    }
+    if (frames == 0) {
+        return true;
+    }
+    
+    // Temperature is not in the FIFO; read it once per batch
+    read_temperature();
+    
+    uint8_t burst[ICM20948_FIFO_BURST_FRAMES * ICM20948_FIFO_FRAME_SIZE];
+    size_t done = 0;
+    while (done < frames) {
+        size_t chunk = frames - done;
+        if (chunk > ICM20948_FIFO_BURST_FRAMES) {
+            chunk = ICM20948_FIFO_BURST_FRAMES;
+        }
+        if (!read_registers(ICM20948_REG_FIFO_R_W, burst, (uint8_t)(chunk * ICM20948_FIFO_FRAME_SIZE))) {
+            // Partial frame read: realign by resetting
+            reset_fifo();
+            m_batch_count = done;
+            return false;
+        }
+        
+        for (size_t i = 0; i < chunk; i++) {
+            const uint8_t* f = &burst[i * ICM20948_FIFO_FRAME_SIZE];
+            convert_accel_data((int16_t)((f[0] << 8) | f[1]),
+                               (int16_t)((f[2] << 8) | f[3]),
+                               (int16_t)((f[4] << 8) | f[5]));
+            convert_gyro_data((int16_t)((f[6] << 8) | f[7]),
+                              (int16_t)((f[8] << 8) | f[9]),
+                              (int16_t)((f[10] << 8) | f[11]));
+            
+            size_t index = done + i;
+            int64_t timestamp = now_us - (int64_t)(frames - 1 - index) * m_fifo_period_us;
+            m_accel_batch[index].timestamp_us = timestamp;
+            m_accel_batch[index].data = m_accel_data;
+            m_gyro_batch[index].timestamp_us = timestamp;
+            m_gyro_batch[index].data = m_gyro_data;
+        }
+        done += chunk;
+    }
     
-    convert_accel_data(raw_x, raw_y, raw_z);
+    m_batch_count = frames;
+    return true;
+}
+
+bool ICM20948Driver::read_temperature() {
+    // Temperature register is 16-bit signed value at 0x39 (high) and 0x3A (low)
+    uint8_t data[2];
+    if (!read_registers(ICM20948_REG_TEMP_OUT_H, data, 2)) {
+        return false;
+    }
+    convert_temperature((int16_t)((data[0] << 8) | data[1]));
     return true;
 }
 
-bool ICM20948Driver::read_gyro_raw() {
-    uint8_t data[6];
-    if (!read_registers(ICM20948_REG_GYRO_XOUT_H, data, 6)) {
+bool ICM20948Driver::read_motion_burst() {
+    // ACCEL_XOUT_H..TEMP_OUT_L (+ EXT_SLV_SENS_DATA_00..08) in one transfer
+    uint8_t data[ICM20948_MOTION_BURST_LEN + AK09916_READ_LEN];
+    uint8_t len = ICM20948_MOTION_BURST_LEN + (m_mag_present ? AK09916_READ_LEN : 0);
+    if (!read_registers(ICM20948_REG_ACCEL_XOUT_H, data, len)) {
         return false;
     }
     
-    int16_t raw_x = (data[0] << 8) | data[1];
-    int16_t raw_y = (data[2] << 8) | data[3];
-    int16_t raw_z = (data[4] << 8) | data[5];
+    int16_t raw[ICM20948_MOTION_BURST_LEN / 2];
+    for (int i = 0; i < ICM20948_MOTION_BURST_LEN / 2; i++) {
+        raw[i] = (int16_t)((data[2 * i] << 8) | data[2 * i + 1]);
+    }
+    
+    convert_accel_data(raw[0], raw[1], raw[2]);
+    convert_gyro_data(raw[3], raw[4], raw[5]);
+    convert_temperature(raw[6]);
     
-    convert_gyro_data(raw_x, raw_y, raw_z);
+    if (m_mag_present) {
+        m_compass_valid = parse_compass(&data[ICM20948_MOTION_BURST_LEN]);
+    }
     return true;
 }
 
 bool ICM20948Driver::read_compass_raw() {
-    // Magnetometer not yet implemented - requires AK09916 configuration
-    // Just return zeros for now
-    int16_t raw_x = 0;
-    int16_t raw_y = 0;
-    int16_t raw_z = 0;
+    // FIFO mode: the slave data is not in the FIFO, read the 9 mirrored bytes
+    if (!m_mag_present) {
+        return false;
+    }
+    uint8_t data[AK09916_READ_LEN];
+    if (!read_registers(ICM20948_REG_EXT_SLV_SENS_DATA_00, data, AK09916_READ_LEN)) {
+        return false;
+    }
+    return parse_compass(data);
+}
+
+bool ICM20948Driver::parse_compass(const uint8_t* ext_data) {
+    // ext_data: ST1, HXL, HXH, HYL, HYH, HZL, HZH, TMPS, ST2
+    if (!(ext_data[0] & 0x01)) {
+        return m_compass_valid;  // No new measurement since last copy, keep previous
+    }
+    if (ext_data[8] & AK09916_ST2_HOFL) {
+        return false;
+    }
+    
+    int16_t raw_x = (int16_t)((ext_data[2] << 8) | ext_data[1]);
+    int16_t raw_y = (int16_t)((ext_data[4] << 8) | ext_data[3]);
+    int16_t raw_z = (int16_t)((ext_data[6] << 8) | ext_data[5]);
     
     convert_compass_data(raw_x, raw_y, raw_z);
-    return true;  // Don't fail the update cycle
+    return true;
 }
 
 void ICM20948Driver::convert_accel_data(int16_t raw_x, int16_t raw_y, int16_t raw_z) {
-    // Debug: Print raw values occasionally
-    static uint32_t last_debug = 0;
-    uint32_t now = millis();
-    if (now - last_debug > 5000) {
-        Serial.printf("Accel RAW: X=%d Y=%d Z=%d\n", raw_x, raw_y, raw_z);
-        last_debug = now;
-    }
-    
     // Convert raw values to g
     // ±4g full scale = ±32768 counts → 4g/32768 = 0.0001220703125 g/count
     // Good resolution for racing: 1-2g normal lateral, 3+g extreme
@@ -261,14 +549,6 @@ void ICM20948Driver::convert_accel_data(int16_t raw_x, int16_t raw_y, int16_t ra
 }
 
 void ICM20948Driver::convert_gyro_data(int16_t raw_x, int16_t raw_y, int16_t raw_z) {
-    // Debug: Print raw values occasionally
-    static uint32_t last_debug = 0;
-    uint32_t now = millis();
-    if (now - last_debug > 5000) {
-        Serial.printf("Gyro RAW: X=%d Y=%d Z=%d\n", raw_x, raw_y, raw_z);
-        last_debug = now;
-    }
-    
     // Convert raw values to dps (degrees per second)
     // Based on raw data drift values, likely configured for ±250dps, not ±2000dps
     // Scale: ±250dps full scale = ±32768 counts → 250dps/32768
@@ -278,18 +558,32 @@ void ICM20948Driver::convert_gyro_data(int16_t raw_x, int16_t raw_y, int16_t raw
     m_gyro_data.z = raw_z * scale;
 }
 
+void ICM20948Driver::convert_temperature(int16_t raw_temp) {
+    // Conversion: Temp [°C] = (RAW / 333.87) + 21
+    m_accel_data.temperature = (raw_temp / 333.87f) + 21.0f;
+}
+
 void ICM20948Driver::convert_compass_data(int16_t raw_x, int16_t raw_y, int16_t raw_z) {
-    // Debug: Print raw values occasionally
-    static uint32_t last_debug = 0;
-    uint32_t now = millis();
-    if (now - last_debug > 5000) {
-        Serial.printf("Compass RAW: X=%d Y=%d Z=%d\n", raw_x, raw_y, raw_z);
-        last_debug = now;
-    }
+    // AK09916: 0.15 uT/LSB. Its Y and Z axes are inverted relative to the
+    // accel/gyro frame, so flip them to keep one body frame
+    m_compass_data.x = raw_x * AK09916_UT_PER_LSB;
+    m_compass_data.y = -raw_y * AK09916_UT_PER_LSB;
+    m_compass_data.z = -raw_z * AK09916_UT_PER_LSB;
+    
+    // Tilt-compensated heading using the latest accelerometer sample
+    // (no hard/soft-iron calibration or declination applied)
+    float roll = atan2f(m_accel_data.y, m_accel_data.z);
+    float pitch = atan2f(-m_accel_data.x,
+                         sqrtf(m_accel_data.y * m_accel_data.y + m_accel_data.z * m_accel_data.z));
+    float mx = m_compass_data.x;
+    float my = m_compass_data.y;
+    float mz = m_compass_data.z;
+    float xh = mx * cosf(pitch) + my * sinf(roll) * sinf(pitch) + mz * cosf(roll) * sinf(pitch);
+    float yh = my * cosf(roll) - mz * sinf(roll);
     
-    // Convert raw magnetometer values (simplified - typically in uT)
-    const float scale = 1.0f / 256.0f;
-    m_compass_data.x = raw_x * scale;
-    m_compass_data.y = raw_y * scale;
-    m_compass_data.z = raw_z * scale;
+    float heading = atan2f(-yh, xh) * 180.0f / (float)M_PI;
+    if (heading < 0.0f) {
+        heading += 360.0f;
+    }
+    m_compass_data.heading = heading;
 }
@@ -31,3 +31,17 @@ bool ICM20948GyroWrapper::is_valid() const {
     }
     return false;
 }
+
+uint16_t ICM20948GyroWrapper::get_batch_rate_hz() const {
+    if (m_imu_driver) {
+        return m_imu_driver->get_batch_rate_hz();
+    }
+    return 0;
+}
+
+size_t ICM20948GyroWrapper::read_batch(gyro_sample_t* out, size_t max_samples) {
+    if (m_imu_driver) {
+        return m_imu_driver->read_gyro_batch(out, max_samples);
+    }
+    return 0;
+}
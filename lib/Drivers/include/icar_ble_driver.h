@@ -2,9 +2,123 @@
 #define ICAR_BLE_DRIVER_H
 
 #include <NimBLEDevice.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include "obd_data.h"
+#include "elm327_response.h"
+#include "obd_pid_decode.h"
+#include "log_record_ring.h"
 #include <vector>
 
+// Commands that can be queued ahead of the one in flight
+#define OBD_COMMAND_QUEUE_SIZE      16
+
+// Longest ELM327 command line ("01" + six PIDs + CR fits comfortably)
+#define OBD_COMMAND_MAX_LEN         24
+
+// Reassembly buffer for one response (multi-frame Mode 09 answers included)
+#define OBD_RESPONSE_MAX_LEN        512
+
+// Default per-command timeout
+#define OBD_COMMAND_TIMEOUT_MS      1000
+
+// Timeout value marking a streaming command (ATMA): no timeout, and every
+// received line is handed over as it arrives instead of at the prompt
+#define OBD_COMMAND_STREAMING       0
+
+// Wait before restarting a CAN monitor that ended on its own (error or STOPPED)
+#define OBD_CAN_MONITOR_RETRY_MS    5000
+
+// Consecutive unusable multi-PID answers before falling back to one PID per request
+#define OBD_BATCH_MAX_FAILURES      2
+
+// Mode 01 requests allowed in the queue at once. Keeping this short lets the
+// scheduler pick PIDs at the last moment instead of committing to a long backlog.
+#define OBD_MODE01_MAX_OUTSTANDING  2
+
+// Adapter capacity (PIDs/sec) assumed until one has been learned
+#define OBD_DEFAULT_CAPACITY        20.0f
+
+// The rate plan slightly oversubscribes the learned capacity so the adapter
+// stays saturated and the estimate keeps tracking it (EDF absorbs the excess)
+#define OBD_CAPACITY_PROBE          1.1f
+
+// Lowest rate a PID is squeezed to when higher priorities use the capacity
+#define OBD_MIN_DEGRADED_HZ         0.2f
+
+// Learned capacity is written back to NVS when it moves this much, at most this often
+#define OBD_CAPACITY_SAVE_DELTA     0.1f
+#define OBD_CAPACITY_SAVE_MIN_MS    60000
+
+// Link parameters asked for on connect. A 247-byte ATT MTU carries a whole
+// multi-PID answer in one notification; 7.5-15 ms intervals keep a round trip
+// to a few connection events (units: 1.25 ms intervals, 10 ms timeout)
+#define OBD_BLE_PREFERRED_MTU       247
+#define OBD_BLE_INTERVAL_MIN        6
+#define OBD_BLE_INTERVAL_MAX        12
+#define OBD_BLE_SUPERVISION_TIMEOUT 400
+
+// Conservative parameters used when an adapter refuses the preferred ones
+// (BLE default MTU, NimBLE default 30-50 ms interval)
+#define OBD_BLE_DEFAULT_MTU         23
+#define OBD_BLE_FALLBACK_INTERVAL_MIN 24
+#define OBD_BLE_FALLBACK_INTERVAL_MAX 40
+
+// Time allowed for the adapter to apply a connection parameter update
+#define OBD_BLE_PARAM_SETTLE_MS     2000
+
+// Connection manager task (core 0, below the storage tasks)
+#define OBD_LINK_TASK_STACK         4096
+#define OBD_LINK_TASK_PRIORITY      1
+#define OBD_LINK_TASK_CORE          0
+#define OBD_LINK_STREAM_PERIOD_MS   5       // Loop period while polling PIDs
+#define OBD_LINK_IDLE_PERIOD_MS     50      // Loop period in every other state
+
+// Reconnection timing
+#define OBD_SCAN_DURATION_S         10
+#define OBD_CONNECT_TIMEOUT_S       5
+#define OBD_INIT_TIMEOUT_MS         15000   // Adapter setup + vehicle info must finish within this
+#define OBD_BACKOFF_MIN_MS          1000
+#define OBD_BACKOFF_MAX_MS          30000
+#define OBD_RESCAN_AFTER_FAILURES   3       // Failed connects to the last address before scanning again
+
+struct logging_config_t;
+
+/**
+ * @brief Connection manager state
+ */
+enum obd_link_state_t {
+    OBD_LINK_IDLE = 0,            // Manager not started
+    OBD_LINK_SCAN,                // Background scan for an adapter
+    OBD_LINK_CONNECT,             // GAP connection to the target address
+    OBD_LINK_DISCOVER,            // Service/characteristic discovery and subscribe
+    OBD_LINK_INIT,                // ELM327 setup and vehicle info commands running
+    OBD_LINK_STREAM,              // Polling PIDs
+    OBD_LINK_BACKOFF              // Waiting before the next attempt
+};
+
+/**
+ * @brief BLE link parameters, remembered per adapter address in NVS
+ */
+struct obd_link_params_t {
+    uint16_t mtu;                 // ATT MTU to request
+    uint16_t interval_min;        // Connection interval range to request (1.25 ms units)
+    uint16_t interval_max;
+};
+
+/**
+ * @brief PID scheduling priority
+ * Capacity is granted in priority order when the requested rates exceed
+ * what the adapter delivers; within the granted rates PIDs are served
+ * earliest-deadline-first.
+ */
+enum obd_pid_priority_t : uint8_t {
+    OBD_PRIORITY_HIGH = 0,        // Driver inputs: RPM, speed, throttle
+    OBD_PRIORITY_NORMAL,          // Load, airflow, timing
+    OBD_PRIORITY_LOW,             // Slow-moving: temperatures, fuel level, counters
+    OBD_PRIORITY_COUNT
+};
+
 /**
  * @brief OBD PID configuration with polling rate
  */
@@ -13,6 +127,95 @@ struct obd_pid_config_t {
     uint32_t poll_interval_ms;    // How often to poll this PID (milliseconds)
     uint32_t last_poll_ms;        // Last time this PID was polled
     const char* description;      // Human-readable description
+    obd_pid_priority_t priority;
+    uint32_t scheduled_interval_ms; // Interval granted under the current capacity (>= poll_interval_ms)
+    uint32_t deadline_ms;         // When the PID is next due
+    float achieved_hz;            // Decoded updates per second over the last window
+    uint16_t window_updates;      // Update counter at the start of the window
+};
+
+/**
+ * @brief Requested vs. achieved rate of one PID
+ */
+struct obd_pid_stats_t {
+    uint8_t pid;
+    obd_pid_priority_t priority;
+    float requested_hz;           // From poll_interval_ms
+    float scheduled_hz;           // Granted under the learned adapter capacity
+    float achieved_hz;            // Measured
+};
+
+/**
+ * @brief CAN monitor acceptance filter (ELM327 ATCF/ATCM)
+ * A frame is captured when (frame_id & mask) == (id & mask). Each captured
+ * frame costs ~20 bytes of BLE notification traffic, so the filter is what
+ * keeps a busy bus within the link's throughput.
+ */
+struct obd_can_filter_t {
+    uint32_t id;
+    uint32_t mask;                // 0 = capture everything (rarely sustainable over BLE)
+    bool extended;                // 29-bit identifiers
+};
+
+/**
+ * @brief Outcome of a queued ELM327 command
+ */
+enum obd_command_status_t : uint8_t {
+    OBD_COMMAND_OK = 0,           // Response ended with the '>' prompt
+    OBD_COMMAND_NO_DATA,          // Adapter answered "NO DATA" (PID unsupported / ECU silent)
+    OBD_COMMAND_ERROR,            // "?", "ERROR", "UNABLE TO CONNECT", "STOPPED", ...
+    OBD_COMMAND_TIMEOUT,          // No prompt within the command timeout
+    OBD_COMMAND_DISCONNECTED      // Link dropped or queue flushed before completion
+};
+
+/**
+ * @brief Completed command passed to its callback
+ */
+struct obd_command_result_t {
+    const char* command;          // Command line as sent (without CR)
+    const char* response;         // Response text without echo, prompt or trailing whitespace
+    obd_command_status_t status;
+    uint32_t rtt_ms;              // Write to prompt (or timeout)
+};
+
+/**
+ * @brief Command completion callback
+ * Runs in the NimBLE host task when the prompt arrives (or in the caller of
+ * update() on timeout), so it must be short and must not block.
+ */
+typedef void (*obd_command_cb_t)(const obd_command_result_t& result, void* ctx);
+
+/**
+ * @brief OBD command engine statistics
+ */
+struct obd_link_stats_t {
+    uint32_t commands_sent;       // Commands written to the adapter
+    uint32_t responses;           // Commands completed with a prompt
+    uint32_t no_data;             // ... of which answered NO DATA
+    uint32_t errors;              // ... of which answered with an error
+    uint32_t timeouts;            // Commands that never saw a prompt
+    uint32_t queue_full;          // queue_command() rejections
+    uint32_t pid_updates;         // Mode 01 PIDs decoded into obd_data_t
+    float pids_per_sec;           // PID decode rate over the last window
+    uint32_t max_queue_depth;
+    uint32_t batch_requests;      // Multi-PID Mode 01 requests sent
+    uint32_t batch_failures;      // ... answered with none of the requested PIDs
+    bool batching;                // Multi-PID requests in use (false after fallback)
+    float demand_pids_per_sec;    // Sum of the requested PID rates
+    float capacity_pids_per_sec;  // Learned adapter throughput
+    bool saturated;               // Due PIDs had to wait during the last window
+    uint32_t can_frames;          // Monitor frames pushed to the CAN ring
+    uint32_t can_dropped;         // ... lost because the ring was full
+    uint32_t can_malformed;       // Monitor lines that did not parse as a frame
+    uint32_t can_buffer_full;     // Adapter stopped monitoring on BUFFER FULL (restarted)
+    uint16_t mtu;                 // Negotiated ATT MTU
+    float conn_interval_ms;       // Connection interval in use
+    float rx_bytes_per_sec;       // Notification payload received over the last window
+    float tx_bytes_per_sec;       // Command bytes written over the last window
+    float rtt_ms;                 // Smoothed command round trip (write to prompt)
+    uint32_t max_rtt_ms;
+    uint32_t connect_failures;    // Connection attempts that did not reach STREAM
+    uint32_t link_losses;         // Established links that dropped
 };
 
 /**
@@ -32,8 +235,48 @@ struct obd_pid_config_t {
  * Connection Notes:
  * - Device advertises with local name containing "iCar" or "vgate"
  * - No authentication required (open connection)
- * - Connection is stable at 1-2 MTU (default 23 bytes)
- * - Requires 500ms+ between writes for reliable communication
+ * - start_link_task() runs the connection manager on its own low-priority
+ *   task: SCAN -> CONNECT -> DISCOVER -> INIT -> STREAM, with exponential
+ *   BACKOFF after a failure or link loss. Reconnects go to the last adapter
+ *   (kept in NVS) and fall back to scanning after repeated failures.
+ *   Only that task ever waits on BLE; everyone else reads cached data.
+ * - connect() asks for a 247-byte MTU and a 7.5-15 ms connection interval.
+ *   Whatever the adapter grants (or a fallback after a refused connection)
+ *   is remembered per address and asked for first next time.
+ *
+ * Command engine:
+ * - The adapter speaks ELM327 text ("010C\r" -> "410C1AF8\r\r>").
+ * - Commands are queued with a completion callback; only one is in flight.
+ * - RX notifications are reassembled until the '>' prompt, which completes
+ *   the command and writes the next queued one immediately (write without
+ *   response), so there is no polling delay between round trips.
+ * - Due PIDs are grouped up to six per Mode 01 request ("010C0D11") so one
+ *   round trip refreshes several values. ECUs that answer a batch with none
+ *   of its PIDs twice in a row get one PID per request until reconnect.
+ *
+ * PID scheduler:
+ * - Each PID has a deadline; update() fills the (short) Mode 01 queue with
+ *   the earliest deadlines first, ties going to the higher priority.
+ * - Adapter capacity in PIDs/sec is learned from the throughput achieved
+ *   while saturated and persisted in NVS. When the requested rates add up
+ *   to more, capacity is granted by priority and lower classes are slowed
+ *   proportionally instead of every PID falling behind at random.
+ *
+ * CAN monitor:
+ * - start_can_monitor() switches the adapter to headers + DLC, raw CAN
+ *   formatting and the given filter, then runs ATMA as a streaming command.
+ * - Frame lines are parsed as notifications arrive and pushed as
+ *   can_record_t into get_can_ring() for LogBlockWriter.
+ * - load_can_monitor_config() is the trigger: the link task starts the
+ *   monitor whenever the link is streaming and the configuration asks for
+ *   it, restarts it after a reconnect, a filter change or an error (no more
+ *   than every OBD_CAN_MONITOR_RETRY_MS), and stops it when disabled.
+ * - The PID scheduler yields while the monitor runs: update() queues no
+ *   Mode 01 requests (the adapter cannot answer them during ATMA) and keeps
+ *   restarting its rate window, so the pause is neither learned as lost
+ *   capacity nor reported as missed PID rates. Deadlines are left alone, so
+ *   once the restore commands drain every PID is due and polling resumes
+ *   earliest-deadline-first.
  */
 class IcarBleDriver {
 public:
@@ -44,9 +287,28 @@ public:
     static bool init();
 
     /**
-     * @brief Start scanning for vgate iCar 2 Pro device
-     * Automatically connects when device is found
-     * @return true if device found and connected
+     * @brief Start the connection manager task
+     * Scans, connects, reconnects and polls PIDs in the background. The first
+     * target is the last adapter used (NVS); without one it scans.
+     * @return true if the task is running
+     */
+    static bool start_link_task();
+
+    /**
+     * @brief Current connection manager state
+     */
+    static obd_link_state_t get_link_state();
+
+    /**
+     * @brief Printable name of a connection manager state
+     */
+    static const char* link_state_name(obd_link_state_t state);
+
+    /**
+     * @brief Start a background scan for vgate iCar 2 Pro device
+     * Returns immediately; the first matching adapter becomes the connect
+     * target and ends the scan.
+     * @return true if the scan started
      */
     static bool start_scan();
 
@@ -57,6 +319,9 @@ public:
 
     /**
      * @brief Connect to a specific device by address
+     * Blocks for the GAP connection and service discovery (bounded by
+     * OBD_CONNECT_TIMEOUT_S); the link task is the only caller.
+     * Adapter setup and vehicle info are queued, not waited for.
      * @param address BLE device address string (format: "AA:BB:CC:DD:EE:FF")
      * @return true if connection successful
      */
@@ -74,11 +339,53 @@ public:
 
     /**
      * @brief Update OBD data by polling configured PIDs
-     * Only polls PIDs whose interval has elapsed
-     * @return true if any PID was updated
+     * Queues PIDs whose interval has elapsed, batched into multi-PID requests
+     * (never blocks), expires timed-out commands and refreshes the throughput
+     * statistics.
+     * @return true if any PID was decoded since the previous call
      */
     static bool update();
 
+    /**
+     * @brief Queue an ELM327 command
+     * @param command Command text without CR (e.g. "010C", "ATE0")
+     * @param callback Completion callback (may be nullptr)
+     * @param ctx Passed to the callback
+     * @param timeout_ms Time allowed from write to prompt
+     * @return true if queued, false if not connected or the queue is full
+     */
+    static bool queue_command(const char* command, obd_command_cb_t callback, void* ctx,
+                              uint32_t timeout_ms = OBD_COMMAND_TIMEOUT_MS);
+
+    /**
+     * @brief Command engine statistics
+     */
+    static obd_link_stats_t get_link_stats();
+
+    /**
+     * @brief Start capturing raw CAN frames (ATMA)
+     * @param filter Acceptance filter programmed into the adapter
+     * @param session_start_us Log session start; record timestamps are relative to it
+     * @return true if the monitor commands were queued
+     */
+    static bool start_can_monitor(const obd_can_filter_t& filter, int64_t session_start_us);
+
+    /**
+     * @brief Stop the CAN monitor and restore polling mode
+     */
+    static void stop_can_monitor();
+
+    /**
+     * @brief Check if the CAN monitor is running (or starting)
+     */
+    static bool is_can_monitor_active();
+
+    /**
+     * @brief Ring of captured CAN records (single producer: the NimBLE host task)
+     * Register it with LogBlockWriter::add_source().
+     */
+    static log_record_ring_t* get_can_ring();
+
     /**
      * @brief Get latest OBD data
      */
@@ -89,10 +396,37 @@ public:
      * @param pid Parameter ID
      * @param poll_interval_ms Polling interval in milliseconds
      * @param description Human-readable description
+     * @param priority Scheduling priority
      * @return true if PID added/updated
      */
+    static bool add_pid(uint8_t pid, uint32_t poll_interval_ms, const char* description,
+                        obd_pid_priority_t priority);
+
+    /**
+     * @brief Configure PID polling with the PID's default priority
+     */
     static bool add_pid(uint8_t pid, uint32_t poll_interval_ms, const char* description);
 
+    /**
+     * @brief Replace the polling list with the enabled PIDs of a configuration
+     * Each PID is polled at its rate_hz, capped at the global obd_hz.
+     */
+    static void load_pid_configs(const logging_config_t& config);
+
+    /**
+     * @brief Request or cancel the CAN monitor from a configuration
+     * Applied by the link task (see the class notes); safe from any task.
+     * @param config can_monitor_enabled and the can_filter_* fields are used
+     * @param session_start_us Log session start; record timestamps are relative to it
+     */
+    static void load_can_monitor_config(const logging_config_t& config, int64_t session_start_us);
+
+    /**
+     * @brief Requested, scheduled and achieved rate per configured PID
+     * @return Number of entries written
+     */
+    static size_t get_pid_stats(obd_pid_stats_t* out, size_t max_count);
+
     /**
      * @brief Remove a PID from polling list
      * @param pid Parameter ID to remove
@@ -116,6 +450,14 @@ public:
      */
     static bool request_pid(uint8_t pid);
 
+    /**
+     * @brief Request several Mode 01 PIDs in one command (e.g. "010C0D11")
+     * @param pids Parameter IDs with known data lengths
+     * @param count 1 to OBD_MAX_PIDS_PER_REQUEST
+     * @return true if request queued
+     */
+    static bool request_pids(const uint8_t* pids, size_t count);
+
     /**
      * @brief Get device address (for remembering last connection)
      */
@@ -145,7 +487,8 @@ public:
 
     /**
      * @brief Request VIN and ECM name from vehicle
-     * Should be called once after connection established
+     * Queues the Mode 09 requests; get_vin()/get_ecm_name() fill in as the
+     * answers arrive ("N/A" if the vehicle has none)
      */
     static void request_vehicle_info();
 
@@ -158,17 +501,154 @@ private:
     static char m_ecm_name[20];
     static NimBLERemoteCharacteristic* m_rx_char;
     static NimBLERemoteCharacteristic* m_tx_char;
+    static NimBLEClient* m_client;              // Kept across reconnects
+    
+    // Connection manager (state only changed by the link task)
+    static TaskHandle_t m_link_task;
+    static volatile obd_link_state_t m_link_state;
+    static uint32_t m_state_since_ms;
+    static uint32_t m_backoff_ms;
+    static uint8_t m_connect_attempts;          // Consecutive failures since the last STREAM
+    static volatile bool m_scan_running;
+    static char m_scan_address[18];             // Adapter found by the last scan
+    
+    // Link parameters: requested, and whether the interval outcome is known yet
+    static obd_link_params_t m_link_params;
+    static bool m_params_checked;
+    static uint32_t m_params_requested_ms;
+    static uint32_t m_rx_bytes;
+    static uint32_t m_tx_bytes;
+    static uint32_t m_rate_window_rx_bytes;
+    static uint32_t m_rate_window_tx_bytes;
     static std::vector<obd_pid_config_t> m_configured_pids;
     
+    struct obd_command_t {
+        char text[OBD_COMMAND_MAX_LEN];
+        obd_command_cb_t callback;
+        void* ctx;
+        uint32_t timeout_ms;
+    };
+    
+    // Command queue; the head entry is in flight while m_cmd_active is set.
+    // Guarded by m_lock (touched from the NimBLE host task and callers).
+    static portMUX_TYPE m_lock;
+    static obd_command_t m_cmd_queue[OBD_COMMAND_QUEUE_SIZE];
+    static uint8_t m_cmd_head;
+    static uint8_t m_cmd_count;
+    static bool m_cmd_active;
+    static uint32_t m_cmd_sent_ms;
+    
+    // Response reassembly (NimBLE host task)
+    static char m_rx_buffer[OBD_RESPONSE_MAX_LEN];
+    static size_t m_rx_len;
+    static char m_response[OBD_RESPONSE_MAX_LEN];
+    
+    // PIDs queued but not yet answered (bitmap over 0x00-0xFF)
+    static uint32_t m_pending_pids[8];
+    static bool m_pid_updated;
+    
+    // Multi-PID requests; cleared after OBD_BATCH_MAX_FAILURES unusable answers
+    static bool m_batching_enabled;
+    static uint8_t m_batch_failures;
+    
+    // Scheduler state
+    static uint8_t m_mode01_outstanding;        // Mode 01 requests queued or in flight
+    static uint16_t m_pid_update_counts[256];   // Decodes per PID (wrapping)
+    static bool m_saturated;                    // Due PIDs waited during this window
+    static float m_capacity;                    // Learned PIDs/sec
+    static float m_saved_capacity;
+    static uint32_t m_capacity_saved_ms;
+    
+    // CAN monitor
+    static bool m_monitor_enabled;              // Wanted by the caller
+    static bool m_monitor_buffer_full;          // Adapter ended ATMA on BUFFER FULL
+    static bool m_monitor_requested;            // Set by load_can_monitor_config() (guarded by m_lock)
+    static obd_can_filter_t m_requested_filter;
+    static int64_t m_requested_session_us;
+    static uint32_t m_monitor_retry_ms;         // Earliest time the link task may (re)start it
+    static obd_can_filter_t m_can_filter;
+    static int64_t m_session_start_us;
+    static log_record_ring_t m_can_ring;
+    
+    static obd_link_stats_t m_stats;
+    static uint32_t m_rate_window_start_ms;
+    static uint32_t m_rate_window_pids;
+    
+    friend class ObdScanCallbacks;
+    
+    static void link_task(void* param);
+    
+    /**
+     * @brief Advance the connection manager by one step
+     */
+    static void run_link(uint32_t now);
+    static void enter_state(obd_link_state_t state, uint32_t now);
+    static void connect_failed(uint32_t now);
+    static bool link_alive();
+    
+    /**
+     * @brief GAP connection with link parameter negotiation (CONNECT state)
+     */
+    static bool open_connection(const char* address);
+    
+    /**
+     * @brief Find the UART service, subscribe and queue adapter setup (DISCOVER state)
+     */
+    static bool discover_services();
+    static void on_advertised(NimBLEAdvertisedDevice* device);
+    static void on_scan_complete(NimBLEScanResults results);
+    
+    static void on_notify(NimBLERemoteCharacteristic* chr, uint8_t* data, size_t length, bool is_notify);
+    static void issue_next();
+    static void complete_active(obd_command_status_t status, const char* response);
+    static void service_timeouts();
+    static void flush_queue();
+    static bool queue_batch(obd_pid_config_t* const* batch, size_t count, uint32_t now);
+    static obd_pid_priority_t default_priority(uint8_t pid);
+    
+    /**
+     * @brief Load the remembered link parameters for an address (preferred ones if none)
+     */
+    static obd_link_params_t load_link_params(const char* address);
+    static void save_link_params(const char* address, const obd_link_params_t& params);
+    
+    /**
+     * @brief Record what the adapter accepted once the interval update has settled
+     */
+    static void check_link_params(uint32_t now);
+    
+    /**
+     * @brief Grant the learned capacity to the configured PIDs by priority
+     * Sets each scheduled_interval_ms; PIDs keep their requested interval
+     * while the total demand fits.
+     */
+    static void plan_rates();
+    
+    /**
+     * @brief Fold the last window's throughput into the capacity estimate
+     */
+    static void learn_capacity(float pids_per_sec, bool saturated, uint32_t now);
+    static void on_pid_response(const obd_command_result_t& result, void* ctx);
+    static void on_vehicle_info(const obd_command_result_t& result, void* ctx);
+    static void on_monitor_done(const obd_command_result_t& result, void* ctx);
+    
+    /**
+     * @brief Start, restart or stop the CAN monitor to match the request (link task)
+     */
+    static void service_can_monitor(uint32_t now);
+    
+    /**
+     * @brief Hand complete lines of a streaming response to parse_can_line()
+     * Consumed bytes are removed from m_rx_buffer (NimBLE host task only).
+     */
+    static void consume_stream_lines();
+    
     /**
-     * @brief Send OBD command and wait for response
-     * @param command Command string to send (e.g., "09 02\r")
-     * @param response Buffer to store response
-     * @param max_len Maximum response buffer size
-     * @param timeout_ms Timeout in milliseconds
-     * @return true if response received
+     * @brief Parse one ATMA line (headers, DLC, no spaces) into a can_record_t
+     * "7E8806410C1AF8AAAA" = ID 7E8, DLC 8, data; 29-bit IDs use 8 digits.
      */
-    static bool send_obd_command(const char* command, char* response, size_t max_len, uint32_t timeout_ms = 2000);
+    static void parse_can_line(const char* line, size_t len);
+    static void decode_pid(uint8_t pid, const uint8_t* data, size_t len);
     
     /**
      * @brief Parse VIN from Mode 09 PID 02 response
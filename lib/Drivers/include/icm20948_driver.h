@@ -4,11 +4,33 @@
 #include "sensor_hal.h"
 #include <Wire.h>
 
+/**
+ * @brief I2C bus cost counters for the ICM20948
+ * A transaction is one START..STOP (or repeated START) on the bus.
+ */
+struct icm20948_bus_stats_t {
+    uint32_t updates;                   // update() calls
+    uint32_t transactions;              // Total bus transactions
+    uint32_t bytes;                     // Total bytes moved (register address + data)
+    uint16_t last_update_transactions;  // Transactions used by the most recent update()
+    uint16_t last_update_bytes;         // Bytes moved by the most recent update()
+};
+
 /**
  * @brief ICM20948 9-DOF IMU Driver
  * Implements IAccelSensor interface for accelerometer
  * Also provides gyroscope and magnetometer data
  * The ICM20948 contains accelerometer, gyroscope, and magnetometer
+ *
+ * Two acquisition modes:
+ *  - Polled (default): update() reads accel, gyro and temperature
+ *    (0x2D-0x3A, contiguous in Bank 0) in one 14-byte burst. When the
+ *    AK09916 is present the burst extends through EXT_SLV_SENS_DATA
+ *    (0x3B-0x43), where the ICM20948 I2C master copies the magnetometer
+ *    registers on its own, so the compass costs no extra transactions.
+ *  - FIFO (enable_fifo()): the chip samples accel+gyro into its 512-byte
+ *    FIFO at a fixed ODR; update() drains it in burst reads and the samples
+ *    are returned, timestamped, through read_batch()/read_gyro_batch().
  */
 class ICM20948Driver : public IAccelSensor {
 public:
@@ -27,9 +49,41 @@ public:
     accel_data_t get_data() const override;
     bool is_valid() const override;
     
+    uint16_t get_batch_rate_hz() const override;
+    size_t read_batch(accel_sample_t* out, size_t max_samples) override;
+    
     // Gyroscope methods (compatible with IGyroSensor)
     gyro_data_t get_gyro() const;
     bool gyro_is_valid() const;
+    size_t read_gyro_batch(gyro_sample_t* out, size_t max_samples) const;
+    
+    /**
+     * @brief Switch to FIFO mode at the given output data rate
+     * ODR = 1125 / (1 + div); the closest achievable rate is used.
+     * @param odr_hz Requested accel/gyro sample rate (up to 1125 Hz)
+     * @return true if the FIFO was configured
+     */
+    bool enable_fifo(uint16_t odr_hz);
+    
+    /**
+     * @brief Return to polled register reads
+     */
+    void disable_fifo();
+    
+    /**
+     * @brief Check if FIFO mode is active
+     */
+    bool is_fifo_enabled() const;
+    
+    /**
+     * @brief Number of times the FIFO overflowed and was reset (samples lost)
+     */
+    uint32_t get_fifo_overflows() const;
+    
+    /**
+     * @brief Get I2C transaction/byte counters (per-update cost of the sensor)
+     */
+    icm20948_bus_stats_t get_bus_stats() const;
     
     // Compass methods (compatible with ICompassSensor)
     compass_data_t get_compass() const;
@@ -47,6 +101,20 @@ private:
     bool m_gyro_valid;
     bool m_compass_valid;
     
+    // FIFO mode state
+    bool m_fifo_enabled;
+    uint16_t m_fifo_rate_hz;
+    uint32_t m_fifo_period_us;
+    uint32_t m_fifo_overflows;
+    accel_sample_t m_accel_batch[IMU_BATCH_MAX_SAMPLES];
+    gyro_sample_t m_gyro_batch[IMU_BATCH_MAX_SAMPLES];
+    size_t m_batch_count;
+    
+    icm20948_bus_stats_t m_bus_stats;
+    
+    // AK09916 magnetometer behind the internal I2C master
+    bool m_mag_present;
+    
     // Low-level I2C operations
     bool write_register(uint8_t reg, uint8_t value);
     uint8_t read_register(uint8_t reg);
@@ -57,16 +125,24 @@ private:
     bool configure_gyro();
     bool configure_compass();
     
+    // AK09916 register access through I2C master slave 4 (configuration only)
+    bool mag_write(uint8_t reg, uint8_t value);
+    bool mag_read(uint8_t reg, uint8_t* value);
+    bool wait_slv4_done();
+    
     // Data reading
-    bool read_accel_raw();
-    bool read_gyro_raw();
+    bool read_motion_burst();
     bool read_compass_raw();
+    bool parse_compass(const uint8_t* ext_data);
     bool read_temperature();
+    bool drain_fifo();
+    void reset_fifo();
     
     // Raw data conversion
     void convert_accel_data(int16_t raw_x, int16_t raw_y, int16_t raw_z);
     void convert_gyro_data(int16_t raw_x, int16_t raw_y, int16_t raw_z);
     void convert_compass_data(int16_t raw_x, int16_t raw_y, int16_t raw_z);
+    void convert_temperature(int16_t raw_temp);
 };
 
 #endif // ICM20948_DRIVER_H
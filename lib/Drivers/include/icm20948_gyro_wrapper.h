@@ -18,6 +18,8 @@ public:
     bool update() override;
     gyro_data_t get_data() const override;
     bool is_valid() const override;
+    uint16_t get_batch_rate_hz() const override;
+    size_t read_batch(gyro_sample_t* out, size_t max_samples) override;
     
 private:
     ICM20948Driver* m_imu_driver;
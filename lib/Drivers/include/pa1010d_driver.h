@@ -2,9 +2,45 @@
 #define PA1010D_GPS_DRIVER_H
 
 #include "sensor_hal.h"
+#include "nmea_parser.h"
+#include "seqlock.h"
 #include <HardwareSerial.h>
 #include <Wire.h>
 
+// MT3333 limit for position fixes with RMC+GGA output
+#define PA1010D_MAX_FIX_HZ          10
+
+// UART baud used when the default 9600 cannot carry the configured output
+#define PA1010D_UART_FAST_BAUD      115200
+
+// Raw NMEA byte ring between bus reads and the sentence assembler (power of two)
+#define PA1010D_RX_RING_SIZE        1024
+
+// I2C read size bounds; the ESP32 Wire buffer caps one read at 128 bytes
+#define PA1010D_I2C_MIN_READ        32
+#define PA1010D_I2C_MAX_READ        128
+
+/**
+ * @brief NMEA byte stream statistics
+ *
+ * Sentence latency runs from the start of the update() whose bus read
+ * delivered the '$' to the parsed fix. It covers the bus transfer, any wait
+ * for the rest of the sentence in later reads (one GPS period each) and the
+ * parse; for a sentence read whole it is the read plus parse time. How long
+ * the module buffered the sentence before the read is not visible here.
+ */
+struct pa1010d_stream_stats_t {
+    uint32_t reads;               // Bus read transactions (I2C) or non-empty polls (UART)
+    uint32_t bytes;               // NMEA bytes queued (padding excluded)
+    uint32_t padding_bytes;       // 0x0A filler returned by an empty PA1010D I2C buffer
+    uint32_t ring_overflows;      // Bytes dropped because the ring was full
+    uint32_t sentence_overflows;  // Sentences discarded for exceeding NMEA_MAX_SENTENCE_LEN
+    uint16_t read_size;           // Current adaptive I2C read size
+    uint32_t last_latency_us;     // Read that delivered '$' -> gps_data_t updated, last sentence
+    uint32_t max_latency_us;
+    uint32_t mean_latency_us;
+};
+
 /**
  * @brief PA1010D GPS Module Driver
  * Implements IGPSSensor interface for the PA1010D GNSS module
@@ -44,6 +80,36 @@ public:
     gps_data_t get_data() const override;
     bool is_valid() const override;
 
+    /**
+     * @brief NMEA parser counters (decoded, checksum failures, malformed)
+     */
+    nmea_parser_stats_t get_parser_stats() const;
+
+    /**
+     * @brief Configure fix rate and sentence output (call after init())
+     * Sends PMTK314 to emit only RMC+GGA, PMTK251 in UART mode when the
+     * current baud cannot carry the output, and PMTK220 for the fix interval.
+     * @param fix_hz Requested fix rate, clamped to 1-PA1010D_MAX_FIX_HZ
+     * @return true if the module acknowledged the output and rate commands
+     */
+    bool configure(uint16_t fix_hz);
+
+    /**
+     * @brief Fix rate sent with PMTK220 (0 until configure() succeeds)
+     */
+    uint16_t get_configured_rate_hz() const;
+
+    /**
+     * @brief Measured fix rate (RMC epochs per second over the last window, 0 once they stop)
+     */
+    float get_fix_rate_hz() const;
+
+    /**
+     * @brief Byte stream and sentence latency statistics
+     * Published once per update(), so any task may call this.
+     */
+    pa1010d_stream_stats_t get_stream_stats() const;
+
 private:
     // Communication mode
     CommInterface m_comm_mode;
@@ -61,17 +127,51 @@ private:
     // Common data
     gps_data_t m_data;
     bool m_valid;
+    NmeaParser m_parser;
+    
+    // PMTK configuration
+    uint16_t m_configured_hz;
+    uint16_t m_last_ack_cmd;
+    uint8_t m_last_ack_flag;
+    
+    // Achieved fix rate (RMC sentences counted per window)
+    uint32_t m_fix_count;
+    uint32_t m_fix_window_start_ms;
+    float m_fix_rate_hz;
+    
+    // Raw bytes from the bus (free-running indices, masked on access)
+    uint8_t m_rx_ring[PA1010D_RX_RING_SIZE];
+    uint16_t m_rx_head;
+    uint16_t m_rx_tail;
+    uint8_t m_prev_byte;
+    uint16_t m_read_size;
+    
+    // Sentence being assembled from the ring
+    char m_sentence[NMEA_MAX_SENTENCE_LEN + 1];
+    size_t m_sentence_len;
+    int64_t m_sentence_start_us;
+    
+    pa1010d_stream_stats_t m_stream_stats;
+    SeqLock<pa1010d_stream_stats_t> m_published_stats;  // Copy read from core 0
+    uint64_t m_latency_total_us;
+    uint32_t m_latency_samples;
     
     // Helper functions
-    bool parse_nmea_sentence(const char* sentence);
-    bool parse_gprmc(const char* sentence);
-    bool parse_gpgga(const char* sentence);
+    bool parse_nmea_sentence(const char* sentence, size_t len);
+    bool send_command(const char* body);
+    bool wait_for_ack(uint16_t cmd, uint32_t timeout_ms);
+    void count_fix();
+    void reset_stream();
+    
+    // Byte ring
+    void push_byte(uint8_t c);
+    void drain_ring(int64_t read_us);
     
     // UART specific
-    bool read_uart_nmea_buffer();
+    void fill_from_uart();
     
     // I2C specific
-    bool read_i2c_nmea_buffer();
+    void fill_from_i2c();
 };
 
 #endif // PA1010D_GPS_DRIVER_H
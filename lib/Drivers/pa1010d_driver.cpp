@@ -1,6 +1,24 @@
 #include "pa1010d_driver.h"
 #include <cstring>
-#include <cstdlib>
+#include <esp_timer.h>
+
+// Time to wait for a PMTK001 acknowledgement
+#define PMTK_ACK_TIMEOUT_MS     1000
+
+// PMTK001 result flag for a command that was applied
+#define PMTK_ACK_SUCCEEDED      3
+
+// Approximate bytes per fix epoch with only RMC+GGA enabled
+#define NMEA_EPOCH_BYTES        160
+
+// Window for the achieved fix rate measurement
+#define FIX_RATE_WINDOW_MS      2000
+
+// Back-to-back I2C reads allowed per update() while the module still has data
+#define I2C_MAX_READS_PER_UPDATE    8
+
+// PA1010D I2C filler byte when its output buffer is empty
+#define I2C_PADDING_BYTE        0x0A
 
 /**
  * @brief I2C Constructor (default)
@@ -8,8 +26,11 @@
 PA1010DDriver::PA1010DDriver(TwoWire& wire, uint8_t i2c_addr)
     : m_comm_mode(CommInterface::I2C),
       m_serial(nullptr), m_tx_pin(0), m_rx_pin(0), m_baud(0),
-      m_wire(&wire), m_i2c_addr(i2c_addr), m_valid(false) {
+      m_wire(&wire), m_i2c_addr(i2c_addr), m_valid(false),
+      m_configured_hz(0), m_last_ack_cmd(0), m_last_ack_flag(0),
+      m_fix_count(0), m_fix_window_start_ms(0), m_fix_rate_hz(0.0f) {
     memset(&m_data, 0, sizeof(m_data));
+    reset_stream();
 }
 
 /**
@@ -18,8 +39,11 @@ PA1010DDriver::PA1010DDriver(TwoWire& wire, uint8_t i2c_addr)
 PA1010DDriver::PA1010DDriver(HardwareSerial& serial, int tx_pin, int rx_pin, unsigned long baud)
     : m_comm_mode(CommInterface::UART),
       m_serial(&serial), m_tx_pin(tx_pin), m_rx_pin(rx_pin), m_baud(baud),
-      m_wire(nullptr), m_i2c_addr(0), m_valid(false) {
+      m_wire(nullptr), m_i2c_addr(0), m_valid(false),
+      m_configured_hz(0), m_last_ack_cmd(0), m_last_ack_flag(0),
+      m_fix_count(0), m_fix_window_start_ms(0), m_fix_rate_hz(0.0f) {
     memset(&m_data, 0, sizeof(m_data));
+    reset_stream();
 }
 
 PA1010DDriver::~PA1010DDriver() {
@@ -41,331 +65,269 @@ bool PA1010DDriver::init() {
     }
 }
 
-bool PA1010DDriver::update() {
-    if (m_comm_mode == CommInterface::UART) {
-        return read_uart_nmea_buffer();
-    } else {
-        return read_i2c_nmea_buffer();
+bool PA1010DDriver::configure(uint16_t fix_hz) {
+    if (fix_hz < 1) {
+        fix_hz = 1;
+    } else if (fix_hz > PA1010D_MAX_FIX_HZ) {
+        Serial.printf("[GPS] Requested %u Hz exceeds PA1010D limit, using %u Hz\n",
+                      fix_hz, PA1010D_MAX_FIX_HZ);
+        fix_hz = PA1010D_MAX_FIX_HZ;
     }
-}
-
-bool PA1010DDriver::read_uart_nmea_buffer() {
-    static char buffer[128];
-    static int buffer_idx = 0;
     
-    // Read available data from GPS module
-    if (m_serial) {
-        while (m_serial->available()) {
-            char c = m_serial->read();
-            
-            if (c == '\n') {
-                buffer[buffer_idx] = '\0';
-                
-                // Parse the complete NMEA sentence
-                if (buffer[0] == '$') {
-                    parse_nmea_sentence(buffer);
-                }
-                
-                buffer_idx = 0;
-            } else if (c != '\r' && buffer_idx < sizeof(buffer) - 1) {
-                buffer[buffer_idx++] = c;
-            }
-        }
+    // PMTK314: per-sentence output divisors
+    // GLL,RMC,VTG,GGA,GSA,GSV,(6 reserved),ZDA,MCHN,(5 reserved) - RMC+GGA every fix only
+    if (!send_command("PMTK314,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0") ||
+        !wait_for_ack(314, PMTK_ACK_TIMEOUT_MS)) {
+        Serial.println("[GPS] PMTK314 (sentence filter) not acknowledged");
+        return false;
     }
     
-    // Always return true - either we got data or waiting for it is OK
+    // UART: raise the baud rate before the output rate if 8N1 (10 bits/byte) would saturate
+    if (m_comm_mode == CommInterface::UART &&
+        (uint32_t)fix_hz * NMEA_EPOCH_BYTES * 10 > m_baud / 2 && m_baud < PA1010D_UART_FAST_BAUD) {
+        char body[24];
+        snprintf(body, sizeof(body), "PMTK251,%lu", (unsigned long)PA1010D_UART_FAST_BAUD);
+        send_command(body);
+        m_serial->flush();
+        delay(100);  // PMTK251 is not acknowledged; the module switches after the sentence
+        m_baud = PA1010D_UART_FAST_BAUD;
+        m_serial->updateBaudRate(m_baud);
+        Serial.printf("[GPS] UART switched to %lu baud\n", m_baud);
+    }
+    
+    // PMTK220: fix interval in milliseconds
+    char body[24];
+    snprintf(body, sizeof(body), "PMTK220,%u", 1000 / fix_hz);
+    if (!send_command(body) || !wait_for_ack(220, PMTK_ACK_TIMEOUT_MS)) {
+        Serial.printf("[GPS] PMTK220 (%u Hz fix rate) not acknowledged\n", fix_hz);
+        return false;
+    }
+    
+    m_configured_hz = fix_hz;
+    m_fix_count = 0;
+    m_fix_window_start_ms = millis();
+    Serial.printf("[GPS] Configured %u Hz fixes, RMC+GGA output only\n", fix_hz);
     return true;
 }
 
-gps_data_t PA1010DDriver::get_data() const {
-    return m_data;
+uint16_t PA1010DDriver::get_configured_rate_hz() const {
+    return m_configured_hz;
 }
 
-bool PA1010DDriver::is_valid() const {
-    return m_valid;
+float PA1010DDriver::get_fix_rate_hz() const {
+    // count_fix() only updates the rate when an RMC arrives; report a silent module as 0
+    if (millis() - m_fix_window_start_ms >= 2 * FIX_RATE_WINDOW_MS) {
+        return 0.0f;
+    }
+    return m_fix_rate_hz;
 }
 
-bool PA1010DDriver::parse_nmea_sentence(const char* sentence) {
-    // Debug: Print last GPS sentence received
-    static uint32_t last_print_time = 0;
-    uint32_t now = millis();
-    if (now - last_print_time >= 2000) {  // Print every 2 seconds
-        Serial.printf("[GPS] Last sentence: %s\n", sentence);
-        last_print_time = now;
+bool PA1010DDriver::send_command(const char* body) {
+    char sentence[NMEA_MAX_SENTENCE_LEN];
+    size_t len = NmeaParser::format_sentence(body, sentence, sizeof(sentence));
+    if (len == 0) {
+        return false;
     }
     
-    // Process RMC sentences for time, date, and speed
-    if (strncmp(sentence, "$GNRMC", 6) == 0 || strncmp(sentence, "$GPRMC", 6) == 0) {
-        return parse_gprmc(sentence);
+    if (m_comm_mode == CommInterface::UART) {
+        if (!m_serial) return false;
+        return m_serial->write((const uint8_t*)sentence, len) == len;
     }
     
-    // Process GGA sentences for position and satellite count
-    if (strncmp(sentence, "$GNGGA", 6) == 0) {
-        return parse_gpgga(sentence);
+    if (!m_wire) return false;
+    m_wire->beginTransmission(m_i2c_addr);
+    m_wire->write((const uint8_t*)sentence, len);
+    return m_wire->endTransmission() == 0;
+}
+
+bool PA1010DDriver::wait_for_ack(uint16_t cmd, uint32_t timeout_ms) {
+    m_last_ack_cmd = 0;
+    uint32_t start = millis();
+    while (millis() - start < timeout_ms) {
+        update();
+        if (m_last_ack_cmd == cmd) {
+            return m_last_ack_flag == PMTK_ACK_SUCCEEDED;
+        }
+        delay(10);
     }
     return false;
 }
 
-bool PA1010DDriver::parse_gprmc(const char* sentence) {
-    // Format: $GPRMC,hhmmss.ss,A,llll.ll,a,yyyyy.yy,a,x.x,x.x,ddmmyy,x.x,a*hh
-    // Example: $GPRMC,064951.734,A,2307.038,N,12042.457,E,2.3,90.0,051200,,,A*22
-    
-    int values = 0;
-    double tmp_lat = 0, tmp_lon = 0;
-    char tmp_lat_dir = 'N', tmp_lon_dir = 'E';
-    int tmp_date = 0;
-    float tmp_speed = 0;
-    
-    // Parse comma-separated values
-    const char* pos = strchr(sentence, ',');
-    
-    if (!pos) return false;
-    
-    // Time: hhmmss.ss (we extract just hhmmss)
-    pos++;
-    int parsed = sscanf(pos, "%2hhu%2hhu%2hhu", &m_data.hour, &m_data.minute, &m_data.second);
-    if (parsed != 3) return false;
-    
-    pos = strchr(pos, ',') + 1;
-    char status = *pos;  // A=valid, V=invalid
-    
-    pos = strchr(pos, ',') + 1;
-    sscanf(pos, "%lf", &tmp_lat);
-    
-    pos = strchr(pos, ',') + 1;
-    tmp_lat_dir = *pos;
-    
-    pos = strchr(pos, ',') + 1;
-    sscanf(pos, "%lf", &tmp_lon);
-    
-    pos = strchr(pos, ',') + 1;
-    tmp_lon_dir = *pos;
-    
-    pos = strchr(pos, ',') + 1;
-    sscanf(pos, "%f", &tmp_speed);
-    
-    // Skip course
-    pos = strchr(pos, ',') + 1;
-    pos = strchr(pos, ',') + 1;
-    
-    // Date: ddmmyy
-    sscanf(pos, "%2hhu%2hhu%2hu", &m_data.day, &m_data.month, &m_data.year);
-    m_data.year += 2000;
-    
-    // Convert latitude and longitude from NMEA format
-    int lat_deg = (int)(tmp_lat / 100.0);
-    m_data.latitude = lat_deg + (tmp_lat - lat_deg * 100.0) / 60.0;
-    if (tmp_lat_dir == 'S') {
-        m_data.latitude = -m_data.latitude;
-    }
-    
-    int lon_deg = (int)(tmp_lon / 100.0);
-    m_data.longitude = lon_deg + (tmp_lon - lon_deg * 100.0) / 60.0;
-    if (tmp_lon_dir == 'W') {
-        m_data.longitude = -m_data.longitude;
-    }
-    
-    m_data.speed = tmp_speed;
-    m_valid = (status == 'A');
-    m_data.valid = m_valid;  // Update the struct field too
-    
-    // Debug: Print parsing result
-    static uint32_t last_parse_debug = 0;
+void PA1010DDriver::count_fix() {
+    m_fix_count++;
     uint32_t now = millis();
-    if (now - last_parse_debug >= 2000) {
-        Serial.printf("[GPS] GPRMC: valid=%d, status=%c, lat=%.6f, lon=%.6f, speed=%.1f\n", 
-                      m_valid, status, m_data.latitude, m_data.longitude, m_data.speed);
-        last_parse_debug = now;
+    uint32_t elapsed = now - m_fix_window_start_ms;
+    if (elapsed >= FIX_RATE_WINDOW_MS) {
+        m_fix_rate_hz = m_fix_count * 1000.0f / elapsed;
+        m_fix_count = 0;
+        m_fix_window_start_ms = now;
     }
-    
-    return m_valid;
 }
 
-bool PA1010DDriver::parse_gpgga(const char* sentence) {
-    // Format: $GNGGA,hhmmss.ss,llll.ll,a,yyyyy.yy,a,x,xx,x.x,x.x,M,x.x,M,,*hh
-    // Example: $GNGGA,014153.377,4219.9872,N,07126.1921,W,1,4,1.69,69.9,M,-33.8,M,,*4B
-    //          0      1          2         3  4         5  6 7  8    9    10
-    
-    // For now, just check if we can parse the basic structure
-    // Focus on: time, lat, lon, fix_quality, sats, altitude
+void PA1010DDriver::reset_stream() {
+    m_rx_head = 0;
+    m_rx_tail = 0;
+    m_prev_byte = 0;
+    m_read_size = PA1010D_I2C_MIN_READ;
+    m_sentence_len = 0;
+    m_sentence_start_us = 0;
+    memset(&m_stream_stats, 0, sizeof(m_stream_stats));
+    m_latency_total_us = 0;
+    m_latency_samples = 0;
+    m_published_stats.store(m_stream_stats);
+}
+
+bool PA1010DDriver::update() {
+    // Timestamp of the bus reads; sentences started in this update are aged from here
+    int64_t read_us = esp_timer_get_time();
     
-    if (!sentence || sentence[0] != '$') {
-        return false;
+    if (m_comm_mode == CommInterface::UART) {
+        if (!m_serial) return false;
+        fill_from_uart();
+    } else {
+        if (!m_wire) return false;
+        fill_from_i2c();
     }
     
-    // Skip the sentence header
-    const char* pos = strchr(sentence, ',');
-    if (!pos) return false;
+    drain_ring(read_us);
+    m_published_stats.store(m_stream_stats);
     
-    // Time field - hhmmss.ss format
-    pos++;
-    int time_parsed = sscanf(pos, "%2hhu%2hhu%2hhu", &m_data.hour, &m_data.minute, &m_data.second);
-    // Continue even if time parsing fails, since we need the position data
-    
-    // Latitude
-    double tmp_lat = 0;
-    pos = strchr(pos, ',');
-    if (!pos) return false;
-    pos++;
-    int lat_scan = sscanf(pos, "%lf", &tmp_lat);
-    if (lat_scan != 1) return false;
-    
-    // Latitude direction (N/S)
-    pos = strchr(pos, ',');
-    if (!pos) return false;
-    pos++;
-    char tmp_lat_dir = *pos;
-    
-    // Longitude
-    double tmp_lon = 0;
-    pos = strchr(pos, ',');
-    if (!pos) return false;
-    pos++;
-    int lon_scan = sscanf(pos, "%lf", &tmp_lon);
-    if (lon_scan != 1) return false;
-    
-    // Longitude direction (E/W)
-    pos = strchr(pos, ',');
-    if (!pos) return false;
-    pos++;
-    char tmp_lon_dir = *pos;
-    
-    // Fix quality (critical field)
-    int fix_quality = 0;
-    pos = strchr(pos, ',');
-    if (!pos) return false;
-    pos++;
-    int fix_scan = sscanf(pos, "%d", &fix_quality);
-    if (fix_scan != 1) return false;
-    
-    // Satellite count
-    uint8_t sats = 0;
-    pos = strchr(pos, ',');
-    if (!pos) return false;
-    pos++;
-    sscanf(pos, "%hhu", &sats);
-    
-    // Skip dilution (HDOP)
-    pos = strchr(pos, ',');
-    if (!pos) return false;
-    
-    // Altitude
-    double alt = 0;
-    pos = strchr(pos, ',');
-    if (!pos) return false;
-    pos++;
-    sscanf(pos, "%lf", &alt);
-    
-    // Convert latitude and longitude from NMEA format (ddmm.mmmm)
-    int lat_deg = (int)(tmp_lat / 100.0);
-    m_data.latitude = lat_deg + (tmp_lat - lat_deg * 100.0) / 60.0;
-    if (tmp_lat_dir == 'S') {
-        m_data.latitude = -m_data.latitude;
+    // Always return true - either we got data or waiting for it is OK
+    return true;
+}
+
+void PA1010DDriver::push_byte(uint8_t c) {
+    if ((uint16_t)(m_rx_head - m_rx_tail) >= PA1010D_RX_RING_SIZE) {
+        m_stream_stats.ring_overflows++;
+        return;
     }
-    
-    int lon_deg = (int)(tmp_lon / 100.0);
-    m_data.longitude = lon_deg + (tmp_lon - lon_deg * 100.0) / 60.0;
-    if (tmp_lon_dir == 'W') {
-        m_data.longitude = -m_data.longitude;
+    m_rx_ring[m_rx_head & (PA1010D_RX_RING_SIZE - 1)] = c;
+    m_rx_head++;
+    m_stream_stats.bytes++;
+}
+
+void PA1010DDriver::fill_from_uart() {
+    size_t free_space = PA1010D_RX_RING_SIZE - (uint16_t)(m_rx_head - m_rx_tail);
+    if (free_space == 0 || !m_serial->available()) {
+        return;
     }
-    
-    m_data.altitude = alt;
-    m_data.satellites = sats;
-    m_valid = (fix_quality > 0);
-    m_data.valid = m_valid;
-    
-    // Debug: Print parsing result
-    static uint32_t last_parse_debug_gga = 0;
-    uint32_t now = millis();
-    if (now - last_parse_debug_gga >= 2000) {
-        Serial.printf("[GPS] GNGGA: valid=%d, fix_quality=%d, sats=%d, alt=%.1f, lat=%.6f, lon=%.6f\n", 
-                      m_valid, fix_quality, sats, alt, m_data.latitude, m_data.longitude);
-        last_parse_debug_gga = now;
+    m_stream_stats.reads++;
+    while (free_space-- > 0 && m_serial->available()) {
+        push_byte((uint8_t)m_serial->read());
     }
-    
-    return m_valid;
 }
 
-bool PA1010DDriver::read_i2c_nmea_buffer() {
-    // PA1010D I2C protocol: Simple streaming read
-    // The GPS continuously outputs NMEA sentences over I2C
-    // Just read available bytes directly - no register addressing needed
-    
-    if (!m_wire) return false;
-    
-    static EXT_RAM_ATTR char sentence_buffer[256];
-    static int buffer_pos = 0;
-    static uint32_t last_i2c_debug = 0;
-    static uint32_t read_attempts = 0;
-    static uint32_t successful_sentences = 0;
-    
-    read_attempts++;
-    
-    // Request up to 32 bytes at a time from the GPS
-    size_t bytes_available = m_wire->requestFrom(m_i2c_addr, (size_t)32);
-    
-    if (bytes_available == 0) {
-        uint32_t now = millis();
-        if (now - last_i2c_debug >= 2000) {
-            Serial.printf("[GPS-I2C] No bytes available (attempts=%u, sentences=%u)\n", 
-                          read_attempts, successful_sentences);
-            last_i2c_debug = now;
+void PA1010DDriver::fill_from_i2c() {
+    // The PA1010D streams NMEA with no register addressing. Once its buffer is
+    // empty it pads reads with 0x0A, so a read that ends in padding means we are
+    // caught up. Reads grow while the module has a backlog and shrink when idle.
+    for (int i = 0; i < I2C_MAX_READS_PER_UPDATE; i++) {
+        size_t free_space = PA1010D_RX_RING_SIZE - (uint16_t)(m_rx_head - m_rx_tail);
+        size_t request = m_read_size < free_space ? m_read_size : free_space;
+        if (request < PA1010D_I2C_MIN_READ) {
+            break;
         }
-        return true;  // No data available yet
-    }
-    
-    // Read available bytes into our sentence buffer
-    while (m_wire->available() && buffer_pos < 255) {
-        char c = m_wire->read();
         
-        // Look for sentence start
-        if (c == '$') {
-            buffer_pos = 0;  // Start new sentence
+        size_t received = m_wire->requestFrom(m_i2c_addr, request);
+        m_stream_stats.reads++;
+        if (received == 0) {
+            break;
         }
         
-        sentence_buffer[buffer_pos++] = c;
+        size_t padding = 0;
+        while (m_wire->available()) {
+            uint8_t c = (uint8_t)m_wire->read();
+            // A lone LF is filler; LF after CR is the real sentence terminator
+            if (c == I2C_PADDING_BYTE && m_prev_byte != '\r') {
+                padding++;
+            } else {
+                push_byte(c);
+            }
+            m_prev_byte = c;
+        }
+        m_stream_stats.padding_bytes += padding;
         
-        // Check for sentence end (newline or carriage return)
-        if (c == '\n' || c == '\r') {
-            if (buffer_pos > 1) {  // We have a complete sentence
-                sentence_buffer[buffer_pos] = '\0';
-                
-                // Remove any trailing CR/LF
-                while (buffer_pos > 0 && (sentence_buffer[buffer_pos-1] == '\n' || 
-                                          sentence_buffer[buffer_pos-1] == '\r')) {
-                    sentence_buffer[--buffer_pos] = '\0';
-                }
-                
-                uint32_t now = millis();
-                if (now - last_i2c_debug >= 2000) {
-                    Serial.printf("[GPS-I2C] Read sentence: %d chars (attempts=%u, sentences=%u)\n", 
-                                  buffer_pos, read_attempts, successful_sentences);
-                    last_i2c_debug = now;
-                }
-                
-                // Parse the NMEA sentence if it starts with '$'
-                if (sentence_buffer[0] == '$') {
-                    successful_sentences++;
-                    parse_nmea_sentence(sentence_buffer);
+        if (padding > 0) {
+            if (m_read_size > PA1010D_I2C_MIN_READ) {
+                m_read_size /= 2;
+            }
+            break;
+        }
+        if (m_read_size < PA1010D_I2C_MAX_READ) {
+            m_read_size *= 2;
+        }
+    }
+    m_stream_stats.read_size = m_read_size;
+}
+
+void PA1010DDriver::drain_ring(int64_t read_us) {
+    while (m_rx_tail != m_rx_head) {
+        char c = (char)m_rx_ring[m_rx_tail & (PA1010D_RX_RING_SIZE - 1)];
+        m_rx_tail++;
+        
+        if (c == '$') {
+            m_sentence_len = 0;
+            m_sentence_start_us = read_us;
+        } else if (c == '\r' || c == '\n') {
+            if (m_sentence_len > 0) {
+                m_sentence[m_sentence_len] = '\0';
+                if (parse_nmea_sentence(m_sentence, m_sentence_len)) {
+                    uint32_t latency = (uint32_t)(esp_timer_get_time() - m_sentence_start_us);
+                    m_stream_stats.last_latency_us = latency;
+                    if (latency > m_stream_stats.max_latency_us) {
+                        m_stream_stats.max_latency_us = latency;
+                    }
+                    m_latency_total_us += latency;
+                    m_latency_samples++;
+                    m_stream_stats.mean_latency_us = (uint32_t)(m_latency_total_us / m_latency_samples);
                 }
-                
-                buffer_pos = 0;  // Reset for next sentence
-            } else {
-                buffer_pos = 0;  // Empty line, reset
             }
+            m_sentence_len = 0;
+            continue;
+        } else if (m_sentence_len == 0) {
+            continue;  // Noise between sentences
         }
+        
+        if (m_sentence_len >= NMEA_MAX_SENTENCE_LEN) {
+            m_stream_stats.sentence_overflows++;
+            m_sentence_len = 0;
+            continue;
+        }
+        m_sentence[m_sentence_len++] = c;
+    }
+}
+
+pa1010d_stream_stats_t PA1010DDriver::get_stream_stats() const {
+    return m_published_stats.load();
+}
+
+gps_data_t PA1010DDriver::get_data() const {
+    return m_data;
+}
+
+bool PA1010DDriver::is_valid() const {
+    return m_valid;
+}
+
+nmea_parser_stats_t PA1010DDriver::get_parser_stats() const {
+    return m_parser.get_stats();
+}
+
+bool PA1010DDriver::parse_nmea_sentence(const char* sentence, size_t len) {
+    // Command acknowledgements are only interesting while configure() waits for them
+    if (len > 5 && strncmp(sentence, "$PMTK", 5) == 0) {
+        return NmeaParser::parse_pmtk_ack(sentence, len, &m_last_ack_cmd, &m_last_ack_flag);
     }
     
-    // Prevent buffer overflow
-    if (buffer_pos >= 255) {
-        uint32_t now = millis();
-        if (now - last_i2c_debug >= 2000) {
-            Serial.printf("[GPS-I2C] Buffer overflow, resetting (attempts=%u, sentences=%u)\n", 
-                          read_attempts, successful_sentences);
-            last_i2c_debug = now;
-        }
-        buffer_pos = 0;
+    nmea_sentence_t type = m_parser.parse(sentence, len, m_data);
+    m_valid = m_data.valid;
+    
+    // One RMC per epoch, whichever talker the module uses; its arrival time
+    // is what TimeBase relates to the epoch's UTC
+    if (type == NMEA_SENTENCE_RMC) {
+        m_data.fix_time_us = m_sentence_start_us;
+        count_fix();
     }
     
-    return true;  // Successfully queried I2C
+    return type != NMEA_SENTENCE_NONE;
 }
@@ -0,0 +1,20 @@
+#ifndef FLASH_DEVICE_H
+#define FLASH_DEVICE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Raw NOR flash region (erase sets bytes to 0xFF, writes only clear bits)
+ */
+class IFlashDevice {
+public:
+    virtual ~IFlashDevice() = default;
+    virtual uint32_t size() const = 0;
+    virtual uint32_t sector_size() const = 0;
+    virtual bool read(uint32_t offset, void* dst, size_t len) = 0;
+    virtual bool write(uint32_t offset, const void* src, size_t len) = 0;
+    virtual bool erase_sector(uint32_t sector) = 0;
+};
+
+#endif // FLASH_DEVICE_H
@@ -0,0 +1,119 @@
+#ifndef FLASH_LOG_RING_H
+#define FLASH_LOG_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include "flash_device.h"
+#include "log_block.h"
+
+// Sectors kept erased ahead of the write head: one worst-case block
+// (16 KB buffer + LZ4 overhead + headers)
+#define FLASH_RING_ERASE_AHEAD_SECTORS  5
+
+// Invalid sectors tolerated after the head on mount: the erase-ahead run plus
+// one sector whose erase or header write was cut by power loss
+#define FLASH_RING_MAX_GAP_SECTORS      (FLASH_RING_ERASE_AHEAD_SECTORS + 2)
+
+/**
+ * @brief Flash ring statistics
+ */
+struct flash_ring_stats_t {
+    uint32_t head_sequence;     // Sequence number of the sector being filled
+    uint32_t write_offset;      // Next byte written
+    uint32_t tail_offset;       // Start of the oldest sector still holding data
+    uint32_t tail_sequence;     // Sequence number of that sector
+    uint32_t sectors_erased;
+    uint32_t erase_stalls;      // Sectors append() had to erase itself (erase-ahead fell behind)
+    uint32_t flash_errors;      // Failed erase/write operations
+    uint32_t mount_reads;       // Sector headers read since the last mount()
+};
+
+/**
+ * @brief Circular, crash-safe log over a raw flash region
+ *
+ * Every sector starts with a log_sector_header_t carrying a sequence number
+ * that grows by one per sector, so around the ring the sequence climbs from
+ * the tail to the head and drops back once. mount() finds the head with a
+ * binary search over sector headers (~log2(sectors) reads instead of a full
+ * scan) and the tail just past the erased gap that follows it.
+ *
+ * Entries are appended as opaque byte runs that may cross sector boundaries.
+ * Power loss can leave a truncated entry or a torn sector header; mount()
+ * treats the torn sector as erased and writing resumes at the next sector,
+ * so a truncated entry is never extended. Readers resynchronise through
+ * first_entry in the following sector.
+ *
+ * Not thread safe: mount(), append() and erase_ahead() belong to one task.
+ * Portable (no ESP-IDF dependencies) so the native tests run it against
+ * RamFlashDevice (lib/RamFlash).
+ */
+class FlashLogRing {
+public:
+    /**
+     * @brief Constructor
+     * @param device Flash region, must outlive the ring
+     */
+    explicit FlashLogRing(IFlashDevice* device);
+
+    /**
+     * @brief Recover head and tail from the sector headers
+     * An unformatted region (no valid headers) mounts empty.
+     * @return false if the device is too small for the ring
+     */
+    bool mount();
+
+    /**
+     * @brief Append one entry
+     * @param data Entry bytes
+     * @param len Entry length (less than the ring size minus the erase-ahead run)
+     * @param offset Output, where the entry starts (may be nullptr)
+     * @return false on a flash error; the next entry then starts a fresh sector
+     */
+    bool append(const void* data, size_t len, uint32_t* offset = nullptr);
+
+    /**
+     * @brief Erase sectors ahead of the write head (call when the writer is idle)
+     * @param max_sectors Upper bound on erases this call
+     * @return Sectors erased
+     */
+    uint32_t erase_ahead(uint32_t max_sectors = 1);
+
+    /**
+     * @brief Read and validate one sector header
+     * @return true if magic and CRC check out
+     */
+    bool read_sector_header(uint32_t sector, log_sector_header_t* header);
+
+    bool is_mounted() const;
+    uint32_t get_sector_count() const;
+    flash_ring_stats_t get_stats() const;
+
+private:
+    IFlashDevice* m_device;
+    uint32_t m_sector_size;
+    uint32_t m_sector_count;
+    bool m_mounted;
+
+    // Write head
+    bool m_open;                // Head sector has room and its header is written
+    uint32_t m_head_sector;     // Last sector opened
+    uint32_t m_head_pos;        // Next byte within the head sector
+    uint32_t m_sequence;        // Sequence number of the head sector
+    uint32_t m_erased_ahead;    // Sectors after the head known to be erased
+
+    // Oldest data
+    bool m_has_tail;
+    uint32_t m_tail_sector;
+
+    flash_ring_stats_t m_stats;
+
+    /**
+     * @brief Move to the next sector and write its header
+     * @param first_entry Offset of the first entry starting in it
+     */
+    bool open_sector(uint16_t first_entry);
+
+    bool erase(uint32_t sector);
+};
+
+#endif // FLASH_LOG_RING_H
@@ -0,0 +1,242 @@
+#include "flash_log_ring.h"
+#include "log_block_codec.h"
+#include <cstring>
+
+#define SECTOR_HEADER_SIZE  ((uint32_t)sizeof(log_sector_header_t))
+
+FlashLogRing::FlashLogRing(IFlashDevice* device)
+    : m_device(device), m_sector_size(0), m_sector_count(0), m_mounted(false),
+      m_open(false), m_head_sector(0), m_head_pos(0), m_sequence(0), m_erased_ahead(0),
+      m_has_tail(false), m_tail_sector(0) {
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+bool FlashLogRing::read_sector_header(uint32_t sector, log_sector_header_t* header) {
+    log_sector_header_t h;
+    m_stats.mount_reads++;
+    if (sector >= m_sector_count || !m_device->read(sector * m_sector_size, &h, sizeof(h))) {
+        return false;
+    }
+    if (h.magic != LOG_SECTOR_MAGIC ||
+        h.crc32 != log_crc32(0, (const uint8_t*)&h, sizeof(h) - sizeof(h.crc32))) {
+        return false;
+    }
+    if (header) {
+        *header = h;
+    }
+    return true;
+}
+
+bool FlashLogRing::mount() {
+    m_mounted = false;
+    if (!m_device || m_device->sector_size() <= SECTOR_HEADER_SIZE) {
+        return false;
+    }
+    m_sector_size = m_device->sector_size();
+    m_sector_count = m_device->size() / m_sector_size;
+    if (m_sector_count < FLASH_RING_MAX_GAP_SECTORS * 2) {
+        return false;
+    }
+
+    uint32_t stalls = m_stats.erase_stalls;
+    uint32_t errors = m_stats.flash_errors;
+    uint32_t erased = m_stats.sectors_erased;
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_stats.erase_stalls = stalls;
+    m_stats.flash_errors = errors;
+    m_stats.sectors_erased = erased;
+
+    // Nothing after the head is trusted to be erased until erase_ahead() runs again
+    m_open = false;
+    m_erased_ahead = 0;
+
+    // Only the gap after the head can be invalid, so a valid sector lies
+    // within the first gap's worth (unless the region is unformatted)
+    log_sector_header_t header;
+    uint32_t base = m_sector_count;
+    uint32_t base_sequence = 0;
+    for (uint32_t i = 0; i < FLASH_RING_MAX_GAP_SECTORS; i++) {
+        if (read_sector_header(i, &header)) {
+            base = i;
+            base_sequence = header.sequence;
+            break;
+        }
+    }
+    if (base == m_sector_count) {
+        m_head_sector = m_sector_count - 1;     // First sector opened is 0
+        m_sequence = 0;
+        m_has_tail = false;
+        m_mounted = true;
+        return true;
+    }
+
+    // From base the sectors run base_sequence, +1, +2 ... up to the head, then
+    // hit the erased gap or an older lap: binary search for the last match
+    uint32_t lo = 0;
+    uint32_t hi = m_sector_count;
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (read_sector_header((base + mid) % m_sector_count, &header) &&
+            header.sequence == base_sequence + mid) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    m_head_sector = (base + lo) % m_sector_count;
+    m_sequence = base_sequence + lo;
+
+    // The tail is the first valid sector past the gap; if none, the ring has
+    // not wrapped and the data starts at base
+    m_has_tail = true;
+    m_tail_sector = base;
+    for (uint32_t i = 1; i <= FLASH_RING_MAX_GAP_SECTORS && i < m_sector_count - lo; i++) {
+        uint32_t sector = (m_head_sector + i) % m_sector_count;
+        if (read_sector_header(sector, &header)) {
+            m_tail_sector = sector;
+            break;
+        }
+    }
+
+    m_mounted = true;
+    return true;
+}
+
+bool FlashLogRing::erase(uint32_t sector) {
+    if (!m_device->erase_sector(sector)) {
+        m_stats.flash_errors++;
+        return false;
+    }
+    m_stats.sectors_erased++;
+
+    // Erasing the oldest sector moves the tail forward
+    if (m_has_tail && sector == m_tail_sector) {
+        m_tail_sector = (m_tail_sector + 1) % m_sector_count;
+    }
+    return true;
+}
+
+uint32_t FlashLogRing::erase_ahead(uint32_t max_sectors) {
+    uint32_t done = 0;
+    while (m_mounted && done < max_sectors && m_erased_ahead < FLASH_RING_ERASE_AHEAD_SECTORS) {
+        uint32_t sector = (m_head_sector + 1 + m_erased_ahead) % m_sector_count;
+        if (!erase(sector)) {
+            break;
+        }
+        m_erased_ahead++;
+        done++;
+    }
+    return done;
+}
+
+bool FlashLogRing::open_sector(uint16_t first_entry) {
+    uint32_t next = (m_head_sector + 1) % m_sector_count;
+    if (m_erased_ahead > 0) {
+        m_erased_ahead--;
+    } else {
+        m_stats.erase_stalls++;
+        if (!erase(next)) {
+            return false;
+        }
+    }
+
+    log_sector_header_t header;
+    header.magic = LOG_SECTOR_MAGIC;
+    header.sequence = m_sequence + 1;
+    header.first_entry = first_entry;
+    header.reserved = 0xFFFF;
+    header.crc32 = log_crc32(0, (const uint8_t*)&header, sizeof(header) - sizeof(header.crc32));
+
+    // A sector without a valid header must not join the run: mount() would
+    // end the run there and erase-ahead would then destroy the newer sectors
+    // after it. Erase and rewrite once; if that fails too, the head and
+    // sequence stay put and the next open_sector() erases the sector again.
+    bool written = m_device->write(next * m_sector_size, &header, sizeof(header));
+    if (!written) {
+        m_stats.flash_errors++;
+        if (erase(next)) {
+            written = m_device->write(next * m_sector_size, &header, sizeof(header));
+            if (!written) {
+                m_stats.flash_errors++;
+            }
+        }
+    }
+    if (!written) {
+        m_erased_ahead = 0;     // Sectors past a dirty one are erased again before use
+        m_open = false;
+        return false;
+    }
+
+    m_head_sector = next;
+    m_sequence++;
+    if (!m_has_tail) {
+        m_has_tail = true;
+        m_tail_sector = next;
+    }
+    m_head_pos = SECTOR_HEADER_SIZE;
+    m_open = true;
+    return true;
+}
+
+bool FlashLogRing::append(const void* data, size_t len, uint32_t* offset) {
+    uint32_t payload_per_sector = m_sector_size - SECTOR_HEADER_SIZE;
+    uint32_t max_len = (m_sector_count - FLASH_RING_MAX_GAP_SECTORS) * payload_per_sector;
+    if (!m_mounted || !data || len == 0 || len > max_len) {
+        return false;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    size_t done = 0;
+    while (done < len) {
+        if (!m_open || m_head_pos >= m_sector_size) {
+            // A sector opened mid-entry records where the next entry will start
+            uint32_t first = SECTOR_HEADER_SIZE + (uint32_t)(len - done);
+            if (done == 0) {
+                first = SECTOR_HEADER_SIZE;
+            } else if (first >= m_sector_size) {
+                first = LOG_SECTOR_NO_ENTRY;
+            }
+            if (!open_sector((uint16_t)first)) {
+                return false;
+            }
+        }
+
+        if (done == 0 && offset) {
+            *offset = m_head_sector * m_sector_size + m_head_pos;
+        }
+
+        size_t chunk = len - done;
+        if (chunk > m_sector_size - m_head_pos) {
+            chunk = m_sector_size - m_head_pos;
+        }
+        if (!m_device->write(m_head_sector * m_sector_size + m_head_pos, bytes + done, chunk)) {
+            // Never write after a failed write: the next entry starts a fresh sector
+            m_stats.flash_errors++;
+            m_open = false;
+            return false;
+        }
+        m_head_pos += (uint32_t)chunk;
+        done += chunk;
+    }
+    return true;
+}
+
+bool FlashLogRing::is_mounted() const {
+    return m_mounted;
+}
+
+uint32_t FlashLogRing::get_sector_count() const {
+    return m_sector_count;
+}
+
+flash_ring_stats_t FlashLogRing::get_stats() const {
+    flash_ring_stats_t stats = m_stats;
+    stats.head_sequence = m_sequence;
+    stats.write_offset = m_open ? m_head_sector * m_sector_size + m_head_pos
+                                : ((m_head_sector + 1) % (m_sector_count ? m_sector_count : 1)) * m_sector_size;
+    stats.tail_offset = m_has_tail ? m_tail_sector * m_sector_size : stats.write_offset;
+    // Sectors and sequence numbers advance together, so the tail's sequence follows from its distance to the head
+    stats.tail_sequence = m_has_tail ? m_sequence - (m_head_sector + m_sector_count - m_tail_sector) % m_sector_count
+                                     : m_sequence + 1;
+    return stats;
+}
@@ -0,0 +1,64 @@
+#ifndef LOG_BLOCK_CODEC_H
+#define LOG_BLOCK_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include "log_block.h"
+
+/**
+ * @brief Block framing for the logging partition
+ * Turns an acquisition buffer into [log_block_header_t | LZ4 payload]
+ * exactly as described in docs/LOG_FORMAT.md. Portable (no ESP-IDF
+ * dependencies) so framing and throughput can be exercised natively.
+ */
+
+/**
+ * @brief CRC32 (IEEE 802.3, reflected) - same result as esp_crc32_le(0, ...)
+ * @param crc Running CRC (0 to start)
+ * @param data Input bytes
+ * @param len Input length
+ * @return Updated CRC
+ */
+uint32_t log_crc32(uint32_t crc, const uint8_t* data, size_t len);
+
+/**
+ * @brief Maximum encoded size (header + worst-case payload) for an input size
+ */
+size_t log_block_max_encoded_size(size_t raw_len);
+
+/**
+ * @brief Compress a buffer and frame it as a log block
+ * @param raw Uncompressed record bytes
+ * @param raw_len Uncompressed size (<= LZ4_BLOCK_MAX_INPUT_SIZE)
+ * @param startup_id Session UUID (16 bytes)
+ * @param timestamp_us esp_timer_get_time() when the buffer was closed
+ * @param out Output buffer for header + payload
+ * @param out_cap Output capacity (use log_block_max_encoded_size())
+ * @param hash_table LZ4 scratch table (LZ4_BLOCK_HASH_ENTRIES entries)
+ * @return Total encoded size, or 0 on failure
+ */
+size_t log_block_encode(const uint8_t* raw, size_t raw_len,
+                        const uint8_t startup_id[16], int64_t timestamp_us,
+                        uint8_t* out, size_t out_cap, uint16_t* hash_table);
+
+/**
+ * @brief Validate a block header and its payload CRC
+ * @param data Pointer to a candidate header followed by its payload
+ * @param avail Bytes available at data
+ * @param header Output copy of the header (may be nullptr)
+ * @return true if magic, version, sizes and CRC all check out
+ */
+bool log_block_validate(const uint8_t* data, size_t avail, log_block_header_t* header);
+
+/**
+ * @brief Decompress a validated block payload
+ * @param header Block header
+ * @param payload Compressed payload (header->compressed_size bytes)
+ * @param out Output buffer
+ * @param out_cap Output capacity (>= header->uncompressed_size)
+ * @return true if the payload decompressed to exactly uncompressed_size bytes
+ */
+bool log_block_decode(const log_block_header_t* header, const uint8_t* payload,
+                      uint8_t* out, size_t out_cap);
+
+#endif // LOG_BLOCK_CODEC_H
@@ -0,0 +1,117 @@
+#ifndef LOG_RECORDS_H
+#define LOG_RECORDS_H
+
+#include <cstdint>
+
+/**
+ * @brief Log record payload layouts
+ * Mirrors docs/RECORD_SCHEMA.md. Every record starts with
+ * msg_type + timestamp_offset_us (µs since session start), little-endian.
+ */
+
+#define LOG_RECORD_IMU      0x01
+#define LOG_RECORD_GPS      0x02
+#define LOG_RECORD_CAN      0x03
+#define LOG_RECORD_COMPASS  0x04
+#define LOG_RECORD_TIME_SYNC 0x05
+
+/**
+ * @brief IMU record (0x01) - accel in m/s^2, gyro in deg/s
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  msg_type;
+    uint64_t timestamp_offset_us;
+    float    accel_x;
+    float    accel_y;
+    float    accel_z;
+    float    gyro_x;
+    float    gyro_y;
+    float    gyro_z;
+} imu_record_t;
+
+/**
+ * @brief GPS record (0x02) - parsed fix
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  msg_type;
+    uint64_t timestamp_offset_us;
+    double   latitude;
+    double   longitude;
+    float    altitude_m;
+    uint8_t  fix_type;            // 0=none, 1=2D, 2=3D
+    uint8_t  num_sats;
+    float    hdop;
+} gps_record_t;
+
+/**
+ * @brief CAN frame record (0x03)
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  msg_type;
+    uint64_t timestamp_offset_us;
+    uint32_t can_id;              // 11- or 29-bit identifier
+    uint8_t  dlc;                 // 0-8
+    uint8_t  flags;               // bit0=extended_id, bit1=remote_frame
+    uint8_t  data[8];
+} can_record_t;
+
+/**
+ * @brief Compass record (0x04) - bearing in degrees 0.0-360.0
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  msg_type;
+    uint64_t timestamp_offset_us;
+    float    bearing_deg;
+} compass_record_t;
+
+/**
+ * @brief Time sync record (0x05) - UTC at the record's timestamp
+ * UTC(t) = utc_us + (t - timestamp_offset_us) * (1 + drift_ppm / 1e6),
+ * valid until the next time sync record.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  msg_type;
+    uint64_t timestamp_offset_us;
+    int64_t  utc_us;              // µs since the Unix epoch
+    float    drift_ppm;           // Local clock rate error relative to GPS
+    uint32_t uncertainty_us;
+    uint8_t  source;              // 1=GPS NMEA arrival, 2=GPS PPS
+} time_sync_record_t;
+
+static_assert(sizeof(imu_record_t) == 33, "imu_record_t must match RECORD_SCHEMA.md");
+static_assert(sizeof(gps_record_t) == 35, "gps_record_t must match RECORD_SCHEMA.md");
+static_assert(sizeof(can_record_t) == 23, "can_record_t must match RECORD_SCHEMA.md");
+static_assert(sizeof(compass_record_t) == 13, "compass_record_t must match RECORD_SCHEMA.md");
+static_assert(sizeof(time_sync_record_t) == 26, "time_sync_record_t must match RECORD_SCHEMA.md");
+
+/**
+ * @brief Any record, sized for the largest type
+ * Used as the fixed-size slot type when records are queued in memory;
+ * msg_type aliases the first byte of every layout.
+ */
+typedef union {
+    uint8_t          msg_type;
+    imu_record_t     imu;
+    gps_record_t     gps;
+    can_record_t     can;
+    compass_record_t compass;
+    time_sync_record_t time_sync;
+} log_record_any_t;
+
+/**
+ * @brief Payload size for a record type (including the common prefix)
+ * @param msg_type Record type byte
+ * @return Record size in bytes, or 0 for unknown types
+ */
+inline uint32_t log_record_size(uint8_t msg_type) {
+    switch (msg_type) {
+        case LOG_RECORD_IMU:     return sizeof(imu_record_t);
+        case LOG_RECORD_GPS:     return sizeof(gps_record_t);
+        case LOG_RECORD_CAN:     return sizeof(can_record_t);
+        case LOG_RECORD_COMPASS: return sizeof(compass_record_t);
+        case LOG_RECORD_TIME_SYNC: return sizeof(time_sync_record_t);
+        default:                 return 0;
+    }
+}
+
+#endif // LOG_RECORDS_H
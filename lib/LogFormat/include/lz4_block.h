@@ -0,0 +1,57 @@
+#ifndef LZ4_BLOCK_H
+#define LZ4_BLOCK_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Minimal LZ4 block-format codec
+ * Produces standard LZ4 raw blocks (no frame header) so any LZ4 decoder
+ * can read the payloads. Portable C++ with no ESP-IDF dependencies, so it
+ * also builds under the native test environment.
+ *
+ * Input is limited to 64 KB per block, which lets the match finder keep
+ * 16-bit positions in a small hash table (8 KB).
+ */
+
+// Largest input accepted by lz4_compress_block()
+#define LZ4_BLOCK_MAX_INPUT_SIZE    65535
+
+// Hash table geometry used by the compressor
+#define LZ4_BLOCK_HASH_LOG          12
+#define LZ4_BLOCK_HASH_ENTRIES      (1u << LZ4_BLOCK_HASH_LOG)
+
+/**
+ * @brief Worst-case compressed size for a given input size
+ * @param src_len Uncompressed size in bytes
+ * @return Output buffer size guaranteeing compression cannot fail
+ */
+inline size_t lz4_compress_bound(size_t src_len) {
+    return src_len + (src_len / 255) + 16;
+}
+
+/**
+ * @brief Compress one buffer into an LZ4 block
+ * @param src Uncompressed input
+ * @param src_len Input size (<= LZ4_BLOCK_MAX_INPUT_SIZE)
+ * @param dst Output buffer
+ * @param dst_cap Output buffer capacity
+ * @param hash_table Scratch table of LZ4_BLOCK_HASH_ENTRIES entries (reset internally)
+ * @return Compressed size in bytes, or 0 if the input is too large or dst too small
+ */
+size_t lz4_compress_block(const uint8_t* src, size_t src_len,
+                          uint8_t* dst, size_t dst_cap,
+                          uint16_t* hash_table);
+
+/**
+ * @brief Decompress one LZ4 block with full bounds checking
+ * @param src Compressed block
+ * @param src_len Compressed size in bytes
+ * @param dst Output buffer
+ * @param dst_cap Output buffer capacity
+ * @return Decompressed size in bytes, or -1 if the block is malformed or dst too small
+ */
+int32_t lz4_decompress_block(const uint8_t* src, size_t src_len,
+                             uint8_t* dst, size_t dst_cap);
+
+#endif // LZ4_BLOCK_H
@@ -0,0 +1,104 @@
+#include "log_block_codec.h"
+#include "lz4_block.h"
+#include <cstring>
+
+// Upper bound on a sane block payload (acquisition buffers are 16 KB)
+#define LOG_BLOCK_MAX_PAYLOAD   LZ4_BLOCK_MAX_INPUT_SIZE
+
+/**
+ * @brief Build the 256-entry CRC32 lookup table at compile time
+ */
+struct crc32_table_t {
+    uint32_t entries[256];
+
+    constexpr crc32_table_t() : entries() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            entries[i] = c;
+        }
+    }
+};
+
+static constexpr crc32_table_t CRC32_TABLE;
+
+uint32_t log_crc32(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = CRC32_TABLE.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+size_t log_block_max_encoded_size(size_t raw_len) {
+    return sizeof(log_block_header_t) + lz4_compress_bound(raw_len);
+}
+
+size_t log_block_encode(const uint8_t* raw, size_t raw_len,
+                        const uint8_t startup_id[16], int64_t timestamp_us,
+                        uint8_t* out, size_t out_cap, uint16_t* hash_table) {
+    if (!raw || !out || out_cap < sizeof(log_block_header_t)) {
+        return 0;
+    }
+
+    uint8_t* payload = out + sizeof(log_block_header_t);
+    size_t compressed = lz4_compress_block(raw, raw_len, payload,
+                                           out_cap - sizeof(log_block_header_t), hash_table);
+    if (compressed == 0) {
+        return 0;
+    }
+
+    log_block_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = LOG_BLOCK_MAGIC;
+    header.version = LOG_BLOCK_VERSION;
+    if (startup_id) {
+        memcpy(header.startup_id, startup_id, sizeof(header.startup_id));
+    }
+    header.timestamp_us = timestamp_us;
+    header.uncompressed_size = (uint32_t)raw_len;
+    header.compressed_size = (uint32_t)compressed;
+    header.crc32 = log_crc32(0, payload, compressed);
+
+    memcpy(out, &header, sizeof(header));
+    return sizeof(header) + compressed;
+}
+
+bool log_block_validate(const uint8_t* data, size_t avail, log_block_header_t* header) {
+    if (!data || avail < sizeof(log_block_header_t)) {
+        return false;
+    }
+
+    log_block_header_t h;
+    memcpy(&h, data, sizeof(h));
+
+    if (h.magic != LOG_BLOCK_MAGIC || h.version != LOG_BLOCK_VERSION) {
+        return false;
+    }
+    if (h.compressed_size == 0 || h.compressed_size > lz4_compress_bound(LOG_BLOCK_MAX_PAYLOAD) ||
+        h.uncompressed_size > LOG_BLOCK_MAX_PAYLOAD) {
+        return false;
+    }
+    if (avail - sizeof(h) < h.compressed_size) {
+        return false;
+    }
+    if (log_crc32(0, data + sizeof(h), h.compressed_size) != h.crc32) {
+        return false;
+    }
+
+    if (header) {
+        *header = h;
+    }
+    return true;
+}
+
+bool log_block_decode(const log_block_header_t* header, const uint8_t* payload,
+                      uint8_t* out, size_t out_cap) {
+    if (!header || !payload || out_cap < header->uncompressed_size) {
+        return false;
+    }
+    int32_t n = lz4_decompress_block(payload, header->compressed_size, out, out_cap);
+    return n >= 0 && (uint32_t)n == header->uncompressed_size;
+}
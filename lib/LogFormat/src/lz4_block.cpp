@@ -0,0 +1,214 @@
+#include "lz4_block.h"
+#include <cstring>
+
+// LZ4 block format constants
+#define LZ4_MIN_MATCH       4
+#define LZ4_LAST_LITERALS   5   // Last 5 bytes are always literals
+#define LZ4_MF_LIMIT        12  // A match cannot start within the last 12 bytes
+#define LZ4_MAX_OFFSET      65535
+#define LZ4_SKIP_TRIGGER    6   // Search step grows every 64 unmatched bytes
+
+static inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t hash32(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - LZ4_BLOCK_HASH_LOG);
+}
+
+static inline uint8_t* write_length(uint8_t* op, size_t len) {
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = (uint8_t)len;
+    return op;
+}
+
+/**
+ * @brief Emit one sequence (literals followed by an optional match)
+ * @return New output pointer, or nullptr if the output would overflow
+ */
+static uint8_t* emit_sequence(uint8_t* op, uint8_t* oend,
+                              const uint8_t* literals, size_t literal_len,
+                              size_t offset, size_t match_len) {
+    // Worst case: token + literal length bytes + literals + offset + match length bytes
+    size_t worst = 1 + (literal_len / 255) + 1 + literal_len +
+                   (match_len ? 2 + (match_len / 255) + 1 : 0);
+    if ((size_t)(oend - op) < worst) {
+        return nullptr;
+    }
+
+    uint8_t* token = op++;
+    if (literal_len >= 15) {
+        *token = 15 << 4;
+        op = write_length(op, literal_len - 15);
+    } else {
+        *token = (uint8_t)(literal_len << 4);
+    }
+
+    memcpy(op, literals, literal_len);
+    op += literal_len;
+
+    if (match_len == 0) {
+        return op;  // Final literal-only sequence
+    }
+
+    *op++ = (uint8_t)(offset & 0xFF);
+    *op++ = (uint8_t)(offset >> 8);
+
+    size_t ml = match_len - LZ4_MIN_MATCH;
+    if (ml >= 15) {
+        *token |= 15;
+        op = write_length(op, ml - 15);
+    } else {
+        *token |= (uint8_t)ml;
+    }
+    return op;
+}
+
+size_t lz4_compress_block(const uint8_t* src, size_t src_len,
+                          uint8_t* dst, size_t dst_cap,
+                          uint16_t* hash_table) {
+    if (!src || !dst || !hash_table || src_len > LZ4_BLOCK_MAX_INPUT_SIZE) {
+        return 0;
+    }
+
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + dst_cap;
+    size_t anchor = 0;
+
+    if (src_len > LZ4_MF_LIMIT) {
+        // Table stores position + 1 so that 0 means "empty"
+        memset(hash_table, 0, LZ4_BLOCK_HASH_ENTRIES * sizeof(uint16_t));
+
+        const size_t match_start_limit = src_len - LZ4_MF_LIMIT;
+        const size_t match_end_limit = src_len - LZ4_LAST_LITERALS;
+        size_t ip = 0;
+
+        while (ip <= match_start_limit) {
+            uint32_t sequence = read32(src + ip);
+            uint32_t h = hash32(sequence);
+            size_t candidate = hash_table[h];
+            hash_table[h] = (uint16_t)(ip + 1);
+
+            if (candidate == 0 || (ip - (candidate - 1)) > LZ4_MAX_OFFSET ||
+                read32(src + candidate - 1) != sequence) {
+                // No match: advance faster through incompressible data
+                ip += 1 + ((ip - anchor) >> LZ4_SKIP_TRIGGER);
+                continue;
+            }
+
+            size_t ref = candidate - 1;
+
+            // Extend the match backwards into pending literals
+            while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+                ip--;
+                ref--;
+            }
+
+            // Extend the match forwards
+            size_t match_len = LZ4_MIN_MATCH;
+            while (ip + match_len < match_end_limit && src[ip + match_len] == src[ref + match_len]) {
+                match_len++;
+            }
+
+            op = emit_sequence(op, oend, src + anchor, ip - anchor, ip - ref, match_len);
+            if (!op) {
+                return 0;
+            }
+
+            ip += match_len;
+            anchor = ip;
+
+            // Seed the table with a position inside the match for better ratio
+            if (ip >= 2 && ip - 2 <= match_start_limit) {
+                hash_table[hash32(read32(src + ip - 2))] = (uint16_t)(ip - 2 + 1);
+            }
+        }
+    }
+
+    // Trailing literals
+    op = emit_sequence(op, oend, src + anchor, src_len - anchor, 0, 0);
+    if (!op) {
+        return 0;
+    }
+
+    return (size_t)(op - dst);
+}
+
+int32_t lz4_decompress_block(const uint8_t* src, size_t src_len,
+                             uint8_t* dst, size_t dst_cap) {
+    if (!src || !dst) {
+        return -1;
+    }
+
+    const uint8_t* ip = src;
+    const uint8_t* const iend = src + src_len;
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + dst_cap;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+
+        // Literal run
+        size_t literal_len = token >> 4;
+        if (literal_len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= iend) return -1;
+                b = *ip++;
+                literal_len += b;
+            } while (b == 255);
+        }
+
+        if ((size_t)(iend - ip) < literal_len || (size_t)(oend - op) < literal_len) {
+            return -1;
+        }
+        memcpy(op, ip, literal_len);
+        ip += literal_len;
+        op += literal_len;
+
+        if (ip == iend) {
+            break;  // Last sequence carries literals only
+        }
+
+        // Match copy
+        if (iend - ip < 2) return -1;
+        size_t offset = ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) {
+            return -1;
+        }
+
+        size_t match_len = token & 0x0F;
+        if (match_len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= iend) return -1;
+                b = *ip++;
+                match_len += b;
+            } while (b == 255);
+        }
+        match_len += LZ4_MIN_MATCH;
+
+        if ((size_t)(oend - op) < match_len) {
+            return -1;
+        }
+
+        const uint8_t* match = op - offset;
+        if (offset >= match_len) {
+            memcpy(op, match, match_len);
+            op += match_len;
+        } else {
+            // Overlapping copy replicates the pattern byte by byte
+            for (size_t i = 0; i < match_len; i++) {
+                *op++ = *match++;
+            }
+        }
+    }
+
+    return (int32_t)(op - dst);
+}
@@ -2,10 +2,28 @@
 #define RT_LOGGER_THREAD_H
 
 #include "sensor_hal.h"
+#include "log_record_ring.h"
+#include "seqlock.h"
+#include "sample_scheduler.h"
+#include "time_base.h"
 #include <cstdint>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
+class LogBlockWriter;
+
+/**
+ * @brief Sampling loop busy time (wake-up to end of iteration)
+ */
+struct rt_loop_stats_t {
+    uint32_t iterations;
+    uint32_t last_us;
+    uint32_t max_us;            // Worst iteration since start
+    uint32_t mean_us;
+    uint32_t budget_us;         // Shortest sensor period: iterations must finish within it
+    uint32_t over_budget;       // Iterations that took longer than budget_us
+};
+
 /**
  * @brief Real-Time Logger Thread
  * Manages continuous sensor data collection and storage
@@ -14,14 +32,17 @@ class RTLoggerThread {
 public:
     /**
      * @brief Constructor
+     * Each sensor class is paced by its own esp_timer (see SampleScheduler).
      * @param sensor_manager Initialized SensorManager instance
-     * @param update_rate_ms Main loop update frequency in milliseconds
-     * @param gps_rate_ms GPS update frequency in milliseconds (0 = use main rate)
-     * @param imu_rate_ms IMU update frequency in milliseconds (0 = use main rate)
-     * @param obd_rate_ms OBD update frequency in milliseconds (0 = use main rate)
+     * @param main_loop_hz Housekeeping rate
+     * @param gps_hz GPS update rate in Hz (0 = use main rate)
+     * @param imu_hz IMU update rate in Hz (0 = use main rate)
+     * @param obd_hz OBD update rate in Hz (0 = use main rate)
+     * @param battery_hz Battery update rate in Hz (0 = use main rate)
      */
-    RTLoggerThread(SensorManager* sensor_manager, uint32_t update_rate_ms = 100,
-                   uint32_t gps_rate_ms = 0, uint32_t imu_rate_ms = 0, uint32_t obd_rate_ms = 0);
+    RTLoggerThread(SensorManager* sensor_manager, uint16_t main_loop_hz = 10,
+                   uint16_t gps_hz = 0, uint16_t imu_hz = 0, uint16_t obd_hz = 0,
+                   uint16_t battery_hz = 1);
     
     ~RTLoggerThread();
     
@@ -44,28 +65,41 @@ public:
                                                       const gyro_data_t&, const compass_data_t&,
                                                       const battery_data_t&));
     
+    /**
+     * @brief Attach the block writer that receives every sample as a log record
+     * Registers this thread's record ring as a writer source; samples are
+     * pushed lock-free and drained in batches by the writer.
+     * @param writer Started LogBlockWriter (nullptr to disable flash logging)
+     */
+    void set_block_writer(LogBlockWriter* writer);
+    
     /**
      * @brief Get the latest GPS data
+     * Safe from any task; never returns a partially updated struct.
      */
     gps_data_t get_last_gps() const;
     
     /**
      * @brief Get the latest accelerometer data
+     * Safe from any task; never returns a partially updated struct.
      */
     accel_data_t get_last_accel() const;
     
     /**
      * @brief Get the latest gyroscope data
+     * Safe from any task; never returns a partially updated struct.
      */
     gyro_data_t get_last_gyro() const;
     
     /**
      * @brief Get the latest compass data
+     * Safe from any task; never returns a partially updated struct.
      */
     compass_data_t get_last_compass() const;
     
     /**
      * @brief Get the latest battery data
+     * Safe from any task; never returns a partially updated struct.
      */
     battery_data_t get_last_battery() const;
     
@@ -74,6 +108,17 @@ public:
      */
     uint32_t get_sample_count() const;
     
+    /**
+     * @brief Get sampling loop iteration time statistics
+     * Safe from any task.
+     */
+    rt_loop_stats_t get_loop_stats() const;
+    
+    /**
+     * @brief Get sampling period/jitter statistics for a sensor class
+     */
+    sample_timing_stats_t get_timing_stats(sample_class_t cls) const;
+    
     /**
      * @brief Force a storage write and report via callback
      */
@@ -102,22 +147,29 @@ public:
 
 private:
     SensorManager* m_sensor_manager;
-    uint32_t m_update_rate_ms;
-    uint32_t m_gps_rate_ms;     // GPS update rate (0 = use main rate)
-    uint32_t m_imu_rate_ms;     // IMU update rate (0 = use main rate)
-    uint32_t m_obd_rate_ms;     // OBD update rate (0 = use main rate)
+    uint16_t m_rates_hz[SAMPLE_CLASS_COUNT];    // Per-class rates, indexed by sample_class_t
+    SampleScheduler m_scheduler;
     TaskHandle_t m_task_handle;
     bool m_running;
     bool m_storage_paused;      // Pause storage writes
     bool m_mark_event;          // Mark next frame as event
     
-    // Latest sensor data
-    gps_data_t m_last_gps;
-    accel_data_t m_last_accel;
-    gyro_data_t m_last_gyro;
-    compass_data_t m_last_compass;
-    battery_data_t m_last_battery;
+    // Latest sensor data (written by this task, read lock-free from other cores)
+    SeqLock<gps_data_t> m_last_gps;
+    SeqLock<accel_data_t> m_last_accel;
+    SeqLock<gyro_data_t> m_last_gyro;
+    SeqLock<compass_data_t> m_last_compass;
+    SeqLock<battery_data_t> m_last_battery;
     uint32_t m_sample_count;
+    SeqLock<rt_loop_stats_t> m_loop_stats;
+    
+    // Hardware FIFO batches drained on each IMU tick
+    accel_sample_t m_accel_batch[IMU_BATCH_MAX_SAMPLES];
+    gyro_sample_t m_gyro_batch[IMU_BATCH_MAX_SAMPLES];
+    
+    // Flash log pipeline (records pushed from this task only)
+    LogBlockWriter* m_block_writer;
+    log_record_ring_t m_record_ring;
     
     // Storage write callback
     void (*m_storage_write_callback)(const gps_data_t&, const accel_data_t&, 
@@ -129,6 +181,21 @@ private:
     
     // Main task loop
     void task_loop();
+    
+    // Account one iteration's busy time
+    void record_iteration(rt_loop_stats_t* stats, uint64_t* total_us, int64_t wake_us);
+    
+    // Push records for the latest samples into the record ring
+    void log_imu_record(int64_t now_us, const accel_data_t& accel, const gyro_data_t& gyro);
+    void log_gps_record(int64_t now_us, const gps_data_t& gps);
+    void log_compass_record(int64_t now_us, const compass_data_t& compass);
+    void log_time_sync_record(const time_base_state_t& state);
+    
+    // Timestamp of the last compass record (records are limited to the magnetometer rate)
+    int64_t m_last_compass_record_us;
+    
+    // Epoch of the last GPS record (one record per fix, not per poll)
+    int64_t m_last_gps_record_fix_us;
 };
 
 #endif // RT_LOGGER_THREAD_H
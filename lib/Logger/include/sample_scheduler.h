@@ -0,0 +1,108 @@
+#ifndef SAMPLE_SCHEDULER_H
+#define SAMPLE_SCHEDULER_H
+
+#include "seqlock.h"
+#include <atomic>
+#include <cstdint>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+
+/**
+ * @brief Sensor classes paced by the scheduler (one timer each)
+ */
+enum sample_class_t {
+    SAMPLE_CLASS_MAIN = 0,      // Housekeeping tick (sample count, UI broadcast)
+    SAMPLE_CLASS_GPS,
+    SAMPLE_CLASS_IMU,
+    SAMPLE_CLASS_OBD,
+    SAMPLE_CLASS_BATTERY,
+    SAMPLE_CLASS_COUNT
+};
+
+/**
+ * @brief Per-class timing statistics
+ * Jitter is |actual interval - nominal period| between consecutive samples,
+ * measured on the esp_timer_get_time() timestamps the task recorded.
+ */
+struct sample_timing_stats_t {
+    uint32_t period_us;         // Nominal period (0 = class disabled)
+    uint32_t samples;           // Samples recorded
+    uint32_t overruns;          // Timer fired again before the task serviced the previous tick
+    uint32_t max_jitter_us;     // Worst interval error
+    uint32_t mean_jitter_us;    // Average interval error
+    int64_t  last_sample_us;    // Timestamp of the most recent sample
+};
+
+/**
+ * @brief Hardware-timer sampling scheduler
+ *
+ * Runs one periodic esp_timer per sensor class. Each expiry sets that class's
+ * bit in the owning task's notification value, so the task wakes at the exact
+ * period instead of sleeping for "remaining ms" on the FreeRTOS tick.
+ * Periods are independent, so a slow GPS read does not shift the IMU grid.
+ */
+class SampleScheduler {
+public:
+    SampleScheduler();
+    ~SampleScheduler();
+
+    /**
+     * @brief Create and start the timers
+     * @param task Task to notify (must not use task notifications for anything else)
+     * @param rates_hz Rate for each sample_class_t (0 disables the class)
+     * @return true if every enabled timer started
+     */
+    bool start(TaskHandle_t task, const uint16_t rates_hz[SAMPLE_CLASS_COUNT]);
+
+    /**
+     * @brief Stop and delete all timers
+     */
+    void stop();
+
+    /**
+     * @brief Block until at least one class is due
+     * @param timeout Maximum ticks to wait
+     * @return Bitmask of due classes (bit n = sample_class_t n), 0 on timeout
+     */
+    uint32_t wait(TickType_t timeout);
+
+    /**
+     * @brief Record the timestamp a class was actually sampled at
+     * Call from the notified task only.
+     * @param cls Sensor class
+     * @param timestamp_us esp_timer_get_time() taken just before the read
+     */
+    void record_sample(sample_class_t cls, int64_t timestamp_us);
+
+    /**
+     * @brief Get timing statistics for a class
+     * Safe from any task: reads the snapshot record_sample() last published.
+     */
+    sample_timing_stats_t get_stats(sample_class_t cls) const;
+
+    /**
+     * @brief Short display name for a class ("GPS", "IMU", ...)
+     */
+    static const char* class_name(sample_class_t cls);
+
+private:
+    struct timer_slot_t {
+        SampleScheduler* owner;
+        sample_class_t cls;
+        esp_timer_handle_t timer;
+        volatile bool pending;
+        uint64_t jitter_sum_us;
+        sample_timing_stats_t stats;                // Notified task's working copy
+        SeqLock<sample_timing_stats_t> published;   // Copy for readers on the other core
+        std::atomic<uint32_t> overruns;             // Counted by the esp_timer task
+    };
+
+    TaskHandle_t m_task;
+    timer_slot_t m_slots[SAMPLE_CLASS_COUNT];
+
+    static void timer_callback(void* arg);
+    static void reset_slot(timer_slot_t& slot, sample_class_t cls);
+};
+
+#endif // SAMPLE_SCHEDULER_H
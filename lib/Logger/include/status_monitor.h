@@ -4,6 +4,7 @@
 #include "sensor_hal.h"
 #include "rt_logger_thread.h"
 #include "st7789_display.h"
+#include "pa1010d_driver.h"
 #include <cstdint>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
@@ -44,6 +45,12 @@ public:
      */
     void increment_write_count();
     
+    /**
+     * @brief Report a GPS driver's stream, fix rate and parser counters
+     * @param gps Driver sampled by the RT logger, or nullptr to leave them out
+     */
+    void set_gps_driver(const PA1010DDriver* gps);
+    
     /**
      * @brief Print current status immediately
      */
@@ -51,6 +58,7 @@ public:
 
 private:
     RTLoggerThread* m_rt_logger;
+    const PA1010DDriver* m_gps_driver;
     uint32_t m_report_interval_ms;
     TaskHandle_t m_task_handle;
     bool m_running;
@@ -2,6 +2,7 @@
 #define STORAGE_REPORTER_H
 
 #include "sensor_hal.h"
+#include "log_block_writer.h"
 #include <cstdio>
 
 /**
@@ -31,6 +32,11 @@ public:
                               const gyro_data_t& gyro, const compass_data_t& compass,
                               const battery_data_t& battery);
     
+    /**
+     * @brief Report flash block writer throughput and health
+     */
+    void report_writer_stats(const log_writer_stats_t& stats);
+    
     /**
      * @brief Print a debug message
      */
@@ -0,0 +1,54 @@
+#ifndef TELEMETRY_PUBLISHER_H
+#define TELEMETRY_PUBLISHER_H
+
+#include "rt_logger_thread.h"
+#include <cstdint>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/**
+ * @brief Telemetry Publisher Thread - Core 0
+ *
+ * Owns every live telemetry send. It ticks at the fastest client rate and,
+ * whenever a client is due, reads the RT logger's latest-value snapshots
+ * and the cached OBD data and hands one frame to the WebSocket server
+ * (which paces and throttles each client), so the sampling loop on core 1
+ * never touches WiFi, frame encoding or the heap.
+ */
+class TelemetryPublisher {
+public:
+    /**
+     * @brief Constructor
+     * @param rt_logger RTLoggerThread instance providing the sensor snapshots
+     */
+    explicit TelemetryPublisher(RTLoggerThread* rt_logger);
+
+    ~TelemetryPublisher();
+
+    /**
+     * @brief Start the publisher thread on core 0
+     * @return true if successfully started
+     */
+    bool start();
+
+    /**
+     * @brief Stop the publisher thread
+     */
+    void stop();
+
+private:
+    RTLoggerThread* m_rt_logger;
+    TaskHandle_t m_task_handle;
+    bool m_running;
+
+    // Static task function wrapper
+    static void task_wrapper(void* arg);
+
+    // Main task loop
+    void task_loop();
+
+    // Fill and send one frame from the latest snapshots
+    void publish(uint32_t now_ms, bool obd_enabled);
+};
+
+#endif // TELEMETRY_PUBLISHER_H
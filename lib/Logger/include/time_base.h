@@ -0,0 +1,165 @@
+#ifndef TIME_BASE_H
+#define TIME_BASE_H
+
+#include <cstdint>
+#include <freertos/FreeRTOS.h>
+#include "sensor_hal.h"
+#include "seqlock.h"
+
+// GPIO wired to the GPS 1PPS output (-1 = not wired, NMEA timing only)
+#ifndef TIME_BASE_PPS_PIN
+#define TIME_BASE_PPS_PIN           -1
+#endif
+
+// NMEA-only timing: fixes per measurement; the least-delayed fix of each window is used
+#define TIME_BASE_NMEA_WINDOW       10
+
+// Loop filter gains (fraction of a residual applied to offset and rate)
+#define TIME_BASE_PPS_OFFSET_GAIN   0.5f
+#define TIME_BASE_PPS_DRIFT_GAIN    0.05f
+#define TIME_BASE_NMEA_OFFSET_GAIN  0.25f
+
+// NMEA arrival jitter (ms) dwarfs a crystal's ppm error over one window, so
+// the NMEA rate is the slope since lock, taken once the baseline is this long
+#define TIME_BASE_NMEA_BASELINE_US  60000000
+
+// Crystal error bound; estimates beyond this are clamped
+#define TIME_BASE_MAX_DRIFT_PPM     500.0f
+
+// Residuals larger than this are outliers; this many in a row re-lock (step) the clock
+#define TIME_BASE_STEP_THRESHOLD_US 200000
+#define TIME_BASE_MAX_OUTLIERS      3
+
+// Without an edge for this long the clock falls back to NMEA timing
+#define TIME_BASE_PPS_TIMEOUT_US    3000000
+
+/**
+ * @brief Where the current UTC mapping came from
+ */
+enum time_source_t : uint8_t {
+    TIME_SOURCE_NONE = 0,       // Not locked
+    TIME_SOURCE_NMEA = 1,       // GPS sentence arrival times (biased by the module's output delay)
+    TIME_SOURCE_PPS  = 2        // GPS 1PPS edges (µs level)
+};
+
+/**
+ * @brief Mapping from esp_timer_get_time() to UTC
+ * UTC(t) = ref_utc_us + (t - ref_esp_us) * (1 + drift_ppm / 1e6)
+ */
+struct time_base_state_t {
+    int64_t ref_esp_us;         // Local instant of the last correction
+    int64_t ref_utc_us;         // UTC at ref_esp_us, µs since the Unix epoch
+    float drift_ppm;            // Local oscillator error relative to GPS
+    uint32_t uncertainty_us;    // Smoothed |residual| of recent corrections
+    time_source_t source;
+};
+
+/**
+ * @brief Clock service counters
+ */
+struct time_base_stats_t {
+    time_base_state_t state;
+    uint32_t corrections;       // Measurements folded into the filter
+    uint32_t steps;             // (Re-)locks that set the clock outright
+    uint32_t outliers;          // Measurements rejected as outliers
+    uint32_t pps_edges;         // 1PPS interrupts seen
+    int32_t last_residual_us;   // Measured minus predicted UTC, last correction
+};
+
+/**
+ * @brief Monotonic µs clock disciplined to GPS UTC
+ *
+ * Every log record is stamped with esp_timer_get_time() relative to the
+ * session start; this service relates that clock to UTC so IMU, GPS and OBD
+ * can be aligned in post-processing. GPS fixes (and 1PPS edges when wired)
+ * feed a two-state loop filter that tracks the offset and the crystal drift.
+ *
+ * - PPS: the edge marks the exact UTC second named by the next whole-second
+ *   fix, so each second yields one measurement good to interrupt latency.
+ * - NMEA: a fix's arrival time lags its epoch by a variable delay; the
+ *   least-delayed fix of each window is used, so sensors still share one
+ *   timeline and absolute UTC is off by the module's minimum output delay.
+ *
+ * on_gps_fix() must be called from a single task (the RT logger); readers
+ * on any task see a consistent state through a SeqLock.
+ */
+class TimeBase {
+public:
+    /**
+     * @brief Attach the PPS interrupt (if a pin is given) and reset the filter
+     * @param pps_pin GPIO connected to 1PPS, -1 for NMEA timing only
+     */
+    static void init(int pps_pin = TIME_BASE_PPS_PIN);
+
+    /**
+     * @brief Feed the latest GPS fix (RT logger task only)
+     * Repeated calls with the same fix are ignored.
+     * @return true if the UTC mapping was corrected (worth a TIME_SYNC record)
+     */
+    static bool on_gps_fix(const gps_data_t& gps);
+
+    /**
+     * @brief Whether a UTC mapping is available
+     */
+    static bool is_locked();
+
+    /**
+     * @brief Convert a local timestamp to UTC
+     * @param esp_us esp_timer_get_time() value
+     * @param utc_us Output, µs since the Unix epoch
+     * @return false if not locked
+     */
+    static bool esp_to_utc(int64_t esp_us, int64_t* utc_us);
+
+    /**
+     * @brief Convert UTC to the local timestamp it corresponds to
+     * @return false if not locked
+     */
+    static bool utc_to_esp(int64_t utc_us, int64_t* esp_us);
+
+    /**
+     * @brief UTC of a fix's epoch from its date/time fields
+     * @return µs since the Unix epoch, or -1 if the fix carries no date/time
+     */
+    static int64_t gps_fix_utc_us(const gps_data_t& gps);
+
+    /**
+     * @brief Current mapping (consistent snapshot, any task)
+     */
+    static time_base_state_t get_state();
+
+    static time_base_stats_t get_stats();
+
+private:
+    static SeqLock<time_base_state_t> m_state;
+    static time_base_state_t m_work;            // Writer's copy
+    static int64_t m_last_fix_us;               // fix_time_us of the last fix processed
+    static int64_t m_last_pps_used_us;
+    static uint8_t m_outlier_run;
+    static uint32_t m_corrections;
+    static uint32_t m_steps;
+    static uint32_t m_outliers;
+    static int32_t m_last_residual_us;
+    static int64_t m_anchor_esp_us;             // Measurement the clock was last stepped to
+    static int64_t m_anchor_utc_us;
+
+    // NMEA window: best (largest UTC - arrival) fix so far
+    static uint8_t m_window_count;
+    static int64_t m_window_esp_us;
+    static int64_t m_window_utc_us;
+
+    // Written by the PPS interrupt (64-bit, so read under the lock)
+    static portMUX_TYPE m_pps_lock;
+    static volatile int64_t m_pps_us;
+    static volatile uint32_t m_pps_edges;
+
+    static void pps_isr();
+
+    /**
+     * @brief Fold one (local, UTC) pair into the filter
+     * @return true if the mapping changed
+     */
+    static bool correct(int64_t esp_us, int64_t utc_us, time_source_t source);
+};
+
+#endif // TIME_BASE_H
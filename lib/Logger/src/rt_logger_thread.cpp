@@ -1,23 +1,41 @@
 #include "rt_logger_thread.h"
-#include "../../../lib/WiFi/include/wifi_manager.h"
+#include "log_block_writer.h"
+#include "log_records.h"
+#include "time_base.h"
 #include <Arduino.h>
 #include <cstring>
-#include <ArduinoJson.h>
-
-RTLoggerThread::RTLoggerThread(SensorManager* sensor_manager, uint32_t update_rate_ms,
-                               uint32_t gps_rate_ms, uint32_t imu_rate_ms, uint32_t obd_rate_ms)
-    : m_sensor_manager(sensor_manager), m_update_rate_ms(update_rate_ms),
-      m_gps_rate_ms(gps_rate_ms == 0 ? update_rate_ms : gps_rate_ms),
-      m_imu_rate_ms(imu_rate_ms == 0 ? update_rate_ms : imu_rate_ms),
-      m_obd_rate_ms(obd_rate_ms == 0 ? update_rate_ms : obd_rate_ms),
+#include <esp_timer.h>
+
+// Standard gravity, for converting accelerometer g to m/s^2 in IMU records
+#define STANDARD_GRAVITY 9.80665f
+
+// Sampling task: pinned to core 1, above WiFi/status work so timer wakeups are serviced promptly
+#define RT_LOGGER_TASK_STACK    4096
+#define RT_LOGGER_TASK_PRIORITY 5
+#define RT_LOGGER_TASK_CORE     1
+
+// IMU drain rate when the sensor batches samples in a hardware FIFO
+#define IMU_FIFO_DRAIN_HZ       50
+
+// Compass records follow the AK09916 100 Hz measurement rate, not the IMU rate
+#define COMPASS_RECORD_INTERVAL_US  10000
+
+RTLoggerThread::RTLoggerThread(SensorManager* sensor_manager, uint16_t main_loop_hz,
+                               uint16_t gps_hz, uint16_t imu_hz, uint16_t obd_hz,
+                               uint16_t battery_hz)
+    : m_sensor_manager(sensor_manager),
       m_task_handle(nullptr), m_running(false), m_storage_paused(false),
-      m_mark_event(false), m_sample_count(0),
-      m_storage_write_callback(nullptr) {
-    memset(&m_last_gps, 0, sizeof(m_last_gps));
-    memset(&m_last_accel, 0, sizeof(m_last_accel));
-    memset(&m_last_gyro, 0, sizeof(m_last_gyro));
-    memset(&m_last_compass, 0, sizeof(m_last_compass));
-    memset(&m_last_battery, 0, sizeof(m_last_battery));
+      m_mark_event(false), m_sample_count(0), m_block_writer(nullptr),
+      m_storage_write_callback(nullptr), m_last_compass_record_us(0),
+      m_last_gps_record_fix_us(0) {
+    if (main_loop_hz == 0) {
+        main_loop_hz = 10;
+    }
+    m_rates_hz[SAMPLE_CLASS_MAIN] = main_loop_hz;
+    m_rates_hz[SAMPLE_CLASS_GPS] = gps_hz == 0 ? main_loop_hz : gps_hz;
+    m_rates_hz[SAMPLE_CLASS_IMU] = imu_hz == 0 ? main_loop_hz : imu_hz;
+    m_rates_hz[SAMPLE_CLASS_OBD] = obd_hz == 0 ? main_loop_hz : obd_hz;
+    m_rates_hz[SAMPLE_CLASS_BATTERY] = battery_hz == 0 ? main_loop_hz : battery_hz;
 }
 
 RTLoggerThread::~RTLoggerThread() {
@@ -29,23 +47,43 @@ bool RTLoggerThread::start() {
         return false;
     }
     
+    // With a hardware FIFO the IMU timer only needs to drain it, not pace each sample.
+    // Clamp before the task exists: it reads the rates for its banner and loop budget.
+    if (m_sensor_manager->get_imu_batch_rate_hz() > 0 && m_rates_hz[SAMPLE_CLASS_IMU] > IMU_FIFO_DRAIN_HZ) {
+        m_rates_hz[SAMPLE_CLASS_IMU] = IMU_FIFO_DRAIN_HZ;
+    }
+    
     m_running = true;
     m_sample_count = 0;
     
     // Create FreeRTOS task
-    BaseType_t result = xTaskCreate(
-        task_wrapper,           // Task function
-        "RTLogger",             // Task name
-        4096,                   // Stack size
-        this,                   // Parameter (pointer to this)
-        2,                      // Priority (0 = lowest, higher = more important)
-        &m_task_handle          // Task handle
+    BaseType_t result = xTaskCreatePinnedToCore(
+        task_wrapper,               // Task function
+        "RTLogger",                 // Task name
+        RT_LOGGER_TASK_STACK,       // Stack size
+        this,                       // Parameter (pointer to this)
+        RT_LOGGER_TASK_PRIORITY,    // Priority (0 = lowest, higher = more important)
+        &m_task_handle,             // Task handle
+        RT_LOGGER_TASK_CORE         // Core
     );
     
-    return result == pdPASS;
+    if (result != pdPASS) {
+        m_running = false;
+        m_task_handle = nullptr;
+        return false;
+    }
+    
+    // Timers notify the task directly; it sleeps until one of them fires
+    if (!m_scheduler.start(m_task_handle, m_rates_hz)) {
+        stop();
+        return false;
+    }
+    
+    return true;
 }
 
 void RTLoggerThread::stop() {
+    m_scheduler.stop();
     if (m_running && m_task_handle) {
         m_running = false;
         vTaskDelete(m_task_handle);
@@ -60,33 +98,50 @@ void RTLoggerThread::set_storage_write_callback(
     m_storage_write_callback = callback;
 }
 
+void RTLoggerThread::set_block_writer(LogBlockWriter* writer) {
+    if (writer && !writer->add_source(&m_record_ring)) {
+        Serial.println("[RTLogger] WARNING: Block writer has no free source slot");
+        return;
+    }
+    m_block_writer = writer;
+}
+
 gps_data_t RTLoggerThread::get_last_gps() const {
-    return m_last_gps;
+    return m_last_gps.load();
 }
 
 accel_data_t RTLoggerThread::get_last_accel() const {
-    return m_last_accel;
+    return m_last_accel.load();
 }
 
 gyro_data_t RTLoggerThread::get_last_gyro() const {
-    return m_last_gyro;
+    return m_last_gyro.load();
 }
 
 compass_data_t RTLoggerThread::get_last_compass() const {
-    return m_last_compass;
+    return m_last_compass.load();
 }
 
 battery_data_t RTLoggerThread::get_last_battery() const {
-    return m_last_battery;
+    return m_last_battery.load();
 }
 
 uint32_t RTLoggerThread::get_sample_count() const {
     return m_sample_count;
 }
 
+rt_loop_stats_t RTLoggerThread::get_loop_stats() const {
+    return m_loop_stats.load();
+}
+
+sample_timing_stats_t RTLoggerThread::get_timing_stats(sample_class_t cls) const {
+    return m_scheduler.get_stats(cls);
+}
+
 void RTLoggerThread::trigger_storage_write() {
     if (m_storage_write_callback) {
-        m_storage_write_callback(m_last_gps, m_last_accel, m_last_gyro, m_last_compass, m_last_battery);
+        m_storage_write_callback(m_last_gps.load(), m_last_accel.load(), m_last_gyro.load(),
+                                 m_last_compass.load(), m_last_battery.load());
     }
 }
 
@@ -98,117 +153,209 @@ void RTLoggerThread::task_wrapper(void* arg) {
 }
 
 void RTLoggerThread::task_loop() {
-    // Timing trackers for individual sensors
-    uint32_t last_gps_update = 0;
-    uint32_t last_imu_update = 0;
-    uint32_t last_obd_update = 0;
-    
     // Debug: Print once at start
     static bool first_run = true;
     if (first_run) {
-        Serial.printf("RT Logger thread started - Main: %dms, GPS: %dms, IMU: %dms, OBD: %dms\n",
-                     m_update_rate_ms, m_gps_rate_ms, m_imu_rate_ms, m_obd_rate_ms);
+        Serial.printf("RT Logger thread started - Main: %uHz, GPS: %uHz, IMU: %uHz, OBD: %uHz, Battery: %uHz\n",
+                     m_rates_hz[SAMPLE_CLASS_MAIN], m_rates_hz[SAMPLE_CLASS_GPS],
+                     m_rates_hz[SAMPLE_CLASS_IMU], m_rates_hz[SAMPLE_CLASS_OBD],
+                     m_rates_hz[SAMPLE_CLASS_BATTERY]);
+        if (m_sensor_manager->get_imu_batch_rate_hz() > 0) {
+            Serial.printf("  IMU hardware FIFO: %uHz samples drained at %uHz\n",
+                         m_sensor_manager->get_imu_batch_rate_hz(), m_rates_hz[SAMPLE_CLASS_IMU]);
+        }
         Serial.flush();
         first_run = false;
     }
     
+    // Iteration budget: the shortest sensor period
+    rt_loop_stats_t loop_stats = {};
+    uint64_t loop_total_us = 0;
+    uint16_t max_rate_hz = 1;
+    for (int i = 0; i < SAMPLE_CLASS_COUNT; i++) {
+        max_rate_hz = m_rates_hz[i] > max_rate_hz ? m_rates_hz[i] : max_rate_hz;
+    }
+    loop_stats.budget_us = 1000000UL / max_rate_hz;
+    m_loop_stats.store(loop_stats);
+    
+    // Nothing below touches WiFi, Serial or the heap: live telemetry and driver
+    // statistics are read on core 0 by TelemetryPublisher and StatusMonitor
     while (m_running) {
-        // Timestamp at the TOP of the loop
-        uint32_t loop_start_ms = millis();
+        // Sleep until one or more sensor timers fire
+        uint32_t due = m_scheduler.wait(pdMS_TO_TICKS(1000));
+        if (due == 0) {
+            continue;
+        }
+        int64_t wake_us = esp_timer_get_time();
         bool any_updated = false;
         
-        // Update GPS if interval elapsed
-        if (loop_start_ms - last_gps_update >= m_gps_rate_ms) {
-            m_sensor_manager->update_gps();
-            m_last_gps = m_sensor_manager->get_gps();
-            last_gps_update = loop_start_ms;
+        // IMU first: it has the tightest period
+        if (due & (1UL << SAMPLE_CLASS_IMU)) {
+            int64_t sample_us = esp_timer_get_time();
+            m_sensor_manager->update_imu();
+            accel_data_t accel = m_sensor_manager->get_accel();
+            gyro_data_t gyro = m_sensor_manager->get_gyro();
+            m_last_accel.store(accel);
+            m_last_gyro.store(gyro);
+            compass_data_t compass = m_sensor_manager->get_comp();
+            m_last_compass.store(compass);
+            m_scheduler.record_sample(SAMPLE_CLASS_IMU, sample_us);
             any_updated = true;
+            
+            // FIFO mode: log every buffered sample with its own timestamp
+            size_t batch = m_sensor_manager->get_accel_batch(m_accel_batch, IMU_BATCH_MAX_SAMPLES);
+            if (batch > 0) {
+                size_t gyro_batch = m_sensor_manager->get_gyro_batch(m_gyro_batch, IMU_BATCH_MAX_SAMPLES);
+                for (size_t i = 0; i < batch; i++) {
+                    log_imu_record(m_accel_batch[i].timestamp_us, m_accel_batch[i].data,
+                                   i < gyro_batch ? m_gyro_batch[i].data : gyro);
+                }
+            } else if (m_sensor_manager->get_imu_batch_rate_hz() == 0) {
+                log_imu_record(sample_us, accel, gyro);
+            }
+            
+            if (m_sensor_manager->compass_valid() &&
+                sample_us - m_last_compass_record_us >= COMPASS_RECORD_INTERVAL_US) {
+                m_last_compass_record_us = sample_us;
+                log_compass_record(sample_us, compass);
+            }
         }
         
-        // Update IMU if interval elapsed
-        if (loop_start_ms - last_imu_update >= m_imu_rate_ms) {
-            m_sensor_manager->update_imu();
-            m_last_accel = m_sensor_manager->get_accel();
-            m_last_gyro = m_sensor_manager->get_gyro();
-            m_last_compass = m_sensor_manager->get_comp();
-            last_imu_update = loop_start_ms;
+        if (due & (1UL << SAMPLE_CLASS_GPS)) {
+            int64_t sample_us = esp_timer_get_time();
+            m_sensor_manager->update_gps();
+            gps_data_t gps = m_sensor_manager->get_gps();
+            m_last_gps.store(gps);
+            m_scheduler.record_sample(SAMPLE_CLASS_GPS, sample_us);
             any_updated = true;
+            if (TimeBase::on_gps_fix(gps)) {
+                log_time_sync_record(TimeBase::get_state());
+            }
+            
+            // The timer polls faster than fixes arrive; log each epoch once
+            if (gps.fix_time_us == 0 || gps.fix_time_us != m_last_gps_record_fix_us) {
+                m_last_gps_record_fix_us = gps.fix_time_us;
+                log_gps_record(sample_us, gps);
+            }
         }
         
-        // Update OBD if interval elapsed (handled separately in OBD driver)
-        if (loop_start_ms - last_obd_update >= m_obd_rate_ms) {
-            // OBD updates would go here when implemented
-            last_obd_update = loop_start_ms;
+        // OBD updates are handled separately in the OBD driver
+        if (due & (1UL << SAMPLE_CLASS_OBD)) {
+            m_scheduler.record_sample(SAMPLE_CLASS_OBD, esp_timer_get_time());
         }
         
-        // Always update battery (low frequency sensor)
-        m_sensor_manager->update_battery();
-        m_last_battery = m_sensor_manager->get_battery();
+        if (due & (1UL << SAMPLE_CLASS_BATTERY)) {
+            int64_t sample_us = esp_timer_get_time();
+            m_sensor_manager->update_battery();
+            m_last_battery.store(m_sensor_manager->get_battery());
+            m_scheduler.record_sample(SAMPLE_CLASS_BATTERY, sample_us);
+        }
         
         if (any_updated) {
             m_sample_count++;
-            
-            // Broadcast to WebSocket clients at 5Hz (every 200ms)
-            static uint32_t last_broadcast_ms = 0;
-            
-            if (WiFiManager::is_initialized() && (loop_start_ms - last_broadcast_ms) >= 200) {
-                last_broadcast_ms = loop_start_ms;
-                
-                // Create JSON document with sensor data
-                // Use JsonDocument to avoid dynamic allocation
-                JsonDocument doc;
-                doc["type"] = "sensor";
-                doc["uptime_ms"] = loop_start_ms;
-                doc["sample_count"] = m_sample_count;
-                doc["is_paused"] = m_storage_paused;
-                
-                // GPS data
-                doc["gps_valid"] = m_last_gps.valid;
-                doc["latitude"] = m_last_gps.latitude;
-                doc["longitude"] = m_last_gps.longitude;
-                doc["altitude"] = m_last_gps.altitude;
-                doc["speed"] = m_last_gps.speed;
-                doc["satellites"] = m_last_gps.satellites;
-                
-                // Accelerometer
-                doc["accel_x"] = m_last_accel.x;
-                doc["accel_y"] = m_last_accel.y;
-                doc["accel_z"] = m_last_accel.z;
-                doc["temperature"] = m_last_accel.temperature;
-                
-                // Gyroscope
-                doc["gyro_x"] = m_last_gyro.x;
-                doc["gyro_y"] = m_last_gyro.y;
-                doc["gyro_z"] = m_last_gyro.z;
-                
-                // Battery data
-                doc["battery_soc"] = m_last_battery.state_of_charge;
-                doc["battery_voltage"] = m_last_battery.voltage;
-                doc["battery_current"] = m_last_battery.current;
-                doc["battery_temp"] = m_last_battery.temperature / 100.0f;
-                
-                // Serialize and broadcast
-                char json_buffer[512];
-                size_t n = serializeJson(doc, json_buffer, sizeof(json_buffer));
-                if (n > 0) {
-                    WiFiManager::broadcast_json(json_buffer);
-                }
-            }
         }
         
-        // Calculate elapsed time and wait only the difference
-        uint32_t elapsed_ms = millis() - loop_start_ms;
-        
-        if (elapsed_ms < m_update_rate_ms) {
-            // We have time left, delay for the remainder
-            uint32_t remaining_ms = m_update_rate_ms - elapsed_ms;
-            vTaskDelay(pdMS_TO_TICKS(remaining_ms));
-        } else {
-            // Processing took longer than the update rate, yield immediately
-            // This allows other tasks to run but maintains maximum throughput
-            taskYIELD();
+        // Housekeeping tick
+        if (due & (1UL << SAMPLE_CLASS_MAIN)) {
+            m_scheduler.record_sample(SAMPLE_CLASS_MAIN, esp_timer_get_time());
         }
+        
+        record_iteration(&loop_stats, &loop_total_us, wake_us);
+    }
+}
+
+void RTLoggerThread::record_iteration(rt_loop_stats_t* stats, uint64_t* total_us, int64_t wake_us) {
+    uint32_t busy_us = (uint32_t)(esp_timer_get_time() - wake_us);
+    stats->iterations++;
+    stats->last_us = busy_us;
+    if (busy_us > stats->max_us) {
+        stats->max_us = busy_us;
     }
+    if (busy_us > stats->budget_us) {
+        stats->over_budget++;
+    }
+    *total_us += busy_us;
+    stats->mean_us = (uint32_t)(*total_us / stats->iterations);
+    m_loop_stats.store(*stats);
+}
+
+
+void RTLoggerThread::log_imu_record(int64_t now_us, const accel_data_t& accel, const gyro_data_t& gyro) {
+    if (!m_block_writer || m_storage_paused) {
+        return;
+    }
+    
+    log_record_any_t slot;
+    imu_record_t& record = slot.imu;
+    record.msg_type = LOG_RECORD_IMU;
+    record.timestamp_offset_us = (uint64_t)(now_us - m_block_writer->get_session_start_us());
+    record.accel_x = accel.x * STANDARD_GRAVITY;
+    record.accel_y = accel.y * STANDARD_GRAVITY;
+    record.accel_z = accel.z * STANDARD_GRAVITY;
+    record.gyro_x = gyro.x;
+    record.gyro_y = gyro.y;
+    record.gyro_z = gyro.z;
+    m_record_ring.push(slot);
+}
+
+void RTLoggerThread::log_gps_record(int64_t now_us, const gps_data_t& gps) {
+    if (!m_block_writer || m_storage_paused) {
+        return;
+    }
+    
+    // A fix describes its epoch, not the moment it was polled: stamp it with
+    // the epoch's local time once the clock is locked, else its arrival
+    int64_t fix_us = gps.fix_time_us != 0 ? gps.fix_time_us : now_us;
+    int64_t epoch_us;
+    int64_t fix_utc = TimeBase::gps_fix_utc_us(gps);
+    if (fix_utc >= 0 && TimeBase::utc_to_esp(fix_utc, &epoch_us) && epoch_us <= fix_us) {
+        fix_us = epoch_us;
+    }
+    int64_t session_start_us = m_block_writer->get_session_start_us();
+    if (fix_us < session_start_us) {
+        fix_us = now_us;
+    }
+    
+    log_record_any_t slot;
+    gps_record_t& record = slot.gps;
+    record.msg_type = LOG_RECORD_GPS;
+    record.timestamp_offset_us = (uint64_t)(fix_us - session_start_us);
+    record.latitude = gps.latitude;
+    record.longitude = gps.longitude;
+    record.altitude_m = (float)gps.altitude;
+    record.fix_type = gps.valid ? gps.fix_type : 0;
+    record.num_sats = gps.satellites;
+    record.hdop = gps.hdop;
+    m_record_ring.push(slot);
+}
+
+void RTLoggerThread::log_compass_record(int64_t now_us, const compass_data_t& compass) {
+    if (!m_block_writer || m_storage_paused) {
+        return;
+    }
+
+    log_record_any_t slot;
+    compass_record_t& record = slot.compass;
+    record.msg_type = LOG_RECORD_COMPASS;
+    record.timestamp_offset_us = (uint64_t)(now_us - m_block_writer->get_session_start_us());
+    record.bearing_deg = compass.heading;
+    m_record_ring.push(slot);
+}
+
+void RTLoggerThread::log_time_sync_record(const time_base_state_t& state) {
+    if (!m_block_writer || m_storage_paused || state.ref_esp_us < m_block_writer->get_session_start_us()) {
+        return;
+    }
+    
+    log_record_any_t slot;
+    time_sync_record_t& record = slot.time_sync;
+    record.msg_type = LOG_RECORD_TIME_SYNC;
+    record.timestamp_offset_us = (uint64_t)(state.ref_esp_us - m_block_writer->get_session_start_us());
+    record.utc_us = state.ref_utc_us;
+    record.drift_ppm = state.drift_ppm;
+    record.uncertainty_us = state.uncertainty_us;
+    record.source = state.source;
+    m_record_ring.push(slot);
 }
 
 void RTLoggerThread::pause_storage() {
@@ -0,0 +1,152 @@
+#include "sample_scheduler.h"
+#include <Arduino.h>
+#include <cstring>
+
+static const char* CLASS_NAMES[SAMPLE_CLASS_COUNT] = {
+    "Main", "GPS", "IMU", "OBD", "Battery"
+};
+
+SampleScheduler::SampleScheduler() : m_task(nullptr) {
+    for (int i = 0; i < SAMPLE_CLASS_COUNT; i++) {
+        m_slots[i].timer = nullptr;
+        reset_slot(m_slots[i], (sample_class_t)i);
+    }
+}
+
+SampleScheduler::~SampleScheduler() {
+    stop();
+}
+
+bool SampleScheduler::start(TaskHandle_t task, const uint16_t rates_hz[SAMPLE_CLASS_COUNT]) {
+    if (!task) {
+        return false;
+    }
+    stop();
+    m_task = task;
+
+    for (int i = 0; i < SAMPLE_CLASS_COUNT; i++) {
+        timer_slot_t& slot = m_slots[i];
+        reset_slot(slot, (sample_class_t)i);
+        slot.owner = this;
+
+        if (rates_hz[i] == 0) {
+            continue;
+        }
+        slot.stats.period_us = 1000000UL / rates_hz[i];
+        slot.published.store(slot.stats);
+
+        esp_timer_create_args_t args = {};
+        args.callback = timer_callback;
+        args.arg = &slot;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = CLASS_NAMES[i];
+        args.skip_unhandled_events = true;
+
+        if (esp_timer_create(&args, &slot.timer) != ESP_OK) {
+            Serial.printf("[Scheduler] ERROR: Failed to create %s timer\n", CLASS_NAMES[i]);
+            stop();
+            return false;
+        }
+        if (esp_timer_start_periodic(slot.timer, slot.stats.period_us) != ESP_OK) {
+            Serial.printf("[Scheduler] ERROR: Failed to start %s timer\n", CLASS_NAMES[i]);
+            stop();
+            return false;
+        }
+    }
+
+    // Sample every enabled class once immediately instead of waiting a full period
+    uint32_t initial = 0;
+    for (int i = 0; i < SAMPLE_CLASS_COUNT; i++) {
+        if (m_slots[i].timer) {
+            initial |= (1UL << i);
+        }
+    }
+    xTaskNotify(m_task, initial, eSetBits);
+    return true;
+}
+
+void SampleScheduler::stop() {
+    for (int i = 0; i < SAMPLE_CLASS_COUNT; i++) {
+        if (m_slots[i].timer) {
+            esp_timer_stop(m_slots[i].timer);
+            esp_timer_delete(m_slots[i].timer);
+            m_slots[i].timer = nullptr;
+        }
+    }
+    m_task = nullptr;
+}
+
+uint32_t SampleScheduler::wait(TickType_t timeout) {
+    uint32_t bits = 0;
+    if (xTaskNotifyWait(0, 0xFFFFFFFFUL, &bits, timeout) != pdTRUE) {
+        return 0;
+    }
+    for (int i = 0; i < SAMPLE_CLASS_COUNT; i++) {
+        if (bits & (1UL << i)) {
+            m_slots[i].pending = false;
+        }
+    }
+    return bits;
+}
+
+void SampleScheduler::record_sample(sample_class_t cls, int64_t timestamp_us) {
+    if (cls >= SAMPLE_CLASS_COUNT) {
+        return;
+    }
+    timer_slot_t& slot = m_slots[cls];
+    sample_timing_stats_t& stats = slot.stats;
+
+    if (stats.samples > 0 && stats.period_us > 0) {
+        int64_t interval = timestamp_us - stats.last_sample_us;
+        int64_t error = interval - (int64_t)stats.period_us;
+        uint32_t jitter = (uint32_t)(error < 0 ? -error : error);
+        if (jitter > stats.max_jitter_us) {
+            stats.max_jitter_us = jitter;
+        }
+        slot.jitter_sum_us += jitter;
+        stats.mean_jitter_us = (uint32_t)(slot.jitter_sum_us / stats.samples);
+    }
+
+    stats.last_sample_us = timestamp_us;
+    stats.samples++;
+    stats.overruns = slot.overruns.load(std::memory_order_relaxed);
+    slot.published.store(stats);
+}
+
+sample_timing_stats_t SampleScheduler::get_stats(sample_class_t cls) const {
+    if (cls >= SAMPLE_CLASS_COUNT) {
+        sample_timing_stats_t empty = {};
+        return empty;
+    }
+    // Overruns keep counting while the task is stalled, so fold in the live value
+    sample_timing_stats_t stats = m_slots[cls].published.load();
+    stats.overruns = m_slots[cls].overruns.load(std::memory_order_relaxed);
+    return stats;
+}
+
+const char* SampleScheduler::class_name(sample_class_t cls) {
+    return cls < SAMPLE_CLASS_COUNT ? CLASS_NAMES[cls] : "?";
+}
+
+void SampleScheduler::reset_slot(timer_slot_t& slot, sample_class_t cls) {
+    slot.owner = nullptr;
+    slot.cls = cls;
+    slot.pending = false;
+    slot.jitter_sum_us = 0;
+    memset(&slot.stats, 0, sizeof(slot.stats));
+    slot.overruns.store(0, std::memory_order_relaxed);
+    slot.published.store(slot.stats);
+}
+
+void SampleScheduler::timer_callback(void* arg) {
+    timer_slot_t* slot = static_cast<timer_slot_t*>(arg);
+    SampleScheduler* owner = slot->owner;
+    if (!owner->m_task) {
+        return;
+    }
+    if (slot->pending) {
+        slot->overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    slot->pending = true;
+    xTaskNotify(owner->m_task, 1UL << slot->cls, eSetBits);
+}
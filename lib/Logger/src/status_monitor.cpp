@@ -1,12 +1,8 @@
 #include "status_monitor.h"
 #include "units_helper.h"
-#include "wifi_manager.h"
-#include "config_manager.h"
-#include "icar_ble_driver.h"
 #include <Arduino.h>
 #include <cstdio>
 #include <esp_log.h>
-#include <ArduinoJson.h>
 
 // Button GPIO pins
 #define BUTTON_D0 0   // Pause/Resume
@@ -21,6 +17,7 @@ static const char* TAG = "STATUS";
 
 StatusMonitor::StatusMonitor(RTLoggerThread* rt_logger, uint32_t report_interval_ms)
     : m_rt_logger(rt_logger),
+      m_gps_driver(nullptr),
       m_report_interval_ms(report_interval_ms),
       m_task_handle(nullptr),
       m_running(false),
@@ -71,6 +68,10 @@ void StatusMonitor::increment_write_count() {
     m_write_count++;
 }
 
+void StatusMonitor::set_gps_driver(const PA1010DDriver* gps) {
+    m_gps_driver = gps;
+}
+
 void StatusMonitor::print_status_now() {
     uint32_t uptime_ms = millis();
     uint32_t uptime_sec = uptime_ms / 1000;
@@ -100,6 +101,26 @@ void StatusMonitor::print_status_now() {
         } else {
             Serial.println("║ GPS: NO FIX");
         }
+        
+        // GPS byte stream and parser health (kept off the RT core, which only samples)
+        if (m_gps_driver != nullptr) {
+            pa1010d_stream_stats_t stream = m_gps_driver->get_stream_stats();
+            nmea_parser_stats_t parser = m_gps_driver->get_parser_stats();
+            snprintf(buffer, sizeof(buffer), "║ GPS stream: %lu bytes in %lu reads (read %u, padding %lu, overflows %lu/%lu)",
+                     (unsigned long)stream.bytes, (unsigned long)stream.reads, stream.read_size,
+                     (unsigned long)stream.padding_bytes, (unsigned long)stream.ring_overflows,
+                     (unsigned long)stream.sentence_overflows);
+            Serial.println(buffer);
+            snprintf(buffer, sizeof(buffer), "║ GPS latency: last %luus avg %luus max %luus",
+                     (unsigned long)stream.last_latency_us, (unsigned long)stream.mean_latency_us,
+                     (unsigned long)stream.max_latency_us);
+            Serial.println(buffer);
+            snprintf(buffer, sizeof(buffer), "║ GPS fixes: %.1f/%uHz (sentences %lu, checksum errors %lu, malformed %lu)",
+                     m_gps_driver->get_fix_rate_hz(), m_gps_driver->get_configured_rate_hz(),
+                     (unsigned long)parser.sentences, (unsigned long)parser.checksum_errors,
+                     (unsigned long)parser.malformed);
+            Serial.println(buffer);
+        }
         Serial.println("║");
         
         // IMU Status
@@ -109,8 +130,8 @@ void StatusMonitor::print_status_now() {
         snprintf(buffer, sizeof(buffer), "║ Gyro:  X=%.1fdps Y=%.1fdps Z=%.1fdps",
                  gyro.x, gyro.y, gyro.z);
         Serial.println(buffer);
-        snprintf(buffer, sizeof(buffer), "║ Compass: X=%.1fuT Y=%.1fuT Z=%.1fuT",
-                 compass.x, compass.y, compass.z);
+        snprintf(buffer, sizeof(buffer), "║ Compass: X=%.1fuT Y=%.1fuT Z=%.1fuT | Heading: %.1f°",
+                 compass.x, compass.y, compass.z, compass.heading);
         Serial.println(buffer);
         Serial.println("║");
         
@@ -126,6 +147,27 @@ void StatusMonitor::print_status_now() {
                  sample_count, sample_count > 0 ? (float)sample_count / (uptime_sec > 0 ? uptime_sec : 1) : 0.0f);
         Serial.println(buffer);
         
+        // Sampling loop busy time against the shortest sensor period
+        rt_loop_stats_t loop = m_rt_logger->get_loop_stats();
+        snprintf(buffer, sizeof(buffer), "║ RT loop: avg %luus max %luus (budget %luus, %lu over)",
+                 (unsigned long)loop.mean_us, (unsigned long)loop.max_us,
+                 (unsigned long)loop.budget_us, (unsigned long)loop.over_budget);
+        Serial.println(buffer);
+        
+        // Sampling jitter per timer-driven sensor class
+        for (int i = SAMPLE_CLASS_GPS; i < SAMPLE_CLASS_COUNT; i++) {
+            sample_timing_stats_t timing = m_rt_logger->get_timing_stats((sample_class_t)i);
+            if (timing.period_us == 0) {
+                continue;
+            }
+            snprintf(buffer, sizeof(buffer), "║ Timing %-7s %4luHz: jitter avg %luus max %luus, overruns %lu",
+                     SampleScheduler::class_name((sample_class_t)i),
+                     (unsigned long)(1000000UL / timing.period_us),
+                     (unsigned long)timing.mean_jitter_us, (unsigned long)timing.max_jitter_us,
+                     (unsigned long)timing.overruns);
+            Serial.println(buffer);
+        }
+        
         // Update display based on current mode
         DisplayMode current_mode = ST7789Display::get_display_mode();
         bool is_paused = m_rt_logger->is_storage_paused();
@@ -261,102 +303,6 @@ void StatusMonitor::task_loop() {
         }
         d2_last_state = d2_state;
         
-        // Broadcast sensor data via WebSocket at 2Hz (every 500ms)
-        // Only when clients are connected to minimize overhead
-        static uint32_t last_ws_broadcast_ms = 0;
-        static uint32_t last_config_check_ms = 0;
-        static bool obd_ble_enabled = true;
-        
-        // Update OBD BLE enabled state every 5 seconds
-        if (now - last_config_check_ms >= 5000) {
-            obd_ble_enabled = ConfigManager::get_current().obd_ble_enabled;
-            last_config_check_ms = now;
-        }
-        
-        if (WiFiManager::is_initialized() && WiFiManager::has_clients() && 
-            (now - last_ws_broadcast_ms) >= 500) {
-            last_ws_broadcast_ms = now;
-            
-            if (m_rt_logger != nullptr) {
-                // Get latest sensor data
-                gps_data_t gps = m_rt_logger->get_last_gps();
-                accel_data_t accel = m_rt_logger->get_last_accel();
-                gyro_data_t gyro = m_rt_logger->get_last_gyro();
-                battery_data_t battery = m_rt_logger->get_last_battery();
-                uint32_t sample_count = m_rt_logger->get_sample_count();
-                bool is_paused = m_rt_logger->is_storage_paused();
-                
-                // Create JSON document with sensor data
-                JsonDocument doc;
-                doc["type"] = "sensor";
-                doc["uptime_ms"] = now;
-                doc["sample_count"] = sample_count;
-                doc["is_paused"] = is_paused;
-                
-                // GPS data
-                doc["gps_valid"] = gps.valid;
-                doc["latitude"] = gps.latitude;
-                doc["longitude"] = gps.longitude;
-                doc["altitude"] = gps.altitude;
-                doc["speed"] = gps.speed;
-                doc["satellites"] = gps.satellites;
-                
-                // Accelerometer
-                doc["accel_x"] = accel.x;
-                doc["accel_y"] = accel.y;
-                doc["accel_z"] = accel.z;
-                doc["temperature"] = accel.temperature;
-                
-                // Gyroscope
-                doc["gyro_x"] = gyro.x;
-                doc["gyro_y"] = gyro.y;
-                doc["gyro_z"] = gyro.z;
-                
-                // Battery data
-                doc["battery_soc"] = battery.state_of_charge;
-                doc["battery_voltage"] = battery.voltage;
-                doc["battery_current"] = battery.current;
-                doc["battery_temp"] = battery.temperature / 100.0f;
-                
-                // OBD data (if connected and enabled)
-                bool obd_available = false;
-                if (obd_ble_enabled) {
-                    try {
-                        obd_available = IcarBleDriver::is_connected();
-                    } catch (...) {
-                        obd_available = false;
-                    }
-                }
-                
-                if (obd_available) {
-                    try {
-                        obd_data_t obd = IcarBleDriver::get_data();
-                        JsonObject obd_obj = doc["obd"].to<JsonObject>();
-                        obd_obj["connected"] = true;
-                        obd_obj["rpm"] = obd.engine_rpm;
-                        obd_obj["speed"] = obd.vehicle_speed;
-                        obd_obj["throttle"] = obd.throttle_position;
-                        obd_obj["load"] = obd.engine_load;
-                        obd_obj["coolant_temp"] = obd.coolant_temp;
-                        obd_obj["intake_temp"] = obd.intake_temp;
-                        obd_obj["maf"] = obd.maf_flow;
-                        obd_obj["timing_advance"] = obd.timing_advance;
-                    } catch (...) {
-                        doc["obd"]["connected"] = false;
-                    }
-                } else {
-                    doc["obd"]["connected"] = false;
-                }
-                
-                // Serialize and broadcast
-                static EXT_RAM_ATTR char json_buffer[768];
-                size_t n = serializeJson(doc, json_buffer, sizeof(json_buffer));
-                if (n > 0 && n < sizeof(json_buffer)) {
-                    WiFiManager::broadcast_json(json_buffer);
-                }
-            }
-        }
-        
         // Print status at regular intervals
         if (now - m_last_report_time >= m_report_interval_ms) {
             print_status_now();
@@ -50,13 +50,34 @@ void StorageReporter::report_storage_write(const gps_data_t& gps, const accel_da
     ESP_LOGI(TAG, "===========================");
 }
 
+void StorageReporter::report_writer_stats(const log_writer_stats_t& stats) {
+    ESP_LOGI(TAG, "--- Block Writer ---");
+    ESP_LOGI(TAG, "  Records:   %u appended, %u dropped", stats.records_appended, stats.records_dropped);
+    ESP_LOGI(TAG, "  Rings:     %u dropped, high water %u/%u",
+             stats.ring_dropped, stats.ring_high_water, (unsigned)LOG_RECORD_RING_CAPACITY);
+    ESP_LOGI(TAG, "  Blocks:    %u written @ 0x%06X (tail 0x%06X)", stats.blocks_written,
+             stats.write_offset, stats.tail_offset);
+    if (stats.bytes_compressed > 0) {
+        ESP_LOGI(TAG, "  Ratio:     %.2f:1 (%u -> %u bytes)",
+                 (float)stats.bytes_uncompressed / stats.bytes_compressed,
+                 stats.bytes_uncompressed, stats.bytes_compressed);
+    }
+    ESP_LOGI(TAG, "  Worst:     compress %u us, write %u us (%u erase stalls)", stats.max_compress_us,
+             stats.max_write_us, stats.erase_stalls);
+    if (stats.flash_errors > 0) {
+        ESP_LOGW(TAG, "  Flash errors: %u", stats.flash_errors);
+    }
+}
+
 void StorageReporter::print_gps_data(const gps_data_t& gps) {
     if (gps.valid) {
         ESP_LOGI(TAG, "  Latitude:  %.6f", gps.latitude);
         ESP_LOGI(TAG, "  Longitude: %.6f", gps.longitude);
         ESP_LOGI(TAG, "  Altitude:  %.2f m", gps.altitude);
         ESP_LOGI(TAG, "  Speed:     %.2f kts", gps.speed);
-        ESP_LOGI(TAG, "  Satellites: %d", gps.satellites);
+        ESP_LOGI(TAG, "  Course:    %.1f deg", gps.course);
+        ESP_LOGI(TAG, "  Satellites: %d (%s fix, HDOP %.2f)", gps.satellites,
+                 gps.fix_type == 2 ? "3D" : "2D", gps.hdop);
         ESP_LOGI(TAG, "  Status: VALID");
     } else {
         ESP_LOGW(TAG, "  Status: INVALID - No GPS fix");
@@ -85,6 +106,7 @@ void StorageReporter::print_compass_data(const compass_data_t& compass) {
     ESP_LOGI(TAG, "  Z: %.2f uT", compass.z);
     ESP_LOGI(TAG, "  Magnitude: %.2f uT", 
              sqrtf(compass.x * compass.x + compass.y * compass.y + compass.z * compass.z));
+    ESP_LOGI(TAG, "  Heading: %.1f deg", compass.heading);
 }
 
 void StorageReporter::print_battery_data(const battery_data_t& battery) {
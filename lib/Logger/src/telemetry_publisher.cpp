@@ -0,0 +1,157 @@
+#include "telemetry_publisher.h"
+#include "wifi_manager.h"
+#include "config_manager.h"
+#include "icar_ble_driver.h"
+#include <Arduino.h>
+
+// Core 0 alongside WiFi at the status monitor's priority: telemetry is best effort
+#define TELEMETRY_TASK_STACK        4096
+#define TELEMETRY_TASK_PRIORITY     1
+#define TELEMETRY_TASK_CORE         0
+
+// Tick at the fastest rate a client may request; clients are paced individually
+#define TELEMETRY_TICK_MS           (1000 / WS_CLIENT_MAX_RATE_HZ)
+
+// How often the OBD enable flag is re-read from the configuration
+#define TELEMETRY_CONFIG_CHECK_MS   5000
+
+TelemetryPublisher::TelemetryPublisher(RTLoggerThread* rt_logger)
+    : m_rt_logger(rt_logger), m_task_handle(nullptr), m_running(false) {
+}
+
+TelemetryPublisher::~TelemetryPublisher() {
+    stop();
+}
+
+bool TelemetryPublisher::start() {
+    if (m_running || m_rt_logger == nullptr) {
+        return false;
+    }
+
+    m_running = true;
+    BaseType_t result = xTaskCreatePinnedToCore(
+        task_wrapper,
+        "Telemetry",
+        TELEMETRY_TASK_STACK,
+        this,
+        TELEMETRY_TASK_PRIORITY,
+        &m_task_handle,
+        TELEMETRY_TASK_CORE
+    );
+
+    if (result != pdPASS) {
+        m_running = false;
+        m_task_handle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void TelemetryPublisher::stop() {
+    m_running = false;
+    if (m_task_handle != nullptr) {
+        vTaskDelete(m_task_handle);
+        m_task_handle = nullptr;
+    }
+}
+
+void TelemetryPublisher::task_wrapper(void* arg) {
+    TelemetryPublisher* publisher = static_cast<TelemetryPublisher*>(arg);
+    if (publisher) {
+        publisher->task_loop();
+    }
+}
+
+void TelemetryPublisher::task_loop() {
+    uint32_t last_config_check_ms = 0;
+    bool obd_enabled = ConfigManager::get_current().obd_ble_enabled;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (m_running) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(TELEMETRY_TICK_MS));
+        uint32_t now_ms = millis();
+
+        if (now_ms - last_config_check_ms >= TELEMETRY_CONFIG_CHECK_MS) {
+            obd_enabled = ConfigManager::get_current().obd_ble_enabled;
+            last_config_check_ms = now_ms;
+        }
+
+        // Only build a frame when some client's tick has come
+        if (WiFiManager::is_initialized() && WiFiManager::telemetry_due()) {
+            publish(now_ms, obd_enabled);
+        }
+    }
+}
+
+void TelemetryPublisher::publish(uint32_t now_ms, bool obd_enabled) {
+    gps_data_t gps = m_rt_logger->get_last_gps();
+    accel_data_t accel = m_rt_logger->get_last_accel();
+    gyro_data_t gyro = m_rt_logger->get_last_gyro();
+    battery_data_t battery = m_rt_logger->get_last_battery();
+    rt_loop_stats_t loop = m_rt_logger->get_loop_stats();
+
+    TelemetryFrame frame;
+    frame.set(TELEMETRY_FIELD_UPTIME_MS, now_ms);
+    frame.set(TELEMETRY_FIELD_SAMPLE_COUNT, m_rt_logger->get_sample_count());
+    frame.set(TELEMETRY_FIELD_IS_PAUSED, m_rt_logger->is_storage_paused());
+    frame.set(TELEMETRY_FIELD_RT_LOOP_MAX_US, loop.max_us);
+
+    // GPS data (position fields only with a fix)
+    frame.set(TELEMETRY_FIELD_GPS_VALID, gps.valid);
+    frame.set(TELEMETRY_FIELD_SATELLITES, gps.satellites);
+    if (gps.valid) {
+        frame.set(TELEMETRY_FIELD_LATITUDE, gps.latitude);
+        frame.set(TELEMETRY_FIELD_LONGITUDE, gps.longitude);
+        frame.set(TELEMETRY_FIELD_ALTITUDE, gps.altitude);
+        frame.set(TELEMETRY_FIELD_SPEED, gps.speed);
+    }
+
+    // Accelerometer
+    frame.set(TELEMETRY_FIELD_ACCEL_X, accel.x);
+    frame.set(TELEMETRY_FIELD_ACCEL_Y, accel.y);
+    frame.set(TELEMETRY_FIELD_ACCEL_Z, accel.z);
+    frame.set(TELEMETRY_FIELD_TEMPERATURE, accel.temperature);
+
+    // Gyroscope
+    frame.set(TELEMETRY_FIELD_GYRO_X, gyro.x);
+    frame.set(TELEMETRY_FIELD_GYRO_Y, gyro.y);
+    frame.set(TELEMETRY_FIELD_GYRO_Z, gyro.z);
+
+    // Battery data
+    if (battery.valid) {
+        frame.set(TELEMETRY_FIELD_BATTERY_SOC, battery.state_of_charge);
+        frame.set(TELEMETRY_FIELD_BATTERY_VOLTAGE, battery.voltage);
+        frame.set(TELEMETRY_FIELD_BATTERY_CURRENT, battery.current);
+        frame.set(TELEMETRY_FIELD_BATTERY_TEMP, battery.temperature / 100.0f);
+    }
+
+    // OBD data (if connected and enabled)
+    bool obd_available = false;
+    if (obd_enabled) {
+        try {
+            obd_available = IcarBleDriver::is_connected();
+        } catch (...) {
+            obd_available = false;
+        }
+    }
+
+    frame.set(TELEMETRY_FIELD_OBD_CONNECTED, false);
+    if (obd_available) {
+        try {
+            obd_data_t obd = IcarBleDriver::get_data();
+            frame.set(TELEMETRY_FIELD_OBD_CONNECTED, true);
+            frame.set(TELEMETRY_FIELD_OBD_RPM, obd.engine_rpm);
+            frame.set(TELEMETRY_FIELD_OBD_SPEED, obd.vehicle_speed);
+            frame.set(TELEMETRY_FIELD_OBD_THROTTLE, obd.throttle_position);
+            frame.set(TELEMETRY_FIELD_OBD_LOAD, obd.engine_load);
+            frame.set(TELEMETRY_FIELD_OBD_COOLANT_TEMP, obd.coolant_temp);
+            frame.set(TELEMETRY_FIELD_OBD_INTAKE_TEMP, obd.intake_temp);
+            frame.set(TELEMETRY_FIELD_OBD_MAF, obd.maf_flow);
+            frame.set(TELEMETRY_FIELD_OBD_TIMING_ADVANCE, obd.timing_advance);
+        } catch (...) {
+            frame.set(TELEMETRY_FIELD_OBD_CONNECTED, false);
+        }
+    }
+
+    WiFiManager::broadcast_telemetry(frame);
+}
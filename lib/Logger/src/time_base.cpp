@@ -0,0 +1,206 @@
+#include "time_base.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <cstdlib>
+
+// Static member initialization
+SeqLock<time_base_state_t> TimeBase::m_state;
+time_base_state_t TimeBase::m_work = {};
+int64_t TimeBase::m_last_fix_us = 0;
+int64_t TimeBase::m_last_pps_used_us = 0;
+uint8_t TimeBase::m_outlier_run = 0;
+uint32_t TimeBase::m_corrections = 0;
+uint32_t TimeBase::m_steps = 0;
+uint32_t TimeBase::m_outliers = 0;
+int32_t TimeBase::m_last_residual_us = 0;
+int64_t TimeBase::m_anchor_esp_us = 0;
+int64_t TimeBase::m_anchor_utc_us = 0;
+uint8_t TimeBase::m_window_count = 0;
+int64_t TimeBase::m_window_esp_us = 0;
+int64_t TimeBase::m_window_utc_us = 0;
+portMUX_TYPE TimeBase::m_pps_lock = portMUX_INITIALIZER_UNLOCKED;
+volatile int64_t TimeBase::m_pps_us = 0;
+volatile uint32_t TimeBase::m_pps_edges = 0;
+
+// Weight of the newest |residual| in the uncertainty estimate
+#define UNCERTAINTY_GAIN_SHIFT  3
+
+void TimeBase::init(int pps_pin) {
+    m_work = {};
+    m_state.store(m_work);
+    m_last_fix_us = 0;
+    m_last_pps_used_us = 0;
+    m_outlier_run = 0;
+    m_window_count = 0;
+
+    if (pps_pin >= 0) {
+        pinMode(pps_pin, INPUT);
+        attachInterrupt(digitalPinToInterrupt(pps_pin), pps_isr, RISING);
+        Serial.printf("[Time] PPS input on GPIO %d\n", pps_pin);
+    } else {
+        Serial.println("[Time] No PPS input, timing from NMEA arrival");
+    }
+}
+
+void IRAM_ATTR TimeBase::pps_isr() {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&m_pps_lock);
+    m_pps_us = now;
+    m_pps_edges++;
+    portEXIT_CRITICAL_ISR(&m_pps_lock);
+}
+
+int64_t TimeBase::gps_fix_utc_us(const gps_data_t& gps) {
+    if (gps.year < 2000 || gps.month < 1 || gps.month > 12 || gps.day < 1 || gps.day > 31) {
+        return -1;
+    }
+
+    // Days since 1970-01-01 in the proleptic Gregorian calendar (years from March)
+    int32_t y = gps.year - (gps.month <= 2 ? 1 : 0);
+    int32_t era = y / 400;
+    uint32_t yoe = (uint32_t)(y - era * 400);
+    uint32_t doy = (153 * (gps.month + (gps.month > 2 ? -3 : 9)) + 2) / 5 + gps.day - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int64_t days = (int64_t)era * 146097 + doe - 719468;
+
+    int64_t seconds = days * 86400 + gps.hour * 3600 + gps.minute * 60 + gps.second;
+    return seconds * 1000000 + (int64_t)gps.millisecond * 1000;
+}
+
+bool TimeBase::on_gps_fix(const gps_data_t& gps) {
+    if (!gps.valid || gps.fix_time_us == 0 || gps.fix_time_us == m_last_fix_us) {
+        return false;
+    }
+    m_last_fix_us = gps.fix_time_us;
+
+    int64_t fix_utc = gps_fix_utc_us(gps);
+    if (fix_utc < 0) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&m_pps_lock);
+    int64_t edge = m_pps_us;
+    portEXIT_CRITICAL(&m_pps_lock);
+
+    // While PPS is live only whole-second fixes count: the edge just before
+    // their arrival is exactly that UTC second
+    if (edge != 0 && gps.fix_time_us - edge < TIME_BASE_PPS_TIMEOUT_US) {
+        if (gps.millisecond == 0 && edge != m_last_pps_used_us &&
+            gps.fix_time_us > edge && gps.fix_time_us - edge < 1000000) {
+            m_last_pps_used_us = edge;
+            return correct(edge, fix_utc, TIME_SOURCE_PPS);
+        }
+        return false;
+    }
+
+    // Arrival = epoch + output delay + polling delay; the fix with the largest
+    // UTC - arrival in the window was delayed least
+    int64_t offset = fix_utc - gps.fix_time_us;
+    if (m_window_count == 0 || offset > m_window_utc_us - m_window_esp_us) {
+        m_window_esp_us = gps.fix_time_us;
+        m_window_utc_us = fix_utc;
+    }
+    if (++m_window_count < TIME_BASE_NMEA_WINDOW) {
+        return false;
+    }
+    m_window_count = 0;
+    return correct(m_window_esp_us, m_window_utc_us, TIME_SOURCE_NMEA);
+}
+
+bool TimeBase::correct(int64_t esp_us, int64_t utc_us, time_source_t source) {
+    // First lock, a better source, or a jump that persists (receiver reset,
+    // leap second): set the clock outright and keep the drift estimate
+    if (m_work.source == TIME_SOURCE_NONE || source > m_work.source ||
+        m_outlier_run >= TIME_BASE_MAX_OUTLIERS) {
+        m_work.ref_esp_us = esp_us;
+        m_work.ref_utc_us = utc_us;
+        m_work.source = source;
+        m_anchor_esp_us = esp_us;
+        m_anchor_utc_us = utc_us;
+        m_outlier_run = 0;
+        m_last_residual_us = 0;
+        m_steps++;
+        m_corrections++;
+        m_state.store(m_work);
+        Serial.printf("[Time] Locked to GPS %s (step %u)\n",
+                      source == TIME_SOURCE_PPS ? "PPS" : "NMEA", m_steps);
+        return true;
+    }
+
+    int64_t dt = esp_us - m_work.ref_esp_us;
+    if (dt <= 0) {
+        return false;
+    }
+    int64_t predicted = m_work.ref_utc_us + dt + (int64_t)(dt * (double)m_work.drift_ppm * 1e-6);
+    int64_t residual = utc_us - predicted;
+    if (llabs(residual) > TIME_BASE_STEP_THRESHOLD_US) {
+        m_outliers++;
+        m_outlier_run++;
+        return false;
+    }
+    m_outlier_run = 0;
+
+    // Pull the offset part way. PPS nudges the rate by the residual slope;
+    // NMEA takes the rate from the whole span since lock
+    bool pps = (source == TIME_SOURCE_PPS);
+    m_work.ref_esp_us = esp_us;
+    m_work.ref_utc_us = predicted + (int64_t)(residual * (pps ? TIME_BASE_PPS_OFFSET_GAIN : TIME_BASE_NMEA_OFFSET_GAIN));
+    float drift = m_work.drift_ppm;
+    int64_t baseline = esp_us - m_anchor_esp_us;
+    if (pps) {
+        drift += TIME_BASE_PPS_DRIFT_GAIN * (float)((double)residual * 1e6 / dt);
+    } else if (baseline >= TIME_BASE_NMEA_BASELINE_US) {
+        drift = (float)((double)(utc_us - m_anchor_utc_us - baseline) * 1e6 / baseline);
+    }
+    if (drift > TIME_BASE_MAX_DRIFT_PPM) drift = TIME_BASE_MAX_DRIFT_PPM;
+    if (drift < -TIME_BASE_MAX_DRIFT_PPM) drift = -TIME_BASE_MAX_DRIFT_PPM;
+    m_work.drift_ppm = drift;
+
+    int64_t error = llabs(residual);
+    m_work.uncertainty_us = (uint32_t)((int64_t)m_work.uncertainty_us +
+                                       ((error - (int64_t)m_work.uncertainty_us) >> UNCERTAINTY_GAIN_SHIFT));
+    m_work.source = source;
+    m_last_residual_us = (int32_t)residual;
+    m_corrections++;
+    m_state.store(m_work);
+    return true;
+}
+
+bool TimeBase::is_locked() {
+    return m_state.load().source != TIME_SOURCE_NONE;
+}
+
+bool TimeBase::esp_to_utc(int64_t esp_us, int64_t* utc_us) {
+    time_base_state_t state = m_state.load();
+    if (state.source == TIME_SOURCE_NONE || !utc_us) {
+        return false;
+    }
+    int64_t dt = esp_us - state.ref_esp_us;
+    *utc_us = state.ref_utc_us + dt + (int64_t)(dt * (double)state.drift_ppm * 1e-6);
+    return true;
+}
+
+bool TimeBase::utc_to_esp(int64_t utc_us, int64_t* esp_us) {
+    time_base_state_t state = m_state.load();
+    if (state.source == TIME_SOURCE_NONE || !esp_us) {
+        return false;
+    }
+    int64_t du = utc_us - state.ref_utc_us;
+    *esp_us = state.ref_esp_us + du - (int64_t)(du * (double)state.drift_ppm * 1e-6);
+    return true;
+}
+
+time_base_state_t TimeBase::get_state() {
+    return m_state.load();
+}
+
+time_base_stats_t TimeBase::get_stats() {
+    time_base_stats_t stats;
+    stats.state = m_state.load();
+    stats.corrections = m_corrections;
+    stats.steps = m_steps;
+    stats.outliers = m_outliers;
+    stats.pps_edges = m_pps_edges;
+    stats.last_residual_us = m_last_residual_us;
+    return stats;
+}
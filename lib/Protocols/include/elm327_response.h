@@ -0,0 +1,39 @@
+#ifndef ELM327_RESPONSE_H
+#define ELM327_RESPONSE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define ELM327_MAX_MESSAGES         8
+#define ELM327_MAX_MESSAGE_BYTES    160
+
+// Most PIDs one Mode 01 request may carry (SAE J1979 limit)
+#define OBD_MAX_PIDS_PER_REQUEST    6
+
+/**
+ * @brief ECU messages recovered from one ELM327 response
+ * Each entry is one complete message (service byte first): a single-frame
+ * line, or an ISO-TP multi-frame answer stitched back together.
+ */
+struct elm327_messages_t {
+    uint8_t data[ELM327_MAX_MESSAGE_BYTES];
+    uint8_t offset[ELM327_MAX_MESSAGES];
+    uint8_t length[ELM327_MAX_MESSAGES];
+    uint8_t count;
+};
+
+/**
+ * @brief Split an ELM327 response (prompt stripped) into ECU messages
+ *
+ * Handles headers-off output with or without spaces:
+ *   "410C1AF80D3C"                     single frame
+ *   "00A\r0:410C1AF80D3C\r1:11260405"  ISO-TP: byte count, then indexed frames
+ *   "41 0C 1A F8\r41 0C 1B 00"         one line per responding ECU
+ * Status lines ("SEARCHING...", "BUS INIT: ...OK") and text lines are skipped.
+ * Portable so it can be exercised natively.
+ *
+ * @return Number of messages found
+ */
+size_t elm327_parse_messages(const char* response, elm327_messages_t* out);
+
+#endif // ELM327_RESPONSE_H
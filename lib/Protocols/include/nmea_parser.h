@@ -0,0 +1,110 @@
+#ifndef NMEA_PARSER_H
+#define NMEA_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "sensor_hal.h"
+
+// NMEA 0183 caps sentences at 82 characters including '$' and CR/LF;
+// MediaTek modules stay within that, the extra room tolerates long talkers
+#define NMEA_MAX_SENTENCE_LEN   120
+#define NMEA_MAX_FIELDS         24
+
+/**
+ * @brief Sentence types decoded by NmeaParser
+ */
+enum nmea_sentence_t : uint8_t {
+    NMEA_SENTENCE_NONE = 0,     // Rejected or not decoded
+    NMEA_SENTENCE_RMC,          // Time, date, position, speed, course, status
+    NMEA_SENTENCE_GGA,          // Time, position, fix quality, satellites, HDOP, altitude
+    NMEA_SENTENCE_GSA,          // 2D/3D fix mode and DOPs
+    NMEA_SENTENCE_VTG           // Course and speed over ground
+};
+
+/**
+ * @brief Parser counters
+ */
+struct nmea_parser_stats_t {
+    uint32_t sentences;         // Sentences decoded into gps_data_t
+    uint32_t checksum_errors;   // '*hh' did not match the XOR of the body
+    uint32_t malformed;         // Missing '$'/'*', bad talker, too long or unparsable fields
+    uint32_t unsupported;       // Valid sentences of other types (GSV, GLL, TXT, PMTK...)
+};
+
+/**
+ * @brief Single-pass NMEA 0183 parser
+ * Tokenizes a sentence in one walk (checksum accumulated on the way),
+ * dispatches on the sentence type through a table and parses numbers as
+ * fixed-point integers - no sscanf, strtod or heap. Accepts GP (GPS) and
+ * GN (multi-constellation) talkers. Portable (no Arduino dependencies) so it
+ * runs under the native tests.
+ *
+ * Fields are decoded into a copy of the caller's gps_data_t and only written
+ * back once the whole sentence parsed, so a corrupt sentence never leaves a
+ * half-updated fix behind. Empty fields leave the previous value untouched.
+ */
+class NmeaParser {
+public:
+    NmeaParser();
+
+    /**
+     * @brief Parse one sentence and merge it into a fix
+     * @param sentence Sentence starting with '$' (trailing CR/LF allowed, need not be terminated)
+     * @param len Sentence length in bytes
+     * @param data Fix to update
+     * @return Sentence type decoded, or NMEA_SENTENCE_NONE if rejected/ignored
+     */
+    nmea_sentence_t parse(const char* sentence, size_t len, gps_data_t& data);
+
+    /**
+     * @brief Verify the '*hh' checksum of a sentence
+     * @return true if present and matching
+     */
+    static bool verify_checksum(const char* sentence, size_t len);
+
+    /**
+     * @brief Decode a MediaTek acknowledgement ($PMTK001,cmd,flag*hh)
+     * @param cmd Output acknowledged command number (e.g. 220)
+     * @param flag Output result: 0=invalid, 1=unsupported, 2=failed, 3=succeeded
+     * @return true if the sentence is a well-formed PMTK001 with a valid checksum
+     */
+    static bool parse_pmtk_ack(const char* sentence, size_t len, uint16_t* cmd, uint8_t* flag);
+
+    /**
+     * @brief Frame a command as $<body>*hh<CR><LF>
+     * @param body Sentence body without '$' or checksum (e.g. "PMTK220,100")
+     * @param out Output buffer
+     * @param out_cap Output capacity
+     * @return Sentence length, or 0 if it does not fit
+     */
+    static size_t format_sentence(const char* body, char* out, size_t out_cap);
+
+    nmea_parser_stats_t get_stats() const;
+    void reset_stats();
+
+private:
+    struct field_t {
+        const char* text;
+        uint8_t len;
+    };
+
+    typedef bool (*apply_fn_t)(const field_t* fields, uint8_t count, gps_data_t& data);
+
+    struct sentence_entry_t {
+        char type[4];
+        nmea_sentence_t sentence;
+        uint8_t min_fields;
+        apply_fn_t apply;
+    };
+
+    static const sentence_entry_t SENTENCE_TABLE[];
+
+    nmea_parser_stats_t m_stats;
+
+    static bool apply_rmc(const field_t* fields, uint8_t count, gps_data_t& data);
+    static bool apply_gga(const field_t* fields, uint8_t count, gps_data_t& data);
+    static bool apply_gsa(const field_t* fields, uint8_t count, gps_data_t& data);
+    static bool apply_vtg(const field_t* fields, uint8_t count, gps_data_t& data);
+};
+
+#endif // NMEA_PARSER_H
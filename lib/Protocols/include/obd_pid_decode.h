@@ -0,0 +1,106 @@
+#ifndef OBD_PID_DECODE_H
+#define OBD_PID_DECODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "obd_data.h"
+#include "elm327_response.h"
+
+// Service byte of a positive Mode 01 answer
+#define OBD_MODE01_RESPONSE     0x41
+
+/**
+ * @brief Scaling formulas for Mode 01 data bytes (A = data[0], B = data[1])
+ * Integer template parameters keep every coefficient a compile-time
+ * constant, so each instantiation folds down to a multiply-add.
+ */
+
+// (MUL_A * A + MUL_B * B) / DIV + OFFSET
+template <int MUL_A, int MUL_B, int DIV, int OFFSET>
+struct obd_linear_t {
+    static constexpr uint8_t BYTES = MUL_B != 0 ? 2 : 1;
+    static float apply(const uint8_t* d) {
+        return (float)(MUL_A * d[0] + MUL_B * (BYTES > 1 ? d[1] : 0)) / DIV + OFFSET;
+    }
+};
+
+// A & MASK (bit fields such as the DTC count in PID 01)
+template <uint8_t MASK>
+struct obd_masked_t {
+    static constexpr uint8_t BYTES = 1;
+    static float apply(const uint8_t* d) {
+        return (float)(d[0] & MASK);
+    }
+};
+
+typedef void (*obd_decode_fn_t)(const uint8_t* data, obd_data_t& out);
+
+/**
+ * @brief Store a formula's result in one obd_data_t field
+ * @tparam FIELD Pointer to the destination member (any arithmetic type)
+ * @tparam FORMULA Scaling formula
+ */
+template <auto FIELD, typename FORMULA>
+void obd_decode_into(const uint8_t* data, obd_data_t& out) {
+    typedef typename std::remove_reference<decltype(out.*FIELD)>::type field_t;
+    out.*FIELD = static_cast<field_t>(FORMULA::apply(data));
+}
+
+/**
+ * @brief Run several decoders on the same data (PIDs that fill more than one field)
+ */
+template <obd_decode_fn_t... DECODERS>
+void obd_decode_all(const uint8_t* data, obd_data_t& out) {
+    (DECODERS(data, out), ...);
+}
+
+/**
+ * @brief Decode one Mode 01 PID into obd_data_t
+ * Direct-indexed table lookup; no string handling.
+ * @param pid Parameter ID
+ * @param data Data bytes following the PID byte
+ * @param len Number of data bytes available
+ * @param out Destination
+ * @return true if the PID has a decoder and enough data was supplied
+ */
+bool obd_decode_pid(uint8_t pid, const uint8_t* data, size_t len, obd_data_t& out);
+
+/**
+ * @brief Data bytes returned for a Mode 01 PID (excluding the PID byte)
+ * @return 1-4 for known PIDs, 0 if the length is unknown
+ */
+uint8_t obd_mode01_data_length(uint8_t pid);
+
+/**
+ * @brief Whether obd_decode_pid() maps a PID into obd_data_t
+ */
+bool obd_pid_decodable(uint8_t pid);
+
+typedef void (*obd_pid_sink_fn_t)(uint8_t pid, const uint8_t* data, size_t len, void* ctx);
+
+/**
+ * @brief Find the requested PIDs in a Mode 01 response
+ * Walks every "41 <pid> <data>..." message using the Mode 01 length table,
+ * so single and multi-PID answers from any number of ECUs are handled. A PID
+ * of unknown length is only accepted as the last one in its message.
+ * @param response ELM327 response (prompt stripped)
+ * @param pids PIDs that were requested (others in the answer are skipped)
+ * @param count Number of requested PIDs
+ * @param messages Scratch for the parsed messages (static in callers with small stacks)
+ * @param sink Called with each requested PID's data bytes
+ * @param ctx Passed through to sink
+ * @return Number of requested PIDs found
+ */
+size_t obd_walk_mode01_response(const char* response, const uint8_t* pids, size_t count,
+                                elm327_messages_t* messages, obd_pid_sink_fn_t sink, void* ctx);
+
+/**
+ * @brief Decode the requested PIDs of a Mode 01 response into obd_data_t
+ * obd_walk_mode01_response() feeding obd_decode_pid().
+ * @return Number of requested PIDs decoded
+ */
+size_t obd_decode_mode01_response(const char* response, const uint8_t* pids, size_t count,
+                                  obd_data_t& out);
+
+#endif // OBD_PID_DECODE_H
@@ -0,0 +1,125 @@
+#include "elm327_response.h"
+#include <cstring>
+
+static inline int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+/**
+ * @brief Decode the hex digits of one line (spaces ignored)
+ * @return Number of bytes, or -1 if the line holds anything but hex and spaces
+ */
+static int decode_hex_line(const char* p, const char* end, uint8_t* out, size_t cap, size_t* digits) {
+    size_t n = 0;
+    int high = -1;
+    *digits = 0;
+    for (; p < end; p++) {
+        if (*p == ' ') {
+            continue;
+        }
+        int v = hex_value(*p);
+        if (v < 0) {
+            return -1;
+        }
+        (*digits)++;
+        if (high < 0) {
+            high = v;
+        } else {
+            if (n < cap) {
+                out[n] = (uint8_t)((high << 4) | v);
+            }
+            n++;
+            high = -1;
+        }
+    }
+    return (int)(n < cap ? n : cap);
+}
+
+size_t elm327_parse_messages(const char* response, elm327_messages_t* out) {
+    if (!out) {
+        return 0;
+    }
+    out->count = 0;
+    if (!response) {
+        return 0;
+    }
+
+    size_t used = 0;
+    size_t expected = 0;          // ISO-TP byte count of the message being assembled
+    bool multi_frame = false;
+
+    const char* p = response;
+    while (*p) {
+        const char* end = p;
+        while (*end && *end != '\r' && *end != '\n') end++;
+        const char* next = end;
+        while (*next == '\r' || *next == '\n') next++;
+
+        // ISO-TP frame lines carry an index prefix ("0:", "1:", ... "F:")
+        const char* colon = (const char*)memchr(p, ':', end - p);
+        bool indexed = colon && colon - p <= 2 && colon > p && hex_value(colon[-1]) >= 0;
+        const char* data_start = indexed ? colon + 1 : p;
+
+        size_t digits = 0;
+        int n = decode_hex_line(data_start, end, out->data + used, sizeof(out->data) - used, &digits);
+
+        if (n < 0 || digits == 0) {
+            // Status or text line
+        } else if (!indexed && digits == 3) {
+            // Byte count ahead of a multi-frame answer ("00A" / "014")
+            expected = 0;
+            for (const char* q = data_start; q < end; q++) {
+                if (*q != ' ') {
+                    expected = (expected << 4) | (size_t)hex_value(*q);
+                }
+            }
+            if (multi_frame) {
+                out->count++;       // Previous answer was cut short; keep what arrived
+                multi_frame = false;
+            }
+            if (out->count < ELM327_MAX_MESSAGES) {
+                out->offset[out->count] = (uint8_t)used;
+                out->length[out->count] = 0;
+                multi_frame = true;
+            }
+        } else if (indexed && multi_frame) {
+            size_t have = out->length[out->count];
+            size_t take = (size_t)n;
+            if (have + take > expected) {
+                take = expected > have ? expected - have : 0;   // Drop frame padding
+            }
+            out->length[out->count] = (uint8_t)(have + take);
+            used += take;
+            if (have + take >= expected) {
+                out->count++;
+                multi_frame = false;
+            }
+        } else if (!indexed && out->count < ELM327_MAX_MESSAGES) {
+            if (multi_frame) {
+                // Previous multi-frame answer was cut short; keep what arrived
+                out->count++;
+                multi_frame = false;
+                if (out->count >= ELM327_MAX_MESSAGES) {
+                    break;
+                }
+            }
+            out->offset[out->count] = (uint8_t)used;
+            out->length[out->count] = (uint8_t)n;
+            used += (size_t)n;
+            out->count++;
+        }
+
+        if (out->count >= ELM327_MAX_MESSAGES || used >= sizeof(out->data)) {
+            break;
+        }
+        p = next;
+    }
+
+    if (multi_frame && out->count < ELM327_MAX_MESSAGES && out->length[out->count] > 0) {
+        out->count++;
+    }
+    return out->count;
+}
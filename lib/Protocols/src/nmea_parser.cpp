@@ -0,0 +1,453 @@
+#include "nmea_parser.h"
+#include <cstring>
+
+// Coordinates are parsed as ddmm.mmmmmm fixed point (6 minute decimals ~ 1.8 cm)
+#define NMEA_COORD_DECIMALS     6
+#define NMEA_COORD_MINUTE_SCALE 1000000LL
+
+// Cap on integer digits so int64 fixed-point values cannot overflow
+#define NMEA_MAX_INT_DIGITS     12
+
+/**
+ * @brief Character classes for the tokenizer, built at compile time
+ * hex holds the nibble value of 0-9/A-F/a-f (or -1); cls drives the
+ * per-character switch in scan_sentence().
+ */
+enum nmea_char_class_t : uint8_t {
+    NMEA_CHAR_TEXT = 0,
+    NMEA_CHAR_FIELD_SEP,        // ','
+    NMEA_CHAR_CHECKSUM,         // '*'
+    NMEA_CHAR_INVALID           // Control characters, '$' and non-ASCII inside a sentence
+};
+
+struct nmea_char_table_t {
+    uint8_t cls[256];
+    int8_t hex[256];
+
+    constexpr nmea_char_table_t() : cls(), hex() {
+        for (int c = 0; c < 256; c++) {
+            cls[c] = (c < 0x20 || c > 0x7E || c == '$') ? NMEA_CHAR_INVALID : NMEA_CHAR_TEXT;
+            hex[c] = -1;
+        }
+        cls[(uint8_t)','] = NMEA_CHAR_FIELD_SEP;
+        cls[(uint8_t)'*'] = NMEA_CHAR_CHECKSUM;
+        for (int c = '0'; c <= '9'; c++) hex[c] = (int8_t)(c - '0');
+        for (int c = 'A'; c <= 'F'; c++) hex[c] = (int8_t)(c - 'A' + 10);
+        for (int c = 'a'; c <= 'f'; c++) hex[c] = (int8_t)(c - 'a' + 10);
+    }
+};
+
+static constexpr nmea_char_table_t NMEA_CHARS;
+
+enum nmea_scan_result_t {
+    NMEA_SCAN_OK,
+    NMEA_SCAN_MALFORMED,
+    NMEA_SCAN_CHECKSUM
+};
+
+/**
+ * @brief Walk a sentence once: split fields and verify the checksum
+ * @param fields Output field table (may be nullptr to only verify)
+ * @param count Output number of fields including the address field
+ */
+template <typename field_t>
+static nmea_scan_result_t scan_sentence(const char* s, size_t len, field_t* fields, uint8_t* count) {
+    if (!s || len < 2 || s[0] != '$' || len > NMEA_MAX_SENTENCE_LEN) {
+        return NMEA_SCAN_MALFORMED;
+    }
+
+    uint8_t checksum = 0;
+    uint8_t n = 0;
+    size_t field_start = 1;
+    size_t i = 1;
+
+    for (; i < len; i++) {
+        uint8_t c = (uint8_t)s[i];
+        switch (NMEA_CHARS.cls[c]) {
+            case NMEA_CHAR_TEXT:
+                checksum ^= c;
+                continue;
+            case NMEA_CHAR_FIELD_SEP:
+                if (n >= NMEA_MAX_FIELDS - 1) {
+                    return NMEA_SCAN_MALFORMED;
+                }
+                if (fields) {
+                    fields[n].text = s + field_start;
+                    fields[n].len = (uint8_t)(i - field_start);
+                }
+                n++;
+                field_start = i + 1;
+                checksum ^= c;
+                continue;
+            case NMEA_CHAR_CHECKSUM:
+                break;
+            default:
+                return NMEA_SCAN_MALFORMED;
+        }
+        break;
+    }
+
+    // Need '*' followed by two hex digits, then optionally CR/LF/NUL only
+    if (i + 2 >= len) {
+        return NMEA_SCAN_MALFORMED;
+    }
+    int8_t hi = NMEA_CHARS.hex[(uint8_t)s[i + 1]];
+    int8_t lo = NMEA_CHARS.hex[(uint8_t)s[i + 2]];
+    if (hi < 0 || lo < 0) {
+        return NMEA_SCAN_MALFORMED;
+    }
+    for (size_t j = i + 3; j < len; j++) {
+        if (s[j] != '\r' && s[j] != '\n' && s[j] != '\0') {
+            return NMEA_SCAN_MALFORMED;
+        }
+    }
+
+    if (fields) {
+        fields[n].text = s + field_start;
+        fields[n].len = (uint8_t)(i - field_start);
+    }
+    n++;
+    if (count) {
+        *count = n;
+    }
+
+    return (uint8_t)((hi << 4) | lo) == checksum ? NMEA_SCAN_OK : NMEA_SCAN_CHECKSUM;
+}
+
+/**
+ * @brief Parse a decimal field as a fixed-point integer
+ * "12.3456" with decimals=3 gives 12345 (extra digits truncated).
+ */
+static bool parse_fixed(const char* p, uint8_t len, uint8_t decimals, int64_t* out) {
+    const char* end = p + len;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+
+    int64_t value = 0;
+    uint8_t int_digits = 0;
+    uint8_t frac_digits = 0;
+    bool any_digit = false;
+
+    while (p < end && (uint8_t)(*p - '0') < 10) {
+        if (++int_digits > NMEA_MAX_INT_DIGITS) {
+            return false;
+        }
+        value = value * 10 + (*p - '0');
+        any_digit = true;
+        p++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && (uint8_t)(*p - '0') < 10) {
+            if (frac_digits < decimals) {
+                value = value * 10 + (*p - '0');
+                frac_digits++;
+            }
+            any_digit = true;
+            p++;
+        }
+    }
+    if (p != end || !any_digit) {
+        return false;
+    }
+    for (; frac_digits < decimals; frac_digits++) {
+        value *= 10;
+    }
+
+    *out = negative ? -value : value;
+    return true;
+}
+
+static bool parse_uint(const char* p, uint8_t len, uint32_t max_value, uint32_t* out) {
+    int64_t value;
+    if (!parse_fixed(p, len, 0, &value) || value < 0 || value > (int64_t)max_value) {
+        return false;
+    }
+    *out = (uint32_t)value;
+    return true;
+}
+
+static inline bool two_digits(const char* p, uint8_t* out) {
+    uint8_t hi = (uint8_t)(p[0] - '0');
+    uint8_t lo = (uint8_t)(p[1] - '0');
+    if (hi > 9 || lo > 9) {
+        return false;
+    }
+    *out = (uint8_t)(hi * 10 + lo);
+    return true;
+}
+
+NmeaParser::NmeaParser() {
+    reset_stats();
+}
+
+const NmeaParser::sentence_entry_t NmeaParser::SENTENCE_TABLE[] = {
+    // Minimum field counts include the address field and stop at the last field we read
+    { "RMC", NMEA_SENTENCE_RMC, 10, &NmeaParser::apply_rmc },
+    { "GGA", NMEA_SENTENCE_GGA, 10, &NmeaParser::apply_gga },
+    { "GSA", NMEA_SENTENCE_GSA, 18, &NmeaParser::apply_gsa },
+    { "VTG", NMEA_SENTENCE_VTG,  8, &NmeaParser::apply_vtg },
+};
+
+bool NmeaParser::verify_checksum(const char* sentence, size_t len) {
+    return scan_sentence<field_t>(sentence, len, nullptr, nullptr) == NMEA_SCAN_OK;
+}
+
+bool NmeaParser::parse_pmtk_ack(const char* sentence, size_t len, uint16_t* cmd, uint8_t* flag) {
+    field_t fields[NMEA_MAX_FIELDS];
+    uint8_t count = 0;
+    if (scan_sentence(sentence, len, fields, &count) != NMEA_SCAN_OK || count < 3 ||
+        fields[0].len != 7 || memcmp(fields[0].text, "PMTK001", 7) != 0) {
+        return false;
+    }
+
+    uint32_t acked_cmd, result;
+    if (!parse_uint(fields[1].text, fields[1].len, 999, &acked_cmd) ||
+        !parse_uint(fields[2].text, fields[2].len, 3, &result)) {
+        return false;
+    }
+    if (cmd) *cmd = (uint16_t)acked_cmd;
+    if (flag) *flag = (uint8_t)result;
+    return true;
+}
+
+size_t NmeaParser::format_sentence(const char* body, char* out, size_t out_cap) {
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    if (!body || !out) {
+        return 0;
+    }
+
+    size_t body_len = strlen(body);
+    size_t total = body_len + 6;  // '$' + body + '*' + 2 hex + CR + LF
+    if (total + 1 > out_cap) {
+        return 0;
+    }
+
+    uint8_t checksum = 0;
+    out[0] = '$';
+    for (size_t i = 0; i < body_len; i++) {
+        checksum ^= (uint8_t)body[i];
+        out[i + 1] = body[i];
+    }
+    out[body_len + 1] = '*';
+    out[body_len + 2] = HEX_DIGITS[checksum >> 4];
+    out[body_len + 3] = HEX_DIGITS[checksum & 0x0F];
+    out[body_len + 4] = '\r';
+    out[body_len + 5] = '\n';
+    out[total] = '\0';
+    return total;
+}
+
+nmea_sentence_t NmeaParser::parse(const char* sentence, size_t len, gps_data_t& data) {
+    field_t fields[NMEA_MAX_FIELDS];
+    uint8_t count = 0;
+
+    switch (scan_sentence(sentence, len, fields, &count)) {
+        case NMEA_SCAN_OK:
+            break;
+        case NMEA_SCAN_CHECKSUM:
+            m_stats.checksum_errors++;
+            return NMEA_SENTENCE_NONE;
+        default:
+            m_stats.malformed++;
+            return NMEA_SENTENCE_NONE;
+    }
+
+    // Address field: 2-character talker + 3-character type (proprietary $P... is ignored)
+    const field_t& address = fields[0];
+    if (address.len != 5 || address.text[0] != 'G' ||
+        (address.text[1] != 'P' && address.text[1] != 'N')) {
+        m_stats.unsupported++;
+        return NMEA_SENTENCE_NONE;
+    }
+
+    for (const sentence_entry_t& entry : SENTENCE_TABLE) {
+        if (memcmp(address.text + 2, entry.type, 3) != 0) {
+            continue;
+        }
+        gps_data_t updated = data;
+        if (count < entry.min_fields || !entry.apply(fields, count, updated)) {
+            m_stats.malformed++;
+            return NMEA_SENTENCE_NONE;
+        }
+        data = updated;
+        m_stats.sentences++;
+        return entry.sentence;
+    }
+
+    m_stats.unsupported++;
+    return NMEA_SENTENCE_NONE;
+}
+
+nmea_parser_stats_t NmeaParser::get_stats() const {
+    return m_stats;
+}
+
+void NmeaParser::reset_stats() {
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+/**
+ * @brief hhmmss[.sss] -> hour/minute/second/millisecond
+ */
+static bool parse_time(const char* p, uint8_t len, gps_data_t& data) {
+    uint8_t h, m, s;
+    if (len < 6 || !two_digits(p, &h) || !two_digits(p + 2, &m) || !two_digits(p + 4, &s) ||
+        h > 23 || m > 59 || s > 60) {
+        return false;
+    }
+    uint16_t ms = 0;
+    if (len > 6) {
+        if (p[6] != '.') {
+            return false;
+        }
+        uint16_t scale = 100;
+        for (uint8_t i = 7; i < len; i++, scale /= 10) {
+            if (p[i] < '0' || p[i] > '9') {
+                return false;
+            }
+            ms += (p[i] - '0') * scale;    // Digits past milliseconds add nothing
+        }
+    }
+    data.hour = h;
+    data.minute = m;
+    data.second = s;
+    data.millisecond = ms;
+    return true;
+}
+
+/**
+ * @brief ddmmyy -> day/month/year
+ */
+static bool parse_date(const char* p, uint8_t len, gps_data_t& data) {
+    uint8_t d, m, y;
+    if (len != 6 || !two_digits(p, &d) || !two_digits(p + 2, &m) || !two_digits(p + 4, &y) ||
+        d < 1 || d > 31 || m < 1 || m > 12) {
+        return false;
+    }
+    data.day = d;
+    data.month = m;
+    data.year = 2000 + y;
+    return true;
+}
+
+/**
+ * @brief (d)ddmm.mmmm + hemisphere -> signed decimal degrees
+ */
+static bool parse_coordinate(const char* p, uint8_t len, const char* hemi, uint8_t hemi_len,
+                             char positive, char negative, int64_t max_degrees, double* out) {
+    int64_t value;
+    if (hemi_len != 1 || (hemi[0] != positive && hemi[0] != negative) ||
+        !parse_fixed(p, len, NMEA_COORD_DECIMALS, &value) || value < 0) {
+        return false;
+    }
+
+    int64_t degrees = value / (100 * NMEA_COORD_MINUTE_SCALE);
+    int64_t minutes = value % (100 * NMEA_COORD_MINUTE_SCALE);
+    if (degrees > max_degrees || minutes >= 60 * NMEA_COORD_MINUTE_SCALE ||
+        (degrees == max_degrees && minutes > 0)) {
+        return false;
+    }
+
+    double result = (double)degrees + (double)minutes / (60.0 * NMEA_COORD_MINUTE_SCALE);
+    *out = (hemi[0] == negative) ? -result : result;
+    return true;
+}
+
+static bool parse_float(const char* p, uint8_t len, uint8_t decimals, float* out) {
+    static const float SCALE[] = { 1.0f, 10.0f, 100.0f, 1000.0f };
+    int64_t value;
+    if (decimals > 3 || !parse_fixed(p, len, decimals, &value)) {
+        return false;
+    }
+    *out = (float)value / SCALE[decimals];
+    return true;
+}
+
+bool NmeaParser::apply_rmc(const field_t* f, uint8_t count, gps_data_t& data) {
+    // $--RMC,hhmmss.ss,A,llll.ll,a,yyyyy.yy,a,x.x,x.x,ddmmyy,x.x,a[,a]*hh
+    (void)count;
+    if (f[1].len && !parse_time(f[1].text, f[1].len, data)) return false;
+
+    if (f[2].len != 1 || (f[2].text[0] != 'A' && f[2].text[0] != 'V')) return false;
+    bool active = (f[2].text[0] == 'A');
+
+    if (f[3].len || f[5].len) {
+        if (!parse_coordinate(f[3].text, f[3].len, f[4].text, f[4].len, 'N', 'S', 90, &data.latitude) ||
+            !parse_coordinate(f[5].text, f[5].len, f[6].text, f[6].len, 'E', 'W', 180, &data.longitude)) {
+            return false;
+        }
+    } else if (active) {
+        return false;
+    }
+
+    if (f[7].len && !parse_float(f[7].text, f[7].len, 3, &data.speed)) return false;
+    if (f[8].len && !parse_float(f[8].text, f[8].len, 2, &data.course)) return false;
+    if (f[9].len && !parse_date(f[9].text, f[9].len, data)) return false;
+
+    data.valid = active;
+    if (!active) {
+        data.fix_type = 0;
+    }
+    return true;
+}
+
+bool NmeaParser::apply_gga(const field_t* f, uint8_t count, gps_data_t& data) {
+    // $--GGA,hhmmss.ss,llll.ll,a,yyyyy.yy,a,q,ss,x.x,x.x,M,x.x,M,x.x,xxxx*hh
+    (void)count;
+    if (f[1].len && !parse_time(f[1].text, f[1].len, data)) return false;
+
+    uint32_t quality;
+    if (!parse_uint(f[6].text, f[6].len, 8, &quality)) return false;
+
+    if (f[2].len || f[4].len) {
+        if (!parse_coordinate(f[2].text, f[2].len, f[3].text, f[3].len, 'N', 'S', 90, &data.latitude) ||
+            !parse_coordinate(f[4].text, f[4].len, f[5].text, f[5].len, 'E', 'W', 180, &data.longitude)) {
+            return false;
+        }
+    }
+
+    uint32_t sats;
+    if (f[7].len) {
+        if (!parse_uint(f[7].text, f[7].len, 99, &sats)) return false;
+        data.satellites = (uint8_t)sats;
+    }
+    if (f[8].len && !parse_float(f[8].text, f[8].len, 2, &data.hdop)) return false;
+    if (f[9].len) {
+        int64_t alt_mm;
+        if (!parse_fixed(f[9].text, f[9].len, 3, &alt_mm)) return false;
+        data.altitude = (double)alt_mm / 1000.0;
+    }
+
+    data.valid = (quality > 0);
+    if (quality == 0) {
+        data.fix_type = 0;
+    } else if (data.fix_type == 0) {
+        // GGA carries no 2D/3D mode; estimate it until a GSA says otherwise
+        data.fix_type = data.satellites >= 4 ? 2 : 1;
+    }
+    return true;
+}
+
+bool NmeaParser::apply_gsa(const field_t* f, uint8_t count, gps_data_t& data) {
+    // $--GSA,a,x,xx,xx,xx,xx,xx,xx,xx,xx,xx,xx,xx,xx,x.x,x.x,x.x[,x]*hh
+    (void)count;
+    uint32_t mode;
+    if (!parse_uint(f[2].text, f[2].len, 3, &mode) || mode == 0) return false;
+    if (f[16].len && !parse_float(f[16].text, f[16].len, 2, &data.hdop)) return false;
+
+    // GSA mode is 1=no fix, 2=2D, 3=3D
+    data.fix_type = (uint8_t)(mode - 1);
+    return true;
+}
+
+bool NmeaParser::apply_vtg(const field_t* f, uint8_t count, gps_data_t& data) {
+    // $--VTG,x.x,T,x.x,M,x.x,N,x.x,K[,a]*hh
+    (void)count;
+    if (f[1].len && !parse_float(f[1].text, f[1].len, 2, &data.course)) return false;
+    if (f[5].len && !parse_float(f[5].text, f[5].len, 3, &data.speed)) return false;
+    return true;
+}
@@ -0,0 +1,155 @@
+#include "obd_pid_decode.h"
+
+/**
+ * @brief Mode 01 data lengths for PIDs 0x00-0x60 (SAE J1979)
+ */
+static constexpr uint8_t MODE01_DATA_LENGTH[0x61] = {
+    //  0  1  2  3  4  5  6  7  8  9  A  B  C  D  E  F
+        4, 4, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1,   // 0x00
+        2, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 2,   // 0x10
+        4, 2, 2, 2, 4, 4, 4, 4, 4, 4, 4, 4, 1, 1, 1, 1,   // 0x20
+        1, 2, 2, 1, 4, 4, 4, 4, 4, 4, 4, 4, 2, 2, 2, 2,   // 0x30
+        4, 4, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 4,   // 0x40
+        4, 1, 1, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 2, 2, 1,   // 0x50
+        4                                                 // 0x60
+};
+
+/**
+ * @brief One decodable PID: bytes read by its formula and where the result goes
+ */
+struct obd_pid_def_t {
+    uint8_t pid;
+    uint8_t bytes;
+    obd_decode_fn_t decode;
+};
+
+template <uint8_t PID, auto FIELD, typename FORMULA>
+static constexpr obd_pid_def_t obd_pid() {
+    return { PID, FORMULA::BYTES, &obd_decode_into<FIELD, FORMULA> };
+}
+
+static constexpr obd_pid_def_t OBD_PID_DEFS[] = {
+    obd_pid<0x01, &obd_data_t::dtc_count,           obd_masked_t<0x7F>>(),
+    obd_pid<0x03, &obd_data_t::fuel_system_status,  obd_linear_t<1, 0, 1, 0>>(),
+    obd_pid<0x04, &obd_data_t::engine_load,         obd_linear_t<100, 0, 255, 0>>(),
+    obd_pid<0x05, &obd_data_t::coolant_temp,        obd_linear_t<1, 0, 1, -40>>(),
+    obd_pid<0x0A, &obd_data_t::fuel_pressure,       obd_linear_t<3, 0, 1, 0>>(),
+    obd_pid<0x0C, &obd_data_t::engine_rpm,          obd_linear_t<256, 1, 4, 0>>(),
+    obd_pid<0x0D, &obd_data_t::vehicle_speed,       obd_linear_t<1, 0, 1, 0>>(),
+    obd_pid<0x0E, &obd_data_t::timing_advance,      obd_linear_t<1, 0, 2, -64>>(),
+    obd_pid<0x0F, &obd_data_t::intake_temp,         obd_linear_t<1, 0, 1, -40>>(),
+    obd_pid<0x10, &obd_data_t::maf_flow,            obd_linear_t<256, 1, 100, 0>>(),
+    obd_pid<0x11, &obd_data_t::throttle_position,   obd_linear_t<100, 0, 255, 0>>(),
+    { 0x14, 2, &obd_decode_all<
+        &obd_decode_into<&obd_data_t::o2_sensor_voltage, obd_linear_t<1, 0, 200, 0>>,
+        &obd_decode_into<&obd_data_t::o2_sensor_trim,    obd_linear_t<0, 100, 128, -100>>> },
+    obd_pid<0x1F, &obd_data_t::run_time,            obd_linear_t<256, 1, 1, 0>>(),
+    obd_pid<0x21, &obd_data_t::distance_with_mil,   obd_linear_t<256, 1, 1, 0>>(),
+    obd_pid<0x2F, &obd_data_t::fuel_level,          obd_linear_t<100, 0, 255, 0>>(),
+    obd_pid<0x33, &obd_data_t::barometric_pressure, obd_linear_t<1, 0, 1, 0>>(),
+};
+
+static constexpr bool decoders_fit_lengths() {
+    for (const auto& def : OBD_PID_DEFS) {
+        if (def.pid >= sizeof(MODE01_DATA_LENGTH) || def.bytes > MODE01_DATA_LENGTH[def.pid]) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(decoders_fit_lengths(), "OBD PID decoder reads past the PID's data length");
+
+/**
+ * @brief Direct-indexed view of the definitions, built at compile time
+ */
+struct obd_pid_table_t {
+    uint8_t length[256];
+    obd_decode_fn_t decode[256];
+
+    constexpr obd_pid_table_t() : length(), decode() {
+        for (size_t pid = 0; pid < sizeof(MODE01_DATA_LENGTH); pid++) {
+            length[pid] = MODE01_DATA_LENGTH[pid];
+        }
+        for (const auto& def : OBD_PID_DEFS) {
+            decode[def.pid] = def.decode;
+        }
+    }
+};
+
+static constexpr obd_pid_table_t OBD_PID_TABLE;
+
+bool obd_decode_pid(uint8_t pid, const uint8_t* data, size_t len, obd_data_t& out) {
+    obd_decode_fn_t decode = OBD_PID_TABLE.decode[pid];
+    if (!decode || len < OBD_PID_TABLE.length[pid]) {
+        return false;
+    }
+    decode(data, out);
+    return true;
+}
+
+uint8_t obd_mode01_data_length(uint8_t pid) {
+    return OBD_PID_TABLE.length[pid];
+}
+
+bool obd_pid_decodable(uint8_t pid) {
+    return OBD_PID_TABLE.decode[pid] != nullptr;
+}
+
+size_t obd_walk_mode01_response(const char* response, const uint8_t* pids, size_t count,
+                                elm327_messages_t* messages, obd_pid_sink_fn_t sink, void* ctx) {
+    if (!pids || !messages || !sink || elm327_parse_messages(response, messages) == 0) {
+        return 0;
+    }
+
+    size_t found = 0;
+    for (size_t m = 0; m < messages->count; m++) {
+        const uint8_t* msg = messages->data + messages->offset[m];
+        size_t len = messages->length[m];
+        if (len < 3 || msg[0] != OBD_MODE01_RESPONSE) {
+            continue;
+        }
+
+        // 41 <pid> <data> [<pid> <data> ...]
+        size_t i = 1;
+        while (i < len) {
+            uint8_t pid = msg[i];
+            size_t data_len = obd_mode01_data_length(pid);
+            if (data_len == 0) {
+                // Unknown length: only safe as the last PID of the message
+                data_len = len - i - 1;
+            }
+            if (data_len == 0 || i + 1 + data_len > len) {
+                break;
+            }
+            for (size_t k = 0; k < count; k++) {
+                if (pids[k] == pid) {
+                    sink(pid, msg + i + 1, data_len, ctx);
+                    found++;
+                    break;
+                }
+            }
+            i += 1 + data_len;
+        }
+    }
+    return found;
+}
+
+struct obd_decode_ctx_t {
+    obd_data_t* out;
+    size_t decoded;
+};
+
+static void decode_into(uint8_t pid, const uint8_t* data, size_t len, void* ctx) {
+    obd_decode_ctx_t* decode = static_cast<obd_decode_ctx_t*>(ctx);
+    if (obd_decode_pid(pid, data, len, *decode->out)) {
+        decode->decoded++;
+    }
+}
+
+size_t obd_decode_mode01_response(const char* response, const uint8_t* pids, size_t count,
+                                  obd_data_t& out) {
+    elm327_messages_t messages;
+    obd_decode_ctx_t ctx = { &out, 0 };
+    obd_walk_mode01_response(response, pids, count, &messages, decode_into, &ctx);
+    return ctx.decoded;
+}
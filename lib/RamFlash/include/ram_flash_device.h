@@ -0,0 +1,83 @@
+#ifndef RAM_FLASH_DEVICE_H
+#define RAM_FLASH_DEVICE_H
+
+#include "flash_device.h"
+
+/**
+ * @brief RAM-backed flash emulator for native builds
+ *
+ * Follows NOR semantics so code that forgets to erase shows corrupted data
+ * instead of working by accident. A write budget simulates power loss: once
+ * it is spent, the write in progress stops part way and every later write
+ * or erase fails until power_cycle(). An erase cut does the same part way
+ * through a sector erase. A write fault makes writes at one offset program
+ * only half their bytes and fail while power stays on.
+ *
+ * Test-only: the firmware never links this library.
+ */
+class RamFlashDevice : public IFlashDevice {
+public:
+    /**
+     * @brief Allocate an erased region
+     * @param size Total bytes (multiple of sector_size)
+     * @param sector_size Erase granularity
+     */
+    RamFlashDevice(uint32_t size, uint32_t sector_size = 4096);
+    ~RamFlashDevice() override;
+
+    RamFlashDevice(const RamFlashDevice&) = delete;
+    RamFlashDevice& operator=(const RamFlashDevice&) = delete;
+
+    uint32_t size() const override;
+    uint32_t sector_size() const override;
+    bool read(uint32_t offset, void* dst, size_t len) override;
+    bool write(uint32_t offset, const void* src, size_t len) override;
+    bool erase_sector(uint32_t sector) override;
+
+    /**
+     * @brief Lose power after this many more bytes are written (-1 = never)
+     */
+    void set_write_budget(int32_t bytes);
+
+    /**
+     * @brief Lose power during a later sector erase
+     * @param erases Erase that is cut (1 = the next one, 0 = never)
+     * @param erased_bytes Bytes at the start of that sector erased before the cut
+     */
+    void set_erase_cut(uint32_t erases, uint32_t erased_bytes);
+
+    /**
+     * @brief Fail the next writes that start at an offset
+     * @param offset Byte offset the failing writes start at
+     * @param count Number of writes there that fail (0 = none)
+     */
+    void fail_writes_at(uint32_t offset, uint32_t count);
+
+    /**
+     * @brief Restore power (contents are kept, the budget and erase cut are cleared)
+     */
+    void power_cycle();
+
+    /**
+     * @brief Direct access to the contents (for inspection and fault injection)
+     */
+    uint8_t* data();
+
+    uint32_t get_erase_count() const;
+    uint32_t get_read_count() const;
+
+private:
+    uint8_t* m_data;
+    uint32_t m_size;
+    uint32_t m_sector_size;
+    int32_t m_write_budget;
+    uint32_t m_erase_cut;
+    uint32_t m_erase_cut_bytes;
+    uint32_t m_fail_offset;
+    uint32_t m_fail_count;
+    bool m_powered;
+    uint32_t m_erase_count;
+    uint32_t m_read_count;
+};
+
+#endif // RAM_FLASH_DEVICE_H
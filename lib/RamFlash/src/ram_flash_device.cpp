@@ -0,0 +1,105 @@
+#include "ram_flash_device.h"
+#include <cstring>
+
+RamFlashDevice::RamFlashDevice(uint32_t size, uint32_t sector_size)
+    : m_data(new uint8_t[size]), m_size(size), m_sector_size(sector_size),
+      m_write_budget(-1), m_erase_cut(0), m_erase_cut_bytes(0),
+      m_fail_offset(0), m_fail_count(0), m_powered(true), m_erase_count(0), m_read_count(0) {
+    memset(m_data, 0xFF, size);
+}
+
+RamFlashDevice::~RamFlashDevice() {
+    delete[] m_data;
+}
+
+uint32_t RamFlashDevice::size() const {
+    return m_size;
+}
+
+uint32_t RamFlashDevice::sector_size() const {
+    return m_sector_size;
+}
+
+bool RamFlashDevice::read(uint32_t offset, void* dst, size_t len) {
+    if (!dst || offset > m_size || len > m_size - offset) {
+        return false;
+    }
+    memcpy(dst, m_data + offset, len);
+    m_read_count++;
+    return true;
+}
+
+bool RamFlashDevice::write(uint32_t offset, const void* src, size_t len) {
+    if (!m_powered || !src || offset > m_size || len > m_size - offset) {
+        return false;
+    }
+
+    size_t allowed = len;
+    bool faulted = false;
+    if (m_fail_count > 0 && offset == m_fail_offset) {
+        m_fail_count--;
+        allowed = len / 2;
+        faulted = true;
+    }
+    if (m_write_budget >= 0 && (size_t)m_write_budget < allowed) {
+        allowed = (size_t)m_write_budget;
+        m_powered = false;
+    }
+    if (m_write_budget >= 0) {
+        m_write_budget -= (int32_t)allowed;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(src);
+    for (size_t i = 0; i < allowed; i++) {
+        m_data[offset + i] &= bytes[i];
+    }
+    return m_powered && !faulted;
+}
+
+bool RamFlashDevice::erase_sector(uint32_t sector) {
+    if (!m_powered || sector >= m_size / m_sector_size) {
+        return false;
+    }
+
+    if (m_erase_cut > 0 && --m_erase_cut == 0) {
+        uint32_t erased = m_erase_cut_bytes < m_sector_size ? m_erase_cut_bytes : m_sector_size;
+        memset(m_data + sector * m_sector_size, 0xFF, erased);
+        m_powered = false;
+        return false;
+    }
+    memset(m_data + sector * m_sector_size, 0xFF, m_sector_size);
+    m_erase_count++;
+    return true;
+}
+
+void RamFlashDevice::set_write_budget(int32_t bytes) {
+    m_write_budget = bytes;
+}
+
+void RamFlashDevice::set_erase_cut(uint32_t erases, uint32_t erased_bytes) {
+    m_erase_cut = erases;
+    m_erase_cut_bytes = erased_bytes;
+}
+
+void RamFlashDevice::fail_writes_at(uint32_t offset, uint32_t count) {
+    m_fail_offset = offset;
+    m_fail_count = count;
+}
+
+void RamFlashDevice::power_cycle() {
+    m_write_budget = -1;
+    m_erase_cut = 0;
+    m_powered = true;
+}
+
+uint8_t* RamFlashDevice::data() {
+    return m_data;
+}
+
+uint32_t RamFlashDevice::get_erase_count() const {
+    return m_erase_count;
+}
+
+uint32_t RamFlashDevice::get_read_count() const {
+    return m_read_count;
+}
@@ -24,6 +24,8 @@ struct obd_data_t {
     float o2_sensor_voltage = 0.0f;    // O2 sensor voltage (V)
     float o2_sensor_trim = 0.0f;       // O2 sensor trim (%)
     float fuel_consumption = 0.0f;     // Fuel consumption (L/h estimated)
+    float fuel_level = 0.0f;           // Fuel tank level (%)
+    uint8_t fuel_system_status = 0;    // Fuel system 1 status bits (open/closed loop)
     
     // Diagnostic
     float maf_flow = 0.0f;             // Mass air flow (g/s)
@@ -31,6 +33,10 @@ struct obd_data_t {
     
     // DTC (Diagnostic Trouble Code)
     uint32_t dtc_count = 0;            // Number of active DTCs
+    uint32_t distance_with_mil = 0;    // Distance traveled with MIL on (km)
+    
+    // Engine run time
+    uint32_t run_time = 0;             // Seconds since engine start
     
     // Connection state
     bool connected = false;            // Connected to OBD device
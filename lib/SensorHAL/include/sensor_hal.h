@@ -1,6 +1,7 @@
 #ifndef SENSOR_HAL_H
 #define SENSOR_HAL_H
 
+#include <cstddef>
 #include <cstdint>
 #include "obd_data.h"
 
@@ -12,14 +13,19 @@ struct gps_data_t {
     double longitude;
     double altitude;
     float speed;           // in knots
+    float course;          // Course over ground, degrees true
+    float hdop;            // Horizontal dilution of precision (0 = unknown)
     uint16_t year;
     uint8_t month;
     uint8_t day;
     uint8_t hour;
     uint8_t minute;
     uint8_t second;
+    uint16_t millisecond;  // Fraction of the fix epoch (10 Hz fixes land on .000, .100, ...)
+    int64_t fix_time_us;   // esp_timer_get_time() when this epoch's RMC started arriving (0 = none yet)
     bool valid;
     uint8_t satellites;
+    uint8_t fix_type;      // 0=none, 1=2D, 2=3D (gps_record_t encoding)
 };
 
 /**
@@ -45,9 +51,32 @@ struct gyro_data_t {
  * @brief Compass/Magnetometer Data Structure
  */
 struct compass_data_t {
-    float x;
+    float x;               // in microtesla (uT), accelerometer axis frame
     float y;
     float z;
+    float heading;         // Tilt-compensated magnetic bearing, 0-360 degrees
+};
+
+/**
+ * @brief Maximum samples returned by one read_batch() call
+ * Sized for a full 512-byte ICM20948 FIFO of accel+gyro frames (42).
+ */
+#define IMU_BATCH_MAX_SAMPLES 48
+
+/**
+ * @brief Timestamped accelerometer sample (hardware FIFO batches)
+ */
+struct accel_sample_t {
+    int64_t timestamp_us;  // esp_timer_get_time() at which the sample was taken
+    accel_data_t data;
+};
+
+/**
+ * @brief Timestamped gyroscope sample (hardware FIFO batches)
+ */
+struct gyro_sample_t {
+    int64_t timestamp_us;  // esp_timer_get_time() at which the sample was taken
+    gyro_data_t data;
 };
 
 /**
@@ -83,6 +112,19 @@ public:
     virtual bool update() = 0;
     virtual accel_data_t get_data() const = 0;
     virtual bool is_valid() const = 0;
+    
+    /**
+     * @brief Sample rate of hardware batching (0 = not batching, use get_data())
+     */
+    virtual uint16_t get_batch_rate_hz() const { return 0; }
+    
+    /**
+     * @brief Copy the samples collected by the last update(), oldest first
+     * @param out Destination array
+     * @param max_samples Capacity of out
+     * @return Number of samples copied (0 if batching is not supported)
+     */
+    virtual size_t read_batch(accel_sample_t* out, size_t max_samples) { (void)out; (void)max_samples; return 0; }
 };
 
 /**
@@ -95,6 +137,19 @@ public:
     virtual bool update() = 0;
     virtual gyro_data_t get_data() const = 0;
     virtual bool is_valid() const = 0;
+    
+    /**
+     * @brief Sample rate of hardware batching (0 = not batching, use get_data())
+     */
+    virtual uint16_t get_batch_rate_hz() const { return 0; }
+    
+    /**
+     * @brief Copy the samples collected by the last update(), oldest first
+     * @param out Destination array
+     * @param max_samples Capacity of out
+     * @return Number of samples copied (0 if batching is not supported)
+     */
+    virtual size_t read_batch(gyro_sample_t* out, size_t max_samples) { (void)out; (void)max_samples; return 0; }
 };
 
 /**
@@ -146,6 +201,11 @@ public:
     compass_data_t get_comp() const;
     battery_data_t get_battery() const;
     
+    // Hardware-batched IMU samples from the last update_imu() (0 = not batching)
+    uint16_t get_imu_batch_rate_hz() const;
+    size_t get_accel_batch(accel_sample_t* out, size_t max_samples);
+    size_t get_gyro_batch(gyro_sample_t* out, size_t max_samples);
+    
     // Validity checks
     bool gps_valid() const;
     bool accel_valid() const;
@@ -156,6 +156,27 @@ battery_data_t SensorManager::get_battery() const {
     return battery_data_t{};
 }
 
+uint16_t SensorManager::get_imu_batch_rate_hz() const {
+    if (m_accel) {
+        return m_accel->get_batch_rate_hz();
+    }
+    return 0;
+}
+
+size_t SensorManager::get_accel_batch(accel_sample_t* out, size_t max_samples) {
+    if (m_accel) {
+        return m_accel->read_batch(out, max_samples);
+    }
+    return 0;
+}
+
+size_t SensorManager::get_gyro_batch(gyro_sample_t* out, size_t max_samples) {
+    if (m_gyro) {
+        return m_gyro->read_batch(out, max_samples);
+    }
+    return 0;
+}
+
 bool SensorManager::gps_valid() const {
     return m_gps && m_gps->is_valid();
 }
@@ -0,0 +1,93 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <thread>
+#endif
+
+// Reader retries before backing off (covers a writer preempted mid-copy)
+#define SEQLOCK_SPIN_LIMIT 64
+
+/**
+ * @brief Single-writer sequence lock around a plain value
+ *
+ * The writer never blocks: it bumps the sequence to odd, copies the value,
+ * then bumps it to even. Readers copy optimistically and retry if the
+ * sequence changed or was odd, so they always see a value from exactly one
+ * store(). Intended for latest-sample snapshots (*_data_t) shared between
+ * the RT logger and lower-priority tasks on the other core.
+ *
+ * @tparam T Trivially copyable value type
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+public:
+    SeqLock() : m_seq(0) {
+        memset((void*)&m_value, 0, sizeof(T));
+    }
+
+    /**
+     * @brief Publish a new value (single writer task only)
+     */
+    void store(const T& value) {
+        uint32_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy((void*)&m_value, &value, sizeof(T));
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Read a consistent copy (any task, never takes a lock)
+     */
+    T load() const {
+        T copy;
+        uint32_t spins = 0;
+        while (true) {
+            uint32_t before = m_seq.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                memcpy(&copy, (const void*)&m_value, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_seq.load(std::memory_order_relaxed) == before) {
+                    return copy;
+                }
+            }
+            if (++spins >= SEQLOCK_SPIN_LIMIT) {
+                spins = 0;
+                back_off();
+            }
+        }
+    }
+
+    /**
+     * @brief Number of completed store() calls
+     */
+    uint32_t version() const {
+        return m_seq.load(std::memory_order_acquire) >> 1;
+    }
+
+private:
+    std::atomic<uint32_t> m_seq;
+    volatile T m_value;
+
+    static void back_off() {
+#ifdef ARDUINO
+        // Writer may be preempted on this core; let it finish
+        vTaskDelay(1);
+#else
+        std::this_thread::yield();
+#endif
+    }
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,29 @@
+#ifndef ESP_PARTITION_FLASH_H
+#define ESP_PARTITION_FLASH_H
+
+#include <esp_partition.h>
+#include "flash_device.h"
+
+/**
+ * @brief IFlashDevice over an esp_partition_t (e.g. "storage" in partitions.csv)
+ */
+class EspPartitionFlash : public IFlashDevice {
+public:
+    EspPartitionFlash();
+
+    /**
+     * @brief Bind to a partition (nullptr detaches)
+     */
+    void attach(const esp_partition_t* partition);
+
+    uint32_t size() const override;
+    uint32_t sector_size() const override;
+    bool read(uint32_t offset, void* dst, size_t len) override;
+    bool write(uint32_t offset, const void* src, size_t len) override;
+    bool erase_sector(uint32_t sector) override;
+
+private:
+    const esp_partition_t* m_partition;
+};
+
+#endif // ESP_PARTITION_FLASH_H
@@ -0,0 +1,261 @@
+#ifndef LOG_BLOCK_WRITER_H
+#define LOG_BLOCK_WRITER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <esp_partition.h>
+#include "session_header.h"
+#include "log_record_ring.h"
+#include "esp_partition_flash.h"
+#include "flash_log_ring.h"
+#include "session_index.h"
+
+/**
+ * @brief Block writer statistics
+ */
+struct log_writer_stats_t {
+    uint32_t records_appended;    // Records copied into acquisition buffers
+    uint32_t records_dropped;     // Records lost because no acquisition buffer was free
+    uint32_t ring_dropped;        // Records lost because a source ring was full
+    uint32_t ring_high_water;     // Deepest source ring occupancy seen
+    uint32_t blocks_written;      // Compressed blocks committed to flash
+    uint32_t bytes_uncompressed;  // Total acquisition bytes compressed
+    uint32_t bytes_compressed;    // Total payload bytes written (excluding headers)
+    uint32_t flash_errors;        // Failed erase/write operations
+    uint32_t erase_stalls;        // Block writes that waited on a sector erase
+    uint32_t max_compress_us;     // Worst-case compression time for one block
+    uint32_t max_write_us;        // Worst-case flash write time for one block
+    uint32_t write_offset;        // Current write head within the partition
+    uint32_t tail_offset;         // Oldest data still in the partition
+};
+
+/**
+ * @brief Where one indexed session currently sits in the ring
+ */
+struct log_session_info_t {
+    session_meta_t meta;
+    uint32_t first_sector;      // First sector still holding the session
+    uint32_t first_sequence;    // Its sequence number
+    uint32_t sector_count;      // Sectors from first_sector, wrapping around the ring
+    bool complete;              // Session start not overwritten yet
+    bool active;                // Session being written now
+};
+
+/**
+ * @brief LZ4 block writer pipeline for the raw logging partition
+ *
+ * Implements the flow from docs/LOG_FORMAT.md:
+ *   1. Sampling tasks push records into their own lock-free SPSC ring
+ *      (see add_source()); a drain task on core 0 moves them in batches
+ *      into a 16 KB acquisition buffer in internal SRAM (double buffered).
+ *      A buffer is closed when full or ACQ_BUFFER_MAX_AGE_MS after its
+ *      first record, so flash never lags the sensors by more than that.
+ *   2. A compressor task on core 0 LZ4-compresses full buffers into PSRAM.
+ *   3. A writer task on core 0 appends log_block_header_t + payload to a
+ *      FlashLogRing over the "storage" partition, erasing ahead while idle.
+ *
+ * The ring is recovered on start(), so a new session continues after the
+ * previous one instead of overwriting it. Each session is recorded in the
+ * NVS session index, and its sectors can be read back while logging runs
+ * (list_sessions(), read_session()).
+ */
+class LogBlockWriter {
+public:
+    static const size_t ACQ_BUFFER_SIZE = 16 * 1024;
+    static const size_t ACQ_BUFFER_COUNT = 2;
+    static const size_t OUT_BUFFER_COUNT = 2;
+    static const size_t MAX_SOURCES = 4;
+    static const uint32_t ACQ_BUFFER_MAX_AGE_MS = 1000;
+
+    /**
+     * @brief Constructor
+     * @param partition_label Data partition used for logging (see partitions.csv)
+     */
+    explicit LogBlockWriter(const char* partition_label = "storage");
+
+    ~LogBlockWriter();
+
+    /**
+     * @brief Recover the ring, allocate buffers, write the session start header and start the tasks
+     * @return true if the pipeline is running
+     */
+    bool start();
+
+    /**
+     * @brief Stop the pipeline tasks (buffered data is discarded)
+     * Each task finishes the block it is working on and exits; buffers are
+     * only freed once all of them have.
+     */
+    void stop();
+
+    /**
+     * @brief Register a producer ring to be drained into the log
+     * Sources are only ever added; the ring must outlive the writer.
+     * @param ring Ring filled by exactly one sampling task
+     * @return true if registered, false if MAX_SOURCES rings are already attached
+     */
+    bool add_source(log_record_ring_t* ring);
+
+    /**
+     * @brief Check if the pipeline is running
+     */
+    bool is_running() const;
+
+    /**
+     * @brief Session UUID written into every block header (16 bytes)
+     */
+    const uint8_t* get_startup_id() const;
+
+    /**
+     * @brief esp_timer_get_time() at session start, the base for record timestamps
+     */
+    int64_t get_session_start_us() const;
+
+    /**
+     * @brief Get pipeline statistics
+     */
+    log_writer_stats_t get_stats() const;
+
+    /**
+     * @brief List the indexed sessions still (at least partly) in the ring, newest first
+     * @param out Output array (SESSION_INDEX_SLOTS entries cover the index)
+     * @param max_count Capacity of out
+     * @return Number of sessions written
+     */
+    size_t list_sessions(log_session_info_t* out, size_t max_count) const;
+
+    /**
+     * @brief Look up one listed session by its startup counter
+     * @return false if it is not indexed or has been overwritten
+     */
+    bool find_session(uint32_t startup_counter, log_session_info_t* info) const;
+
+    /**
+     * @brief Copy part of a session's sector image straight from flash
+     *
+     * The image is the session's sectors in ring order (sector_count x
+     * sector size), laid out like a partition dump so ponylog decodes it.
+     * Reads go through the partition's memory map, so unlike
+     * esp_partition_read() they never disable the flash cache under the
+     * sampling loop. Safe to call from any task while logging runs.
+     * @param session Session from list_sessions() or find_session()
+     * @param offset Byte offset within the image
+     * @param dst Destination (e.g. a response buffer)
+     * @param len Bytes wanted
+     * @return Bytes copied (0 past the end of the image)
+     */
+    size_t read_session(const log_session_info_t& session, uint32_t offset, uint8_t* dst, size_t len) const;
+
+    /**
+     * @brief Flash sector size of the logging partition (0 before start())
+     */
+    uint32_t get_sector_size() const;
+
+private:
+    struct acq_buffer_t {
+        uint8_t* data;
+        size_t used;
+        int64_t opened_us;      // First record appended
+        int64_t closed_us;
+    };
+
+    struct out_slot_t {
+        uint8_t index;
+        uint32_t length;
+    };
+
+    const char* m_partition_label;
+    const esp_partition_t* m_partition;
+    std::atomic<bool> m_running;
+
+    // Acquisition side (producer task)
+    acq_buffer_t m_acq[ACQ_BUFFER_COUNT];
+    acq_buffer_t* m_active;
+    uint8_t m_active_index;
+
+    // Compression side (PSRAM output buffers)
+    uint8_t* m_out[OUT_BUFFER_COUNT];
+    size_t m_out_capacity;
+    uint16_t* m_hash_table;
+
+    QueueHandle_t m_free_acq;
+    QueueHandle_t m_full_acq;
+    QueueHandle_t m_free_out;
+    QueueHandle_t m_full_out;
+
+    TaskHandle_t m_drain_task;
+    TaskHandle_t m_compress_task;
+    TaskHandle_t m_writer_task;
+    std::atomic<uint8_t> m_tasks_running;   // Pipeline tasks that have not exited yet
+
+    // Producer rings drained by the drain task
+    log_record_ring_t* m_sources[MAX_SOURCES];
+    std::atomic<uint8_t> m_source_count;
+
+    // Circular log over the partition (writer task only once running)
+    EspPartitionFlash m_flash;
+    FlashLogRing m_ring;
+
+    // Read-only view of the partition for readers on other tasks
+    const uint8_t* m_map;
+    esp_partition_mmap_handle_t m_map_handle;
+
+    // Session index and the ring position it is resolved against
+    SessionIndex m_index;
+    mutable portMUX_TYPE m_position_lock;
+    flash_ring_stats_t m_ring_stats;    // Ring snapshot published by the writer task
+    bool m_utc_pending;         // Session UTC not yet recorded in the index
+
+    session_start_header_t m_session;
+
+    // Counters updated by the drain, compressor and writer tasks
+    mutable portMUX_TYPE m_stats_lock;
+    log_writer_stats_t m_stats;
+
+    bool allocate_buffers();
+    void free_buffers();
+    void create_session_header();
+    void close_active_buffer();
+
+    /**
+     * @brief Append one record to the active acquisition buffer (drain task only)
+     * Never blocks: if both buffers are still being compressed the record is dropped.
+     */
+    bool append(const void* record, size_t len);
+
+    bool write_entry(const uint8_t* data, size_t len, uint32_t* offset = nullptr);
+
+    /**
+     * @brief Index the session whose start header was written at offset
+     */
+    void index_session(uint32_t offset);
+
+    /**
+     * @brief Publish a snapshot of the ring (head, tail, error counters) to readers
+     * Writer task only once running; FlashLogRing itself is not thread safe.
+     */
+    void publish_ring_position();
+
+    /**
+     * @brief Record the session's UTC start in the index once GPS time is known
+     */
+    void update_session_utc();
+
+    /**
+     * @brief Read raw partition bytes through the memory map
+     */
+    bool read_flash(uint32_t offset, void* dst, size_t len) const;
+
+    static void drain_task_wrapper(void* arg);
+    static void compress_task_wrapper(void* arg);
+    static void writer_task_wrapper(void* arg);
+    void drain_loop();
+    void compress_loop();
+    void writer_loop();
+};
+
+#endif // LOG_BLOCK_WRITER_H
@@ -0,0 +1,19 @@
+#ifndef LOG_RECORD_RING_H
+#define LOG_RECORD_RING_H
+
+#include "spsc_ring.h"
+#include "log_records.h"
+
+/**
+ * @brief Ring depth per producer
+ * At 200 Hz IMU + 10 Hz GPS the drain task (10 ms period) normally sees
+ * 2-3 records; 256 slots ride out ~1.2 s of consumer stall.
+ */
+#define LOG_RECORD_RING_CAPACITY 256
+
+/**
+ * @brief Typed record queue from a sampling task to LogBlockWriter
+ */
+typedef SpscRing<log_record_any_t, LOG_RECORD_RING_CAPACITY> log_record_ring_t;
+
+#endif // LOG_RECORD_RING_H
@@ -0,0 +1,88 @@
+#ifndef SESSION_INDEX_H
+#define SESSION_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <freertos/FreeRTOS.h>
+
+// Rotating NVS slots (docs/LOG_FORMAT.md, "NVS Session Index")
+#define SESSION_INDEX_SLOTS     8
+
+/**
+ * @brief Session summary stored in one NVS slot (packed, little-endian)
+ */
+struct __attribute__((packed)) session_meta_t {
+    uint8_t  startup_id[16];            // Session UUID, as in the session start header
+    uint32_t first_block_offset;        // Session start header within the partition
+    uint32_t first_sequence;            // Sequence number of the sector holding it
+    int64_t  session_start_time_esp_us; // esp_timer_get_time() at session start
+    int64_t  gps_utc_at_start;          // Seconds since epoch, 0 until GPS time is known
+    uint8_t  mac_addr[6];
+    uint8_t  fw_sha[8];
+    uint32_t startup_counter;           // Session number, never reused
+};
+
+/**
+ * @brief NVS index of the most recent logging sessions
+ *
+ * One blob per slot plus the next slot to overwrite, so recording a session
+ * is two small NVS writes. A session's end is not stored: it runs until the
+ * next session's first sector (or the write head), which survives power
+ * loss without any NVS write at shutdown.
+ *
+ * Thread safe: the in-memory copy is guarded by a spinlock and NVS is
+ * written from a private copy, so the writer task can update the index
+ * while the web server lists it.
+ */
+class SessionIndex {
+public:
+    SessionIndex();
+
+    /**
+     * @brief Read every slot from NVS
+     * @return false if the namespace could not be opened (the index starts empty)
+     */
+    bool load();
+
+    /**
+     * @brief Startup counter the next add() will assign
+     */
+    uint32_t get_next_counter() const;
+
+    /**
+     * @brief Record a new session in the oldest slot and commit it
+     * @param meta Session summary; its startup_counter is set to get_next_counter()
+     * @return true if written to NVS
+     */
+    bool add(session_meta_t* meta);
+
+    /**
+     * @brief Fill in a session's UTC start once GPS time is known
+     * @param startup_counter Session to update
+     * @param utc_seconds Seconds since epoch at session start
+     * @return true if the session is indexed and was written to NVS
+     */
+    bool set_gps_utc(uint32_t startup_counter, int64_t utc_seconds);
+
+    /**
+     * @brief Copy the indexed sessions, newest first
+     * @param out Output array
+     * @param max_count Capacity of out
+     * @return Number of sessions written
+     */
+    size_t get_sessions(session_meta_t* out, size_t max_count) const;
+
+private:
+    session_meta_t m_slots[SESSION_INDEX_SLOTS];
+    bool m_valid[SESSION_INDEX_SLOTS];
+    uint8_t m_next_slot;
+    uint32_t m_next_counter;
+    mutable portMUX_TYPE m_lock;
+
+    /**
+     * @brief Write one slot blob (and the rotation index if advance is set)
+     */
+    static bool write_slot(uint8_t slot, const session_meta_t& meta, bool advance);
+};
+
+#endif // SESSION_INDEX_H
@@ -0,0 +1,135 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Head and tail live on separate cache lines so producer and consumer
+// (on different cores) never invalidate each other's line
+#define SPSC_RING_CACHE_LINE 64
+
+/**
+ * @brief SPSC ring statistics
+ */
+struct spsc_ring_stats_t {
+    uint32_t pushed;        // Items accepted by push()
+    uint32_t dropped;       // Items rejected because the ring was full
+    uint32_t high_water;    // Maximum occupancy seen by the producer
+    uint32_t capacity;      // Ring capacity (N)
+};
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring of fixed-size items
+ *
+ * Storage is embedded in the object (no allocation). One task may call
+ * push(), one other task may call pop()/pop_batch(); no locks are taken.
+ * When full, push() drops the new item and counts it instead of blocking.
+ *
+ * @tparam T Trivially copyable item type
+ * @tparam N Capacity, must be a power of two
+ */
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing() : m_head(0), m_cached_tail(0), m_pushed(0), m_dropped(0), m_high_water(0),
+                 m_tail(0), m_cached_head(0) {}
+
+    /**
+     * @brief Copy one item into the ring (producer only)
+     * @return true if stored, false if the ring was full (item dropped)
+     */
+    bool push(const T& item) {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cached_tail >= N) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cached_tail >= N) {
+                m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        m_items[head & (N - 1)] = item;
+        m_head.store(head + 1, std::memory_order_release);
+
+        uint32_t used = head + 1 - m_cached_tail;
+        if (used > m_high_water.load(std::memory_order_relaxed)) {
+            m_high_water.store(used, std::memory_order_relaxed);
+        }
+        m_pushed.store(m_pushed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Remove one item (consumer only)
+     * @return true if an item was copied to out
+     */
+    bool pop(T& out) {
+        return pop_batch(&out, 1) == 1;
+    }
+
+    /**
+     * @brief Remove up to max_items items in FIFO order (consumer only)
+     * @param out Destination array
+     * @param max_items Capacity of out
+     * @return Number of items copied
+     */
+    size_t pop_batch(T* out, size_t max_items) {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_cached_head == tail) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+        }
+
+        size_t count = m_cached_head - tail;
+        if (count > max_items) {
+            count = max_items;
+        }
+        for (size_t i = 0; i < count; i++) {
+            out[i] = m_items[(tail + i) & (N - 1)];
+        }
+
+        m_tail.store(tail + (uint32_t)count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Approximate number of queued items (safe from either side)
+     */
+    size_t size() const {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() {
+        return N;
+    }
+
+    /**
+     * @brief Snapshot of the producer-side counters
+     */
+    spsc_ring_stats_t get_stats() const {
+        spsc_ring_stats_t stats;
+        stats.pushed = m_pushed.load(std::memory_order_relaxed);
+        stats.dropped = m_dropped.load(std::memory_order_relaxed);
+        stats.high_water = m_high_water.load(std::memory_order_relaxed);
+        stats.capacity = (uint32_t)N;
+        return stats;
+    }
+
+private:
+    // Producer-owned line
+    alignas(SPSC_RING_CACHE_LINE) std::atomic<uint32_t> m_head;
+    uint32_t m_cached_tail;
+    std::atomic<uint32_t> m_pushed;
+    std::atomic<uint32_t> m_dropped;
+    std::atomic<uint32_t> m_high_water;
+
+    // Consumer-owned line
+    alignas(SPSC_RING_CACHE_LINE) std::atomic<uint32_t> m_tail;
+    uint32_t m_cached_head;
+
+    alignas(SPSC_RING_CACHE_LINE) T m_items[N];
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,32 @@
+#include "esp_partition_flash.h"
+
+EspPartitionFlash::EspPartitionFlash() : m_partition(nullptr) {
+}
+
+void EspPartitionFlash::attach(const esp_partition_t* partition) {
+    m_partition = partition;
+}
+
+uint32_t EspPartitionFlash::size() const {
+    return m_partition ? m_partition->size : 0;
+}
+
+uint32_t EspPartitionFlash::sector_size() const {
+    return m_partition ? m_partition->erase_size : 0;
+}
+
+bool EspPartitionFlash::read(uint32_t offset, void* dst, size_t len) {
+    return m_partition && esp_partition_read(m_partition, offset, dst, len) == ESP_OK;
+}
+
+bool EspPartitionFlash::write(uint32_t offset, const void* src, size_t len) {
+    return m_partition && esp_partition_write(m_partition, offset, src, len) == ESP_OK;
+}
+
+bool EspPartitionFlash::erase_sector(uint32_t sector) {
+    if (!m_partition) {
+        return false;
+    }
+    uint32_t sector_size = m_partition->erase_size;
+    return esp_partition_erase_range(m_partition, sector * sector_size, sector_size) == ESP_OK;
+}
@@ -0,0 +1,619 @@
+#include "log_block_writer.h"
+#include "log_block_codec.h"
+#include "lz4_block.h"
+#include <Arduino.h>
+#include "version_info.h"
+#include "time_base.h"
+#include <cstring>
+#include <esp_heap_caps.h>
+#include <esp_mac.h>
+#include <esp_random.h>
+#include <esp_timer.h>
+
+// Task configuration (all on core 0, away from the sampling loop)
+#define DRAIN_TASK_STACK        3072
+#define DRAIN_TASK_PRIORITY     4
+#define DRAIN_PERIOD_MS         10
+#define DRAIN_BATCH_SIZE        32
+#define COMPRESS_TASK_STACK     4096
+#define COMPRESS_TASK_PRIORITY  3
+#define WRITER_TASK_STACK       4096
+#define WRITER_TASK_PRIORITY    2
+#define WRITER_IDLE_MS          20      // Erase one sector ahead per idle period
+#define TASK_POLL_MS            50      // Longest wait before a task notices stop()
+#define STOP_TIMEOUT_MS         1000
+#define STORAGE_TASK_CORE       0
+
+LogBlockWriter::LogBlockWriter(const char* partition_label)
+    : m_partition_label(partition_label), m_partition(nullptr), m_running(false),
+      m_active(nullptr), m_active_index(0),
+      m_out_capacity(0), m_hash_table(nullptr),
+      m_free_acq(nullptr), m_full_acq(nullptr), m_free_out(nullptr), m_full_out(nullptr),
+      m_drain_task(nullptr), m_compress_task(nullptr), m_writer_task(nullptr), m_tasks_running(0),
+      m_source_count(0), m_ring(&m_flash), m_map(nullptr), m_map_handle(0),
+      m_position_lock(portMUX_INITIALIZER_UNLOCKED), m_utc_pending(false),
+      m_stats_lock(portMUX_INITIALIZER_UNLOCKED) {
+    memset(m_acq, 0, sizeof(m_acq));
+    memset(m_out, 0, sizeof(m_out));
+    memset(m_sources, 0, sizeof(m_sources));
+    memset(&m_session, 0, sizeof(m_session));
+    memset(&m_ring_stats, 0, sizeof(m_ring_stats));
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+LogBlockWriter::~LogBlockWriter() {
+    stop();
+    if (m_map) {
+        esp_partition_munmap(m_map_handle);
+        m_map = nullptr;
+    }
+}
+
+bool LogBlockWriter::start() {
+    if (m_running) {
+        return false;
+    }
+
+    m_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                           m_partition_label);
+    if (!m_partition) {
+        Serial.printf("[Storage] ERROR: Partition '%s' not found\n", m_partition_label);
+        return false;
+    }
+
+    // Session downloads read through the flash cache: esp_partition_read()
+    // would stall both cores for every chunk
+    if (!m_map) {
+        const void* map = nullptr;
+        if (esp_partition_mmap(m_partition, 0, m_partition->size, ESP_PARTITION_MMAP_DATA,
+                               &map, &m_map_handle) == ESP_OK) {
+            m_map = (const uint8_t*)map;
+        } else {
+            Serial.println("[Storage] WARNING: Failed to map the log partition, downloads use direct reads");
+        }
+    }
+
+    // Binary search over sector headers for the previous head and tail
+    m_flash.attach(m_partition);
+    int64_t t0 = esp_timer_get_time();
+    if (!m_ring.mount()) {
+        Serial.printf("[Storage] ERROR: Partition '%s' too small for the log ring\n", m_partition_label);
+        return false;
+    }
+    flash_ring_stats_t ring = m_ring.get_stats();
+    Serial.printf("[Storage] Ring recovered in %u us (%u header reads): head 0x%06X seq %u, tail 0x%06X\n",
+                  (unsigned)(esp_timer_get_time() - t0), ring.mount_reads, ring.write_offset,
+                  ring.head_sequence, ring.tail_offset);
+
+    if (!allocate_buffers()) {
+        Serial.println("[Storage] ERROR: Failed to allocate block buffers");
+        free_buffers();
+        return false;
+    }
+
+    portENTER_CRITICAL(&m_stats_lock);
+    memset(&m_stats, 0, sizeof(m_stats));
+    portEXIT_CRITICAL(&m_stats_lock);
+    m_ring.erase_ahead(FLASH_RING_ERASE_AHEAD_SECTORS);
+
+    m_index.load();
+    create_session_header();
+    uint32_t session_offset;
+    if (!write_entry((const uint8_t*)&m_session, sizeof(m_session), &session_offset)) {
+        Serial.println("[Storage] ERROR: Failed to write session start header");
+        free_buffers();
+        return false;
+    }
+    index_session(session_offset);
+    publish_ring_position();
+    m_utc_pending = m_session.gps_utc_at_lock == 0;
+
+    m_running = true;
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        compress_task_wrapper, "LogCompress", COMPRESS_TASK_STACK, this,
+        COMPRESS_TASK_PRIORITY, &m_compress_task, STORAGE_TASK_CORE);
+    if (result == pdPASS) {
+        m_tasks_running++;
+        result = xTaskCreatePinnedToCore(
+            drain_task_wrapper, "LogDrain", DRAIN_TASK_STACK, this,
+            DRAIN_TASK_PRIORITY, &m_drain_task, STORAGE_TASK_CORE);
+    }
+    if (result == pdPASS) {
+        m_tasks_running++;
+        result = xTaskCreatePinnedToCore(
+            writer_task_wrapper, "LogWriter", WRITER_TASK_STACK, this,
+            WRITER_TASK_PRIORITY, &m_writer_task, STORAGE_TASK_CORE);
+    }
+    if (result == pdPASS) {
+        m_tasks_running++;
+    }
+
+    if (result != pdPASS) {
+        Serial.println("[Storage] ERROR: Failed to create storage tasks");
+        stop();
+        return false;
+    }
+
+    Serial.printf("[Storage] Block writer started on '%s' (%u KB, %u x %u KB buffers)\n",
+                  m_partition_label, (unsigned)(m_partition->size / 1024),
+                  (unsigned)ACQ_BUFFER_COUNT, (unsigned)(ACQ_BUFFER_SIZE / 1024));
+    return true;
+}
+
+void LogBlockWriter::stop() {
+    // Deleting a task mid-loop could tear a flash entry or leave a queue
+    // holding a freed buffer: let each one finish its block and exit instead
+    m_running = false;
+    int64_t deadline = esp_timer_get_time() + STOP_TIMEOUT_MS * 1000LL;
+    while (m_tasks_running.load() > 0 && esp_timer_get_time() < deadline) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    m_drain_task = nullptr;
+    m_compress_task = nullptr;
+    m_writer_task = nullptr;
+    if (m_tasks_running.load() > 0) {
+        Serial.println("[Storage] ERROR: Storage tasks did not stop, leaving their buffers allocated");
+        return;
+    }
+    free_buffers();
+}
+
+bool LogBlockWriter::add_source(log_record_ring_t* ring) {
+    uint8_t count = m_source_count.load(std::memory_order_relaxed);
+    if (!ring || count >= MAX_SOURCES) {
+        return false;
+    }
+    // Publish the slot before the count so the drain task never sees a null ring
+    m_sources[count] = ring;
+    m_source_count.store(count + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogBlockWriter::append(const void* record, size_t len) {
+    if (!m_running || !record || len == 0 || len > ACQ_BUFFER_SIZE) {
+        return false;
+    }
+
+    if (m_active && m_active->used + len > ACQ_BUFFER_SIZE) {
+        close_active_buffer();
+    }
+
+    if (!m_active) {
+        uint8_t index;
+        if (xQueueReceive(m_free_acq, &index, 0) != pdTRUE) {
+            portENTER_CRITICAL(&m_stats_lock);
+            m_stats.records_dropped++;
+            portEXIT_CRITICAL(&m_stats_lock);
+            return false;
+        }
+        m_active_index = index;
+        m_active = &m_acq[index];
+        m_active->used = 0;
+        m_active->opened_us = esp_timer_get_time();
+    }
+
+    memcpy(m_active->data + m_active->used, record, len);
+    m_active->used += len;
+    portENTER_CRITICAL(&m_stats_lock);
+    m_stats.records_appended++;
+    portEXIT_CRITICAL(&m_stats_lock);
+    return true;
+}
+
+bool LogBlockWriter::is_running() const {
+    return m_running;
+}
+
+const uint8_t* LogBlockWriter::get_startup_id() const {
+    return m_session.startup_id;
+}
+
+int64_t LogBlockWriter::get_session_start_us() const {
+    return m_session.esp_time_at_start;
+}
+
+log_writer_stats_t LogBlockWriter::get_stats() const {
+    // The pipeline tasks update the counters and the ring on core 0 while
+    // status readers run elsewhere: copy both under their locks
+    portENTER_CRITICAL(&m_stats_lock);
+    log_writer_stats_t stats = m_stats;
+    portEXIT_CRITICAL(&m_stats_lock);
+    portENTER_CRITICAL(&m_position_lock);
+    flash_ring_stats_t ring = m_ring_stats;
+    portEXIT_CRITICAL(&m_position_lock);
+    stats.flash_errors = ring.flash_errors;
+    stats.erase_stalls = ring.erase_stalls;
+    stats.write_offset = ring.write_offset;
+    stats.tail_offset = ring.tail_offset;
+    stats.ring_dropped = 0;
+    stats.ring_high_water = 0;
+    uint8_t count = m_source_count.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < count; i++) {
+        spsc_ring_stats_t ring = m_sources[i]->get_stats();
+        stats.ring_dropped += ring.dropped;
+        if (ring.high_water > stats.ring_high_water) {
+            stats.ring_high_water = ring.high_water;
+        }
+    }
+    return stats;
+}
+
+bool LogBlockWriter::allocate_buffers() {
+    m_free_acq = xQueueCreate(ACQ_BUFFER_COUNT, sizeof(uint8_t));
+    m_full_acq = xQueueCreate(ACQ_BUFFER_COUNT, sizeof(uint8_t));
+    m_free_out = xQueueCreate(OUT_BUFFER_COUNT, sizeof(uint8_t));
+    m_full_out = xQueueCreate(OUT_BUFFER_COUNT, sizeof(out_slot_t));
+    if (!m_free_acq || !m_full_acq || !m_free_out || !m_full_out) {
+        return false;
+    }
+
+    // Acquisition buffers and the LZ4 hash table stay in fast internal SRAM
+    for (uint8_t i = 0; i < ACQ_BUFFER_COUNT; i++) {
+        m_acq[i].data = (uint8_t*)heap_caps_malloc(ACQ_BUFFER_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        m_acq[i].used = 0;
+        if (!m_acq[i].data) {
+            return false;
+        }
+        xQueueSend(m_free_acq, &i, 0);
+    }
+
+    m_hash_table = (uint16_t*)heap_caps_malloc(LZ4_BLOCK_HASH_ENTRIES * sizeof(uint16_t),
+                                               MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!m_hash_table) {
+        return false;
+    }
+
+    // Compressed output goes to PSRAM (fall back to internal RAM if absent)
+    m_out_capacity = log_block_max_encoded_size(ACQ_BUFFER_SIZE);
+    for (uint8_t i = 0; i < OUT_BUFFER_COUNT; i++) {
+        m_out[i] = (uint8_t*)heap_caps_malloc(m_out_capacity, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!m_out[i]) {
+            m_out[i] = (uint8_t*)heap_caps_malloc(m_out_capacity, MALLOC_CAP_8BIT);
+        }
+        if (!m_out[i]) {
+            return false;
+        }
+        xQueueSend(m_free_out, &i, 0);
+    }
+
+    m_active = nullptr;
+    return true;
+}
+
+void LogBlockWriter::free_buffers() {
+    for (size_t i = 0; i < ACQ_BUFFER_COUNT; i++) {
+        heap_caps_free(m_acq[i].data);
+        m_acq[i].data = nullptr;
+    }
+    for (size_t i = 0; i < OUT_BUFFER_COUNT; i++) {
+        heap_caps_free(m_out[i]);
+        m_out[i] = nullptr;
+    }
+    heap_caps_free(m_hash_table);
+    m_hash_table = nullptr;
+    m_active = nullptr;
+
+    QueueHandle_t* queues[] = { &m_free_acq, &m_full_acq, &m_free_out, &m_full_out };
+    for (QueueHandle_t* q : queues) {
+        if (*q) {
+            vQueueDelete(*q);
+            *q = nullptr;
+        }
+    }
+}
+
+void LogBlockWriter::create_session_header() {
+    memset(&m_session, 0, sizeof(m_session));
+    m_session.magic = SESSION_START_MAGIC;
+    m_session.version = SESSION_FORMAT_VERSION;
+    m_session.startup_counter = m_index.get_next_counter();
+
+    // UUIDv4 session ID
+    esp_fill_random(m_session.startup_id, sizeof(m_session.startup_id));
+    m_session.startup_id[6] = (m_session.startup_id[6] & 0x0F) | 0x40;
+    m_session.startup_id[8] = (m_session.startup_id[8] & 0x3F) | 0x80;
+
+    // UTC is only known here if GPS locked before the session started;
+    // otherwise TIME_SYNC records in the stream carry it
+    m_session.esp_time_at_start = esp_timer_get_time();
+    int64_t utc_us;
+    m_session.gps_utc_at_lock = TimeBase::esp_to_utc(m_session.esp_time_at_start, &utc_us) ? utc_us / 1000000 : 0;
+    esp_read_mac(m_session.mac_addr, ESP_MAC_WIFI_STA);
+
+    // Short git SHA as raw bytes (non-hex characters map to 0)
+    const char* sha = GIT_COMMIT_SHA;
+    for (size_t i = 0; i < sizeof(m_session.fw_sha) * 2 && sha[i] != '\0'; i++) {
+        char c = sha[i];
+        uint8_t nibble = (c >= '0' && c <= '9') ? c - '0' :
+                         (c >= 'a' && c <= 'f') ? c - 'a' + 10 :
+                         (c >= 'A' && c <= 'F') ? c - 'A' + 10 : 0;
+        m_session.fw_sha[i / 2] |= (i % 2 == 0) ? (nibble << 4) : nibble;
+    }
+
+    m_session.crc32 = log_crc32(0, (const uint8_t*)&m_session,
+                                sizeof(m_session) - sizeof(m_session.crc32));
+}
+
+void LogBlockWriter::close_active_buffer() {
+    if (!m_active) {
+        return;
+    }
+    m_active->closed_us = esp_timer_get_time();
+    // Cannot fail: the full queue holds every buffer index
+    xQueueSend(m_full_acq, &m_active_index, 0);
+    m_active = nullptr;
+}
+
+bool LogBlockWriter::write_entry(const uint8_t* data, size_t len, uint32_t* offset) {
+    return m_ring.append(data, len, offset);
+}
+
+void LogBlockWriter::index_session(uint32_t offset) {
+    // The start header may have opened a fresh sector; that sector's sequence
+    // number anchors the session in the ring
+    log_sector_header_t header;
+    if (!m_ring.read_sector_header(offset / m_flash.sector_size(), &header)) {
+        Serial.println("[Storage] WARNING: Session start sector unreadable, session not indexed");
+        return;
+    }
+
+    session_meta_t meta;
+    memset(&meta, 0, sizeof(meta));
+    memcpy(meta.startup_id, m_session.startup_id, sizeof(meta.startup_id));
+    meta.first_block_offset = offset;
+    meta.first_sequence = header.sequence;
+    meta.session_start_time_esp_us = m_session.esp_time_at_start;
+    meta.gps_utc_at_start = m_session.gps_utc_at_lock;
+    memcpy(meta.mac_addr, m_session.mac_addr, sizeof(meta.mac_addr));
+    memcpy(meta.fw_sha, m_session.fw_sha, sizeof(meta.fw_sha));
+
+    if (m_index.add(&meta)) {
+        Serial.printf("[Storage] Session %u indexed at 0x%06X (sector seq %u)\n",
+                      meta.startup_counter, offset, meta.first_sequence);
+    } else {
+        Serial.println("[Storage] WARNING: Failed to record the session in the NVS index");
+    }
+}
+
+void LogBlockWriter::publish_ring_position() {
+    flash_ring_stats_t ring = m_ring.get_stats();
+    portENTER_CRITICAL(&m_position_lock);
+    m_ring_stats = ring;
+    portEXIT_CRITICAL(&m_position_lock);
+}
+
+void LogBlockWriter::update_session_utc() {
+    // GPS usually locks after the session started; one NVS write once it has
+    int64_t utc_us;
+    if (m_utc_pending && TimeBase::esp_to_utc(m_session.esp_time_at_start, &utc_us)) {
+        m_utc_pending = false;
+        m_index.set_gps_utc(m_session.startup_counter, utc_us / 1000000);
+    }
+}
+
+bool LogBlockWriter::read_flash(uint32_t offset, void* dst, size_t len) const {
+    if (!m_partition || offset > m_partition->size || len > m_partition->size - offset) {
+        return false;
+    }
+    if (m_map) {
+        memcpy(dst, m_map + offset, len);
+        return true;
+    }
+    return esp_partition_read(m_partition, offset, dst, len) == ESP_OK;
+}
+
+uint32_t LogBlockWriter::get_sector_size() const {
+    return m_partition ? m_partition->erase_size : 0;
+}
+
+size_t LogBlockWriter::list_sessions(log_session_info_t* out, size_t max_count) const {
+    uint32_t sector_size = get_sector_size();
+    uint32_t sector_count = m_ring.get_sector_count();
+    if (!out || sector_size == 0 || sector_count == 0) {
+        return 0;
+    }
+
+    session_meta_t metas[SESSION_INDEX_SLOTS];
+    size_t meta_count = m_index.get_sessions(metas, SESSION_INDEX_SLOTS);
+
+    portENTER_CRITICAL(&m_position_lock);
+    uint32_t head_sequence = m_ring_stats.head_sequence;
+    uint32_t tail_sequence = m_ring_stats.tail_sequence;
+    portEXIT_CRITICAL(&m_position_lock);
+
+    // Each session runs until the next one's first sector; the newest until the head
+    size_t count = 0;
+    uint32_t end_sequence = head_sequence + 1;
+    for (size_t i = 0; i < meta_count && count < max_count; i++) {
+        const session_meta_t& meta = metas[i];
+        uint32_t first_sequence = meta.first_sequence > tail_sequence ? meta.first_sequence : tail_sequence;
+        bool in_ring = first_sequence < end_sequence && end_sequence - first_sequence <= sector_count;
+
+        log_session_info_t info;
+        info.meta = meta;
+        info.first_sequence = first_sequence;
+        info.first_sector = (meta.first_block_offset / sector_size + (first_sequence - meta.first_sequence)) % sector_count;
+        info.sector_count = end_sequence - first_sequence;
+        info.complete = first_sequence == meta.first_sequence;
+        info.active = m_running && i == 0;
+
+        // The index can outlive the data (partition erased or reflashed): trust it
+        // only while the first sector still carries the expected sequence
+        log_sector_header_t header;
+        if (in_ring && read_flash(info.first_sector * sector_size, &header, sizeof(header)) &&
+            header.magic == LOG_SECTOR_MAGIC && header.sequence == first_sequence &&
+            header.crc32 == log_crc32(0, (const uint8_t*)&header, sizeof(header) - sizeof(header.crc32))) {
+            out[count++] = info;
+        }
+        end_sequence = meta.first_sequence;
+    }
+    return count;
+}
+
+bool LogBlockWriter::find_session(uint32_t startup_counter, log_session_info_t* info) const {
+    log_session_info_t sessions[SESSION_INDEX_SLOTS];
+    size_t count = list_sessions(sessions, SESSION_INDEX_SLOTS);
+    for (size_t i = 0; i < count; i++) {
+        if (sessions[i].meta.startup_counter == startup_counter) {
+            if (info) {
+                *info = sessions[i];
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t LogBlockWriter::read_session(const log_session_info_t& session, uint32_t offset,
+                                    uint8_t* dst, size_t len) const {
+    uint32_t sector_size = get_sector_size();
+    uint32_t sector_count = m_ring.get_sector_count();
+    uint32_t image_size = session.sector_count * sector_size;
+    if (!dst || sector_count == 0 || offset >= image_size) {
+        return 0;
+    }
+    if (len > image_size - offset) {
+        len = image_size - offset;
+    }
+
+    // Contiguous within a sector; the image wraps at the end of the partition
+    size_t done = 0;
+    while (done < len) {
+        uint32_t pos = offset + (uint32_t)done;
+        uint32_t sector = (session.first_sector + pos / sector_size) % sector_count;
+        uint32_t within = pos % sector_size;
+        size_t chunk = len - done;
+        if (chunk > sector_size - within) {
+            chunk = sector_size - within;
+        }
+        if (!read_flash(sector * sector_size + within, dst + done, chunk)) {
+            break;
+        }
+        done += chunk;
+    }
+    return done;
+}
+
+void LogBlockWriter::drain_task_wrapper(void* arg) {
+    LogBlockWriter* writer = static_cast<LogBlockWriter*>(arg);
+    if (writer) {
+        writer->drain_loop();
+        writer->m_tasks_running--;
+    }
+    vTaskDelete(nullptr);   // A FreeRTOS task function must never return
+}
+
+void LogBlockWriter::compress_task_wrapper(void* arg) {
+    LogBlockWriter* writer = static_cast<LogBlockWriter*>(arg);
+    if (writer) {
+        writer->compress_loop();
+        writer->m_tasks_running--;
+    }
+    vTaskDelete(nullptr);   // A FreeRTOS task function must never return
+}
+
+void LogBlockWriter::writer_task_wrapper(void* arg) {
+    LogBlockWriter* writer = static_cast<LogBlockWriter*>(arg);
+    if (writer) {
+        writer->writer_loop();
+        writer->m_tasks_running--;
+    }
+    vTaskDelete(nullptr);   // A FreeRTOS task function must never return
+}
+
+void LogBlockWriter::drain_loop() {
+    log_record_any_t batch[DRAIN_BATCH_SIZE];
+
+    while (m_running) {
+        uint8_t count = m_source_count.load(std::memory_order_acquire);
+        for (uint8_t i = 0; i < count; i++) {
+            size_t n;
+            while ((n = m_sources[i]->pop_batch(batch, DRAIN_BATCH_SIZE)) > 0) {
+                for (size_t j = 0; j < n; j++) {
+                    uint32_t len = log_record_size(batch[j].msg_type);
+                    if (len > 0) {
+                        append(&batch[j], len);
+                    }
+                }
+            }
+        }
+
+        // Low-rate logging would otherwise sit in RAM for many seconds, lost on
+        // power off and missing from downloads of the running session
+        if (m_active && esp_timer_get_time() - m_active->opened_us >= ACQ_BUFFER_MAX_AGE_MS * 1000LL) {
+            close_active_buffer();
+        }
+        vTaskDelay(pdMS_TO_TICKS(DRAIN_PERIOD_MS));
+    }
+}
+
+void LogBlockWriter::compress_loop() {
+    while (m_running) {
+        uint8_t acq_index;
+        if (xQueueReceive(m_full_acq, &acq_index, pdMS_TO_TICKS(TASK_POLL_MS)) != pdTRUE) {
+            continue;
+        }
+
+        uint8_t out_index;
+        while (xQueueReceive(m_free_out, &out_index, pdMS_TO_TICKS(TASK_POLL_MS)) != pdTRUE) {
+            if (!m_running) {
+                return;
+            }
+        }
+
+        acq_buffer_t& acq = m_acq[acq_index];
+        int64_t t0 = esp_timer_get_time();
+        size_t encoded = log_block_encode(acq.data, acq.used, m_session.startup_id, acq.closed_us,
+                                          m_out[out_index], m_out_capacity, m_hash_table);
+        uint32_t elapsed = (uint32_t)(esp_timer_get_time() - t0);
+        portENTER_CRITICAL(&m_stats_lock);
+        if (elapsed > m_stats.max_compress_us) {
+            m_stats.max_compress_us = elapsed;
+        }
+        m_stats.bytes_uncompressed += acq.used;
+        portEXIT_CRITICAL(&m_stats_lock);
+
+        // Acquisition buffer is free as soon as it has been compressed
+        acq.used = 0;
+        xQueueSend(m_free_acq, &acq_index, portMAX_DELAY);
+
+        if (encoded == 0) {
+            xQueueSend(m_free_out, &out_index, portMAX_DELAY);
+            continue;
+        }
+
+        out_slot_t slot = { out_index, (uint32_t)encoded };
+        xQueueSend(m_full_out, &slot, portMAX_DELAY);
+    }
+}
+
+void LogBlockWriter::writer_loop() {
+    while (m_running) {
+        // Sector erases happen between blocks so a block write rarely waits on one
+        out_slot_t slot;
+        if (xQueueReceive(m_full_out, &slot, pdMS_TO_TICKS(WRITER_IDLE_MS)) != pdTRUE) {
+            m_ring.erase_ahead(1);
+            publish_ring_position();    // Erasing may have moved the tail or failed
+            update_session_utc();
+            continue;
+        }
+
+        int64_t t0 = esp_timer_get_time();
+        bool written = write_entry(m_out[slot.index], slot.length);
+        uint32_t elapsed = (uint32_t)(esp_timer_get_time() - t0);
+        publish_ring_position();
+
+        portENTER_CRITICAL(&m_stats_lock);
+        if (written) {
+            m_stats.blocks_written++;
+            m_stats.bytes_compressed += slot.length - sizeof(log_block_header_t);
+        }
+        if (elapsed > m_stats.max_write_us) {
+            m_stats.max_write_us = elapsed;
+        }
+        portEXIT_CRITICAL(&m_stats_lock);
+
+        xQueueSend(m_free_out, &slot.index, portMAX_DELAY);
+    }
+}
@@ -0,0 +1,141 @@
+#include "session_index.h"
+#include <Arduino.h>
+#include <Preferences.h>
+#include <cstdio>
+#include <cstring>
+
+// NVS layout from docs/LOG_FORMAT.md
+static const char* const NVS_NAMESPACE = "logging";
+static const char* const KEY_NEXT_SLOT = "session_idx";
+#define KEY_META_FORMAT     "session_meta_%u"
+
+static void meta_key(uint8_t slot, char* key, size_t size) {
+    snprintf(key, size, KEY_META_FORMAT, (unsigned)slot);
+}
+
+SessionIndex::SessionIndex()
+    : m_next_slot(0), m_next_counter(1), m_lock(portMUX_INITIALIZER_UNLOCKED) {
+    memset(m_slots, 0, sizeof(m_slots));
+    memset(m_valid, 0, sizeof(m_valid));
+}
+
+bool SessionIndex::load() {
+    session_meta_t slots[SESSION_INDEX_SLOTS];
+    bool valid[SESSION_INDEX_SLOTS] = {};
+    uint8_t next_slot = 0;
+    uint32_t next_counter = 1;
+
+    Preferences prefs;
+    bool opened = prefs.begin(NVS_NAMESPACE, true);  // true = read-only
+    if (opened) {
+        next_slot = prefs.getUChar(KEY_NEXT_SLOT, 0) % SESSION_INDEX_SLOTS;
+        for (uint8_t i = 0; i < SESSION_INDEX_SLOTS; i++) {
+            char key[16];
+            meta_key(i, key, sizeof(key));
+            valid[i] = prefs.getBytesLength(key) == sizeof(session_meta_t) &&
+                       prefs.getBytes(key, &slots[i], sizeof(session_meta_t)) == sizeof(session_meta_t);
+            if (valid[i] && slots[i].startup_counter >= next_counter) {
+                next_counter = slots[i].startup_counter + 1;
+            }
+        }
+        prefs.end();
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    memcpy(m_slots, slots, sizeof(m_slots));
+    memcpy(m_valid, valid, sizeof(m_valid));
+    m_next_slot = next_slot;
+    m_next_counter = next_counter;
+    portEXIT_CRITICAL(&m_lock);
+    return opened;
+}
+
+uint32_t SessionIndex::get_next_counter() const {
+    portENTER_CRITICAL(&m_lock);
+    uint32_t counter = m_next_counter;
+    portEXIT_CRITICAL(&m_lock);
+    return counter;
+}
+
+bool SessionIndex::add(session_meta_t* meta) {
+    if (!meta) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&m_lock);
+    meta->startup_counter = m_next_counter++;
+    uint8_t slot = m_next_slot;
+    m_slots[slot] = *meta;
+    m_valid[slot] = true;
+    m_next_slot = (slot + 1) % SESSION_INDEX_SLOTS;
+    portEXIT_CRITICAL(&m_lock);
+
+    return write_slot(slot, *meta, true);
+}
+
+bool SessionIndex::set_gps_utc(uint32_t startup_counter, int64_t utc_seconds) {
+    session_meta_t meta;
+    int found = -1;
+
+    portENTER_CRITICAL(&m_lock);
+    for (uint8_t i = 0; i < SESSION_INDEX_SLOTS; i++) {
+        if (m_valid[i] && m_slots[i].startup_counter == startup_counter) {
+            m_slots[i].gps_utc_at_start = utc_seconds;
+            meta = m_slots[i];
+            found = i;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&m_lock);
+
+    return found >= 0 && write_slot((uint8_t)found, meta, false);
+}
+
+size_t SessionIndex::get_sessions(session_meta_t* out, size_t max_count) const {
+    if (!out) {
+        return 0;
+    }
+
+    size_t count = 0;
+    portENTER_CRITICAL(&m_lock);
+    for (uint8_t i = 0; i < SESSION_INDEX_SLOTS; i++) {
+        if (!m_valid[i]) {
+            continue;
+        }
+        // Insert by startup counter, newest first, keeping the newest max_count
+        size_t pos = count < max_count ? count : max_count;
+        while (pos > 0 && out[pos - 1].startup_counter < m_slots[i].startup_counter) {
+            if (pos < max_count) {
+                out[pos] = out[pos - 1];
+            }
+            pos--;
+        }
+        if (pos < max_count) {
+            out[pos] = m_slots[i];
+            if (count < max_count) {
+                count++;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&m_lock);
+    return count;
+}
+
+bool SessionIndex::write_slot(uint8_t slot, const session_meta_t& meta, bool advance) {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {  // false = read/write
+        Serial.println("[Storage] ERROR: Failed to open session index in NVS");
+        return false;
+    }
+
+    // Blob first: if a reset cuts in before the rotation index moves on, the
+    // next session reuses the slot instead of evicting an older one
+    char key[16];
+    meta_key(slot, key, sizeof(key));
+    bool ok = prefs.putBytes(key, &meta, sizeof(meta)) == sizeof(meta);
+    if (ok && advance) {
+        ok = prefs.putUChar(KEY_NEXT_SLOT, (slot + 1) % SESSION_INDEX_SLOTS) == sizeof(uint8_t);
+    }
+    prefs.end();
+    return ok;
+}
@@ -0,0 +1,87 @@
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include "telemetry_schema.h"
+
+static_assert(TELEMETRY_FIELD_COUNT <= 32, "presence mask is 32 bits");
+
+/**
+ * @brief Quantized field values (wire units) with their presence mask
+ */
+struct telemetry_values_t {
+    uint32_t present;
+    int64_t raw[TELEMETRY_FIELD_COUNT];
+};
+
+/**
+ * @brief One live telemetry frame (see telemetry_schema.h)
+ *
+ * Fields are set as engineering values; only fields that were set are
+ * marked present and sent. Fixed-point conversion happens in quantize(), so
+ * filling a frame is just stores. A sender that serves several receivers
+ * quantizes once and encodes a keyframe or a per-receiver delta from the
+ * values. Portable (no Arduino dependencies).
+ */
+class TelemetryFrame {
+public:
+    TelemetryFrame();
+
+    /**
+     * @brief Mark every field absent
+     */
+    void clear();
+
+    /**
+     * @brief Set a field and mark it present
+     */
+    void set(telemetry_field_t field, double value);
+
+    /**
+     * @brief Check whether a field has been set
+     */
+    bool has(telemetry_field_t field) const;
+
+    /**
+     * @brief Convert the present fields to wire units
+     *
+     * Values are rounded to the field's scale and saturated to its wire type.
+     */
+    void quantize(telemetry_values_t* values) const;
+
+    /**
+     * @brief Encode the frame as a keyframe
+     * @param out Output buffer (TELEMETRY_FRAME_MAX_SIZE always fits)
+     * @param capacity Output buffer size
+     * @return Frame length, or 0 if it does not fit
+     */
+    size_t encode(uint8_t* out, size_t capacity) const;
+
+    /**
+     * @brief Encode a subset of quantized values
+     * @param type TELEMETRY_FRAME_KEYFRAME or TELEMETRY_FRAME_DELTA
+     * @param values Quantized values
+     * @param fields Mask of fields to include (must be present in values)
+     * @param out Output buffer (TELEMETRY_FRAME_MAX_SIZE always fits)
+     * @param capacity Output buffer size
+     * @return Frame length, or 0 if it does not fit
+     */
+    static size_t encode_values(uint8_t type, const telemetry_values_t& values, uint32_t fields,
+                                uint8_t* out, size_t capacity);
+
+    /**
+     * @brief Fields worth sending in a delta
+     * @param current Values about to be sent
+     * @param sent Values the receiver holds
+     * @return Mask of fields present in current that the receiver lacks or
+     *         that moved at least their schema threshold
+     */
+    static uint32_t changed_fields(const telemetry_values_t& current, const telemetry_values_t& sent);
+
+private:
+    uint32_t m_present;
+    double m_values[TELEMETRY_FIELD_COUNT];
+};
+
+#endif // TELEMETRY_FRAME_H
@@ -0,0 +1,104 @@
+#ifndef TELEMETRY_SCHEMA_H
+#define TELEMETRY_SCHEMA_H
+
+/**
+ * @brief Live telemetry wire schema (WebSocket binary frames)
+ *
+ * Single source of truth for both ends of the link: the firmware encoder
+ * (telemetry_frame.h) and the page decoder (TELEMETRY_SCHEMA_JS, spliced into
+ * web_pages.h) are generated from TELEMETRY_FIELDS, so they cannot drift.
+ *
+ * Frame layout, little-endian:
+ *   u8  frame type (TELEMETRY_FRAME_KEYFRAME or TELEMETRY_FRAME_DELTA)
+ *   u8  schema version (TELEMETRY_SCHEMA_VERSION)
+ *   u8  field count
+ *   u8  presence bitmap[(field count + 7) / 8], bit i = field i is present
+ *   present fields in schema order, each round(value * scale) in its wire type
+ *
+ * A keyframe carries every field that currently has a value and replaces the
+ * receiver's state. A delta carries only fields that moved at least their
+ * threshold since they were last sent to that client; the receiver keeps
+ * its previous values for the rest.
+ *
+ * Rules: append new fields at the end (older pages still decode the fields
+ * they know); bump the version when an existing field's type or scale
+ * changes, or a field is removed.
+ */
+
+#define TELEMETRY_FRAME_KEYFRAME    0x01
+#define TELEMETRY_FRAME_DELTA       0x02
+#define TELEMETRY_SCHEMA_VERSION    1
+
+// X(ID, json_name, wire type, scale, delta threshold in field units; 0 = any change)
+#define TELEMETRY_FIELDS(X) \
+    X(UPTIME_MS,          uptime_ms,          U32, 1,    1000)       \
+    X(SAMPLE_COUNT,       sample_count,       U32, 1,    50)         \
+    X(IS_PAUSED,          is_paused,          U8,  1,    0)          \
+    X(GPS_VALID,          gps_valid,          U8,  1,    0)          \
+    X(LATITUDE,           latitude,           I32, 1e7,  1e-6)       \
+    X(LONGITUDE,          longitude,          I32, 1e7,  1e-6)       \
+    X(ALTITUDE,           altitude,           I32, 100,  0.5)        \
+    X(SPEED,              speed,              U16, 100,  0.1)        \
+    X(SATELLITES,         satellites,         U8,  1,    0)          \
+    X(ACCEL_X,            accel_x,            I16, 1000, 0.01)       \
+    X(ACCEL_Y,            accel_y,            I16, 1000, 0.01)       \
+    X(ACCEL_Z,            accel_z,            I16, 1000, 0.01)       \
+    X(TEMPERATURE,        temperature,        I16, 100,  0.5)        \
+    X(GYRO_X,             gyro_x,             I16, 10,   0.5)        \
+    X(GYRO_Y,             gyro_y,             I16, 10,   0.5)        \
+    X(GYRO_Z,             gyro_z,             I16, 10,   0.5)        \
+    X(BATTERY_SOC,        battery_soc,        U16, 100,  0.1)        \
+    X(BATTERY_VOLTAGE,    battery_voltage,    U16, 1000, 0.01)       \
+    X(BATTERY_CURRENT,    battery_current,    I32, 10,   5)          \
+    X(BATTERY_TEMP,       battery_temp,       I16, 100,  0.5)        \
+    X(OBD_CONNECTED,      obd_connected,      U8,  1,    0)          \
+    X(OBD_RPM,            obd_rpm,            U16, 1,    25)         \
+    X(OBD_SPEED,          obd_speed,          U16, 10,   1)          \
+    X(OBD_THROTTLE,       obd_throttle,       U16, 100,  0.5)        \
+    X(OBD_LOAD,           obd_load,           U16, 100,  0.5)        \
+    X(OBD_COOLANT_TEMP,   obd_coolant_temp,   I16, 10,   1)          \
+    X(OBD_INTAKE_TEMP,    obd_intake_temp,    I16, 10,   1)          \
+    X(OBD_MAF,            obd_maf,            U16, 100,  0.1)        \
+    X(OBD_TIMING_ADVANCE, obd_timing_advance, I16, 10,   0.5)        \
+    X(RT_LOOP_MAX_US,     rt_loop_max_us,     U32, 1,    0)
+
+// Wire type sizes in bytes
+#define TELEMETRY_WIRE_SIZE_U8      1
+#define TELEMETRY_WIRE_SIZE_U16     2
+#define TELEMETRY_WIRE_SIZE_I16     2
+#define TELEMETRY_WIRE_SIZE_U32     4
+#define TELEMETRY_WIRE_SIZE_I32     4
+
+enum telemetry_wire_type_t {
+    TELEMETRY_WIRE_U8,
+    TELEMETRY_WIRE_U16,
+    TELEMETRY_WIRE_I16,
+    TELEMETRY_WIRE_U32,
+    TELEMETRY_WIRE_I32
+};
+
+#define TELEMETRY_FIELD_ENUM(id, name, type, scale, delta) TELEMETRY_FIELD_##id,
+enum telemetry_field_t {
+    TELEMETRY_FIELDS(TELEMETRY_FIELD_ENUM)
+    TELEMETRY_FIELD_COUNT
+};
+#undef TELEMETRY_FIELD_ENUM
+
+#define TELEMETRY_BITMAP_SIZE       ((TELEMETRY_FIELD_COUNT + 7) / 8)
+#define TELEMETRY_HEADER_SIZE       (3 + TELEMETRY_BITMAP_SIZE)
+
+// Largest frame: every field present
+#define TELEMETRY_FIELD_SIZE(id, name, type, scale, delta) + TELEMETRY_WIRE_SIZE_##type
+#define TELEMETRY_FRAME_MAX_SIZE    (TELEMETRY_HEADER_SIZE TELEMETRY_FIELDS(TELEMETRY_FIELD_SIZE))
+
+// Page-side schema as a JavaScript literal: {keyframe, delta, version, fields: [[name, type, scale], ...]}
+#define TELEMETRY_STRINGIFY_(x) #x
+#define TELEMETRY_STRINGIFY(x) TELEMETRY_STRINGIFY_(x)
+#define TELEMETRY_FIELD_JS(id, name, type, scale, delta) "['" #name "','" #type "'," #scale "],"
+#define TELEMETRY_SCHEMA_JS \
+    "{keyframe:" TELEMETRY_STRINGIFY(TELEMETRY_FRAME_KEYFRAME) \
+    ",delta:" TELEMETRY_STRINGIFY(TELEMETRY_FRAME_DELTA) \
+    ",version:" TELEMETRY_STRINGIFY(TELEMETRY_SCHEMA_VERSION) \
+    ",fields:[" TELEMETRY_FIELDS(TELEMETRY_FIELD_JS) "]}"
+
+#endif // TELEMETRY_SCHEMA_H
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "telemetry_schema.h"
+
 const char HTML_MAIN_PAGE[] PROGMEM = R"rawliteral(
 <!DOCTYPE html>
 <html>
@@ -84,6 +86,17 @@ const char HTML_MAIN_PAGE[] PROGMEM = R"rawliteral(
         
         <!-- Dashboard Tab -->
         <div id="dashboard" class="tab-content active">
+            <div class="form-group" style="max-width: 220px; margin-bottom: 15px;">
+                <label for="live-rate">Live Update Rate</label>
+                <select id="live-rate" onchange="setLiveRate(this.value)">
+                    <option value="1">1 Hz</option>
+                    <option value="2">2 Hz</option>
+                    <option value="5" selected>5 Hz</option>
+                    <option value="10">10 Hz</option>
+                    <option value="20">20 Hz</option>
+                    <option value="50">50 Hz</option>
+                </select>
+            </div>
             <div class="sensor-grid">
                 <div class="sensor-card">
                     <div class="sensor-label">GPS Status</div>
@@ -125,6 +138,10 @@ const char HTML_MAIN_PAGE[] PROGMEM = R"rawliteral(
                     <div class="sensor-label">Uptime</div>
                     <div class="sensor-value" id="uptime">--</div>
                 </div>
+                <div class="sensor-card">
+                    <div class="sensor-label">RT Loop Max</div>
+                    <div class="sensor-value" id="rt-loop-max">--</div>
+                </div>
             </div>
             
             <!-- OBD-II Data Section (shown only when connected) -->
@@ -152,12 +169,12 @@ const char HTML_MAIN_PAGE[] PROGMEM = R"rawliteral(
                     
                     <div class="form-group">
                         <label for="gps-hz">GPS Update Frequency (Hz)</label>
-                        <input type="number" id="gps-hz" name="gps_hz" min="1" max="100" value="10" required>
+                        <input type="number" id="gps-hz" name="gps_hz" min="1" max="10" value="10" required>
                     </div>
                     
                     <div class="form-group">
                         <label for="imu-hz">IMU Update Frequency (Hz)</label>
-                        <input type="number" id="imu-hz" name="imu_hz" min="1" max="100" value="10" required>
+                        <input type="number" id="imu-hz" name="imu_hz" min="1" max="1000" value="10" required>
                     </div>
                     
                     <div class="form-group">
@@ -165,6 +182,11 @@ const char HTML_MAIN_PAGE[] PROGMEM = R"rawliteral(
                         <input type="number" id="obd-hz" name="obd_hz" min="1" max="100" value="10" required>
                     </div>
                     
+                    <div class="form-group">
+                        <label for="battery-hz">Battery Update Frequency (Hz)</label>
+                        <input type="number" id="battery-hz" name="battery_hz" min="1" max="10" value="1" required>
+                    </div>
+                    
                     <div class="form-group">
                         <label style="display: flex; align-items: center; gap: 10px; cursor: pointer;">
                             <input type="checkbox" id="obd-ble-enabled" name="obd_ble_enabled" checked style="width: auto; margin: 0;">
@@ -172,6 +194,31 @@ const char HTML_MAIN_PAGE[] PROGMEM = R"rawliteral(
                         </label>
                         <p style="color: #aaa; font-size: 12px; margin: 5px 0 0 0;">Scan for ELM-327 Bluetooth OBD-II adapters. Disable to reduce resource usage at high update rates.</p>
                     </div>
+                    
+                    <div class="form-group">
+                        <label style="display: flex; align-items: center; gap: 10px; cursor: pointer;">
+                            <input type="checkbox" id="can-monitor-enabled" name="can_monitor_enabled" style="width: auto; margin: 0;">
+                            <span>Capture Raw CAN Frames</span>
+                        </label>
+                        <p style="color: #aaa; font-size: 12px; margin: 5px 0 0 0;">Logs every frame matching the filter through the adapter. PID polling pauses while capturing. Applies immediately.</p>
+                    </div>
+                    
+                    <div class="form-group">
+                        <label for="can-filter-id">CAN Filter ID (hex)</label>
+                        <input type="text" id="can-filter-id" name="can_filter_id" pattern="[0-9A-Fa-f]{1,8}" value="000">
+                    </div>
+                    
+                    <div class="form-group">
+                        <label for="can-filter-mask">CAN Filter Mask (hex, 0 = every frame)</label>
+                        <input type="text" id="can-filter-mask" name="can_filter_mask" pattern="[0-9A-Fa-f]{1,8}" value="700">
+                    </div>
+                    
+                    <div class="form-group">
+                        <label style="display: flex; align-items: center; gap: 10px; cursor: pointer;">
+                            <input type="checkbox" id="can-filter-extended" name="can_filter_extended" style="width: auto; margin: 0;">
+                            <span>29-bit CAN IDs</span>
+                        </label>
+                    </div>
                 </div>
                 
                 <div class="config-section">
@@ -441,18 +488,101 @@ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
             }
         }
         
+        // Telemetry wire schema, generated from telemetry_schema.h at build time
+        const TELEMETRY_SCHEMA = )rawliteral" TELEMETRY_SCHEMA_JS R"rawliteral(;
+        const WIRE_READERS = {
+            U8:  [1, (v, o) => v.getUint8(o)],
+            U16: [2, (v, o) => v.getUint16(o, true)],
+            I16: [2, (v, o) => v.getInt16(o, true)],
+            U32: [4, (v, o) => v.getUint32(o, true)],
+            I32: [4, (v, o) => v.getInt32(o, true)]
+        };
+        
+        // Binary frame -> {keyframe, fields: {field: value}} with only the fields in the frame
+        function decodeTelemetry(buffer) {
+            const view = new DataView(buffer);
+            if (view.byteLength < 3) return null;
+            const type = view.getUint8(0);
+            if (type !== TELEMETRY_SCHEMA.keyframe && type !== TELEMETRY_SCHEMA.delta) return null;
+            if (view.getUint8(1) !== TELEMETRY_SCHEMA.version) {
+                console.warn('Telemetry schema version mismatch, reload the page');
+                return null;
+            }
+            const count = view.getUint8(2);
+            const known = Math.min(count, TELEMETRY_SCHEMA.fields.length);
+            let offset = 3 + Math.ceil(count / 8);
+            const fields = {};
+            for (let i = 0; i < known; i++) {
+                if (!(view.getUint8(3 + (i >> 3)) & (1 << (i & 7)))) continue;
+                const [name, wireType, scale] = TELEMETRY_SCHEMA.fields[i];
+                const [size, read] = WIRE_READERS[wireType];
+                if (offset + size > view.byteLength) return null;
+                fields[name] = read(view, offset) / scale;
+                offset += size;
+            }
+            return { keyframe: type === TELEMETRY_SCHEMA.keyframe, fields: fields };
+        }
+        
+        // Live state: a keyframe replaces it, a delta updates the fields it carries
+        let liveState = null;
+        function applyTelemetry(frame) {
+            if (frame.keyframe) {
+                liveState = Object.assign({ type: 'sensor' }, frame.fields);
+            } else if (liveState) {
+                Object.assign(liveState, frame.fields);
+            }
+            return liveState;
+        }
+        
+        // Each page asks for its own rate (e.g. 20 Hz dash, 1 Hz pit laptop); kept per browser
+        function setLiveRate(rate) {
+            localStorage.setItem('liveRateHz', rate);
+            if (ws && ws.readyState === WebSocket.OPEN) {
+                ws.send(JSON.stringify({ rate_hz: parseInt(rate), delta: true }));
+            }
+        }
+        
+        // At high stream rates redraw at most once per display frame
+        let renderPending = false;
+        let renderData = null;
+        function renderDashboard(data) {
+            renderData = data;
+            if (!renderPending) {
+                renderPending = true;
+                requestAnimationFrame(() => {
+                    renderPending = false;
+                    updateDashboard(renderData);
+                });
+            }
+        }
+        
         function connectWebSocket() {
             ws = new WebSocket('ws://' + window.location.hostname + '/ws');
+            ws.binaryType = 'arraybuffer';
             
-            ws.onopen = () => console.log('WebSocket connected');
+            ws.onopen = () => {
+                console.log('WebSocket connected');
+                liveState = null;
+                const rate = localStorage.getItem('liveRateHz');
+                if (rate) {
+                    document.getElementById('live-rate').value = rate;
+                }
+                setLiveRate(document.getElementById('live-rate').value);
+            };
             ws.onclose = () => setTimeout(connectWebSocket, 3000);
             ws.onerror = (e) => console.error('WebSocket error:', e);
             
             ws.onmessage = (event) => {
                 try {
-                    const data = JSON.parse(event.data);
-                    if (data.type === 'sensor') {
-                        updateDashboard(data);
+                    let data = null;
+                    if (event.data instanceof ArrayBuffer) {
+                        const frame = decodeTelemetry(event.data);
+                        data = frame ? applyTelemetry(frame) : null;
+                    } else {
+                        data = JSON.parse(event.data);
+                    }
+                    if (data && data.type === 'sensor') {
+                        renderDashboard(data);
                     }
                 } catch (e) {
                     console.error('Parse error:', e);
@@ -461,15 +591,19 @@ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
         }
         
         function updateDashboard(data) {
+            // Fields missing from a frame (no fix, no battery monitor) show as --
+            const fixed = (value, decimals) => value !== undefined ? value.toFixed(decimals) : '--';
             document.getElementById('gps-status').textContent = data.gps_valid ? 'Valid' : 'Invalid';
-            document.getElementById('latitude').textContent = data.latitude.toFixed(6);
-            document.getElementById('longitude').textContent = data.longitude.toFixed(6);
-            document.getElementById('speed').textContent = data.speed.toFixed(1);
-            document.getElementById('accel-x').textContent = data.accel_x.toFixed(2);
-            document.getElementById('accel-y').textContent = data.accel_y.toFixed(2);
-            document.getElementById('accel-z').textContent = data.accel_z.toFixed(2);
-            document.getElementById('battery').textContent = data.battery_soc.toFixed(1);
+            document.getElementById('latitude').textContent = fixed(data.latitude, 6);
+            document.getElementById('longitude').textContent = fixed(data.longitude, 6);
+            document.getElementById('speed').textContent = fixed(data.speed, 1);
+            document.getElementById('accel-x').textContent = fixed(data.accel_x, 2);
+            document.getElementById('accel-y').textContent = fixed(data.accel_y, 2);
+            document.getElementById('accel-z').textContent = fixed(data.accel_z, 2);
+            document.getElementById('battery').textContent = fixed(data.battery_soc, 1);
             document.getElementById('sample-count').textContent = data.sample_count;
+            document.getElementById('rt-loop-max').textContent =
+                data.rt_loop_max_us !== undefined ? data.rt_loop_max_us + ' µs' : '--';
             
             const uptimeSec = Math.floor(data.uptime_ms / 1000);
             const hours = Math.floor(uptimeSec / 3600);
@@ -478,8 +612,13 @@ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
             document.getElementById('uptime').textContent = 
                 `${hours.toString().padStart(2, '0')}:${minutes.toString().padStart(2, '0')}:${seconds.toString().padStart(2, '0')}`;
             
+            // Frames without OBD state leave the section as it is
+            if (data.obd_connected === undefined) {
+                return;
+            }
+            
             // Update OBD data if connected
-            if (data.obd && data.obd.connected) {
+            if (data.obd_connected) {
                 const obdSection = document.getElementById('obd-section');
                 const obdGrid = document.getElementById('obd-grid');
                 obdSection.style.display = 'block';
@@ -489,23 +628,23 @@ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
                 
                 // Define OBD parameters to display
                 const obdParams = [
-                    { key: 'rpm', label: 'Engine RPM', unit: 'rpm', decimals: 0 },
-                    { key: 'speed', label: 'Vehicle Speed', unit: 'km/h', decimals: 1 },
-                    { key: 'throttle', label: 'Throttle Position', unit: '%', decimals: 1 },
-                    { key: 'load', label: 'Engine Load', unit: '%', decimals: 1 },
-                    { key: 'coolant_temp', label: 'Coolant Temp', unit: '°C', decimals: 1 },
-                    { key: 'intake_temp', label: 'Intake Temp', unit: '°C', decimals: 1 },
-                    { key: 'maf', label: 'MAF', unit: 'g/s', decimals: 2 },
-                    { key: 'timing_advance', label: 'Timing Advance', unit: '°', decimals: 1 }
+                    { key: 'obd_rpm', label: 'Engine RPM', unit: 'rpm', decimals: 0 },
+                    { key: 'obd_speed', label: 'Vehicle Speed', unit: 'km/h', decimals: 1 },
+                    { key: 'obd_throttle', label: 'Throttle Position', unit: '%', decimals: 1 },
+                    { key: 'obd_load', label: 'Engine Load', unit: '%', decimals: 1 },
+                    { key: 'obd_coolant_temp', label: 'Coolant Temp', unit: '°C', decimals: 1 },
+                    { key: 'obd_intake_temp', label: 'Intake Temp', unit: '°C', decimals: 1 },
+                    { key: 'obd_maf', label: 'MAF', unit: 'g/s', decimals: 2 },
+                    { key: 'obd_timing_advance', label: 'Timing Advance', unit: '°', decimals: 1 }
                 ];
                 
                 obdParams.forEach(param => {
-                    if (data.obd[param.key] !== undefined && data.obd[param.key] !== 0) {
+                    if (data[param.key] !== undefined && data[param.key] !== 0) {
                         const card = document.createElement('div');
                         card.className = 'sensor-card';
                         card.innerHTML = `
                             <div class="sensor-label">${param.label}</div>
-                            <div class="sensor-value">${data.obd[param.key].toFixed(param.decimals)}<span class="sensor-unit">${param.unit}</span></div>
+                            <div class="sensor-value">${data[param.key].toFixed(param.decimals)}<span class="sensor-unit">${param.unit}</span></div>
                         `;
                         obdGrid.appendChild(card);
                     }
@@ -523,7 +662,12 @@ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
                 document.getElementById('gps-hz').value = config.gps_hz;
                 document.getElementById('imu-hz').value = config.imu_hz;
                 document.getElementById('obd-hz').value = config.obd_hz;
+                document.getElementById('battery-hz').value = config.battery_hz || 1;
                 document.getElementById('obd-ble-enabled').checked = config.obd_ble_enabled;
+                document.getElementById('can-monitor-enabled').checked = config.can_monitor_enabled;
+                document.getElementById('can-filter-id').value = (config.can_filter_id || 0).toString(16).toUpperCase();
+                document.getElementById('can-filter-mask').value = (config.can_filter_mask || 0).toString(16).toUpperCase();
+                document.getElementById('can-filter-extended').checked = config.can_filter_extended;
                 
                 // Load network configuration if present
                 if (config.network) {
@@ -559,7 +703,12 @@ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
                 gps_hz: parseInt(document.getElementById('gps-hz').value),
                 imu_hz: parseInt(document.getElementById('imu-hz').value),
                 obd_hz: parseInt(document.getElementById('obd-hz').value),
+                battery_hz: parseInt(document.getElementById('battery-hz').value),
                 obd_ble_enabled: document.getElementById('obd-ble-enabled').checked,
+                can_monitor_enabled: document.getElementById('can-monitor-enabled').checked,
+                can_filter_id: parseInt(document.getElementById('can-filter-id').value, 16) || 0,
+                can_filter_mask: parseInt(document.getElementById('can-filter-mask').value, 16) || 0,
+                can_filter_extended: document.getElementById('can-filter-extended').checked,
                 network: {
                     ssid: document.getElementById('net-ssid').value,
                     password: document.getElementById('net-password').value,
@@ -5,6 +5,52 @@
 #include <WiFi.h>
 #include <ESPAsyncWebServer.h>
 #include <AsyncWebSocket.h>
+#include "telemetry_frame.h"
+
+class LogBlockWriter;
+class RTLoggerThread;
+class PA1010DDriver;
+
+// WebSocket clients tracked for telemetry (matches AsyncWebSocket's default client limit)
+#define WS_MAX_CLIENTS              8
+
+// Per-client telemetry rate, requested by the client with {"rate_hz": N}
+// (the maximum matches the IMU snapshot rate)
+#define WS_CLIENT_DEFAULT_RATE_HZ   5
+#define WS_CLIENT_MIN_RATE_HZ       1
+#define WS_CLIENT_MAX_RATE_HZ       50
+
+// Delta stream clients ({"delta": true}) get a full keyframe at least this often
+#define WS_KEYFRAME_INTERVAL_MS     5000
+
+/**
+ * @brief Live telemetry counters (binary WebSocket frames)
+ */
+struct telemetry_stats_t {
+    uint32_t frames_sent;       // Ticks that built a frame (at least one client due)
+    uint32_t bytes_last;        // Size of the last message queued to a client
+    uint32_t bytes_avg;         // Average message size, keyframes and deltas
+    uint32_t encode_us_last;    // Per tick: fixed-point conversion and every client's packing
+    uint32_t encode_us_max;
+    uint32_t encode_us_avg;
+    uint32_t delivered;         // Messages queued to clients, all clients
+    uint32_t keyframes;         // Of which keyframes
+    uint32_t dropped;           // Frames skipped for a full client queue, all clients
+};
+
+/**
+ * @brief Telemetry delivery to one WebSocket client
+ */
+struct ws_client_stats_t {
+    uint32_t id;
+    char ip[16];
+    uint16_t rate_hz;           // Requested telemetry rate
+    bool delta;                 // Delta stream requested
+    uint32_t delivered;         // Messages queued to this client
+    uint32_t keyframes;         // Of which keyframes
+    uint32_t bytes;             // Bytes queued to this client
+    uint32_t dropped;           // Frames skipped because its send queue was still full
+};
 
 /**
  * @brief WiFi manager for AP mode with WebSocket support
@@ -44,10 +90,59 @@ public:
     static bool has_clients();
     
     /**
-     * @brief Send JSON data to all connected WebSocket clients
-     * @param json JSON string to send (e.g., "{\"type\": \"sensor\", ...}")
+     * @brief Check whether any client is due a telemetry frame
+     * Lets the publisher skip building frames between client ticks.
      */
-    static void broadcast_json(const char* json);
+    static bool telemetry_due();
+    
+    /**
+     * @brief Encode a telemetry frame and send it to every client that is due
+     *
+     * Each client is paced at its own requested rate. A client whose send
+     * queue is still full is skipped rather than queued behind: it stays due
+     * and gets the newest frame once the queue drains, and each period it
+     * misses counts as one dropped frame. Delta stream clients get only the
+     * fields that moved past their threshold since what they were last sent,
+     * with a keyframe on connect, every WS_KEYFRAME_INTERVAL_MS and whenever
+     * a field disappears. Sent as binary messages (see telemetry_schema.h);
+     * message sizes and encode time are recorded in the telemetry stats.
+     * @param frame Frame with the fields to send marked present
+     */
+    static void broadcast_telemetry(const TelemetryFrame& frame);
+    
+    /**
+     * @brief Get per-client telemetry delivery counters
+     * @param out Output array
+     * @param max_count Capacity of out
+     * @return Number of connected clients written
+     */
+    static size_t get_client_stats(ws_client_stats_t* out, size_t max_count);
+    
+    /**
+     * @brief Get live telemetry counters
+     */
+    static telemetry_stats_t get_telemetry_stats();
+    
+    /**
+     * @brief Serve the logged sessions of a block writer under /api/logs
+     *
+     * GET /api/logs lists the indexed sessions; GET /api/logs/<id> streams
+     * one session's sectors straight from flash (HTTP Range supported).
+     * @param writer Running block writer, or nullptr to disable downloads
+     */
+    static void set_log_writer(LogBlockWriter* writer);
+    
+    /**
+     * @brief Report a sampling loop's busy time under "rt_loop" in /api/about
+     * @param logger Running RT logger, or nullptr to leave it out
+     */
+    static void set_rt_logger(const RTLoggerThread* logger);
+    
+    /**
+     * @brief Report a GPS driver's fix rate, byte stream and latency under "gps" in /api/about
+     * @param gps Driver sampled by the RT logger, or nullptr to leave it out
+     */
+    static void set_gps_driver(const PA1010DDriver* gps);
     
     /**
      * @brief Check if WiFi is initialized
@@ -61,6 +156,37 @@ private:
     static bool m_initialized;
     static String m_ssid;
     static String m_password;
+    static portMUX_TYPE m_stats_lock;
+    static telemetry_stats_t m_telemetry_stats;
+    static uint64_t m_telemetry_bytes;
+    static uint64_t m_telemetry_encode_us;
+    static LogBlockWriter* m_log_writer;
+    static const RTLoggerThread* m_rt_logger;
+    static const PA1010DDriver* m_gps_driver;
+    
+    /**
+     * @brief Telemetry schedule and counters for one connected client
+     */
+    struct client_slot_t {
+        bool used;
+        ws_client_stats_t stats;
+        uint32_t period_us;
+        int64_t next_send_us;   // When the next frame is due
+        int64_t next_keyframe_us;
+        bool keyframe_due;      // Connect or mode change: next frame is a keyframe
+        telemetry_values_t sent;    // What the client holds (delta baseline)
+    };
+    static client_slot_t m_clients[WS_MAX_CLIENTS];
+    
+    /**
+     * @brief Find the slot of a client ID (call with m_stats_lock held)
+     */
+    static client_slot_t* find_client(uint32_t id);
+    
+    /**
+     * @brief Apply a {"rate_hz": N, "delta": true} request from a client
+     */
+    static void handle_client_message(AsyncWebSocketClient* client, const uint8_t* data, size_t len);
     
     /**
      * @brief Handle HTTP request for root path (/)
@@ -82,6 +208,16 @@ private:
      */
     static void handle_about(AsyncWebServerRequest* request);
     
+    /**
+     * @brief Handle GET requests under /api/logs (session list or one session)
+     */
+    static void handle_logs(AsyncWebServerRequest* request);
+    
+    /**
+     * @brief Stream one session's sector image, honouring a Range header
+     */
+    static void handle_log_download(AsyncWebServerRequest* request, uint32_t id);
+    
     /**
      * @brief Handle POST request to restart device
      */
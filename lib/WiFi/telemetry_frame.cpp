@@ -0,0 +1,130 @@
+#include "telemetry_frame.h"
+#include <cmath>
+
+struct telemetry_field_desc_t {
+    telemetry_wire_type_t type;
+    double scale;
+    int64_t delta;          // Delta threshold in wire units (at least 1)
+};
+
+#define TELEMETRY_DELTA_RAW(delta, scale) \
+    ((int64_t)((delta) * (scale) + 0.5) > 0 ? (int64_t)((delta) * (scale) + 0.5) : 1)
+#define TELEMETRY_FIELD_DESC(id, name, type, scale, delta) \
+    { TELEMETRY_WIRE_##type, scale, TELEMETRY_DELTA_RAW(delta, scale) },
+static const telemetry_field_desc_t FIELD_DESC[TELEMETRY_FIELD_COUNT] = {
+    TELEMETRY_FIELDS(TELEMETRY_FIELD_DESC)
+};
+#undef TELEMETRY_FIELD_DESC
+#undef TELEMETRY_DELTA_RAW
+
+static const uint8_t WIRE_SIZE[] = {
+    TELEMETRY_WIRE_SIZE_U8, TELEMETRY_WIRE_SIZE_U16, TELEMETRY_WIRE_SIZE_I16,
+    TELEMETRY_WIRE_SIZE_U32, TELEMETRY_WIRE_SIZE_I32
+};
+
+static int64_t quantize_value(double value, const telemetry_field_desc_t& desc) {
+    int64_t lo, hi;
+    switch (desc.type) {
+        case TELEMETRY_WIRE_U8:  lo = 0;         hi = UINT8_MAX;  break;
+        case TELEMETRY_WIRE_U16: lo = 0;         hi = UINT16_MAX; break;
+        case TELEMETRY_WIRE_I16: lo = INT16_MIN; hi = INT16_MAX;  break;
+        case TELEMETRY_WIRE_U32: lo = 0;         hi = UINT32_MAX; break;
+        default:                 lo = INT32_MIN; hi = INT32_MAX;  break;
+    }
+    double scaled = value * desc.scale;
+    if (std::isnan(scaled)) {
+        return 0;
+    }
+    if (scaled <= (double)lo) {
+        return lo;
+    }
+    if (scaled >= (double)hi) {
+        return hi;
+    }
+    return llround(scaled);
+}
+
+TelemetryFrame::TelemetryFrame() : m_present(0) {
+    for (double& value : m_values) {
+        value = 0.0;
+    }
+}
+
+void TelemetryFrame::clear() {
+    m_present = 0;
+}
+
+void TelemetryFrame::set(telemetry_field_t field, double value) {
+    if (field >= TELEMETRY_FIELD_COUNT) {
+        return;
+    }
+    m_values[field] = value;
+    m_present |= 1UL << field;
+}
+
+bool TelemetryFrame::has(telemetry_field_t field) const {
+    return field < TELEMETRY_FIELD_COUNT && (m_present & (1UL << field)) != 0;
+}
+
+void TelemetryFrame::quantize(telemetry_values_t* values) const {
+    values->present = m_present;
+    for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+        values->raw[i] = (m_present & (1UL << i)) ? quantize_value(m_values[i], FIELD_DESC[i]) : 0;
+    }
+}
+
+size_t TelemetryFrame::encode(uint8_t* out, size_t capacity) const {
+    telemetry_values_t values;
+    quantize(&values);
+    return encode_values(TELEMETRY_FRAME_KEYFRAME, values, values.present, out, capacity);
+}
+
+size_t TelemetryFrame::encode_values(uint8_t type, const telemetry_values_t& values, uint32_t fields,
+                                     uint8_t* out, size_t capacity) {
+    if (out == nullptr || capacity < TELEMETRY_HEADER_SIZE) {
+        return 0;
+    }
+    fields &= values.present;
+
+    out[0] = type;
+    out[1] = TELEMETRY_SCHEMA_VERSION;
+    out[2] = TELEMETRY_FIELD_COUNT;
+    for (size_t i = 0; i < TELEMETRY_BITMAP_SIZE; i++) {
+        out[3 + i] = (uint8_t)(fields >> (8 * i));
+    }
+
+    size_t pos = TELEMETRY_HEADER_SIZE;
+    for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+        if ((fields & (1UL << i)) == 0) {
+            continue;
+        }
+        size_t size = WIRE_SIZE[FIELD_DESC[i].type];
+        if (pos + size > capacity) {
+            return 0;
+        }
+        // Two's complement little-endian: the low bytes are the wire value for every type
+        uint64_t raw = (uint64_t)values.raw[i];
+        for (size_t b = 0; b < size; b++) {
+            out[pos++] = (uint8_t)(raw >> (8 * b));
+        }
+    }
+    return pos;
+}
+
+uint32_t TelemetryFrame::changed_fields(const telemetry_values_t& current, const telemetry_values_t& sent) {
+    uint32_t changed = current.present & ~sent.present;
+    uint32_t common = current.present & sent.present;
+    for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+        if ((common & (1UL << i)) == 0) {
+            continue;
+        }
+        int64_t diff = current.raw[i] - sent.raw[i];
+        if (diff < 0) {
+            diff = -diff;
+        }
+        if (diff >= FIELD_DESC[i].delta) {
+            changed |= 1UL << i;
+        }
+    }
+    return changed;
+}
@@ -2,9 +2,17 @@
 #include "web_pages.h"
 #include "config_manager.h"
 #include "icar_ble_driver.h"
+#include "time_base.h"
 #include "version_info.h"
+#include "log_block_writer.h"
+#include "rt_logger_thread.h"
+#include "pa1010d_driver.h"
+#include <cctype>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <ArduinoJson.h>
+#include <esp_timer.h>
 
 // Static member initialization
 AsyncWebServer* WiFiManager::m_server = nullptr;
@@ -12,6 +20,75 @@ AsyncWebSocket* WiFiManager::m_websocket = nullptr;
 bool WiFiManager::m_initialized = false;
 String WiFiManager::m_ssid = "";
 String WiFiManager::m_password = "";
+portMUX_TYPE WiFiManager::m_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+telemetry_stats_t WiFiManager::m_telemetry_stats = {};
+uint64_t WiFiManager::m_telemetry_bytes = 0;
+uint64_t WiFiManager::m_telemetry_encode_us = 0;
+WiFiManager::client_slot_t WiFiManager::m_clients[WS_MAX_CLIENTS] = {};
+LogBlockWriter* WiFiManager::m_log_writer = nullptr;
+const RTLoggerThread* WiFiManager::m_rt_logger = nullptr;
+const PA1010DDriver* WiFiManager::m_gps_driver = nullptr;
+
+// A client tick this early still counts as due (publisher wake-up jitter)
+#define WS_SEND_SLACK_US    5000
+
+// Session list; /api/logs/<id> downloads one session
+#define LOG_API_PATH        "/api/logs"
+
+static void format_uuid(const uint8_t* id, char* out, size_t size) {
+    snprintf(out, size, "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+             id[0], id[1], id[2], id[3], id[4], id[5], id[6], id[7],
+             id[8], id[9], id[10], id[11], id[12], id[13], id[14], id[15]);
+}
+
+/**
+ * @brief Parse a single-range "Range: bytes=..." header against a resource size
+ * @return 1 if first/last were set, 0 to ignore the header and send everything
+ *         (other units, several ranges, bad syntax), -1 if unsatisfiable
+ */
+static int parse_byte_range(const char* header, uint32_t total, uint32_t* first, uint32_t* last) {
+    if (strncmp(header, "bytes=", 6) != 0 || strchr(header, ',') != nullptr) {
+        return 0;
+    }
+    const char* p = header + 6;
+    char* end;
+
+    // Suffix range: the last N bytes
+    if (*p == '-') {
+        unsigned long count = strtoul(p + 1, &end, 10);
+        if (end == p + 1 || *end != '\0') {
+            return 0;
+        }
+        if (count == 0 || total == 0) {
+            return -1;
+        }
+        *first = count < total ? total - (uint32_t)count : 0;
+        *last = total - 1;
+        return 1;
+    }
+
+    if (!isdigit((unsigned char)*p)) {
+        return 0;
+    }
+    unsigned long start = strtoul(p, &end, 10);
+    if (*end != '-') {
+        return 0;
+    }
+    p = end + 1;
+    unsigned long stop = total > 0 ? total - 1 : 0;
+    if (*p != '\0') {
+        stop = strtoul(p, &end, 10);
+        if (end == p || *end != '\0' || stop < start) {
+            return 0;
+        }
+    }
+    if (start >= total) {
+        return -1;
+    }
+    *first = (uint32_t)start;
+    *last = stop < total ? (uint32_t)stop : total - 1;
+    return 1;
+}
 
 bool WiFiManager::init() {
     if (m_initialized) {
@@ -98,6 +175,7 @@ bool WiFiManager::init() {
     m_server->on("/api/config", HTTP_POST, [](AsyncWebServerRequest* request){}, nullptr, handle_config_post);
     m_server->on("/api/about", HTTP_GET, handle_about);
     m_server->on("/api/restart", HTTP_POST, handle_restart);
+    m_server->on(LOG_API_PATH, HTTP_GET, handle_logs);      // Also matches /api/logs/<id>
     
     // Start server
     m_server->begin();
@@ -126,21 +204,206 @@ bool WiFiManager::has_clients() {
     return get_client_count() > 0;
 }
 
-void WiFiManager::broadcast_json(const char* json) {
-    if (m_websocket == nullptr || json == nullptr) return;
-    
-    // Verify we have clients before broadcasting
-    if (m_websocket->count() == 0) return;
+WiFiManager::client_slot_t* WiFiManager::find_client(uint32_t id) {
+    for (client_slot_t& slot : m_clients) {
+        if (slot.used && slot.stats.id == id) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+bool WiFiManager::telemetry_due() {
+    int64_t now_us = esp_timer_get_time();
+    bool due = false;
+    portENTER_CRITICAL(&m_stats_lock);
+    for (const client_slot_t& slot : m_clients) {
+        if (slot.used && now_us >= slot.next_send_us - WS_SEND_SLACK_US) {
+            due = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&m_stats_lock);
+    return due;
+}
+
+void WiFiManager::broadcast_telemetry(const TelemetryFrame& frame) {
+    if (m_websocket == nullptr) return;
+    
+    // Clients whose tick has come
+    uint32_t due_ids[WS_MAX_CLIENTS];
+    size_t due_count = 0;
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&m_stats_lock);
+    for (const client_slot_t& slot : m_clients) {
+        if (slot.used && now_us >= slot.next_send_us - WS_SEND_SLACK_US) {
+            due_ids[due_count++] = slot.stats.id;
+        }
+    }
+    portEXIT_CRITICAL(&m_stats_lock);
+    if (due_count == 0) return;
+    
+    // Quantize once; each client then gets a keyframe or its own delta
+    int64_t start_us = esp_timer_get_time();
+    telemetry_values_t current;
+    frame.quantize(&current);
+    uint32_t encode_us = (uint32_t)(esp_timer_get_time() - start_us);
+    
+    uint8_t buffer[TELEMETRY_FRAME_MAX_SIZE];
+    uint32_t bytes_sent = 0;
+    uint32_t messages_sent = 0;
+    size_t len = 0;
+    for (size_t i = 0; i < due_count; i++) {
+        // Never queue behind a backlog: a slow client waits for the newest frame instead
+        AsyncWebSocketClient* client = m_websocket->client(due_ids[i]);
+        bool room = client != nullptr && !client->queueIsFull();
+        
+        bool keyframe = true;
+        uint32_t fields = current.present;
+        if (room) {
+            portENTER_CRITICAL(&m_stats_lock);
+            client_slot_t* slot = find_client(due_ids[i]);
+            if (slot != nullptr) {
+                keyframe = !slot->stats.delta || slot->keyframe_due || now_us >= slot->next_keyframe_us ||
+                           (slot->sent.present & ~current.present) != 0;
+                if (!keyframe) {
+                    fields = TelemetryFrame::changed_fields(current, slot->sent);
+                }
+            }
+            portEXIT_CRITICAL(&m_stats_lock);
+        }
+        
+        // Nothing moved past its threshold: skip the message, keep the schedule
+        bool sent = false;
+        if (room && (keyframe || fields != 0)) {
+            start_us = esp_timer_get_time();
+            len = TelemetryFrame::encode_values(keyframe ? TELEMETRY_FRAME_KEYFRAME : TELEMETRY_FRAME_DELTA,
+                                                current, fields, buffer, sizeof(buffer));
+            encode_us += (uint32_t)(esp_timer_get_time() - start_us);
+            if (len > 0) {
+                client->binary(buffer, len);
+                sent = true;
+                bytes_sent += len;
+                messages_sent++;
+            }
+        }
+        
+        portENTER_CRITICAL(&m_stats_lock);
+        client_slot_t* slot = find_client(due_ids[i]);
+        if (slot != nullptr) {
+            if (room) {
+                if (sent) {
+                    slot->stats.delivered++;
+                    slot->stats.bytes += len;
+                    if (keyframe) {
+                        slot->stats.keyframes++;
+                        slot->sent = current;
+                        slot->keyframe_due = false;
+                        slot->next_keyframe_us = now_us + WS_KEYFRAME_INTERVAL_MS * 1000LL;
+                    } else {
+                        for (int f = 0; f < TELEMETRY_FIELD_COUNT; f++) {
+                            if (fields & (1UL << f)) {
+                                slot->sent.raw[f] = current.raw[f];
+                            }
+                        }
+                        slot->sent.present |= fields;
+                    }
+                    m_telemetry_stats.keyframes += keyframe ? 1 : 0;
+                }
+                slot->next_send_us += slot->period_us;
+                if (slot->next_send_us <= now_us) {
+                    slot->next_send_us = now_us + slot->period_us;
+                }
+            } else if (now_us >= slot->next_send_us + slot->period_us) {
+                // A whole period passed without room: that frame is lost
+                slot->stats.dropped++;
+                m_telemetry_stats.dropped++;
+                slot->next_send_us += slot->period_us;
+            }
+        }
+        portEXIT_CRITICAL(&m_stats_lock);
+    }
     
-    // Check json string length to prevent crashes
-    size_t len = strlen(json);
-    if (len == 0 || len > 2048) {
-        Serial.printf("[WiFi] Invalid JSON length: %d\n", len);
+    portENTER_CRITICAL(&m_stats_lock);
+    telemetry_stats_t& stats = m_telemetry_stats;
+    stats.frames_sent++;
+    m_telemetry_encode_us += encode_us;
+    stats.encode_us_last = encode_us;
+    stats.encode_us_max = encode_us > stats.encode_us_max ? encode_us : stats.encode_us_max;
+    stats.encode_us_avg = (uint32_t)(m_telemetry_encode_us / stats.frames_sent);
+    if (messages_sent > 0) {
+        stats.delivered += messages_sent;
+        m_telemetry_bytes += bytes_sent;
+        stats.bytes_last = len;
+        stats.bytes_avg = (uint32_t)(m_telemetry_bytes / stats.delivered);
+    }
+    portEXIT_CRITICAL(&m_stats_lock);
+}
+
+telemetry_stats_t WiFiManager::get_telemetry_stats() {
+    portENTER_CRITICAL(&m_stats_lock);
+    telemetry_stats_t stats = m_telemetry_stats;
+    portEXIT_CRITICAL(&m_stats_lock);
+    return stats;
+}
+
+size_t WiFiManager::get_client_stats(ws_client_stats_t* out, size_t max_count) {
+    size_t count = 0;
+    portENTER_CRITICAL(&m_stats_lock);
+    for (const client_slot_t& slot : m_clients) {
+        if (slot.used && count < max_count) {
+            out[count++] = slot.stats;
+        }
+    }
+    portEXIT_CRITICAL(&m_stats_lock);
+    return count;
+}
+
+void WiFiManager::handle_client_message(AsyncWebSocketClient* client, const uint8_t* data, size_t len) {
+    JsonDocument doc;
+    if (deserializeJson(doc, (const char*)data, len) ||
+        (!doc["rate_hz"].is<int>() && !doc["delta"].is<bool>())) {
+        Serial.printf("[WebSocket] Ignoring message from client #%u: %.*s\n", client->id(), (int)len, data);
         return;
     }
     
-    // Send to all connected clients
-    m_websocket->textAll(json);
+    int rate_hz = doc["rate_hz"] | 0;
+    if (rate_hz != 0) {
+        if (rate_hz < WS_CLIENT_MIN_RATE_HZ) rate_hz = WS_CLIENT_MIN_RATE_HZ;
+        if (rate_hz > WS_CLIENT_MAX_RATE_HZ) rate_hz = WS_CLIENT_MAX_RATE_HZ;
+    }
+    
+    bool delta = false;
+    portENTER_CRITICAL(&m_stats_lock);
+    client_slot_t* slot = find_client(client->id());
+    if (slot != nullptr) {
+        if (rate_hz != 0) {
+            slot->stats.rate_hz = (uint16_t)rate_hz;
+            slot->period_us = 1000000UL / rate_hz;
+            slot->next_send_us = esp_timer_get_time();
+        }
+        if (doc["delta"].is<bool>() && doc["delta"].as<bool>() != slot->stats.delta) {
+            slot->stats.delta = doc["delta"].as<bool>();
+            slot->keyframe_due = true;
+        }
+        rate_hz = slot->stats.rate_hz;
+        delta = slot->stats.delta;
+    }
+    portEXIT_CRITICAL(&m_stats_lock);
+    Serial.printf("[WebSocket] Client #%u telemetry %d Hz, %s\n", client->id(), rate_hz,
+                  delta ? "delta stream" : "keyframes only");
+}
+
+void WiFiManager::set_log_writer(LogBlockWriter* writer) {
+    m_log_writer = writer;
+}
+
+void WiFiManager::set_rt_logger(const RTLoggerThread* logger) {
+    m_rt_logger = logger;
+}
+
+void WiFiManager::set_gps_driver(const PA1010DDriver* gps) {
+    m_gps_driver = gps;
 }
 
 bool WiFiManager::is_initialized() {
@@ -168,7 +431,12 @@ void WiFiManager::handle_config_get(AsyncWebServerRequest* request) {
     doc["gps_hz"] = config.gps_hz;
     doc["imu_hz"] = config.imu_hz;
     doc["obd_hz"] = config.obd_hz;
+    doc["battery_hz"] = config.battery_hz;
     doc["obd_ble_enabled"] = config.obd_ble_enabled;
+    doc["can_monitor_enabled"] = config.can_monitor_enabled;
+    doc["can_filter_id"] = config.can_filter_id;
+    doc["can_filter_mask"] = config.can_filter_mask;
+    doc["can_filter_extended"] = config.can_filter_extended;
     
     // Add network configuration with null-termination safety
     JsonObject network = doc["network"].to<JsonObject>();
@@ -224,7 +492,12 @@ void WiFiManager::handle_config_post(AsyncWebServerRequest* request, uint8_t* da
     config.gps_hz = doc["gps_hz"] | 10;
     config.imu_hz = doc["imu_hz"] | 10;
     config.obd_hz = doc["obd_hz"] | 10;
+    config.battery_hz = doc["battery_hz"] | 1;
     config.obd_ble_enabled = doc["obd_ble_enabled"] | true;
+    config.can_monitor_enabled = doc["can_monitor_enabled"] | config.can_monitor_enabled;
+    config.can_filter_id = doc["can_filter_id"] | config.can_filter_id;
+    config.can_filter_mask = doc["can_filter_mask"] | config.can_filter_mask;
+    config.can_filter_extended = doc["can_filter_extended"] | config.can_filter_extended;
     
     // Parse network configuration if provided
     if (doc.containsKey("network")) {
@@ -253,6 +526,11 @@ void WiFiManager::handle_config_post(AsyncWebServerRequest* request, uint8_t* da
     
     bool success = ConfigManager::update(config);
     
+    // The CAN monitor switches live; captured frames need a logging session
+    if (success && m_log_writer && m_log_writer->is_running()) {
+        IcarBleDriver::load_can_monitor_config(config, m_log_writer->get_session_start_us());
+    }
+    
     String response = success ? 
         "{\"success\":true,\"message\":\"Configuration saved\"}" :
         "{\"success\":false,\"error\":\"Validation failed\"}";
@@ -301,6 +579,74 @@ void WiFiManager::handle_about(AsyncWebServerRequest* request) {
     doc["devices"]["imu"] = true;
     doc["devices"]["battery"] = true;
     
+    // GPS-disciplined clock
+    time_base_stats_t time = TimeBase::get_stats();
+    static const char* const TIME_SOURCES[] = { "none", "nmea", "pps" };
+    doc["time"]["source"] = TIME_SOURCES[time.state.source <= TIME_SOURCE_PPS ? time.state.source : 0];
+    doc["time"]["drift_ppm"] = time.state.drift_ppm;
+    doc["time"]["uncertainty_us"] = time.state.uncertainty_us;
+    doc["time"]["last_residual_us"] = time.last_residual_us;
+    doc["time"]["corrections"] = time.corrections;
+    doc["time"]["steps"] = time.steps;
+    doc["time"]["outliers"] = time.outliers;
+    doc["time"]["pps_edges"] = time.pps_edges;
+    
+    // Sampling loop busy time; tools/rt_load_check.py reads it under client load
+    if (m_rt_logger != nullptr) {
+        rt_loop_stats_t loop = m_rt_logger->get_loop_stats();
+        doc["rt_loop"]["iterations"] = loop.iterations;
+        doc["rt_loop"]["mean_us"] = loop.mean_us;
+        doc["rt_loop"]["max_us"] = loop.max_us;
+        doc["rt_loop"]["budget_us"] = loop.budget_us;
+        doc["rt_loop"]["over_budget"] = loop.over_budget;
+    }
+    
+    // GPS fix rate (PMTK220 setting vs. RMC epochs seen), byte stream and sentence latency
+    if (m_gps_driver != nullptr) {
+        pa1010d_stream_stats_t stream = m_gps_driver->get_stream_stats();
+        JsonObject gps = doc["gps"].to<JsonObject>();
+        gps["configured_hz"] = m_gps_driver->get_configured_rate_hz();
+        gps["fix_rate_hz"] = m_gps_driver->get_fix_rate_hz();
+        gps["reads"] = stream.reads;
+        gps["bytes"] = stream.bytes;
+        gps["read_size"] = stream.read_size;
+        gps["padding_bytes"] = stream.padding_bytes;
+        gps["ring_overflows"] = stream.ring_overflows;
+        gps["sentence_overflows"] = stream.sentence_overflows;
+        gps["latency_us"] = stream.last_latency_us;
+        gps["mean_latency_us"] = stream.mean_latency_us;
+        gps["max_latency_us"] = stream.max_latency_us;
+    }
+    
+    // Live telemetry frames
+    telemetry_stats_t telemetry = get_telemetry_stats();
+    doc["telemetry"]["schema_version"] = TELEMETRY_SCHEMA_VERSION;
+    doc["telemetry"]["frames_sent"] = telemetry.frames_sent;
+    doc["telemetry"]["bytes_per_frame"] = telemetry.bytes_last;
+    doc["telemetry"]["avg_bytes_per_frame"] = telemetry.bytes_avg;
+    doc["telemetry"]["max_frame_bytes"] = TELEMETRY_FRAME_MAX_SIZE;
+    doc["telemetry"]["encode_us"] = telemetry.encode_us_last;
+    doc["telemetry"]["avg_encode_us"] = telemetry.encode_us_avg;
+    doc["telemetry"]["max_encode_us"] = telemetry.encode_us_max;
+    doc["telemetry"]["delivered"] = telemetry.delivered;
+    doc["telemetry"]["keyframes"] = telemetry.keyframes;
+    doc["telemetry"]["dropped"] = telemetry.dropped;
+    
+    ws_client_stats_t clients[WS_MAX_CLIENTS];
+    size_t client_count = get_client_stats(clients, WS_MAX_CLIENTS);
+    JsonArray client_array = doc["telemetry"]["clients"].to<JsonArray>();
+    for (size_t i = 0; i < client_count; i++) {
+        JsonObject entry = client_array.add<JsonObject>();
+        entry["id"] = clients[i].id;
+        entry["ip"] = clients[i].ip;
+        entry["rate_hz"] = clients[i].rate_hz;
+        entry["delta"] = clients[i].delta;
+        entry["delivered"] = clients[i].delivered;
+        entry["keyframes"] = clients[i].keyframes;
+        entry["bytes"] = clients[i].bytes;
+        entry["dropped"] = clients[i].dropped;
+    }
+    
     // OBD/ELM-327 status
     bool obd_connected = false;
     try {
@@ -310,6 +656,7 @@ void WiFiManager::handle_about(AsyncWebServerRequest* request) {
     }
     
     doc["devices"]["obd"] = obd_connected;
+    doc["devices"]["obd_link"] = IcarBleDriver::link_state_name(IcarBleDriver::get_link_state());
     if (obd_connected) {
         doc["obd_info"]["device_name"] = String(IcarBleDriver::get_device_name());
         doc["obd_info"]["address"] = String(IcarBleDriver::get_device_address());
@@ -323,6 +670,39 @@ void WiFiManager::handle_about(AsyncWebServerRequest* request) {
         if (ecm && strlen(ecm) > 0) {
             doc["obd_info"]["ecm_name"] = String(ecm);
         }
+
+        // Polling: learned adapter capacity and requested vs. achieved rate per PID
+        obd_link_stats_t link = IcarBleDriver::get_link_stats();
+        doc["obd_info"]["capacity_pids_per_sec"] = link.capacity_pids_per_sec;
+        doc["obd_info"]["demand_pids_per_sec"] = link.demand_pids_per_sec;
+        doc["obd_info"]["pids_per_sec"] = link.pids_per_sec;
+        doc["obd_info"]["batching"] = link.batching;
+        doc["obd_info"]["mtu"] = link.mtu;
+        doc["obd_info"]["conn_interval_ms"] = link.conn_interval_ms;
+        doc["obd_info"]["rx_bytes_per_sec"] = link.rx_bytes_per_sec;
+        doc["obd_info"]["tx_bytes_per_sec"] = link.tx_bytes_per_sec;
+        doc["obd_info"]["rtt_ms"] = link.rtt_ms;
+        doc["obd_info"]["max_rtt_ms"] = link.max_rtt_ms;
+        doc["obd_info"]["connect_failures"] = link.connect_failures;
+        doc["obd_info"]["link_losses"] = link.link_losses;
+
+        // Raw CAN capture (PID polling pauses while it runs)
+        doc["obd_info"]["can_monitor"] = IcarBleDriver::is_can_monitor_active();
+        doc["obd_info"]["can_frames"] = link.can_frames;
+        doc["obd_info"]["can_dropped"] = link.can_dropped;
+        doc["obd_info"]["can_buffer_full"] = link.can_buffer_full;
+
+        obd_pid_stats_t pid_stats[32];
+        size_t pid_count = IcarBleDriver::get_pid_stats(pid_stats, 32);
+        JsonArray pids = doc["obd_info"]["pids"].to<JsonArray>();
+        for (size_t i = 0; i < pid_count; i++) {
+            JsonObject entry = pids.add<JsonObject>();
+            entry["pid"] = pid_stats[i].pid;
+            entry["priority"] = pid_stats[i].priority;
+            entry["requested_hz"] = pid_stats[i].requested_hz;
+            entry["scheduled_hz"] = pid_stats[i].scheduled_hz;
+            entry["achieved_hz"] = pid_stats[i].achieved_hz;
+        }
     }
     
     String json_str;
@@ -330,6 +710,120 @@ void WiFiManager::handle_about(AsyncWebServerRequest* request) {
     request->send(200, "application/json", json_str);
 }
 
+void WiFiManager::handle_logs(AsyncWebServerRequest* request) {
+    LogBlockWriter* writer = m_log_writer;
+    if (writer == nullptr) {
+        request->send(503, "application/json", "{\"success\":false,\"error\":\"Logging is not running\"}");
+        return;
+    }
+
+    const char* path = request->url().c_str() + strlen(LOG_API_PATH);
+    if (path[0] == '/' && path[1] != '\0') {
+        char* end;
+        unsigned long id = strtoul(path + 1, &end, 10);
+        if (!isdigit((unsigned char)path[1]) || *end != '\0') {
+            request->send(404, "application/json", "{\"success\":false,\"error\":\"Unknown session\"}");
+            return;
+        }
+        handle_log_download(request, (uint32_t)id);
+        return;
+    }
+
+    log_session_info_t sessions[SESSION_INDEX_SLOTS];
+    size_t count = writer->list_sessions(sessions, SESSION_INDEX_SLOTS);
+    uint32_t sector_size = writer->get_sector_size();
+
+    JsonDocument doc;
+    doc["sector_size"] = sector_size;
+    JsonArray list = doc["sessions"].to<JsonArray>();
+    for (size_t i = 0; i < count; i++) {
+        // Copy out of the packed index entry before handing values to ArduinoJson
+        uint32_t id = sessions[i].meta.startup_counter;
+        int64_t start_utc = sessions[i].meta.gps_utc_at_start;
+        int64_t start_esp_us = sessions[i].meta.session_start_time_esp_us;
+        char uuid[37];
+        char url[32];
+        format_uuid(sessions[i].meta.startup_id, uuid, sizeof(uuid));
+        snprintf(url, sizeof(url), LOG_API_PATH "/%u", (unsigned)id);
+
+        JsonObject entry = list.add<JsonObject>();
+        entry["id"] = id;
+        entry["startup_id"] = uuid;
+        entry["start_utc"] = start_utc;         // 0 if GPS time was never known
+        entry["start_esp_us"] = start_esp_us;
+        entry["bytes"] = sessions[i].sector_count * sector_size;
+        entry["complete"] = sessions[i].complete;   // false: the ring has overwritten its start
+        entry["active"] = sessions[i].active;
+        entry["url"] = url;
+    }
+
+    String json_str;
+    serializeJson(doc, json_str);
+    request->send(200, "application/json", json_str);
+}
+
+void WiFiManager::handle_log_download(AsyncWebServerRequest* request, uint32_t id) {
+    LogBlockWriter* writer = m_log_writer;
+    log_session_info_t session;
+    if (!writer->find_session(id, &session)) {
+        request->send(404, "application/json", "{\"success\":false,\"error\":\"Session not found or overwritten\"}");
+        return;
+    }
+
+    uint32_t total = session.sector_count * writer->get_sector_size();
+    uint32_t first = 0;
+    uint32_t last = total - 1;
+
+    // The tag changes when the session gains a sector, so If-Range only
+    // resumes against the same image
+    char etag[40];
+    snprintf(etag, sizeof(etag), "\"%u-%u-%u\"", (unsigned)id, (unsigned)session.first_sequence,
+             (unsigned)session.sector_count);
+
+    int range = 0;
+    if (request->hasHeader("Range") &&
+        (!request->hasHeader("If-Range") || request->getHeader("If-Range")->value() == etag)) {
+        range = parse_byte_range(request->getHeader("Range")->value().c_str(), total, &first, &last);
+    }
+    if (range < 0) {
+        char content_range[32];
+        snprintf(content_range, sizeof(content_range), "bytes */%u", (unsigned)total);
+        AsyncWebServerResponse* response = request->beginResponse(416, "text/plain", "Range not satisfiable");
+        response->addHeader("Content-Range", content_range);
+        request->send(response);
+        return;
+    }
+
+    // The filler runs in the async TCP task on core 0 whenever the socket can
+    // take more data, copying flash straight into the send buffer
+    uint32_t length = last - first + 1;
+    AsyncWebServerResponse* response = request->beginResponse("application/octet-stream", length,
+        [writer, session, first, length](uint8_t* buffer, size_t max_len, size_t index) -> size_t {
+            if (index >= length) {
+                return 0;
+            }
+            size_t len = max_len < length - index ? max_len : length - index;
+            return writer->read_session(session, first + (uint32_t)index, buffer, len);
+        });
+
+    char disposition[48];
+    snprintf(disposition, sizeof(disposition), "attachment; filename=\"session-%u.bin\"", (unsigned)id);
+    response->addHeader("Accept-Ranges", "bytes");
+    response->addHeader("ETag", etag);
+    response->addHeader("Content-Disposition", disposition);
+    if (range > 0) {
+        char content_range[48];
+        snprintf(content_range, sizeof(content_range), "bytes %u-%u/%u",
+                 (unsigned)first, (unsigned)last, (unsigned)total);
+        response->setCode(206);
+        response->addHeader("Content-Range", content_range);
+    }
+
+    Serial.printf("[WiFi] Log download: session %u, bytes %u-%u of %u\n",
+                  (unsigned)id, (unsigned)first, (unsigned)last, (unsigned)total);
+    request->send(response);
+}
+
 void WiFiManager::handle_restart(AsyncWebServerRequest* request) {
     Serial.println("[WiFi] Restart requested via web interface");
     request->send(200, "application/json", "{\"success\":true,\"message\":\"Restarting device...\"}");
@@ -342,21 +836,49 @@ void WiFiManager::handle_restart(AsyncWebServerRequest* request) {
 void WiFiManager::handle_websocket_event(AsyncWebSocket* server, AsyncWebSocketClient* client,
                                          AwsEventType type, void* arg, uint8_t* data, size_t len) {
     switch (type) {
-        case WS_EVT_CONNECT:
+        case WS_EVT_CONNECT: {
             Serial.printf("[WebSocket] Client #%u connected from %s\n", client->id(), client->remoteIP().toString().c_str());
+            String ip = client->remoteIP().toString();
+            bool tracked = false;
+            portENTER_CRITICAL(&m_stats_lock);
+            for (client_slot_t& slot : m_clients) {
+                if (!slot.used) {
+                    slot = {};
+                    slot.used = true;
+                    slot.stats.id = client->id();
+                    strncpy(slot.stats.ip, ip.c_str(), sizeof(slot.stats.ip) - 1);
+                    slot.stats.rate_hz = WS_CLIENT_DEFAULT_RATE_HZ;
+                    slot.period_us = 1000000UL / WS_CLIENT_DEFAULT_RATE_HZ;
+                    slot.next_send_us = esp_timer_get_time();
+                    slot.keyframe_due = true;
+                    tracked = true;
+                    break;
+                }
+            }
+            portEXIT_CRITICAL(&m_stats_lock);
+            if (!tracked) {
+                Serial.printf("[WebSocket] Client #%u rejected: %d clients already connected\n", client->id(), WS_MAX_CLIENTS);
+                client->close();
+            }
             break;
+        }
             
-        case WS_EVT_DISCONNECT:
+        case WS_EVT_DISCONNECT: {
             Serial.printf("[WebSocket] Client #%u disconnected\n", client->id());
+            portENTER_CRITICAL(&m_stats_lock);
+            client_slot_t* slot = find_client(client->id());
+            if (slot != nullptr) {
+                slot->used = false;
+            }
+            portEXIT_CRITICAL(&m_stats_lock);
             break;
+        }
             
         case WS_EVT_DATA: {
-            // Currently not expecting client-side messages, but handle gracefully
+            // Single-frame text messages are stream requests: {"rate_hz": N, "delta": true}
             AwsFrameInfo* info = (AwsFrameInfo*)arg;
-            if (info->opcode == WS_TEXT) {
-                // Could implement commands from client if needed
-                // For now, just log the message
-                Serial.printf("[WebSocket] Message from client #%u: %.*s\n", client->id(), (int)len, data);
+            if (info->opcode == WS_TEXT && info->final && info->index == 0 && info->len == len) {
+                handle_client_message(client, data, len);
             }
             break;
         }
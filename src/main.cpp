@@ -8,9 +8,13 @@
 #include "rt_logger_thread.h"
 #include "storage_reporter.h"
 #include "status_monitor.h"
+#include "telemetry_publisher.h"
 #include "st7789_display.h"
 #include "wifi_manager.h"
 #include "config_manager.h"
+#include "log_block_writer.h"
+#include "icar_ble_driver.h"
+#include "time_base.h"
 
 // Hardware configuration
 #define GPS_TX_PIN          17
@@ -22,6 +26,9 @@
 #define IMU_I2C_ADDR        0x69
 #define BATTERY_I2C_ADDR    0x36
 
+// IMU rates above this use the ICM20948 hardware FIFO instead of per-sample polling
+#define IMU_FIFO_MIN_HZ     100
+
 // Button Configuration (GPIO pins)
 #define BUTTON_D0           0   // Bottom button - Pause/Resume storage
 #define BUTTON_D1           1   // Middle button - Cycle display mode
@@ -38,7 +45,9 @@ static const char* TAG = "MAIN";
 SensorManager sensor_manager;
 RTLoggerThread* rt_logger = nullptr;
 StatusMonitor* status_monitor = nullptr;
+TelemetryPublisher* telemetry_publisher = nullptr;
 StorageReporter reporter;
+LogBlockWriter block_writer;
 
 // PA1010D GPS driver instance
 PA1010DDriver* gps_driver = nullptr;
@@ -60,6 +69,14 @@ void on_storage_write(const gps_data_t& gps, const accel_data_t& accel,
                       const gyro_data_t& gyro, const compass_data_t& compass,
                       const battery_data_t& battery) {
     reporter.report_storage_write(gps, accel, gyro, compass, battery);
+    if (block_writer.is_running()) {
+        reporter.report_writer_stats(block_writer.get_stats());
+    }
+    if (imu_driver != nullptr) {
+        icm20948_bus_stats_t bus = imu_driver->get_bus_stats();
+        reporter.printf_debug("IMU bus: %u tx / %u bytes per update (%u updates)",
+                              bus.last_update_transactions, bus.last_update_bytes, bus.updates);
+    }
     
     // Increment write counter in status monitor
     if (status_monitor != nullptr) {
@@ -109,6 +126,15 @@ bool init_sensors() {
         reporter.print_debug("  ✓ GPS initialized (UART)");
     }
     
+    // Fix rate and RMC+GGA-only output from the configured GPS rate
+    uint16_t gps_hz = ConfigManager::get_current().gps_hz;
+    reporter.printf_debug("  → Configuring GPS for %u Hz fixes...", gps_hz);
+    if (gps_driver->configure(gps_hz)) {
+        reporter.printf_debug("  ✓ GPS configured (%u Hz, RMC+GGA)", gps_driver->get_configured_rate_hz());
+    } else {
+        reporter.print_debug("  ⚠ WARNING: GPS did not acknowledge configuration, using module defaults");
+    }
+    
     // Create and initialize IMU driver
     reporter.printf_debug("  → Initializing IMU (ICM20948 @ 0x%02X)...", IMU_I2C_ADDR);
     imu_driver = new ICM20948Driver(Wire, IMU_I2C_ADDR);
@@ -141,6 +167,17 @@ bool init_sensors() {
     }
     reporter.print_debug("  ✓ Sensor Manager ready");
     
+    // High IMU rates: let the chip buffer samples and drain them in bursts
+    uint16_t imu_hz = ConfigManager::get_current().imu_hz;
+    if (imu_hz > IMU_FIFO_MIN_HZ) {
+        reporter.printf_debug("  → Enabling IMU FIFO at %u Hz...", imu_hz);
+        if (imu_driver->enable_fifo(imu_hz)) {
+            reporter.print_debug("  ✓ IMU FIFO enabled");
+        } else {
+            reporter.print_debug("  ⚠ IMU FIFO unavailable, polling registers");
+        }
+    }
+    
     return true;
 }
 
@@ -227,10 +264,6 @@ void setup() {
     
     // Get current configuration
     logging_config_t config = ConfigManager::get_current();
-    uint32_t main_loop_ms = 1000 / config.main_loop_hz;
-    uint32_t gps_ms = 1000 / config.gps_hz;
-    uint32_t imu_ms = 1000 / config.imu_hz;
-    uint32_t obd_ms = 1000 / config.obd_hz;
     
     // Initialize sensors
     Serial.println("About to call init_sensors()");
@@ -247,13 +280,27 @@ void setup() {
     Serial.println("init_sensors() completed successfully");
     Serial.flush();
     
+    // GPS-disciplined clock for record timestamps (PPS if wired)
+    TimeBase::init();
+    
+    // Start the flash block writer before sampling begins
+    Serial.println("▶ Starting LZ4 block writer (storage partition)...");
+    Serial.flush();
+    if (!block_writer.start()) {
+        Serial.println("⚠ WARNING: Block writer failed to start, logging to serial only");
+    } else {
+        Serial.println("✓ Block writer started");
+    }
+    Serial.flush();
+    
     Serial.println("▶ Starting Real-Time Logger Thread (Core 1)...");
     Serial.flush();
     
     // Create and start the RT logger thread on core 1
     Serial.println("  → Creating RTLoggerThread object...");
     Serial.flush();
-    rt_logger = new RTLoggerThread(&sensor_manager, main_loop_ms, gps_ms, imu_ms, obd_ms);
+    rt_logger = new RTLoggerThread(&sensor_manager, config.main_loop_hz, config.gps_hz,
+                                   config.imu_hz, config.obd_hz, config.battery_hz);
     Serial.println("  ✓ RTLoggerThread object created");
     Serial.flush();
     
@@ -261,6 +308,10 @@ void setup() {
     Serial.println("  → Registering storage callback...");
     Serial.flush();
     rt_logger->set_storage_write_callback(on_storage_write);
+    if (block_writer.is_running()) {
+        rt_logger->set_block_writer(&block_writer);
+        block_writer.add_source(IcarBleDriver::get_can_ring());  // Filled while the CAN monitor runs
+    }
     Serial.println("  ✓ Callback registered");
     Serial.flush();
     
@@ -281,14 +332,46 @@ void setup() {
     // Initialize WiFi AP mode with WebSocket server
     Serial.println("▶ Initializing WiFi AP mode...");
     Serial.flush();
+    if (block_writer.is_running()) {
+        WiFiManager::set_log_writer(&block_writer);     // Session downloads under /api/logs
+    }
+    WiFiManager::set_rt_logger(rt_logger);              // Loop timing under /api/about
+    WiFiManager::set_gps_driver(gps_driver);            // GPS stream under /api/about
     if (WiFiManager::init()) {
         Serial.printf("✓ WiFi AP initialized - SSID: %s\n", WiFiManager::get_ssid().c_str());
-        Serial.printf("  IP: 192.168.4.1 | WebSocket: /ws\n");
+        Serial.printf("  IP: 192.168.4.1 | WebSocket: /ws | Logs: /api/logs\n");
     } else {
         Serial.println("✗ WARNING: WiFi AP initialization failed, continuing without WiFi...");
     }
     Serial.flush();
     
+    // OBD-II link runs on its own task; loggers only read cached values
+    if (config.obd_ble_enabled) {
+        Serial.println("▶ Starting OBD-II BLE link task...");
+        Serial.flush();
+        IcarBleDriver::init();
+        IcarBleDriver::load_pid_configs(config);
+        if (block_writer.is_running()) {
+            // Captured frames go to flash, so the monitor needs a running session
+            IcarBleDriver::load_can_monitor_config(config, block_writer.get_session_start_us());
+        }
+        if (IcarBleDriver::start_link_task()) {
+            Serial.println("✓ OBD link task started");
+        } else {
+            Serial.println("⚠ WARNING: OBD link task failed to start, continuing without OBD...");
+        }
+        Serial.flush();
+    }
+    
+    // Live telemetry is encoded and sent on core 0, never from the sampling loop
+    telemetry_publisher = new TelemetryPublisher(rt_logger);
+    if (telemetry_publisher->start()) {
+        Serial.println("✓ Telemetry publisher started");
+    } else {
+        Serial.println("⚠ WARNING: Telemetry publisher failed to start, no live data on the web page");
+    }
+    Serial.flush();
+    
     Serial.println("▶ Starting Status Monitor Thread (Core 0)...");
     Serial.flush();
     
@@ -296,6 +379,7 @@ void setup() {
     Serial.println("  → Creating StatusMonitor object...");
     Serial.flush();
     status_monitor = new StatusMonitor(rt_logger, 1000);  // Report every 1 second for debugging
+    status_monitor->set_gps_driver(gps_driver);
     Serial.println("  ✓ StatusMonitor object created");
     Serial.flush();
     
@@ -0,0 +1,359 @@
+/**
+ * @brief Native tests for the crash-safe flash log ring
+ *
+ * Runs FlashLogRing against the RAM flash emulator: mounting an empty and a
+ * written region, wrapping several laps, power cuts part way through an
+ * entry, a sector header or a sector erase, and sector header writes that
+ * fail with power still on. After every cut the region must
+ * mount again with the complete entries intact and an unbroken run of
+ * sector sequence numbers from the tail to the head.
+ *
+ * Run with: pio test -e test -f test_flash_log_ring
+ */
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "flash_log_ring.h"
+#include "ram_flash_device.h"
+
+// Small sectors keep laps short; the ring only needs sector_size > header
+#define TEST_SECTOR_SIZE    1024
+#define TEST_SECTOR_COUNT   32
+#define TEST_FLASH_SIZE     (TEST_SECTOR_SIZE * TEST_SECTOR_COUNT)
+#define HEADER_SIZE         ((uint32_t)sizeof(log_sector_header_t))
+
+// Base search + binary search + tail scan, far below a full scan on 4 MB
+#define MAX_MOUNT_READS     (FLASH_RING_MAX_GAP_SECTORS * 2 + 6)
+
+struct entry_ref_t {
+    uint32_t id;
+    uint32_t offset;
+    uint32_t len;
+};
+
+/**
+ * @brief Deterministic entry contents, distinct per id
+ */
+static std::vector<uint8_t> make_entry(uint32_t id, size_t len) {
+    std::vector<uint8_t> bytes(len);
+    uint32_t x = id * 2654435761u + 1;
+    for (size_t i = 0; i < len; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        bytes[i] = (uint8_t)x;
+    }
+    return bytes;
+}
+
+/**
+ * @brief Read an entry back, skipping the header of every sector it crosses
+ */
+static std::vector<uint8_t> read_entry(RamFlashDevice& flash, uint32_t offset, size_t len) {
+    std::vector<uint8_t> bytes(len);
+    size_t done = 0;
+    while (done < len) {
+        uint32_t room = TEST_SECTOR_SIZE - offset % TEST_SECTOR_SIZE;
+        size_t chunk = len - done < room ? len - done : room;
+        flash.read(offset, bytes.data() + done, chunk);
+        done += chunk;
+        offset += (uint32_t)chunk;
+        if (offset % TEST_SECTOR_SIZE == 0) {
+            offset = offset % TEST_FLASH_SIZE + HEADER_SIZE;
+        }
+    }
+    return bytes;
+}
+
+static entry_ref_t append_entry(FlashLogRing& ring, uint32_t id, size_t len) {
+    std::vector<uint8_t> bytes = make_entry(id, len);
+    entry_ref_t ref = {id, 0, (uint32_t)len};
+    TEST_ASSERT_TRUE(ring.append(bytes.data(), bytes.size(), &ref.offset));
+    return ref;
+}
+
+static void assert_entry(RamFlashDevice& flash, const entry_ref_t& ref) {
+    std::vector<uint8_t> expected = make_entry(ref.id, ref.len);
+    std::vector<uint8_t> actual = read_entry(flash, ref.offset, ref.len);
+    TEST_ASSERT_EQUAL_MEMORY(expected.data(), actual.data(), ref.len);
+}
+
+/**
+ * @brief Every sector from the tail to the head carries the next sequence number
+ */
+static void assert_sequence_chain(FlashLogRing& ring) {
+    flash_ring_stats_t stats = ring.get_stats();
+    uint32_t used = stats.head_sequence - stats.tail_sequence + 1;
+    TEST_ASSERT_TRUE(used <= TEST_SECTOR_COUNT);
+
+    uint32_t tail_sector = stats.tail_offset / TEST_SECTOR_SIZE;
+    for (uint32_t i = 0; i < used; i++) {
+        log_sector_header_t header;
+        TEST_ASSERT_TRUE(ring.read_sector_header((tail_sector + i) % TEST_SECTOR_COUNT, &header));
+        TEST_ASSERT_EQUAL_UINT32(stats.tail_sequence + i, header.sequence);
+    }
+}
+
+/**
+ * @brief Mount a second ring over the same flash and check it agrees with the first
+ */
+static void assert_remount_matches(RamFlashDevice& flash, FlashLogRing& ring) {
+    flash_ring_stats_t before = ring.get_stats();
+    FlashLogRing remounted(&flash);
+    TEST_ASSERT_TRUE(remounted.mount());
+
+    flash_ring_stats_t after = remounted.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(before.head_sequence, after.head_sequence);
+    TEST_ASSERT_EQUAL_UINT32(before.tail_sequence, after.tail_sequence);
+    TEST_ASSERT_EQUAL_UINT32(before.tail_offset, after.tail_offset);
+    TEST_ASSERT_TRUE(after.mount_reads <= MAX_MOUNT_READS);
+    assert_sequence_chain(remounted);
+}
+
+/**
+ * @brief Append entries with the writer's idle erase-ahead in between
+ */
+static std::vector<entry_ref_t> fill(FlashLogRing& ring, uint32_t first_id, uint32_t count, size_t len) {
+    std::vector<entry_ref_t> refs;
+    ring.erase_ahead(FLASH_RING_ERASE_AHEAD_SECTORS);
+    for (uint32_t i = 0; i < count; i++) {
+        refs.push_back(append_entry(ring, first_id + i, len));
+        ring.erase_ahead(FLASH_RING_ERASE_AHEAD_SECTORS);
+    }
+    return refs;
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_mount_unformatted_region_is_empty() {
+    RamFlashDevice flash(TEST_FLASH_SIZE, TEST_SECTOR_SIZE);
+    FlashLogRing ring(&flash);
+    TEST_ASSERT_TRUE(ring.mount());
+    TEST_ASSERT_TRUE(ring.is_mounted());
+    TEST_ASSERT_EQUAL_UINT32(TEST_SECTOR_COUNT, ring.get_sector_count());
+
+    flash_ring_stats_t stats = ring.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.write_offset);
+    TEST_ASSERT_EQUAL_UINT32(stats.write_offset, stats.tail_offset);
+
+    // The first entry lands in sector 0 with sequence 1
+    entry_ref_t ref = append_entry(ring, 1, 100);
+    TEST_ASSERT_EQUAL_UINT32(HEADER_SIZE, ref.offset);
+    TEST_ASSERT_EQUAL_UINT32(1, ring.get_stats().head_sequence);
+    assert_entry(flash, ref);
+}
+
+void test_mount_rejects_small_region() {
+    RamFlashDevice flash(TEST_SECTOR_SIZE * (FLASH_RING_MAX_GAP_SECTORS * 2 - 1), TEST_SECTOR_SIZE);
+    FlashLogRing ring(&flash);
+    TEST_ASSERT_FALSE(ring.mount());
+    TEST_ASSERT_FALSE(ring.append("x", 1));
+}
+
+void test_remount_recovers_head_and_tail() {
+    RamFlashDevice flash(TEST_FLASH_SIZE, TEST_SECTOR_SIZE);
+    FlashLogRing ring(&flash);
+    TEST_ASSERT_TRUE(ring.mount());
+
+    // 300-byte entries cross sector boundaries
+    std::vector<entry_ref_t> refs = fill(ring, 1, 20, 300);
+    assert_remount_matches(flash, ring);
+
+    // Writing resumes in a fresh sector after the recovered head
+    FlashLogRing remounted(&flash);
+    TEST_ASSERT_TRUE(remounted.mount());
+    uint32_t head = remounted.get_stats().head_sequence;
+    entry_ref_t next = append_entry(remounted, 100, 300);
+    TEST_ASSERT_EQUAL_UINT32(HEADER_SIZE, next.offset % TEST_SECTOR_SIZE);
+    TEST_ASSERT_EQUAL_UINT32(head + 1, remounted.get_stats().head_sequence);
+
+    for (const entry_ref_t& ref : refs) {
+        assert_entry(flash, ref);
+    }
+    assert_entry(flash, next);
+}
+
+void test_wrap_drops_oldest_sectors() {
+    RamFlashDevice flash(TEST_FLASH_SIZE, TEST_SECTOR_SIZE);
+    FlashLogRing ring(&flash);
+    TEST_ASSERT_TRUE(ring.mount());
+
+    // About three laps of the ring
+    std::vector<entry_ref_t> refs = fill(ring, 1, 200, 500);
+    flash_ring_stats_t stats = ring.get_stats();
+    TEST_ASSERT_TRUE(stats.head_sequence > 2 * TEST_SECTOR_COUNT);
+    TEST_ASSERT_TRUE(stats.tail_sequence > 1);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.erase_stalls);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.flash_errors);
+
+    // Everything but the erase-ahead run still holds data
+    TEST_ASSERT_EQUAL_UINT32(TEST_SECTOR_COUNT - FLASH_RING_ERASE_AHEAD_SECTORS,
+                             stats.head_sequence - stats.tail_sequence + 1);
+    assert_sequence_chain(ring);
+    assert_remount_matches(flash, ring);
+
+    // The newest lap is readable
+    for (size_t i = refs.size() - 20; i < refs.size(); i++) {
+        assert_entry(flash, refs[i]);
+    }
+}
+
+void test_power_cut_mid_entry() {
+    RamFlashDevice flash(TEST_FLASH_SIZE, TEST_SECTOR_SIZE);
+    FlashLogRing ring(&flash);
+    TEST_ASSERT_TRUE(ring.mount());
+    std::vector<entry_ref_t> refs = fill(ring, 1, 10, 300);
+
+    // Power fails 100 bytes into a 600-byte entry
+    flash.set_write_budget(100);
+    std::vector<uint8_t> cut = make_entry(50, 600);
+    TEST_ASSERT_FALSE(ring.append(cut.data(), cut.size()));
+    TEST_ASSERT_TRUE(ring.get_stats().flash_errors > 0);
+    flash.power_cycle();
+
+    FlashLogRing remounted(&flash);
+    TEST_ASSERT_TRUE(remounted.mount());
+    uint32_t head = remounted.get_stats().head_sequence;
+    assert_sequence_chain(remounted);
+
+    // The truncated entry is never extended: the next one opens a new sector
+    entry_ref_t next = append_entry(remounted, 51, 300);
+    TEST_ASSERT_EQUAL_UINT32(HEADER_SIZE, next.offset % TEST_SECTOR_SIZE);
+    TEST_ASSERT_EQUAL_UINT32(head + 1, remounted.get_stats().head_sequence);
+
+    for (const entry_ref_t& ref : refs) {
+        assert_entry(flash, ref);
+    }
+    assert_entry(flash, next);
+    assert_remount_matches(flash, remounted);
+}
+
+void test_power_cut_mid_sector_header() {
+    RamFlashDevice flash(TEST_FLASH_SIZE, TEST_SECTOR_SIZE);
+    FlashLogRing ring(&flash);
+    TEST_ASSERT_TRUE(ring.mount());
+    std::vector<entry_ref_t> refs = fill(ring, 1, 10, 300);
+    flash_ring_stats_t before = ring.get_stats();
+
+    // Fill the head sector, then lose power 6 bytes into the next sector header
+    uint32_t room = TEST_SECTOR_SIZE - before.write_offset % TEST_SECTOR_SIZE;
+    flash.set_write_budget((int32_t)(room + 6));
+    std::vector<uint8_t> cut = make_entry(50, room + 200);
+    TEST_ASSERT_FALSE(ring.append(cut.data(), cut.size()));
+    flash.power_cycle();
+
+    // The torn sector counts as erased, so the head stays where it was
+    FlashLogRing remounted(&flash);
+    TEST_ASSERT_TRUE(remounted.mount());
+    TEST_ASSERT_EQUAL_UINT32(before.head_sequence, remounted.get_stats().head_sequence);
+    assert_sequence_chain(remounted);
+
+    // The torn sector is erased again and reused with the same sequence number
+    uint32_t torn_sector = before.write_offset / TEST_SECTOR_SIZE + 1;
+    entry_ref_t next = append_entry(remounted, 51, 300);
+    TEST_ASSERT_EQUAL_UINT32(torn_sector * TEST_SECTOR_SIZE + HEADER_SIZE, next.offset);
+    TEST_ASSERT_EQUAL_UINT32(before.head_sequence + 1, remounted.get_stats().head_sequence);
+
+    for (const entry_ref_t& ref : refs) {
+        assert_entry(flash, ref);
+    }
+    assert_entry(flash, next);
+    assert_remount_matches(flash, remounted);
+}
+
+void test_power_cut_mid_erase() {
+    // Cut before the erase reaches the header (old lap's header survives),
+    // inside the header (torn), and half way through the sector
+    const uint32_t erased_bytes[] = {0, 8, TEST_SECTOR_SIZE / 2};
+
+    for (uint32_t erased : erased_bytes) {
+        RamFlashDevice flash(TEST_FLASH_SIZE, TEST_SECTOR_SIZE);
+        FlashLogRing ring(&flash);
+        TEST_ASSERT_TRUE(ring.mount());
+        std::vector<entry_ref_t> refs = fill(ring, 1, 100, 500);
+
+        // Use up one erased sector, then lose power erasing its replacement
+        refs.push_back(append_entry(ring, 1000, TEST_SECTOR_SIZE));
+        flash.set_erase_cut(1, erased);
+        TEST_ASSERT_EQUAL_UINT32(0, ring.erase_ahead(1));
+        flash_ring_stats_t before = ring.get_stats();
+        flash.power_cycle();
+
+        FlashLogRing remounted(&flash);
+        TEST_ASSERT_TRUE(remounted.mount());
+        TEST_ASSERT_EQUAL_UINT32(before.head_sequence, remounted.get_stats().head_sequence);
+        assert_sequence_chain(remounted);
+
+        // Writing carries on through the half-erased sector
+        std::vector<entry_ref_t> more = fill(remounted, 2000, 20, 500);
+        TEST_ASSERT_EQUAL_UINT32(0, remounted.get_stats().flash_errors);
+        assert_sequence_chain(remounted);
+        assert_remount_matches(flash, remounted);
+
+        assert_entry(flash, refs.back());
+        for (const entry_ref_t& ref : more) {
+            assert_entry(flash, ref);
+        }
+    }
+}
+
+void test_failed_sector_header_write() {
+    // One failure is retried after a re-erase; two give up without moving the head
+    const uint32_t failures[] = {1, 2};
+
+    for (uint32_t count : failures) {
+        RamFlashDevice flash(TEST_FLASH_SIZE, TEST_SECTOR_SIZE);
+        FlashLogRing ring(&flash);
+        TEST_ASSERT_TRUE(ring.mount());
+        std::vector<entry_ref_t> refs = fill(ring, 1, 10, 300);
+        flash_ring_stats_t before = ring.get_stats();
+
+        // Fill the head sector so the entry runs into the next one
+        uint32_t room = TEST_SECTOR_SIZE - before.write_offset % TEST_SECTOR_SIZE;
+        uint32_t next_sector = (before.write_offset / TEST_SECTOR_SIZE + 1) % TEST_SECTOR_COUNT;
+        flash.fail_writes_at(next_sector * TEST_SECTOR_SIZE, count);
+        std::vector<uint8_t> entry = make_entry(50, room + 200);
+        bool appended = ring.append(entry.data(), entry.size());
+
+        flash_ring_stats_t after = ring.get_stats();
+        TEST_ASSERT_EQUAL_UINT32(count, after.flash_errors);
+        if (count == 1) {
+            TEST_ASSERT_TRUE(appended);
+            TEST_ASSERT_EQUAL_UINT32(before.head_sequence + 1, after.head_sequence);
+        } else {
+            TEST_ASSERT_FALSE(appended);
+            TEST_ASSERT_EQUAL_UINT32(before.head_sequence, after.head_sequence);
+        }
+        assert_sequence_chain(ring);
+
+        // The failed sector never breaks the run, so remounts find the real head
+        std::vector<entry_ref_t> more = fill(ring, 100, 60, 300);
+        assert_sequence_chain(ring);
+        assert_remount_matches(flash, ring);
+
+        for (const entry_ref_t& ref : refs) {
+            assert_entry(flash, ref);
+        }
+        for (const entry_ref_t& ref : more) {
+            assert_entry(flash, ref);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_mount_unformatted_region_is_empty);
+    RUN_TEST(test_mount_rejects_small_region);
+    RUN_TEST(test_remount_recovers_head_and_tail);
+    RUN_TEST(test_wrap_drops_oldest_sectors);
+    RUN_TEST(test_power_cut_mid_entry);
+    RUN_TEST(test_power_cut_mid_sector_header);
+    RUN_TEST(test_power_cut_mid_erase);
+    RUN_TEST(test_failed_sector_header_write);
+    return UNITY_END();
+}
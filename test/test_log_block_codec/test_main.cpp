@@ -0,0 +1,261 @@
+/**
+ * @brief Native tests for the LZ4 block codec and log block framing
+ *
+ * Round trips, corruption detection and the compression ratio of a
+ * realistic acquisition buffer. The benchmark prints throughput; it only
+ * asserts on the ratio, since host speed says little about the ESP32-S3.
+ *
+ * Run with: pio test -e test -f test_log_block_codec
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "lz4_block.h"
+#include "log_block_codec.h"
+#include "log_records.h"
+
+// Acquisition buffer size used by LogBlockWriter
+#define ACQ_BUFFER_SIZE     (16 * 1024)
+
+// Worst acceptable compressed/raw ratio for the mixed IMU + GPS buffer (0.76 today;
+// sensor noise in the float mantissas bounds what LZ4 can find)
+#define MAX_COMPRESSION_RATIO   0.80
+
+static const uint8_t STARTUP_ID[16] = {
+    0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0x4c, 0xde,
+    0x81, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+};
+
+static uint16_t hash_table[LZ4_BLOCK_HASH_ENTRIES];
+
+// Deterministic noise (xorshift32) so every run sees the same data
+static uint32_t rng_state = 0x12345678;
+
+static float noise(float amplitude) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return amplitude * ((float)(rng_state & 0xFFFF) / 32768.0f - 1.0f);
+}
+
+// Sensor values carry the ICM20948's 16-bit resolution, as logged on the car
+static float quantize(float value, float lsb) {
+    return std::round(value / lsb) * lsb;
+}
+
+/**
+ * @brief Fill a buffer with 100 Hz IMU records and a 10 Hz GPS record, as the RT logger does
+ * @return Bytes used
+ */
+static size_t fill_acquisition_buffer(uint8_t* buf, size_t cap) {
+    const float accel_lsb = 9.80665f * 4.0f / 32768.0f;    // +-4 g
+    const float gyro_lsb = 500.0f / 32768.0f;               // +-500 dps
+    size_t used = 0;
+    uint64_t t_us = 0;
+    double lat = 42.3601, lon = -71.0589;
+
+    for (uint32_t i = 0;; i++, t_us += 10000) {
+        imu_record_t imu;
+        imu.msg_type = LOG_RECORD_IMU;
+        imu.timestamp_offset_us = t_us;
+        float phase = (float)i * 0.01f;
+        imu.accel_x = quantize(2.0f * std::sin(phase) + noise(0.05f), accel_lsb);
+        imu.accel_y = quantize(1.5f * std::cos(phase * 0.7f) + noise(0.05f), accel_lsb);
+        imu.accel_z = quantize(9.80665f + noise(0.05f), accel_lsb);
+        imu.gyro_x = quantize(noise(0.5f), gyro_lsb);
+        imu.gyro_y = quantize(noise(0.5f), gyro_lsb);
+        imu.gyro_z = quantize(20.0f * std::sin(phase * 0.3f) + noise(0.5f), gyro_lsb);
+        if (used + sizeof(imu) > cap) {
+            break;
+        }
+        memcpy(buf + used, &imu, sizeof(imu));
+        used += sizeof(imu);
+
+        if (i % 10 == 0) {
+            gps_record_t gps;
+            gps.msg_type = LOG_RECORD_GPS;
+            gps.timestamp_offset_us = t_us;
+            lat += 0.00001;
+            lon += 0.000007;
+            gps.latitude = lat;
+            gps.longitude = lon;
+            gps.altitude_m = 12.5f;
+            gps.fix_type = 2;
+            gps.num_sats = 9;
+            gps.hdop = 0.9f;
+            if (used + sizeof(gps) > cap) {
+                break;
+            }
+            memcpy(buf + used, &gps, sizeof(gps));
+            used += sizeof(gps);
+        }
+    }
+    return used;
+}
+
+static void round_trip(const uint8_t* src, size_t len) {
+    std::vector<uint8_t> compressed(lz4_compress_bound(len));
+    std::vector<uint8_t> restored(len + 1);
+
+    size_t compressed_len = lz4_compress_block(src, len, compressed.data(), compressed.size(), hash_table);
+    TEST_ASSERT_TRUE(len == 0 || compressed_len > 0);
+    TEST_ASSERT_LESS_OR_EQUAL(lz4_compress_bound(len), compressed_len);
+
+    int32_t restored_len = lz4_decompress_block(compressed.data(), compressed_len, restored.data(), restored.size());
+    TEST_ASSERT_EQUAL_INT32((int32_t)len, restored_len);
+    TEST_ASSERT_EQUAL_MEMORY(src, restored.data(), len);
+}
+
+void setUp() {
+    rng_state = 0x12345678;
+}
+
+void tearDown() {
+}
+
+void test_crc32_matches_ieee_check_value() {
+    const char* check = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, log_crc32(0, (const uint8_t*)check, strlen(check)));
+
+    // Running CRC over two halves equals the CRC of the whole
+    uint32_t crc = log_crc32(0, (const uint8_t*)check, 4);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, log_crc32(crc, (const uint8_t*)check + 4, 5));
+}
+
+void test_lz4_round_trip_acquisition_buffer() {
+    static uint8_t buf[ACQ_BUFFER_SIZE];
+    size_t len = fill_acquisition_buffer(buf, sizeof(buf));
+    round_trip(buf, len);
+}
+
+void test_lz4_round_trip_edge_sizes() {
+    static uint8_t buf[LZ4_BLOCK_MAX_INPUT_SIZE];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)(i % 251);
+    }
+    const size_t sizes[] = { 1, 4, 5, 12, 13, 64, 255, 256, 4096, LZ4_BLOCK_MAX_INPUT_SIZE };
+    for (size_t len : sizes) {
+        round_trip(buf, len);
+    }
+}
+
+void test_lz4_round_trip_incompressible() {
+    static uint8_t buf[ACQ_BUFFER_SIZE];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)(noise(128.0f) + 128.0f);
+    }
+    round_trip(buf, sizeof(buf));
+}
+
+void test_lz4_round_trip_constant_run() {
+    static uint8_t buf[ACQ_BUFFER_SIZE];
+    memset(buf, 0xAA, sizeof(buf));
+    round_trip(buf, sizeof(buf));
+}
+
+void test_lz4_rejects_oversized_input_and_small_output() {
+    static uint8_t buf[LZ4_BLOCK_MAX_INPUT_SIZE + 1];
+    static uint8_t out[LZ4_BLOCK_MAX_INPUT_SIZE + 1024];
+    TEST_ASSERT_EQUAL(0, lz4_compress_block(buf, sizeof(buf), out, sizeof(out), hash_table));
+
+    uint8_t small[8];
+    TEST_ASSERT_EQUAL(0, lz4_compress_block(buf, 4096, small, sizeof(small), hash_table));
+}
+
+void test_lz4_rejects_truncated_block() {
+    static uint8_t buf[ACQ_BUFFER_SIZE];
+    static uint8_t compressed[ACQ_BUFFER_SIZE + 1024];
+    static uint8_t restored[ACQ_BUFFER_SIZE];
+    size_t len = fill_acquisition_buffer(buf, sizeof(buf));
+    size_t compressed_len = lz4_compress_block(buf, len, compressed, sizeof(compressed), hash_table);
+    TEST_ASSERT_GREATER_THAN(0, compressed_len);
+
+    TEST_ASSERT_EQUAL_INT32(-1, lz4_decompress_block(compressed, compressed_len / 2, restored, sizeof(restored)));
+    TEST_ASSERT_EQUAL_INT32(-1, lz4_decompress_block(compressed, compressed_len, restored, len / 2));
+}
+
+void test_block_encode_validate_decode() {
+    static uint8_t raw[ACQ_BUFFER_SIZE];
+    static uint8_t restored[ACQ_BUFFER_SIZE];
+    size_t raw_len = fill_acquisition_buffer(raw, sizeof(raw));
+    std::vector<uint8_t> block(log_block_max_encoded_size(raw_len));
+
+    size_t block_len = log_block_encode(raw, raw_len, STARTUP_ID, 123456789, block.data(), block.size(), hash_table);
+    TEST_ASSERT_GREATER_THAN(sizeof(log_block_header_t), block_len);
+
+    log_block_header_t header;
+    TEST_ASSERT_TRUE(log_block_validate(block.data(), block_len, &header));
+    TEST_ASSERT_EQUAL_HEX32(LOG_BLOCK_MAGIC, header.magic);
+    TEST_ASSERT_EQUAL_UINT8(LOG_BLOCK_VERSION, header.version);
+    TEST_ASSERT_EQUAL_MEMORY(STARTUP_ID, header.startup_id, sizeof(STARTUP_ID));
+    TEST_ASSERT_EQUAL_INT64(123456789, header.timestamp_us);
+    TEST_ASSERT_EQUAL_UINT32(raw_len, header.uncompressed_size);
+    TEST_ASSERT_EQUAL_UINT32(block_len - sizeof(log_block_header_t), header.compressed_size);
+
+    TEST_ASSERT_TRUE(log_block_decode(&header, block.data() + sizeof(header), restored, sizeof(restored)));
+    TEST_ASSERT_EQUAL_MEMORY(raw, restored, raw_len);
+}
+
+void test_block_validate_rejects_corruption() {
+    static uint8_t raw[ACQ_BUFFER_SIZE];
+    size_t raw_len = fill_acquisition_buffer(raw, sizeof(raw));
+    std::vector<uint8_t> block(log_block_max_encoded_size(raw_len));
+    size_t block_len = log_block_encode(raw, raw_len, STARTUP_ID, 0, block.data(), block.size(), hash_table);
+    TEST_ASSERT_GREATER_THAN(0, block_len);
+
+    // Payload bit flip fails the CRC
+    block[sizeof(log_block_header_t) + block_len / 3] ^= 0x10;
+    TEST_ASSERT_FALSE(log_block_validate(block.data(), block_len, nullptr));
+    block[sizeof(log_block_header_t) + block_len / 3] ^= 0x10;
+    TEST_ASSERT_TRUE(log_block_validate(block.data(), block_len, nullptr));
+
+    // Truncated block (power cut mid-write)
+    TEST_ASSERT_FALSE(log_block_validate(block.data(), block_len - 1, nullptr));
+
+    // Bad magic (erased flash)
+    std::vector<uint8_t> erased(block_len, 0xFF);
+    TEST_ASSERT_FALSE(log_block_validate(erased.data(), erased.size(), nullptr));
+}
+
+void test_block_compression_ratio_and_throughput() {
+    static uint8_t raw[ACQ_BUFFER_SIZE];
+    size_t raw_len = fill_acquisition_buffer(raw, sizeof(raw));
+    std::vector<uint8_t> block(log_block_max_encoded_size(raw_len));
+
+    const int iterations = 200;
+    size_t block_len = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        block_len = log_block_encode(raw, raw_len, STARTUP_ID, i, block.data(), block.size(), hash_table);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    TEST_ASSERT_GREATER_THAN(0, block_len);
+
+    double seconds = std::chrono::duration<double>(t1 - t0).count();
+    double ratio = (double)block_len / (double)raw_len;
+    char message[128];
+    snprintf(message, sizeof(message), "%u -> %u bytes (ratio %.3f), encode %.1f MB/s",
+             (unsigned)raw_len, (unsigned)block_len, ratio,
+             (double)raw_len * iterations / seconds / 1e6);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE_MESSAGE(ratio <= MAX_COMPRESSION_RATIO, message);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_matches_ieee_check_value);
+    RUN_TEST(test_lz4_round_trip_acquisition_buffer);
+    RUN_TEST(test_lz4_round_trip_edge_sizes);
+    RUN_TEST(test_lz4_round_trip_incompressible);
+    RUN_TEST(test_lz4_round_trip_constant_run);
+    RUN_TEST(test_lz4_rejects_oversized_input_and_small_output);
+    RUN_TEST(test_lz4_rejects_truncated_block);
+    RUN_TEST(test_block_encode_validate_decode);
+    RUN_TEST(test_block_validate_rejects_corruption);
+    RUN_TEST(test_block_compression_ratio_and_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,571 @@
+/**
+ * @brief Native tests for the single-pass NMEA parser
+ *
+ * A corpus of GP and GN talker RMC/GGA/GSA/VTG sentences: good ones must
+ * decode to the expected fix, while truncated, bad-checksum and overlong
+ * ones must be rejected, counted, and leave the caller's fix untouched.
+ * The benchmark times the parser against the strchr/sscanf walk it
+ * replaced (kept here as a baseline) on the same RMC/GGA input and prints
+ * both rates; host speed says little about the ESP32-S3, so it asserts only
+ * that the new parser is the faster of the two. The fuzz case feeds
+ * randomly mutated corpus sentences from a fixed seed, so any failure
+ * reproduces.
+ *
+ * Run with: pio test -e test -f test_nmea_parser
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "nmea_parser.h"
+
+// Sentences in the shape the PA1010D and u-blox modules send, with valid checksums
+static const char* const RMC_GP = "$GPRMC,123519.00,A,4807.038,N,01131.000,E,22.4,84.4,160326,3.1,W,A*26";
+static const char* const RMC_GN = "$GNRMC,235959.900,A,3345.1234,S,15112.5678,W,0.15,359.99,311226,,,D*73";
+static const char* const RMC_VOID = "$GPRMC,010203.00,V,,,,,,,160326,,,N*7D";
+static const char* const GGA_GP = "$GPGGA,123519.00,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*69";
+static const char* const GGA_GN = "$GNGGA,235959.900,3345.1234,S,15112.5678,W,2,12,0.75,-12.345,M,-30.1,M,,0000*4B";
+static const char* const GGA_NO_FIX = "$GPGGA,000000.00,,,,,0,00,99.99,,,,,,*66";
+static const char* const GSA_GP = "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39";
+static const char* const GSA_GN = "$GNGSA,A,2,10,15,18,,,,,,,,,,3.10,2.05,2.33,1*0B";
+static const char* const VTG_GP = "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K,A*25";
+static const char* const VTG_GN = "$GNVTG,,T,,M,0.012,N,0.022,K,A*3E";
+
+static const char* const GOOD_SENTENCES[] = {
+    RMC_GP, RMC_GN, RMC_VOID, GGA_GP, GGA_GN, GGA_NO_FIX, GSA_GP, GSA_GN, VTG_GP, VTG_GN
+};
+#define GOOD_SENTENCE_COUNT (sizeof(GOOD_SENTENCES) / sizeof(GOOD_SENTENCES[0]))
+
+static NmeaParser parser;
+
+static nmea_sentence_t parse(const char* sentence, gps_data_t& data) {
+    return parser.parse(sentence, strlen(sentence), data);
+}
+
+static gps_data_t empty_fix() {
+    gps_data_t data;
+    memset(&data, 0, sizeof(data));
+    return data;
+}
+
+/**
+ * @brief A fix with every field set, to show rejected sentences change nothing
+ */
+static gps_data_t sentinel_fix() {
+    gps_data_t data = empty_fix();
+    data.latitude = 1.5;
+    data.longitude = -2.5;
+    data.altitude = 3.5;
+    data.speed = 4.5f;
+    data.course = 5.5f;
+    data.hdop = 6.5f;
+    data.year = 2001;
+    data.month = 2;
+    data.day = 3;
+    data.hour = 4;
+    data.minute = 5;
+    data.second = 6;
+    data.millisecond = 700;
+    data.valid = true;
+    data.satellites = 9;
+    data.fix_type = 2;
+    return data;
+}
+
+/**
+ * @brief Baseline: the strchr/sscanf RMC walk the driver used before NmeaParser
+ * No checksum and no field checks; only fed well-formed corpus sentences.
+ */
+static bool legacy_parse_rmc(const char* sentence, gps_data_t& data) {
+    double tmp_lat = 0, tmp_lon = 0;
+    float tmp_speed = 0;
+
+    const char* pos = strchr(sentence, ',');
+    if (!pos) return false;
+    pos++;
+    if (sscanf(pos, "%2hhu%2hhu%2hhu", &data.hour, &data.minute, &data.second) != 3) return false;
+
+    pos = strchr(pos, ',') + 1;
+    char status = *pos;
+    pos = strchr(pos, ',') + 1;
+    sscanf(pos, "%lf", &tmp_lat);
+    pos = strchr(pos, ',') + 1;
+    char tmp_lat_dir = *pos;
+    pos = strchr(pos, ',') + 1;
+    sscanf(pos, "%lf", &tmp_lon);
+    pos = strchr(pos, ',') + 1;
+    char tmp_lon_dir = *pos;
+    pos = strchr(pos, ',') + 1;
+    sscanf(pos, "%f", &tmp_speed);
+    pos = strchr(pos, ',') + 1;
+    pos = strchr(pos, ',') + 1;
+    sscanf(pos, "%2hhu%2hhu%2hu", &data.day, &data.month, &data.year);
+    data.year += 2000;
+
+    int lat_deg = (int)(tmp_lat / 100.0);
+    data.latitude = lat_deg + (tmp_lat - lat_deg * 100.0) / 60.0;
+    if (tmp_lat_dir == 'S') data.latitude = -data.latitude;
+    int lon_deg = (int)(tmp_lon / 100.0);
+    data.longitude = lon_deg + (tmp_lon - lon_deg * 100.0) / 60.0;
+    if (tmp_lon_dir == 'W') data.longitude = -data.longitude;
+
+    data.speed = tmp_speed;
+    data.valid = status == 'A';
+    return data.valid;
+}
+
+/**
+ * @brief Baseline: the strchr/sscanf GGA walk the driver used before NmeaParser
+ */
+static bool legacy_parse_gga(const char* sentence, gps_data_t& data) {
+    const char* pos = strchr(sentence, ',');
+    if (!pos) return false;
+    pos++;
+    sscanf(pos, "%2hhu%2hhu%2hhu", &data.hour, &data.minute, &data.second);
+
+    double tmp_lat = 0, tmp_lon = 0, alt = 0;
+    int fix_quality = 0;
+    uint8_t sats = 0;
+    if (!(pos = strchr(pos, ','))) return false;
+    if (sscanf(++pos, "%lf", &tmp_lat) != 1) return false;
+    if (!(pos = strchr(pos, ','))) return false;
+    char tmp_lat_dir = *++pos;
+    if (!(pos = strchr(pos, ','))) return false;
+    if (sscanf(++pos, "%lf", &tmp_lon) != 1) return false;
+    if (!(pos = strchr(pos, ','))) return false;
+    char tmp_lon_dir = *++pos;
+    if (!(pos = strchr(pos, ','))) return false;
+    if (sscanf(++pos, "%d", &fix_quality) != 1) return false;
+    if (!(pos = strchr(pos, ','))) return false;
+    sscanf(++pos, "%hhu", &sats);
+    if (!(pos = strchr(pos, ','))) return false;
+    if (!(pos = strchr(pos + 1, ','))) return false;
+    sscanf(++pos, "%lf", &alt);
+
+    int lat_deg = (int)(tmp_lat / 100.0);
+    data.latitude = lat_deg + (tmp_lat - lat_deg * 100.0) / 60.0;
+    if (tmp_lat_dir == 'S') data.latitude = -data.latitude;
+    int lon_deg = (int)(tmp_lon / 100.0);
+    data.longitude = lon_deg + (tmp_lon - lon_deg * 100.0) / 60.0;
+    if (tmp_lon_dir == 'W') data.longitude = -data.longitude;
+
+    data.altitude = alt;
+    data.satellites = sats;
+    data.valid = fix_quality > 0;
+    return data.valid;
+}
+
+static bool legacy_parse(const char* sentence, size_t len, gps_data_t& data) {
+    (void)len;
+    if (strncmp(sentence, "$GNRMC", 6) == 0 || strncmp(sentence, "$GPRMC", 6) == 0) {
+        return legacy_parse_rmc(sentence, data);
+    }
+    if (strncmp(sentence, "$GNGGA", 6) == 0) {
+        return legacy_parse_gga(sentence, data);
+    }
+    return false;
+}
+
+static bool single_pass_parse(const char* sentence, size_t len, gps_data_t& data) {
+    return parser.parse(sentence, len, data) != NMEA_SENTENCE_NONE;
+}
+
+/**
+ * @brief Sentences per second for one parser over a repeated epoch
+ */
+static double sentences_per_second(bool (*parse_fn)(const char*, size_t, gps_data_t&),
+                                   const char* const* epoch, const size_t* lengths, int count,
+                                   uint32_t iterations, gps_data_t& data) {
+    uint32_t decoded = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < iterations; n++) {
+        for (int i = 0; i < count; i++) {
+            decoded += parse_fn(epoch[i], lengths[i], data) ? 1 : 0;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    TEST_ASSERT_EQUAL_UINT32(iterations * count, decoded);
+    return iterations * count / std::chrono::duration<double>(t1 - t0).count();
+}
+
+/**
+ * @brief xorshift32: a fixed seed gives the same mutations on every host
+ */
+static uint32_t next_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void assert_rejected(const char* sentence, size_t len) {
+    gps_data_t data = sentinel_fix();
+    gps_data_t before;
+    memcpy(&before, &data, sizeof(data));
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_NONE, parser.parse(sentence, len, data));
+    TEST_ASSERT_EQUAL_MEMORY(&before, &data, sizeof(data));
+}
+
+void setUp() {
+    parser.reset_stats();
+}
+
+void tearDown() {
+}
+
+void test_rmc_gp_decodes() {
+    gps_data_t data = empty_fix();
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_RMC, parse(RMC_GP, data));
+    TEST_ASSERT_TRUE(data.valid);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, 48.1173, data.latitude);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, 11.0 + 31.0 / 60.0, data.longitude);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 22.4f, data.speed);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 84.4f, data.course);
+    TEST_ASSERT_EQUAL_UINT8(12, data.hour);
+    TEST_ASSERT_EQUAL_UINT8(35, data.minute);
+    TEST_ASSERT_EQUAL_UINT8(19, data.second);
+    TEST_ASSERT_EQUAL_UINT16(0, data.millisecond);
+    TEST_ASSERT_EQUAL_UINT8(16, data.day);
+    TEST_ASSERT_EQUAL_UINT8(3, data.month);
+    TEST_ASSERT_EQUAL_UINT16(2026, data.year);
+}
+
+void test_rmc_gn_decodes_southern_western_hemisphere() {
+    gps_data_t data = empty_fix();
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_RMC, parse(RMC_GN, data));
+    TEST_ASSERT_TRUE(data.valid);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, -(33.0 + 45.1234 / 60.0), data.latitude);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, -(151.0 + 12.5678 / 60.0), data.longitude);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.15f, data.speed);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 359.99f, data.course);
+    TEST_ASSERT_EQUAL_UINT16(900, data.millisecond);
+    TEST_ASSERT_EQUAL_UINT8(31, data.day);
+    TEST_ASSERT_EQUAL_UINT8(12, data.month);
+}
+
+void test_rmc_void_clears_fix_and_keeps_position() {
+    gps_data_t data = sentinel_fix();
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_RMC, parse(RMC_VOID, data));
+    TEST_ASSERT_FALSE(data.valid);
+    TEST_ASSERT_EQUAL_UINT8(0, data.fix_type);
+    TEST_ASSERT_EQUAL_DOUBLE(1.5, data.latitude);
+    TEST_ASSERT_EQUAL_DOUBLE(-2.5, data.longitude);
+    TEST_ASSERT_EQUAL_UINT8(1, data.hour);
+    TEST_ASSERT_EQUAL_UINT8(2, data.minute);
+    TEST_ASSERT_EQUAL_UINT8(3, data.second);
+}
+
+void test_gga_decodes() {
+    gps_data_t data = empty_fix();
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_GGA, parse(GGA_GP, data));
+    TEST_ASSERT_TRUE(data.valid);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, 48.1173, data.latitude);
+    TEST_ASSERT_EQUAL_UINT8(8, data.satellites);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.9f, data.hdop);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 545.4, data.altitude);
+    TEST_ASSERT_EQUAL_UINT8(2, data.fix_type);     // Estimated 3D until a GSA arrives
+
+    data = empty_fix();
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_GGA, parse(GGA_GN, data));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, -(33.0 + 45.1234 / 60.0), data.latitude);
+    TEST_ASSERT_EQUAL_UINT8(12, data.satellites);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.75f, data.hdop);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, -12.345, data.altitude);
+
+    data = sentinel_fix();
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_GGA, parse(GGA_NO_FIX, data));
+    TEST_ASSERT_FALSE(data.valid);
+    TEST_ASSERT_EQUAL_UINT8(0, data.fix_type);
+    TEST_ASSERT_EQUAL_UINT8(0, data.satellites);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 99.99f, data.hdop);
+    TEST_ASSERT_EQUAL_DOUBLE(1.5, data.latitude);
+}
+
+void test_gsa_sets_fix_mode_and_hdop() {
+    gps_data_t data = empty_fix();
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_GSA, parse(GSA_GP, data));
+    TEST_ASSERT_EQUAL_UINT8(2, data.fix_type);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.3f, data.hdop);
+
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_GSA, parse(GSA_GN, data));
+    TEST_ASSERT_EQUAL_UINT8(1, data.fix_type);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 2.05f, data.hdop);
+}
+
+void test_vtg_decodes_course_and_speed() {
+    gps_data_t data = empty_fix();
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_VTG, parse(VTG_GP, data));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 54.7f, data.course);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 5.5f, data.speed);
+
+    // Empty course keeps the previous one
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_VTG, parse(VTG_GN, data));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 54.7f, data.course);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.012f, data.speed);
+}
+
+void test_line_endings_and_lowercase_checksum_accepted() {
+    char line[NMEA_MAX_SENTENCE_LEN];
+    gps_data_t data = empty_fix();
+
+    snprintf(line, sizeof(line), "%s\r\n", RMC_GP);
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_RMC, parse(line, data));
+
+    snprintf(line, sizeof(line), "%s", GSA_GN);
+    line[strlen(line) - 1] = 'b';
+    TEST_ASSERT_EQUAL_INT(NMEA_SENTENCE_GSA, parse(line, data));
+    TEST_ASSERT_EQUAL_UINT32(2, parser.get_stats().sentences);
+}
+
+void test_truncated_sentences_rejected() {
+    // Every cut short of the full checksum, as a UART overrun or a
+    // buffer boundary would leave it
+    uint32_t rejected = 0;
+    for (const char* sentence : GOOD_SENTENCES) {
+        size_t full = strlen(sentence);
+        for (size_t len = 0; len < full; len++) {
+            assert_rejected(sentence, len);
+            rejected++;
+        }
+    }
+    nmea_parser_stats_t stats = parser.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.sentences);
+    TEST_ASSERT_EQUAL_UINT32(rejected, stats.malformed + stats.checksum_errors);
+}
+
+void test_bad_checksums_rejected() {
+    char line[NMEA_MAX_SENTENCE_LEN];
+    for (const char* sentence : GOOD_SENTENCES) {
+        size_t len = strlen(sentence);
+
+        // Wrong checksum digit
+        memcpy(line, sentence, len + 1);
+        line[len - 1] = line[len - 1] == '0' ? '1' : '0';
+        assert_rejected(line, len);
+        TEST_ASSERT_FALSE(NmeaParser::verify_checksum(line, len));
+
+        // One corrupted body character (a single bit error on the wire)
+        memcpy(line, sentence, len + 1);
+        line[8] ^= 0x01;
+        assert_rejected(line, len);
+
+        // Not hex
+        memcpy(line, sentence, len + 1);
+        line[len - 2] = 'G';
+        assert_rejected(line, len);
+    }
+    nmea_parser_stats_t stats = parser.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.sentences);
+    TEST_ASSERT_EQUAL_UINT32(2 * GOOD_SENTENCE_COUNT, stats.checksum_errors);
+    TEST_ASSERT_EQUAL_UINT32(GOOD_SENTENCE_COUNT, stats.malformed);
+}
+
+void test_overlong_sentences_rejected() {
+    char line[NMEA_MAX_SENTENCE_LEN * 2];
+
+    // Longer than the line buffer, even with a valid checksum
+    char body[NMEA_MAX_SENTENCE_LEN];
+    memset(body, 0, sizeof(body));
+    size_t used = (size_t)snprintf(body, sizeof(body), "GPRMC,123519.00,A,4807.038,N,01131.000,E,22.4,84.4,160326,3.1,W,A");
+    while (used < NMEA_MAX_SENTENCE_LEN - 5) {
+        body[used++] = '0';
+    }
+    body[used] = '\0';
+    size_t len = NmeaParser::format_sentence(body, line, sizeof(line));
+    TEST_ASSERT_TRUE(len > NMEA_MAX_SENTENCE_LEN);
+    assert_rejected(line, len);
+
+    // More fields than the tokenizer holds
+    char fields[NMEA_MAX_SENTENCE_LEN];
+    size_t pos = (size_t)snprintf(fields, sizeof(fields), "GPGSA,A,3");
+    for (int i = 0; i < NMEA_MAX_FIELDS; i++) {
+        fields[pos++] = ',';
+    }
+    fields[pos] = '\0';
+    len = NmeaParser::format_sentence(fields, line, sizeof(line));
+    TEST_ASSERT_TRUE(len > 0 && len <= NMEA_MAX_SENTENCE_LEN);
+    assert_rejected(line, len);
+
+    // A field with more digits than the fixed-point parser accepts
+    len = NmeaParser::format_sentence("GPGGA,123519.00,4807.038,N,01131.000,E,1,08,0.9,5454545454545454.4,M,46.9,M,,",
+                                      line, sizeof(line));
+    TEST_ASSERT_TRUE(len > 0);
+    assert_rejected(line, len);
+
+    // Garbage after the checksum
+    snprintf(line, sizeof(line), "%sXX", RMC_GP);
+    assert_rejected(line, strlen(line));
+
+    TEST_ASSERT_EQUAL_UINT32(4, parser.get_stats().malformed);
+}
+
+void test_other_talkers_and_types_counted_unsupported() {
+    gps_data_t data = empty_fix();
+    parse("$GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00*74", data);
+    parse("$GLRMC,123519.00,A,4807.038,N,01131.000,E,22.4,84.4,160326,3.1,W,A*3A", data);
+    parse("$PMTK001,220,3*30", data);
+    TEST_ASSERT_EQUAL_UINT32(3, parser.get_stats().unsupported);
+    TEST_ASSERT_FALSE(data.valid);
+}
+
+void test_pmtk_ack_and_command_framing() {
+    uint16_t cmd = 0;
+    uint8_t flag = 0;
+    const char* ack = "$PMTK001,220,3*30";
+    TEST_ASSERT_TRUE(NmeaParser::parse_pmtk_ack(ack, strlen(ack), &cmd, &flag));
+    TEST_ASSERT_EQUAL_UINT16(220, cmd);
+    TEST_ASSERT_EQUAL_UINT8(3, flag);
+
+    char line[32];
+    size_t len = NmeaParser::format_sentence("PMTK220,100", line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("$PMTK220,100*2F\r\n", line);
+    TEST_ASSERT_EQUAL_UINT32(strlen(line), len);
+    TEST_ASSERT_TRUE(NmeaParser::verify_checksum(line, len));
+    TEST_ASSERT_EQUAL_UINT32(0, NmeaParser::format_sentence("PMTK220,100", line, 17));
+}
+
+void test_parse_throughput() {
+    // A 10 Hz epoch as the PA1010D sends it: RMC, GGA, GSA, VTG
+    const char* const epoch[] = { RMC_GN, GGA_GN, GSA_GN, VTG_GP };
+    size_t lengths[4];
+    for (int i = 0; i < 4; i++) {
+        lengths[i] = strlen(epoch[i]);
+    }
+
+    gps_data_t data = empty_fix();
+    double rate = sentences_per_second(single_pass_parse, epoch, lengths, 4, 250000, data);
+    char message[96];
+    snprintf(message, sizeof(message), "RMC/GGA/GSA/VTG: %.2fM sentences/s", rate / 1e6);
+    TEST_MESSAGE(message);
+}
+
+void test_parse_throughput_against_sscanf_baseline() {
+    // The old walk only decoded RMC and GNGGA, so both parsers get just those
+    const char* const epoch[] = { RMC_GN, GGA_GN };
+    size_t lengths[2];
+    for (int i = 0; i < 2; i++) {
+        lengths[i] = strlen(epoch[i]);
+    }
+
+    gps_data_t baseline_fix = empty_fix();
+    gps_data_t new_fix = empty_fix();
+    double baseline = sentences_per_second(legacy_parse, epoch, lengths, 2, 100000, baseline_fix);
+    double rate = sentences_per_second(single_pass_parse, epoch, lengths, 2, 100000, new_fix);
+
+    // Same input, same answer
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, baseline_fix.latitude, new_fix.latitude);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, baseline_fix.longitude, new_fix.longitude);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, baseline_fix.altitude, new_fix.altitude);
+    TEST_ASSERT_EQUAL_UINT8(baseline_fix.satellites, new_fix.satellites);
+
+    char message[96];
+    snprintf(message, sizeof(message), "RMC/GGA: sscanf %.2fM/s, single-pass %.2fM/s (%.1fx)",
+             baseline / 1e6, rate / 1e6, rate / baseline);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(rate > baseline);
+}
+
+void test_random_mutations_never_corrupt_the_fix() {
+    // Bit flips, substitutions, insertions, deletions and cuts of corpus
+    // sentences. Half get a fresh checksum so the field decoders see them.
+    const uint32_t iterations = 2000000;
+    const char alphabet[] = "0123456789.,-*$ANSEWVMTKD";
+    uint32_t seed = 0x2545F491;
+    uint32_t decoded = 0;
+
+    gps_data_t data = empty_fix();
+    parse(RMC_GN, data);
+    parse(GGA_GN, data);
+    parser.reset_stats();
+
+    for (uint32_t n = 0; n < iterations; n++) {
+        const char* sentence = GOOD_SENTENCES[next_random(&seed) % GOOD_SENTENCE_COUNT];
+
+        // Mutate the body between '$' and '*'
+        char body[NMEA_MAX_SENTENCE_LEN * 2];
+        size_t len = strlen(sentence) - 4;
+        memcpy(body, sentence + 1, len);
+        uint32_t mutations = 1 + next_random(&seed) % 4;
+        for (uint32_t m = 0; m < mutations && len > 0; m++) {
+            uint32_t r = next_random(&seed);
+            size_t at = (r >> 8) % len;
+            switch (r % 5) {
+                case 0: body[at] ^= (char)(1 << ((r >> 4) % 7)); break;
+                case 1: body[at] = alphabet[(r >> 16) % (sizeof(alphabet) - 1)]; break;
+                case 2:
+                    if (len < NMEA_MAX_SENTENCE_LEN + 8) {
+                        memmove(body + at + 1, body + at, len - at);
+                        body[at] = alphabet[(r >> 16) % (sizeof(alphabet) - 1)];
+                        len++;
+                    }
+                    break;
+                case 3: memmove(body + at, body + at + 1, len - at - 1); len--; break;
+                default: len = at; break;
+            }
+        }
+        body[len] = '\0';
+
+        char line[NMEA_MAX_SENTENCE_LEN * 2 + 8];
+        size_t line_len;
+        if (next_random(&seed) & 1) {
+            line_len = NmeaParser::format_sentence(body, line, sizeof(line));
+        } else {
+            line_len = (size_t)snprintf(line, sizeof(line), "$%s%s", body, sentence + strlen(sentence) - 3);
+        }
+        // Too long to frame: send it without a checksum
+        if (line_len == 0) {
+            line_len = len + 1;
+            line[0] = '$';
+            memcpy(line + 1, body, len);
+        }
+
+        gps_data_t before;
+        memcpy(&before, &data, sizeof(data));
+        nmea_sentence_t type = parser.parse(line, line_len, data);
+        if (type == NMEA_SENTENCE_NONE) {
+            TEST_ASSERT_EQUAL_MEMORY(&before, &data, sizeof(data));
+            continue;
+        }
+        decoded++;
+        TEST_ASSERT_TRUE(type <= NMEA_SENTENCE_VTG);
+        TEST_ASSERT_TRUE(std::fabs(data.latitude) <= 90.0);
+        TEST_ASSERT_TRUE(std::fabs(data.longitude) <= 180.0);
+        TEST_ASSERT_TRUE(data.hour <= 23 && data.minute <= 59 && data.second <= 60);
+        TEST_ASSERT_TRUE(data.millisecond <= 999);
+        TEST_ASSERT_TRUE(data.day >= 1 && data.day <= 31);
+        TEST_ASSERT_TRUE(data.month >= 1 && data.month <= 12);
+        TEST_ASSERT_TRUE(data.fix_type <= 2);
+    }
+
+    // Every sentence is counted once, and the mix reached the decoders
+    nmea_parser_stats_t stats = parser.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(iterations, stats.sentences + stats.checksum_errors + stats.malformed + stats.unsupported);
+    TEST_ASSERT_EQUAL_UINT32(decoded, stats.sentences);
+    TEST_ASSERT_TRUE(decoded > iterations / 100);
+    TEST_ASSERT_TRUE(stats.checksum_errors > 0 && stats.malformed > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_rmc_gp_decodes);
+    RUN_TEST(test_rmc_gn_decodes_southern_western_hemisphere);
+    RUN_TEST(test_rmc_void_clears_fix_and_keeps_position);
+    RUN_TEST(test_gga_decodes);
+    RUN_TEST(test_gsa_sets_fix_mode_and_hdop);
+    RUN_TEST(test_vtg_decodes_course_and_speed);
+    RUN_TEST(test_line_endings_and_lowercase_checksum_accepted);
+    RUN_TEST(test_truncated_sentences_rejected);
+    RUN_TEST(test_bad_checksums_rejected);
+    RUN_TEST(test_overlong_sentences_rejected);
+    RUN_TEST(test_other_talkers_and_types_counted_unsupported);
+    RUN_TEST(test_pmtk_ack_and_command_framing);
+    RUN_TEST(test_parse_throughput);
+    RUN_TEST(test_parse_throughput_against_sscanf_baseline);
+    RUN_TEST(test_random_mutations_never_corrupt_the_fix);
+    return UNITY_END();
+}
@@ -0,0 +1,259 @@
+/**
+ * @brief Native tests for the OBD-II Mode 01 PID decoder
+ *
+ * Vectors for every decodable PID, written as the ELM327 returns them and run
+ * through obd_decode_mode01_response(), the response walk the iCar driver
+ * uses. Every PID logged by default (logging_config_t) must have a vector,
+ * and so must every PID the decoder table knows, so a new decoder cannot
+ * land untested.
+ *
+ * Run with: pio test -e test -f test_obd_pid_decode
+ */
+
+#include <unity.h>
+#include <cstdio>
+#include <cstring>
+#include "elm327_response.h"
+#include "obd_pid_decode.h"
+
+typedef float (*obd_field_fn_t)(const obd_data_t& data);
+
+struct pid_vector_t {
+    uint8_t pid;
+    const char* response;       // Headers-off ELM327 output
+    obd_field_fn_t field;
+    float expected;
+    float tolerance;
+};
+
+// Fields as floats, so one table covers float and integer members
+static float rpm(const obd_data_t& d) { return d.engine_rpm; }
+static float load(const obd_data_t& d) { return d.engine_load; }
+static float coolant(const obd_data_t& d) { return d.coolant_temp; }
+static float intake(const obd_data_t& d) { return d.intake_temp; }
+static float fuel_pressure(const obd_data_t& d) { return d.fuel_pressure; }
+static float speed(const obd_data_t& d) { return d.vehicle_speed; }
+static float throttle(const obd_data_t& d) { return d.throttle_position; }
+static float timing(const obd_data_t& d) { return d.timing_advance; }
+static float o2_voltage(const obd_data_t& d) { return d.o2_sensor_voltage; }
+static float o2_trim(const obd_data_t& d) { return d.o2_sensor_trim; }
+static float fuel_level(const obd_data_t& d) { return d.fuel_level; }
+static float fuel_system(const obd_data_t& d) { return (float)d.fuel_system_status; }
+static float maf(const obd_data_t& d) { return d.maf_flow; }
+static float baro(const obd_data_t& d) { return d.barometric_pressure; }
+static float dtc_count(const obd_data_t& d) { return (float)d.dtc_count; }
+static float distance_mil(const obd_data_t& d) { return (float)d.distance_with_mil; }
+static float run_time(const obd_data_t& d) { return (float)d.run_time; }
+
+// Expected values worked out from the SAE J1979 formulas
+static const pid_vector_t VECTORS[] = {
+    { 0x01, "41 01 83 07 65 04", dtc_count,     3.0f,       0.0f },     // MIL on, 3 DTCs
+    { 0x03, "41 03 02 00",       fuel_system,   2.0f,       0.0f },     // Closed loop
+    { 0x04, "410480",            load,          50.196f,    0.001f },
+    { 0x04, "41 04 FF",          load,          100.0f,     0.001f },
+    { 0x05, "41 05 7B",          coolant,       83.0f,      0.0f },
+    { 0x05, "41 05 00",          coolant,       -40.0f,     0.0f },
+    { 0x05, "41 05 FF",          coolant,       215.0f,     0.0f },
+    { 0x0A, "41 0A 64",          fuel_pressure, 300.0f,     0.0f },
+    { 0x0C, "41 0C 1A F8",       rpm,           1726.0f,    0.0f },
+    { 0x0C, "410CFFFF",          rpm,           16383.75f,  0.0f },
+    { 0x0D, "41 0D 3C",          speed,         60.0f,      0.0f },
+    { 0x0D, "41 0D FF",          speed,         255.0f,     0.0f },
+    { 0x0E, "41 0E 90",          timing,        8.0f,       0.0f },
+    { 0x0E, "41 0E 00",          timing,        -64.0f,     0.0f },
+    { 0x0F, "41 0F 46",          intake,        30.0f,      0.0f },
+    { 0x10, "41 10 01 F4",       maf,           5.0f,       0.001f },
+    { 0x10, "4110FFFF",          maf,           655.35f,    0.01f },
+    { 0x11, "41 11 26",          throttle,      14.902f,    0.001f },
+    { 0x14, "41 14 B4 80",       o2_voltage,    0.9f,       0.001f },
+    { 0x14, "41 14 B4 80",       o2_trim,       0.0f,       0.001f },
+    { 0x14, "41 14 00 00",       o2_trim,       -100.0f,    0.001f },
+    { 0x1F, "41 1F 04 B0",       run_time,      1200.0f,    0.0f },
+    { 0x1F, "41 1F FF FF",       run_time,      65535.0f,   0.0f },
+    { 0x21, "41 21 00 2A",       distance_mil,  42.0f,      0.0f },
+    { 0x2F, "41 2F 80",          fuel_level,    50.196f,    0.001f },
+    { 0x33, "41 33 65",          baro,          101.0f,     0.0f },
+};
+
+// logging_config_t() defaults in lib/Config/include/config_manager.h
+static const uint8_t DEFAULT_LOGGING_PIDS[] = {
+    0x0C, 0x0D, 0x05, 0x0F, 0x11, 0x10, 0x1F, 0x2F, 0x33, 0x21, 0x03, 0x04
+};
+
+struct found_pid_t {
+    uint8_t pid;
+    size_t len;
+};
+
+struct found_pids_t {
+    found_pid_t pids[8];
+    size_t count;
+};
+
+static void record_pid(uint8_t pid, const uint8_t* data, size_t len, void* ctx) {
+    (void)data;
+    found_pids_t* found = static_cast<found_pids_t*>(ctx);
+    if (found->count < 8) {
+        found->pids[found->count++] = { pid, len };
+    }
+}
+
+static bool has_vector(uint8_t pid) {
+    for (const pid_vector_t& v : VECTORS) {
+        if (v.pid == pid) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_vectors_decode() {
+    for (const pid_vector_t& v : VECTORS) {
+        obd_data_t data;
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, obd_decode_mode01_response(v.response, &v.pid, 1, data), v.response);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(v.tolerance, v.expected, v.field(data), v.response);
+    }
+}
+
+void test_default_logging_pids_covered() {
+    for (uint8_t pid : DEFAULT_LOGGING_PIDS) {
+        char message[32];
+        snprintf(message, sizeof(message), "PID 0x%02X", pid);
+        TEST_ASSERT_TRUE_MESSAGE(obd_pid_decodable(pid), message);
+        TEST_ASSERT_TRUE_MESSAGE(has_vector(pid), message);
+    }
+}
+
+void test_every_decoder_has_a_vector() {
+    for (int pid = 0; pid < 256; pid++) {
+        char message[32];
+        snprintf(message, sizeof(message), "PID 0x%02X", pid);
+        if (obd_pid_decodable((uint8_t)pid)) {
+            TEST_ASSERT_TRUE_MESSAGE(has_vector((uint8_t)pid), message);
+            TEST_ASSERT_TRUE_MESSAGE(obd_mode01_data_length((uint8_t)pid) > 0, message);
+        }
+    }
+}
+
+void test_data_lengths_match_j1979() {
+    TEST_ASSERT_EQUAL_UINT8(4, obd_mode01_data_length(0x01));
+    TEST_ASSERT_EQUAL_UINT8(2, obd_mode01_data_length(0x03));
+    TEST_ASSERT_EQUAL_UINT8(1, obd_mode01_data_length(0x04));
+    TEST_ASSERT_EQUAL_UINT8(2, obd_mode01_data_length(0x0C));
+    TEST_ASSERT_EQUAL_UINT8(1, obd_mode01_data_length(0x0D));
+    TEST_ASSERT_EQUAL_UINT8(2, obd_mode01_data_length(0x10));
+    TEST_ASSERT_EQUAL_UINT8(2, obd_mode01_data_length(0x14));
+    TEST_ASSERT_EQUAL_UINT8(2, obd_mode01_data_length(0x1F));
+    TEST_ASSERT_EQUAL_UINT8(2, obd_mode01_data_length(0x21));
+    TEST_ASSERT_EQUAL_UINT8(1, obd_mode01_data_length(0x33));
+    TEST_ASSERT_EQUAL_UINT8(0, obd_mode01_data_length(0xA6));   // Beyond the table
+}
+
+void test_short_data_rejected() {
+    const uint8_t bytes[] = { 0x1A, 0xF8 };
+    obd_data_t data;
+    data.engine_rpm = 123.0f;
+    TEST_ASSERT_FALSE(obd_decode_pid(0x0C, bytes, 1, data));
+    TEST_ASSERT_EQUAL_FLOAT(123.0f, data.engine_rpm);
+    TEST_ASSERT_TRUE(obd_decode_pid(0x0C, bytes, 2, data));
+    TEST_ASSERT_EQUAL_FLOAT(1726.0f, data.engine_rpm);
+
+    // Known length, no decoder
+    TEST_ASSERT_FALSE(obd_pid_decodable(0x00));
+    TEST_ASSERT_FALSE(obd_decode_pid(0x00, bytes, 2, data));
+}
+
+void test_batched_and_multiframe_responses() {
+    // Several PIDs in one request, one ECU line
+    const uint8_t batch[] = { 0x0C, 0x0D, 0x05 };
+    obd_data_t data;
+    TEST_ASSERT_EQUAL_UINT32(3, obd_decode_mode01_response("41 0C 1A F8 0D 3C 05 7B", batch, 3, data));
+    TEST_ASSERT_EQUAL_FLOAT(1726.0f, data.engine_rpm);
+    TEST_ASSERT_EQUAL_FLOAT(60.0f, data.vehicle_speed);
+    TEST_ASSERT_EQUAL_FLOAT(83.0f, data.coolant_temp);
+
+    // ISO-TP answer over two frames: byte count, then indexed frames
+    const uint8_t multi_pids[] = { 0x0C, 0x0D, 0x11, 0x04 };
+    obd_data_t multi;
+    TEST_ASSERT_EQUAL_UINT32(4, obd_decode_mode01_response("00A\r0:410C1AF80D3C\r1:11260405",
+                                                           multi_pids, 4, multi));
+    TEST_ASSERT_EQUAL_FLOAT(1726.0f, multi.engine_rpm);
+    TEST_ASSERT_EQUAL_FLOAT(60.0f, multi.vehicle_speed);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 14.902f, multi.throttle_position);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.961f, multi.engine_load);
+
+    // Status lines are skipped; negative responses decode nothing
+    const uint8_t speed_pid = 0x0D;
+    obd_data_t status;
+    TEST_ASSERT_EQUAL_UINT32(1, obd_decode_mode01_response("SEARCHING...\r41 0D 3C", &speed_pid, 1, status));
+    TEST_ASSERT_EQUAL_FLOAT(60.0f, status.vehicle_speed);
+    TEST_ASSERT_EQUAL_UINT32(0, obd_decode_mode01_response("7F 01 12", &speed_pid, 1, status));
+    TEST_ASSERT_EQUAL_UINT32(0, obd_decode_mode01_response("NO DATA", &speed_pid, 1, status));
+}
+
+void test_only_requested_pids_decoded() {
+    // An ECU answering more than was asked must not overwrite other fields
+    const uint8_t speed_pid = 0x0D;
+    obd_data_t data;
+    data.engine_rpm = 123.0f;
+    TEST_ASSERT_EQUAL_UINT32(1, obd_decode_mode01_response("41 0C 1A F8 0D 3C", &speed_pid, 1, data));
+    TEST_ASSERT_EQUAL_FLOAT(60.0f, data.vehicle_speed);
+    TEST_ASSERT_EQUAL_FLOAT(123.0f, data.engine_rpm);
+}
+
+void test_each_ecu_line_walked() {
+    // Two ECUs answer the same PID; the walk reports both, the later one wins
+    const uint8_t speed_pid = 0x0D;
+    elm327_messages_t messages;
+    found_pids_t found = {};
+    TEST_ASSERT_EQUAL_UINT32(2, obd_walk_mode01_response("41 0D 3C\r41 0D 3D", &speed_pid, 1,
+                                                         &messages, record_pid, &found));
+    obd_data_t data;
+    TEST_ASSERT_EQUAL_UINT32(2, obd_decode_mode01_response("41 0D 3C\r41 0D 3D", &speed_pid, 1, data));
+    TEST_ASSERT_EQUAL_FLOAT(61.0f, data.vehicle_speed);
+}
+
+void test_unknown_length_pid_only_last() {
+    // 0xA6 is beyond the length table: it takes the rest of its message
+    const uint8_t pids[] = { 0x0D, 0xA6 };
+    elm327_messages_t messages;
+    found_pids_t found = {};
+    TEST_ASSERT_EQUAL_UINT32(2, obd_walk_mode01_response("41 0D 3C A6 01 02 03 04", pids, 2,
+                                                         &messages, record_pid, &found));
+    TEST_ASSERT_EQUAL_UINT8(0x0D, found.pids[0].pid);
+    TEST_ASSERT_EQUAL_UINT32(1, found.pids[0].len);
+    TEST_ASSERT_EQUAL_UINT8(0xA6, found.pids[1].pid);
+    TEST_ASSERT_EQUAL_UINT32(4, found.pids[1].len);
+
+    // Found but not decodable: only the speed lands in obd_data_t
+    obd_data_t data;
+    TEST_ASSERT_EQUAL_UINT32(1, obd_decode_mode01_response("41 0D 3C A6 01 02 03 04", pids, 2, data));
+    TEST_ASSERT_EQUAL_FLOAT(60.0f, data.vehicle_speed);
+
+    // Anywhere else it swallows the PIDs behind it
+    found_pids_t swallowed = {};
+    TEST_ASSERT_EQUAL_UINT32(1, obd_walk_mode01_response("41 A6 01 0D 3C", pids, 2,
+                                                         &messages, record_pid, &swallowed));
+    TEST_ASSERT_EQUAL_UINT8(0xA6, swallowed.pids[0].pid);
+    TEST_ASSERT_EQUAL_UINT32(3, swallowed.pids[0].len);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_vectors_decode);
+    RUN_TEST(test_default_logging_pids_covered);
+    RUN_TEST(test_every_decoder_has_a_vector);
+    RUN_TEST(test_data_lengths_match_j1979);
+    RUN_TEST(test_short_data_rejected);
+    RUN_TEST(test_batched_and_multiframe_responses);
+    RUN_TEST(test_only_requested_pids_decoded);
+    RUN_TEST(test_each_ecu_line_walked);
+    RUN_TEST(test_unknown_length_pid_only_last);
+    return UNITY_END();
+}
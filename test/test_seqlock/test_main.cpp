@@ -0,0 +1,155 @@
+/**
+ * @brief Native stress test for the single-writer sequence lock
+ *
+ * One writer thread publishes snapshots whose every field is derived from
+ * the same counter while reader threads load as fast as they can. A torn
+ * read (fields from two different store() calls) breaks that relation, and
+ * a reader must never see the counter go backwards.
+ *
+ * Run with: pio test -e test -f test_seqlock
+ */
+
+#include <unity.h>
+#include <pthread.h>
+#include <atomic>
+#include <cstdio>
+#include "seqlock.h"
+
+// Two cores on the ESP32-S3; a few more readers make collisions likelier on the host
+#define READER_THREADS      3
+#define WRITER_STORES       2000000
+
+/**
+ * @brief Larger than a cache line so a copy cannot complete in one access
+ */
+struct snapshot_t {
+    uint64_t counter;
+    uint32_t words[24];
+    double value;
+    uint64_t check;
+};
+
+static SeqLock<snapshot_t> shared;
+static std::atomic<bool> writer_done;
+
+struct reader_result_t {
+    uint64_t loads;
+    uint64_t torn;
+    uint64_t backwards;
+    uint64_t changes;
+};
+
+static snapshot_t make_snapshot(uint64_t counter) {
+    snapshot_t s;
+    s.counter = counter;
+    for (uint32_t i = 0; i < 24; i++) {
+        s.words[i] = (uint32_t)(counter * 2654435761u) ^ i;
+    }
+    s.value = (double)counter * 0.5;
+    s.check = ~counter;
+    return s;
+}
+
+static bool is_consistent(const snapshot_t& s) {
+    if (s.check != ~s.counter || s.value != (double)s.counter * 0.5) {
+        return false;
+    }
+    for (uint32_t i = 0; i < 24; i++) {
+        if (s.words[i] != ((uint32_t)(s.counter * 2654435761u) ^ i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void* writer_main(void*) {
+    for (uint64_t n = 1; n <= WRITER_STORES; n++) {
+        shared.store(make_snapshot(n));
+    }
+    writer_done.store(true);
+    return nullptr;
+}
+
+static void* reader_main(void* arg) {
+    reader_result_t* result = static_cast<reader_result_t*>(arg);
+    uint64_t last = 0;
+    while (!writer_done.load()) {
+        snapshot_t s = shared.load();
+        result->loads++;
+        if (!is_consistent(s)) {
+            result->torn++;
+        }
+        if (s.counter < last) {
+            result->backwards++;
+        } else if (s.counter > last) {
+            result->changes++;
+        }
+        last = s.counter;
+    }
+    return nullptr;
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_initial_value_is_zeroed() {
+    SeqLock<snapshot_t> lock;
+    snapshot_t s = lock.load();
+    TEST_ASSERT_EQUAL_UINT32(0, lock.version());
+    TEST_ASSERT_EQUAL_UINT64(0, s.counter);
+    TEST_ASSERT_EQUAL_UINT64(0, s.check);
+}
+
+void test_store_load_round_trip() {
+    SeqLock<snapshot_t> lock;
+    lock.store(make_snapshot(42));
+    snapshot_t s = lock.load();
+    TEST_ASSERT_TRUE(is_consistent(s));
+    TEST_ASSERT_EQUAL_UINT64(42, s.counter);
+    TEST_ASSERT_EQUAL_UINT32(1, lock.version());
+}
+
+void test_concurrent_readers_never_see_torn_values() {
+    shared.store(make_snapshot(0));
+    writer_done.store(false);
+
+    pthread_t writer;
+    pthread_t readers[READER_THREADS];
+    reader_result_t results[READER_THREADS] = {};
+    for (int i = 0; i < READER_THREADS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&readers[i], nullptr, reader_main, &results[i]));
+    }
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&writer, nullptr, writer_main, nullptr));
+
+    pthread_join(writer, nullptr);
+    for (int i = 0; i < READER_THREADS; i++) {
+        pthread_join(readers[i], nullptr);
+    }
+
+    for (int i = 0; i < READER_THREADS; i++) {
+        char message[128];
+        snprintf(message, sizeof(message), "reader %d: %llu loads, %llu distinct values",
+                 i, (unsigned long long)results[i].loads, (unsigned long long)results[i].changes);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_EQUAL_UINT64_MESSAGE(0, results[i].torn, message);
+        TEST_ASSERT_EQUAL_UINT64_MESSAGE(0, results[i].backwards, message);
+        // The readers must actually have raced the writer
+        TEST_ASSERT_TRUE_MESSAGE(results[i].changes > 1, message);
+    }
+
+    snapshot_t last = shared.load();
+    TEST_ASSERT_TRUE(is_consistent(last));
+    TEST_ASSERT_EQUAL_UINT64(WRITER_STORES, last.counter);
+    TEST_ASSERT_EQUAL_UINT32(WRITER_STORES + 1, shared.version());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_initial_value_is_zeroed);
+    RUN_TEST(test_store_load_round_trip);
+    RUN_TEST(test_concurrent_readers_never_see_torn_values);
+    return UNITY_END();
+}
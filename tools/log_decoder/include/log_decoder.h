@@ -0,0 +1,156 @@
+#ifndef LOG_DECODER_H
+#define LOG_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "log_block.h"
+#include "log_records.h"
+#include "session_header.h"
+
+/**
+ * @brief One compressed block found in the image
+ */
+struct decoded_block_t {
+    log_block_header_t header;
+    uint32_t image_offset;      // Block header position in the image
+    size_t stream_offset;       // Block header position in the reassembled stream
+    size_t run_end;             // End of the sector run holding the block
+    size_t data_offset;         // Decompressed bytes within the decoder's arena
+    bool valid;                 // CRC matched and the payload decompressed
+};
+
+/**
+ * @brief Blocks sharing one startup_id, oldest first
+ */
+struct decoded_session_t {
+    uint8_t startup_id[16];
+    bool has_header;            // Session start header still in the ring (not overwritten)
+    session_start_header_t header;
+    std::vector<size_t> blocks; // Indices into LogDecoder::get_blocks()
+};
+
+/**
+ * @brief Decoder statistics for one image
+ */
+struct decode_stats_t {
+    uint32_t sectors_valid;     // Sectors with a valid 'LOGS' header
+    uint32_t runs;              // Runs of consecutive sector sequence numbers
+    bool legacy_layout;         // No sector headers: pre-ring image, entries back to back
+    uint32_t sessions;
+    uint32_t blocks_found;
+    uint32_t blocks_valid;
+    uint32_t blocks_corrupt;    // Failed CRC or decompression
+    uint32_t blocks_truncated;  // Cut short by power loss (writing resumed in a later sector)
+    uint32_t resyncs;           // Times the walker lost framing and skipped ahead
+    uint64_t bytes_compressed;
+    uint64_t bytes_uncompressed;
+    unsigned threads;
+    double scan_ms;             // Sector ordering and entry walk
+    double decode_ms;           // Parallel CRC + LZ4 decompression
+};
+
+/**
+ * @brief Decoder for dumped logging partitions (docs/LOG_FORMAT.md)
+ *
+ * decode() orders sectors by sequence number, walks the entry stream for
+ * session headers and block headers, then validates CRCs and decompresses
+ * all blocks in parallel into one arena. Records are then iterated per
+ * session without further copies.
+ *
+ * Framing is checked structurally during the walk; a block whose header is
+ * intact but whose payload fails its CRC is reported and skipped, and one
+ * that runs past the next sector's first entry was truncated by power loss.
+ * When framing is lost the walker resumes at the next sector's first entry
+ * (or scans for the next magic in legacy images).
+ */
+class LogDecoder {
+public:
+    LogDecoder();
+
+    /**
+     * @brief Decode a partition image
+     * @param image Image bytes (must stay valid while records are iterated)
+     * @param size Image size
+     * @param threads Decompression threads (0 = one per core)
+     * @return false if nothing recognisable was found
+     */
+    bool decode(const uint8_t* image, size_t size, unsigned threads = 0);
+
+    const std::vector<decoded_session_t>& get_sessions() const;
+    const std::vector<decoded_block_t>& get_blocks() const;
+    decode_stats_t get_stats() const;
+
+    /**
+     * @brief Decompressed records of a valid block
+     */
+    const uint8_t* block_data(const decoded_block_t& block) const;
+
+    /**
+     * @brief Visit every record of a session in log order
+     * @param fn Called as fn(uint8_t msg_type, const uint8_t* record); records
+     *           are packed and unaligned, copy them out with record_as<T>()
+     * @return Records visited
+     */
+    template <typename F>
+    uint64_t for_each_record(const decoded_session_t& session, F&& fn) const {
+        uint64_t count = 0;
+        for (size_t index : session.blocks) {
+            const decoded_block_t& block = m_blocks[index];
+            if (!block.valid) {
+                continue;
+            }
+            const uint8_t* data = block_data(block);
+            size_t len = block.header.uncompressed_size;
+            size_t pos = 0;
+            while (pos < len) {
+                uint32_t size = log_record_size(data[pos]);
+                if (size == 0 || pos + size > len) {
+                    break;      // Unknown type: the rest of the block cannot be framed
+                }
+                fn(data[pos], data + pos);
+                pos += size;
+                count++;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Copy a packed record out of the stream
+     */
+    template <typename T>
+    static T record_as(const uint8_t* record) {
+        T value;
+        memcpy(&value, record, sizeof(value));
+        return value;
+    }
+
+private:
+    const uint8_t* m_stream;            // Reassembled entry stream (or the image itself)
+    size_t m_stream_size;
+    std::vector<uint8_t> m_stream_buffer;
+
+    // Sector payloads in stream order: stream position -> image offset
+    std::vector<size_t> m_segment_stream;
+    std::vector<uint32_t> m_segment_image;
+    std::vector<size_t> m_resync;       // Stream positions where an entry starts, ascending
+    std::vector<size_t> m_run_ends;     // End of each run of consecutive sectors, ascending
+
+    std::vector<decoded_block_t> m_blocks;
+    std::vector<decoded_session_t> m_sessions;
+    std::vector<uint8_t> m_arena;
+    decode_stats_t m_stats;
+
+    void reset();
+    void assemble_sectors(const uint8_t* image, size_t size);
+    void walk_stream();
+    void decompress_blocks(unsigned threads);
+
+    size_t find_session(const uint8_t startup_id[16]);
+    size_t next_resync(size_t pos, size_t run_end) const;
+    uint32_t image_offset(size_t stream_pos) const;
+};
+
+#endif // LOG_DECODER_H
@@ -0,0 +1,60 @@
+#ifndef LOG_EXPORT_H
+#define LOG_EXPORT_H
+
+#include <string>
+#include "log_decoder.h"
+
+// Columnar file: 'PCOL' little-endian
+#define LOG_COLUMNAR_MAGIC      0x4C4F4350
+#define LOG_COLUMNAR_VERSION    0x01
+
+/**
+ * @brief Column element types in the columnar format
+ */
+enum column_type_t : uint8_t {
+    COLUMN_U8  = 1,
+    COLUMN_U32 = 2,
+    COLUMN_U64 = 3,
+    COLUMN_I64 = 4,
+    COLUMN_F32 = 5,
+    COLUMN_F64 = 6
+};
+
+/**
+ * @brief Session naming for exported files: "<prefix>_<first 8 hex digits of the UUID>"
+ */
+std::string session_file_stem(const std::string& prefix, const decoded_session_t& session);
+
+/**
+ * @brief Format a startup_id as a UUID string
+ */
+std::string session_uuid(const decoded_session_t& session);
+
+/**
+ * @brief Write one CSV per record type ("<stem>_imu.csv", "<stem>_gps.csv", ...)
+ *
+ * Every row carries t_us (µs since session start) and utc_us, derived from
+ * the latest TIME_SYNC record (or the session header's gps_utc_at_lock);
+ * utc_us is empty until one is seen.
+ *
+ * @param stem Output path without suffix
+ * @param error Filled on failure
+ * @return false if a file could not be written
+ */
+bool export_session_csv(const LogDecoder& decoder, const decoded_session_t& session,
+                        const std::string& stem, std::string* error);
+
+/**
+ * @brief Write the session as one columnar file ("<stem>.pcol")
+ *
+ * Layout (little-endian), see tools/log_decoder/README.md:
+ *   magic u32 | version u8 | reserved[3] | startup_id[16] | table_count u32
+ *   per table:  msg_type u8 | name | column_count u8 | row_count u64
+ *               per column: name | type u8
+ *               per column: row_count values, contiguous
+ * where name = length u8 + bytes. utc_us is 0 where unknown.
+ */
+bool export_session_columnar(const LogDecoder& decoder, const decoded_session_t& session,
+                             const std::string& stem, std::string* error);
+
+#endif // LOG_EXPORT_H
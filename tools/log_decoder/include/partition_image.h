@@ -0,0 +1,43 @@
+#ifndef PARTITION_IMAGE_H
+#define PARTITION_IMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Read-only view of a dumped logging partition
+ * (e.g. `esptool.py read_flash <offset> 0x200000 storage.bin`)
+ *
+ * The file is memory-mapped where the platform allows it, otherwise read
+ * into memory; either way data() stays valid until close().
+ */
+class PartitionImage {
+public:
+    PartitionImage();
+    ~PartitionImage();
+
+    PartitionImage(const PartitionImage&) = delete;
+    PartitionImage& operator=(const PartitionImage&) = delete;
+
+    /**
+     * @brief Map a partition image
+     * @param path Image file
+     * @return false if the file cannot be opened or is empty (see get_error())
+     */
+    bool open(const std::string& path);
+
+    void close();
+
+    const uint8_t* data() const;
+    size_t size() const;
+    const std::string& get_error() const;
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    bool m_mapped;          // munmap() on close, otherwise delete[]
+    std::string m_error;
+};
+
+#endif // PARTITION_IMAGE_H
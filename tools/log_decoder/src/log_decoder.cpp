@@ -0,0 +1,280 @@
+#include "log_decoder.h"
+#include "log_block_codec.h"
+#include "lz4_block.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Flash erase granularity of the logging partition (one log_sector_header_t each)
+#define LOG_DECODER_SECTOR_SIZE     4096
+
+#define SECTOR_PAYLOAD_SIZE  (LOG_DECODER_SECTOR_SIZE - sizeof(log_sector_header_t))
+
+static double elapsed_ms(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+static uint32_t read_u32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+LogDecoder::LogDecoder() : m_stream(nullptr), m_stream_size(0) {
+    reset();
+}
+
+void LogDecoder::reset() {
+    m_stream = nullptr;
+    m_stream_size = 0;
+    m_stream_buffer.clear();
+    m_segment_stream.clear();
+    m_segment_image.clear();
+    m_resync.clear();
+    m_run_ends.clear();
+    m_blocks.clear();
+    m_sessions.clear();
+    m_arena.clear();
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+bool LogDecoder::decode(const uint8_t* image, size_t size, unsigned threads) {
+    reset();
+    if (!image || size == 0) {
+        return false;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    assemble_sectors(image, size);
+    walk_stream();
+    m_stats.scan_ms = elapsed_ms(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    decompress_blocks(threads);
+    m_stats.decode_ms = elapsed_ms(t0);
+
+    m_stats.sessions = (uint32_t)m_sessions.size();
+    return !m_sessions.empty();
+}
+
+void LogDecoder::assemble_sectors(const uint8_t* image, size_t size) {
+    // Valid sector headers, ordered by sequence number
+    std::vector<std::pair<uint32_t, uint32_t>> sectors;
+    size_t count = size / LOG_DECODER_SECTOR_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        log_sector_header_t h;
+        memcpy(&h, image + i * LOG_DECODER_SECTOR_SIZE, sizeof(h));
+        if (h.magic == LOG_SECTOR_MAGIC &&
+            h.crc32 == log_crc32(0, (const uint8_t*)&h, sizeof(h) - sizeof(h.crc32))) {
+            uint32_t sequence = h.sequence;
+            sectors.push_back({sequence, (uint32_t)i});
+        }
+    }
+    m_stats.sectors_valid = (uint32_t)sectors.size();
+
+    if (sectors.empty()) {
+        // Images from before the sector ring: entries back to back from offset 0
+        m_stats.legacy_layout = true;
+        m_stats.runs = 1;
+        m_stream = image;
+        m_stream_size = size;
+        m_segment_stream.push_back(0);
+        m_segment_image.push_back(0);
+        m_run_ends.push_back(size);
+        return;
+    }
+
+    std::sort(sectors.begin(), sectors.end());
+    m_stream_buffer.reserve(sectors.size() * SECTOR_PAYLOAD_SIZE);
+    for (size_t i = 0; i < sectors.size(); i++) {
+        if (i > 0 && sectors[i].first != sectors[i - 1].first + 1) {
+            m_run_ends.push_back(m_stream_buffer.size());
+        }
+
+        const uint8_t* sector = image + (size_t)sectors[i].second * LOG_DECODER_SECTOR_SIZE;
+        log_sector_header_t h;
+        memcpy(&h, sector, sizeof(h));
+        size_t base = m_stream_buffer.size();
+        m_segment_stream.push_back(base);
+        m_segment_image.push_back(sectors[i].second * LOG_DECODER_SECTOR_SIZE);
+        if (h.first_entry >= sizeof(h) && h.first_entry < LOG_DECODER_SECTOR_SIZE) {
+            m_resync.push_back(base + h.first_entry - sizeof(h));
+        }
+        m_stream_buffer.insert(m_stream_buffer.end(), sector + sizeof(h), sector + LOG_DECODER_SECTOR_SIZE);
+    }
+    m_run_ends.push_back(m_stream_buffer.size());
+    m_stats.runs = (uint32_t)m_run_ends.size();
+
+    m_stream = m_stream_buffer.data();
+    m_stream_size = m_stream_buffer.size();
+}
+
+size_t LogDecoder::next_resync(size_t pos, size_t run_end) const {
+    if (m_stats.legacy_layout) {
+        for (size_t p = pos + 1; p + sizeof(uint32_t) <= run_end; p++) {
+            uint32_t magic = read_u32(m_stream + p);
+            if (magic == LOG_BLOCK_MAGIC || magic == SESSION_START_MAGIC) {
+                return p;
+            }
+        }
+        return run_end;
+    }
+    auto it = std::upper_bound(m_resync.begin(), m_resync.end(), pos);
+    return (it != m_resync.end() && *it < run_end) ? *it : run_end;
+}
+
+uint32_t LogDecoder::image_offset(size_t stream_pos) const {
+    if (m_stats.legacy_layout) {
+        return (uint32_t)stream_pos;
+    }
+    size_t i = std::upper_bound(m_segment_stream.begin(), m_segment_stream.end(), stream_pos) -
+               m_segment_stream.begin() - 1;
+    return m_segment_image[i] + (uint32_t)sizeof(log_sector_header_t) + (uint32_t)(stream_pos - m_segment_stream[i]);
+}
+
+size_t LogDecoder::find_session(const uint8_t startup_id[16]) {
+    for (size_t i = 0; i < m_sessions.size(); i++) {
+        if (memcmp(m_sessions[i].startup_id, startup_id, 16) == 0) {
+            return i;
+        }
+    }
+    decoded_session_t session;
+    memcpy(session.startup_id, startup_id, 16);
+    session.has_header = false;
+    memset(&session.header, 0, sizeof(session.header));
+    m_sessions.push_back(session);
+    return m_sessions.size() - 1;
+}
+
+void LogDecoder::walk_stream() {
+    const size_t max_compressed = lz4_compress_bound(LZ4_BLOCK_MAX_INPUT_SIZE);
+    size_t run_start = 0;
+
+    for (size_t run_end : m_run_ends) {
+        size_t pos = run_start;
+        if (!m_stats.legacy_layout) {
+            // A run may open mid-entry: start at the first entry boundary
+            auto it = std::lower_bound(m_resync.begin(), m_resync.end(), run_start);
+            pos = (it != m_resync.end() && *it < run_end) ? *it : run_end;
+        }
+
+        while (pos + sizeof(uint32_t) <= run_end) {
+            uint32_t magic = read_u32(m_stream + pos);
+
+            // Sectors opened mid-entry point first_entry at that entry's end, so an
+            // entry reaching past the next entry start was cut short by power loss
+            size_t limit = m_stats.legacy_layout ? run_end : next_resync(pos, run_end);
+
+            if (magic == LOG_BLOCK_MAGIC && pos + sizeof(log_block_header_t) <= run_end) {
+                log_block_header_t h;
+                memcpy(&h, m_stream + pos, sizeof(h));
+                size_t end = pos + sizeof(h) + h.compressed_size;
+                if (end > limit && limit < run_end) {
+                    m_stats.blocks_truncated++;
+                    pos = limit;
+                    continue;
+                }
+                if (h.version == LOG_BLOCK_VERSION && h.compressed_size > 0 &&
+                    h.compressed_size <= max_compressed &&
+                    h.uncompressed_size <= LZ4_BLOCK_MAX_INPUT_SIZE && end <= run_end) {
+                    decoded_block_t block;
+                    block.header = h;
+                    block.image_offset = image_offset(pos);
+                    block.stream_offset = pos;
+                    block.run_end = run_end;
+                    block.data_offset = 0;
+                    block.valid = false;
+                    m_blocks.push_back(block);
+                    m_sessions[find_session(h.startup_id)].blocks.push_back(m_blocks.size() - 1);
+                    pos = end;
+                    continue;
+                }
+            } else if (magic == SESSION_START_MAGIC && pos + sizeof(session_start_header_t) <= limit) {
+                session_start_header_t s;
+                memcpy(&s, m_stream + pos, sizeof(s));
+                if (s.crc32 == log_crc32(0, (const uint8_t*)&s, sizeof(s) - sizeof(s.crc32))) {
+                    decoded_session_t& session = m_sessions[find_session(s.startup_id)];
+                    session.has_header = true;
+                    session.header = s;
+                    pos += sizeof(s);
+                    continue;
+                }
+            }
+
+            // Erased space after the last entry of a sector is expected; anything else lost framing
+            if (magic != 0xFFFFFFFF) {
+                m_stats.resyncs++;
+            }
+            pos = next_resync(pos, run_end);
+        }
+        run_start = run_end;
+    }
+    m_stats.blocks_found = (uint32_t)m_blocks.size();
+}
+
+void LogDecoder::decompress_blocks(unsigned threads) {
+    size_t total = 0;
+    for (decoded_block_t& block : m_blocks) {
+        block.data_offset = total;
+        total += block.header.uncompressed_size;
+    }
+    m_arena.resize(total);
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (threads > m_blocks.size()) {
+        threads = (unsigned)std::max<size_t>(1, m_blocks.size());
+    }
+    m_stats.threads = threads;
+
+    // Blocks are independent: workers claim them one at a time
+    std::atomic<size_t> next(0);
+    auto worker = [this, &next]() {
+        size_t i;
+        while ((i = next.fetch_add(1, std::memory_order_relaxed)) < m_blocks.size()) {
+            decoded_block_t& block = m_blocks[i];
+            const uint8_t* entry = m_stream + block.stream_offset;
+            log_block_header_t h;
+            block.valid = log_block_validate(entry, block.run_end - block.stream_offset, &h) &&
+                          log_block_decode(&h, entry + sizeof(h), m_arena.data() + block.data_offset,
+                                           h.uncompressed_size);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : pool) {
+        t.join();
+    }
+
+    for (const decoded_block_t& block : m_blocks) {
+        if (block.valid) {
+            m_stats.blocks_valid++;
+            m_stats.bytes_compressed += block.header.compressed_size;
+            m_stats.bytes_uncompressed += block.header.uncompressed_size;
+        } else {
+            m_stats.blocks_corrupt++;
+        }
+    }
+}
+
+const std::vector<decoded_session_t>& LogDecoder::get_sessions() const {
+    return m_sessions;
+}
+
+const std::vector<decoded_block_t>& LogDecoder::get_blocks() const {
+    return m_blocks;
+}
+
+decode_stats_t LogDecoder::get_stats() const {
+    return m_stats;
+}
+
+const uint8_t* LogDecoder::block_data(const decoded_block_t& block) const {
+    return m_arena.data() + block.data_offset;
+}
@@ -0,0 +1,328 @@
+#include "log_export.h"
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief One exported field of a record layout
+ */
+struct column_t {
+    const char* name;
+    column_type_t type;
+    size_t offset;
+};
+
+/**
+ * @brief Exported columns of one record type (t_us first)
+ */
+struct record_table_t {
+    uint8_t msg_type;
+    const char* name;
+    const column_t* columns;
+    size_t column_count;
+};
+
+#define RECORD_COLUMN(record, field, type)  { #field, type, offsetof(record, field) }
+
+static const column_t IMU_COLUMNS[] = {
+    { "t_us", COLUMN_U64, offsetof(imu_record_t, timestamp_offset_us) },
+    RECORD_COLUMN(imu_record_t, accel_x, COLUMN_F32),
+    RECORD_COLUMN(imu_record_t, accel_y, COLUMN_F32),
+    RECORD_COLUMN(imu_record_t, accel_z, COLUMN_F32),
+    RECORD_COLUMN(imu_record_t, gyro_x, COLUMN_F32),
+    RECORD_COLUMN(imu_record_t, gyro_y, COLUMN_F32),
+    RECORD_COLUMN(imu_record_t, gyro_z, COLUMN_F32),
+};
+
+static const column_t GPS_COLUMNS[] = {
+    { "t_us", COLUMN_U64, offsetof(gps_record_t, timestamp_offset_us) },
+    RECORD_COLUMN(gps_record_t, latitude, COLUMN_F64),
+    RECORD_COLUMN(gps_record_t, longitude, COLUMN_F64),
+    RECORD_COLUMN(gps_record_t, altitude_m, COLUMN_F32),
+    RECORD_COLUMN(gps_record_t, fix_type, COLUMN_U8),
+    RECORD_COLUMN(gps_record_t, num_sats, COLUMN_U8),
+    RECORD_COLUMN(gps_record_t, hdop, COLUMN_F32),
+};
+
+static const column_t CAN_COLUMNS[] = {
+    { "t_us", COLUMN_U64, offsetof(can_record_t, timestamp_offset_us) },
+    RECORD_COLUMN(can_record_t, can_id, COLUMN_U32),
+    RECORD_COLUMN(can_record_t, dlc, COLUMN_U8),
+    RECORD_COLUMN(can_record_t, flags, COLUMN_U8),
+    { "d0", COLUMN_U8, offsetof(can_record_t, data) + 0 },
+    { "d1", COLUMN_U8, offsetof(can_record_t, data) + 1 },
+    { "d2", COLUMN_U8, offsetof(can_record_t, data) + 2 },
+    { "d3", COLUMN_U8, offsetof(can_record_t, data) + 3 },
+    { "d4", COLUMN_U8, offsetof(can_record_t, data) + 4 },
+    { "d5", COLUMN_U8, offsetof(can_record_t, data) + 5 },
+    { "d6", COLUMN_U8, offsetof(can_record_t, data) + 6 },
+    { "d7", COLUMN_U8, offsetof(can_record_t, data) + 7 },
+};
+
+static const column_t COMPASS_COLUMNS[] = {
+    { "t_us", COLUMN_U64, offsetof(compass_record_t, timestamp_offset_us) },
+    RECORD_COLUMN(compass_record_t, bearing_deg, COLUMN_F32),
+};
+
+static const column_t TIME_SYNC_COLUMNS[] = {
+    { "t_us", COLUMN_U64, offsetof(time_sync_record_t, timestamp_offset_us) },
+    { "sync_utc_us", COLUMN_I64, offsetof(time_sync_record_t, utc_us) },
+    RECORD_COLUMN(time_sync_record_t, drift_ppm, COLUMN_F32),
+    RECORD_COLUMN(time_sync_record_t, uncertainty_us, COLUMN_U32),
+    RECORD_COLUMN(time_sync_record_t, source, COLUMN_U8),
+};
+
+#define TABLE(type, name, columns)  { type, name, columns, sizeof(columns) / sizeof(columns[0]) }
+
+static const record_table_t RECORD_TABLES[] = {
+    TABLE(LOG_RECORD_IMU, "imu", IMU_COLUMNS),
+    TABLE(LOG_RECORD_GPS, "gps", GPS_COLUMNS),
+    TABLE(LOG_RECORD_CAN, "can", CAN_COLUMNS),
+    TABLE(LOG_RECORD_COMPASS, "compass", COMPASS_COLUMNS),
+    TABLE(LOG_RECORD_TIME_SYNC, "time_sync", TIME_SYNC_COLUMNS),
+};
+
+#define TABLE_COUNT  (sizeof(RECORD_TABLES) / sizeof(RECORD_TABLES[0]))
+
+static int table_index(uint8_t msg_type) {
+    for (size_t i = 0; i < TABLE_COUNT; i++) {
+        if (RECORD_TABLES[i].msg_type == msg_type) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static size_t column_width(column_type_t type) {
+    switch (type) {
+        case COLUMN_U8:  return 1;
+        case COLUMN_U32: return 4;
+        case COLUMN_F32: return 4;
+        default:         return 8;
+    }
+}
+
+/**
+ * @brief Session time -> UTC from the latest TIME_SYNC record seen
+ */
+class UtcTracker {
+public:
+    explicit UtcTracker(const decoded_session_t& session)
+        : m_valid(false), m_ref_t(0), m_ref_utc(0), m_drift_ppm(0.0) {
+        if (session.has_header && session.header.gps_utc_at_lock > 0) {
+            m_valid = true;
+            m_ref_utc = session.header.gps_utc_at_lock * 1000000;
+        }
+    }
+
+    void observe(uint8_t msg_type, const uint8_t* record) {
+        if (msg_type == LOG_RECORD_TIME_SYNC) {
+            time_sync_record_t sync = LogDecoder::record_as<time_sync_record_t>(record);
+            m_valid = true;
+            m_ref_t = (int64_t)sync.timestamp_offset_us;
+            m_ref_utc = sync.utc_us;
+            m_drift_ppm = sync.drift_ppm;
+        }
+    }
+
+    bool at(uint64_t t_us, int64_t* utc_us) const {
+        if (!m_valid) {
+            return false;
+        }
+        int64_t dt = (int64_t)t_us - m_ref_t;
+        *utc_us = m_ref_utc + dt + (int64_t)((double)dt * m_drift_ppm * 1e-6);
+        return true;
+    }
+
+private:
+    bool m_valid;
+    int64_t m_ref_t;
+    int64_t m_ref_utc;
+    double m_drift_ppm;
+};
+
+static uint64_t record_t_us(const uint8_t* record) {
+    uint64_t t;
+    memcpy(&t, record + 1, sizeof(t));
+    return t;
+}
+
+std::string session_uuid(const decoded_session_t& session) {
+    char text[37];
+    char* p = text;
+    for (int i = 0; i < 16; i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) {
+            *p++ = '-';
+        }
+        p += snprintf(p, 3, "%02x", session.startup_id[i]);
+    }
+    return std::string(text, p - text);
+}
+
+std::string session_file_stem(const std::string& prefix, const decoded_session_t& session) {
+    return prefix + "_" + session_uuid(session).substr(0, 8);
+}
+
+static void write_csv_value(FILE* f, column_type_t type, const uint8_t* p) {
+    switch (type) {
+        case COLUMN_U8:  fprintf(f, "%u", p[0]); break;
+        case COLUMN_U32: { uint32_t v; memcpy(&v, p, 4); fprintf(f, "%" PRIu32, v); break; }
+        case COLUMN_U64: { uint64_t v; memcpy(&v, p, 8); fprintf(f, "%" PRIu64, v); break; }
+        case COLUMN_I64: { int64_t v; memcpy(&v, p, 8); fprintf(f, "%" PRId64, v); break; }
+        case COLUMN_F32: { float v; memcpy(&v, p, 4); fprintf(f, "%.7g", v); break; }
+        case COLUMN_F64: { double v; memcpy(&v, p, 8); fprintf(f, "%.10f", v); break; }
+    }
+}
+
+bool export_session_csv(const LogDecoder& decoder, const decoded_session_t& session,
+                        const std::string& stem, std::string* error) {
+    struct file_closer_t {
+        void operator()(FILE* f) const { fclose(f); }
+    };
+    std::unique_ptr<FILE, file_closer_t> files[TABLE_COUNT];
+    bool ok = true;
+    UtcTracker utc(session);
+
+    decoder.for_each_record(session, [&](uint8_t msg_type, const uint8_t* record) {
+        utc.observe(msg_type, record);
+        int t = table_index(msg_type);
+        if (t < 0 || !ok) {
+            return;
+        }
+        const record_table_t& table = RECORD_TABLES[t];
+
+        // Files are created on first use so absent sensors leave no empty CSVs
+        FILE* f = files[t].get();
+        if (!f) {
+            std::string path = stem + "_" + table.name + ".csv";
+            f = fopen(path.c_str(), "w");
+            if (!f) {
+                if (error) *error = "cannot write " + path;
+                ok = false;
+                return;
+            }
+            setvbuf(f, nullptr, _IOFBF, 1 << 20);
+            files[t].reset(f);
+            fputs("t_us,utc_us", f);
+            for (size_t c = 1; c < table.column_count; c++) {
+                fprintf(f, ",%s", table.columns[c].name);
+            }
+            fputc('\n', f);
+        }
+
+        uint64_t t_us = record_t_us(record);
+        int64_t utc_us;
+        fprintf(f, "%" PRIu64 ",", t_us);
+        if (utc.at(t_us, &utc_us)) {
+            fprintf(f, "%" PRId64, utc_us);
+        }
+        for (size_t c = 1; c < table.column_count; c++) {
+            fputc(',', f);
+            write_csv_value(f, table.columns[c].type, record + table.columns[c].offset);
+        }
+        fputc('\n', f);
+    });
+    return ok;
+}
+
+static void write_name(FILE* f, const char* name) {
+    uint8_t len = (uint8_t)strlen(name);
+    fwrite(&len, 1, 1, f);
+    fwrite(name, 1, len, f);
+}
+
+bool export_session_columnar(const LogDecoder& decoder, const decoded_session_t& session,
+                             const std::string& stem, std::string* error) {
+    // Pass 1: row counts, so every column is one contiguous allocation
+    uint64_t rows[TABLE_COUNT] = {};
+    decoder.for_each_record(session, [&](uint8_t msg_type, const uint8_t*) {
+        int t = table_index(msg_type);
+        if (t >= 0) {
+            rows[t]++;
+        }
+    });
+
+    // Pass 2: scatter fields into columns; column 0 is t_us, then the derived utc_us
+    std::vector<std::vector<uint8_t>> columns[TABLE_COUNT];
+    std::vector<int64_t> utc_columns[TABLE_COUNT];
+    for (size_t t = 0; t < TABLE_COUNT; t++) {
+        columns[t].resize(RECORD_TABLES[t].column_count);
+        for (size_t c = 0; c < RECORD_TABLES[t].column_count; c++) {
+            columns[t][c].reserve(rows[t] * column_width(RECORD_TABLES[t].columns[c].type));
+        }
+        utc_columns[t].reserve(rows[t]);
+    }
+
+    UtcTracker utc(session);
+    decoder.for_each_record(session, [&](uint8_t msg_type, const uint8_t* record) {
+        utc.observe(msg_type, record);
+        int t = table_index(msg_type);
+        if (t < 0) {
+            return;
+        }
+        const record_table_t& table = RECORD_TABLES[t];
+        for (size_t c = 0; c < table.column_count; c++) {
+            const uint8_t* p = record + table.columns[c].offset;
+            columns[t][c].insert(columns[t][c].end(), p, p + column_width(table.columns[c].type));
+        }
+        int64_t utc_us = 0;
+        utc.at(record_t_us(record), &utc_us);
+        utc_columns[t].push_back(utc_us);
+    });
+
+    std::string path = stem + ".pcol";
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        if (error) *error = "cannot write " + path;
+        return false;
+    }
+
+    uint32_t table_count = 0;
+    for (size_t t = 0; t < TABLE_COUNT; t++) {
+        table_count += rows[t] > 0 ? 1 : 0;
+    }
+    uint32_t magic = LOG_COLUMNAR_MAGIC;
+    uint8_t version[4] = { LOG_COLUMNAR_VERSION, 0, 0, 0 };
+    fwrite(&magic, sizeof(magic), 1, f);
+    fwrite(version, 1, sizeof(version), f);
+    fwrite(session.startup_id, 1, 16, f);
+    fwrite(&table_count, sizeof(table_count), 1, f);
+
+    for (size_t t = 0; t < TABLE_COUNT; t++) {
+        if (rows[t] == 0) {
+            continue;
+        }
+        const record_table_t& table = RECORD_TABLES[t];
+        uint8_t column_count = (uint8_t)(table.column_count + 1);
+        fwrite(&table.msg_type, 1, 1, f);
+        write_name(f, table.name);
+        fwrite(&column_count, 1, 1, f);
+        fwrite(&rows[t], sizeof(rows[t]), 1, f);
+
+        uint8_t utc_type = COLUMN_I64;
+        for (size_t c = 0; c < table.column_count; c++) {
+            uint8_t type = table.columns[c].type;
+            write_name(f, table.columns[c].name);
+            fwrite(&type, 1, 1, f);
+            if (c == 0) {
+                write_name(f, "utc_us");
+                fwrite(&utc_type, 1, 1, f);
+            }
+        }
+        for (size_t c = 0; c < table.column_count; c++) {
+            fwrite(columns[t][c].data(), 1, columns[t][c].size(), f);
+            if (c == 0) {
+                fwrite(utc_columns[t].data(), sizeof(int64_t), utc_columns[t].size(), f);
+            }
+        }
+    }
+
+    bool ok = !ferror(f);
+    fclose(f);
+    if (!ok && error) {
+        *error = "write failed: " + path;
+    }
+    return ok;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file main.cpp
+ * @brief ponylog - decode dumped OpenPonyLogger partitions
+ *
+ * Usage: ponylog [options] image.bin [image.bin ...]
+ *   -c, --csv DIR       Export every session as CSV files into DIR
+ *   -k, --columnar DIR  Export every session as a .pcol file into DIR
+ *   -j, --threads N     Decompression threads (default: one per core)
+ *   -q, --quiet         Only print errors and the batch summary
+ */
+
+#include "log_decoder.h"
+#include "log_export.h"
+#include "partition_image.h"
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct options_t {
+    std::string csv_dir;
+    std::string columnar_dir;
+    unsigned threads = 0;
+    bool quiet = false;
+    std::vector<std::string> images;
+};
+
+static void print_usage() {
+    fprintf(stderr,
+            "Usage: ponylog [options] image.bin [image.bin ...]\n"
+            "  -c, --csv DIR       Export every session as CSV files into DIR\n"
+            "  -k, --columnar DIR  Export every session as a .pcol file into DIR\n"
+            "  -j, --threads N     Decompression threads (default: one per core)\n"
+            "  -q, --quiet         Only print errors and the batch summary\n");
+}
+
+static bool parse_args(int argc, char** argv, options_t* opts) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if ((arg == "-c" || arg == "--csv") && has_value) {
+            opts->csv_dir = argv[++i];
+        } else if ((arg == "-k" || arg == "--columnar") && has_value) {
+            opts->columnar_dir = argv[++i];
+        } else if ((arg == "-j" || arg == "--threads") && has_value) {
+            opts->threads = (unsigned)atoi(argv[++i]);
+        } else if (arg == "-q" || arg == "--quiet") {
+            opts->quiet = true;
+        } else if (arg == "-h" || arg == "--help" || arg[0] == '-') {
+            return false;
+        } else {
+            opts->images.push_back(arg);
+        }
+    }
+    return !opts->images.empty();
+}
+
+static void print_session(const LogDecoder& decoder, const decoded_session_t& session) {
+    const std::vector<decoded_block_t>& blocks = decoder.get_blocks();
+    uint32_t valid = 0;
+    uint64_t counts[256] = {};
+    uint64_t first_t = UINT64_MAX;
+    uint64_t last_t = 0;
+    for (size_t index : session.blocks) {
+        valid += blocks[index].valid ? 1 : 0;
+    }
+    decoder.for_each_record(session, [&](uint8_t msg_type, const uint8_t* record) {
+        uint64_t t;
+        memcpy(&t, record + 1, sizeof(t));
+        counts[msg_type]++;
+        first_t = t < first_t ? t : first_t;
+        last_t = t > last_t ? t : last_t;
+    });
+
+    printf("  session %s  %u/%zu blocks", session_uuid(session).c_str(), valid, session.blocks.size());
+    if (first_t <= last_t) {
+        printf("  %.1f s", (last_t - first_t) / 1e6);
+    }
+    printf("\n");
+    if (session.has_header) {
+        const session_start_header_t& h = session.header;
+        printf("    fw %02x%02x%02x%02x  mac %02x:%02x:%02x:%02x:%02x:%02x  boot +%.3f s",
+               h.fw_sha[0], h.fw_sha[1], h.fw_sha[2], h.fw_sha[3],
+               h.mac_addr[0], h.mac_addr[1], h.mac_addr[2], h.mac_addr[3], h.mac_addr[4], h.mac_addr[5],
+               h.esp_time_at_start / 1e6);
+        if (h.gps_utc_at_lock > 0) {
+            time_t utc = (time_t)h.gps_utc_at_lock;
+            char text[32];
+            strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%SZ", gmtime(&utc));
+            printf("  start %s", text);
+        }
+        printf("\n");
+    } else {
+        printf("    (start header overwritten)\n");
+    }
+    printf("    records: imu %" PRIu64 ", gps %" PRIu64 ", can %" PRIu64 ", compass %" PRIu64 ", time_sync %" PRIu64 "\n",
+           counts[LOG_RECORD_IMU], counts[LOG_RECORD_GPS], counts[LOG_RECORD_CAN],
+           counts[LOG_RECORD_COMPASS], counts[LOG_RECORD_TIME_SYNC]);
+}
+
+int main(int argc, char** argv) {
+    options_t opts;
+    if (!parse_args(argc, argv, &opts)) {
+        print_usage();
+        return 2;
+    }
+
+    for (const std::string* dir : { &opts.csv_dir, &opts.columnar_dir }) {
+        std::error_code ec;
+        if (!dir->empty() && !std::filesystem::create_directories(*dir, ec) && ec) {
+            fprintf(stderr, "ponylog: cannot create %s: %s\n", dir->c_str(), ec.message().c_str());
+            return 1;
+        }
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    int failures = 0;
+    uint64_t total_bytes = 0;
+    uint32_t total_sessions = 0;
+    uint32_t total_corrupt = 0;
+
+    for (const std::string& path : opts.images) {
+        PartitionImage image;
+        if (!image.open(path)) {
+            fprintf(stderr, "ponylog: %s\n", image.get_error().c_str());
+            failures++;
+            continue;
+        }
+
+        LogDecoder decoder;
+        if (!decoder.decode(image.data(), image.size(), opts.threads)) {
+            fprintf(stderr, "ponylog: %s: no log data found\n", path.c_str());
+            failures++;
+            continue;
+        }
+
+        decode_stats_t stats = decoder.get_stats();
+        total_bytes += image.size();
+        total_sessions += stats.sessions;
+        total_corrupt += stats.blocks_corrupt;
+        if (!opts.quiet) {
+            printf("%s: %s layout, %u sectors in %u run(s), %u/%u blocks valid (%u corrupt, %u truncated, %u resyncs)\n",
+                   path.c_str(), stats.legacy_layout ? "legacy" : "ring", stats.sectors_valid, stats.runs,
+                   stats.blocks_valid, stats.blocks_found, stats.blocks_corrupt, stats.blocks_truncated,
+                   stats.resyncs);
+            printf("  %.1f KB -> %.1f KB, scan %.2f ms, decode %.2f ms on %u thread(s)\n",
+                   stats.bytes_compressed / 1024.0, stats.bytes_uncompressed / 1024.0,
+                   stats.scan_ms, stats.decode_ms, stats.threads);
+            for (const decoded_session_t& session : decoder.get_sessions()) {
+                print_session(decoder, session);
+            }
+        }
+
+        std::string prefix = std::filesystem::path(path).stem().string();
+        for (const decoded_session_t& session : decoder.get_sessions()) {
+            std::string error;
+            if (!opts.csv_dir.empty() &&
+                !export_session_csv(decoder, session,
+                                    (std::filesystem::path(opts.csv_dir) / session_file_stem(prefix, session)).string(),
+                                    &error)) {
+                fprintf(stderr, "ponylog: %s\n", error.c_str());
+                failures++;
+            }
+            if (!opts.columnar_dir.empty() &&
+                !export_session_columnar(decoder, session,
+                                         (std::filesystem::path(opts.columnar_dir) / session_file_stem(prefix, session)).string(),
+                                         &error)) {
+                fprintf(stderr, "ponylog: %s\n", error.c_str());
+                failures++;
+            }
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    printf("%zu image(s), %.1f MB, %u session(s), %u corrupt block(s) in %.1f ms\n",
+           opts.images.size(), total_bytes / (1024.0 * 1024.0), total_sessions, total_corrupt, ms);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include "partition_image.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PARTITION_IMAGE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+PartitionImage::PartitionImage() : m_data(nullptr), m_size(0), m_mapped(false) {
+}
+
+PartitionImage::~PartitionImage() {
+    close();
+}
+
+bool PartitionImage::open(const std::string& path) {
+    close();
+
+#ifdef PARTITION_IMAGE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        m_error = path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        m_error = path + ": empty or unreadable";
+        ::close(fd);
+        return false;
+    }
+    void* map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map != MAP_FAILED) {
+        m_data = static_cast<const uint8_t*>(map);
+        m_size = (size_t)st.st_size;
+        m_mapped = true;
+        return true;
+    }
+#endif
+
+    // No mmap: read the whole image (2 MB)
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+        m_error = path + ": " + strerror(errno);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (len <= 0) {
+        m_error = path + ": empty or unreadable";
+        fclose(f);
+        return false;
+    }
+    uint8_t* buf = new uint8_t[(size_t)len];
+    size_t got = fread(buf, 1, (size_t)len, f);
+    fclose(f);
+    if (got != (size_t)len) {
+        m_error = path + ": short read";
+        delete[] buf;
+        return false;
+    }
+    m_data = buf;
+    m_size = (size_t)len;
+    m_mapped = false;
+    return true;
+}
+
+void PartitionImage::close() {
+    if (m_data) {
+#ifdef PARTITION_IMAGE_MMAP
+        if (m_mapped) {
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+        } else
+#endif
+        {
+            delete[] m_data;
+        }
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+}
+
+const uint8_t* PartitionImage::data() const {
+    return m_data;
+}
+
+size_t PartitionImage::size() const {
+    return m_size;
+}
+
+const std::string& PartitionImage::get_error() const {
+    return m_error;
+}
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Check that live telemetry does not push the RT sampling loop over budget.
+
+Attaches several WebSocket telemetry clients to a running logger, then polls
+/api/about while they stay attached. Fails if the loop's worst iteration
+(rt_loop.max_us) exceeds its budget (rt_loop.budget_us, the shortest sensor
+period) or if any iteration ran over budget during the run. Needs only the
+Python standard library and a PC joined to the logger's WiFi AP.
+
+    python3 tools/rt_load_check.py                  # 4 clients at 50 Hz for 2 minutes
+    python3 tools/rt_load_check.py --clients 6 --duration 600
+
+Exit status: 0 pass, 1 over budget, 2 could not run the check.
+"""
+
+import argparse
+import base64
+import json
+import os
+import socket
+import sys
+import threading
+import time
+import urllib.request
+
+
+def open_websocket(host, port, path, timeout):
+    sock = socket.create_connection((host, port), timeout=timeout)
+    key = base64.b64encode(os.urandom(16)).decode()
+    request = (f"GET {path} HTTP/1.1\r\nHost: {host}\r\nUpgrade: websocket\r\n"
+               f"Connection: Upgrade\r\nSec-WebSocket-Key: {key}\r\n"
+               "Sec-WebSocket-Version: 13\r\n\r\n")
+    sock.sendall(request.encode())
+    response = b""
+    while b"\r\n\r\n" not in response:
+        chunk = sock.recv(1024)
+        if not chunk:
+            raise ConnectionError("closed during handshake")
+        response += chunk
+    status = response.split(b"\r\n", 1)[0]
+    if b" 101 " not in status:
+        raise ConnectionError(f"handshake refused: {status.decode(errors='replace')}")
+    return sock
+
+
+def send_text(sock, text):
+    # Client frames must be masked (RFC 6455, 5.3)
+    payload = text.encode()
+    mask = os.urandom(4)
+    header = bytes([0x81, 0x80 | len(payload)]) + mask
+    sock.sendall(header + bytes(b ^ mask[i % 4] for i, b in enumerate(payload)))
+
+
+class TelemetryClient(threading.Thread):
+    """Reads and discards telemetry so the logger keeps sending at full rate."""
+
+    def __init__(self, sock):
+        super().__init__(daemon=True)
+        self.sock = sock
+        self.bytes = 0
+        self.closed = False
+
+    def run(self):
+        self.sock.settimeout(None)
+        try:
+            while True:
+                chunk = self.sock.recv(4096)
+                if not chunk:
+                    break
+                self.bytes += len(chunk)
+        except OSError:
+            pass
+        self.closed = True
+
+
+def get_about(host, port, timeout):
+    with urllib.request.urlopen(f"http://{host}:{port}/api/about", timeout=timeout) as response:
+        return json.load(response)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--host", default="192.168.4.1")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--clients", type=int, default=4)
+    parser.add_argument("--rate-hz", type=int, default=50, help="per client (the logger caps it at 50)")
+    parser.add_argument("--delta", action="store_true", help="request the delta stream")
+    parser.add_argument("--duration", type=float, default=120.0, help="seconds under load")
+    parser.add_argument("--poll", type=float, default=2.0, help="seconds between /api/about polls")
+    args = parser.parse_args()
+
+    clients = []
+    try:
+        for _ in range(args.clients):
+            sock = open_websocket(args.host, args.port, "/ws", timeout=5.0)
+            send_text(sock, json.dumps({"rate_hz": args.rate_hz, "delta": args.delta}))
+            client = TelemetryClient(sock)
+            client.start()
+            clients.append(client)
+    except OSError as e:
+        print(f"FAIL: could not connect client {len(clients) + 1}: {e}", file=sys.stderr)
+        return 2
+
+    first_over = None
+    samples = 0
+    deadline = time.monotonic() + args.duration
+    while time.monotonic() < deadline:
+        time.sleep(args.poll)
+        if any(c.closed for c in clients):
+            print("FAIL: the logger closed a telemetry client", file=sys.stderr)
+            return 2
+        try:
+            about = get_about(args.host, args.port, timeout=5.0)
+        except OSError as e:
+            print(f"warning: /api/about: {e}", file=sys.stderr)
+            continue
+        loop = about.get("rt_loop")
+        if loop is None:
+            print("FAIL: /api/about has no rt_loop section (firmware too old?)", file=sys.stderr)
+            return 2
+
+        # Other viewers may be attached too; only judge samples taken under full load
+        attached = len(about.get("telemetry", {}).get("clients", []))
+        if attached < args.clients:
+            print(f"warning: only {attached} clients attached", file=sys.stderr)
+            continue
+        if first_over is None:
+            first_over = loop["over_budget"]
+        samples += 1
+        over = loop["over_budget"] - first_over
+        print(f"{attached} clients: max {loop['max_us']} us, mean {loop['mean_us']} us, "
+              f"budget {loop['budget_us']} us, {over} over budget")
+        if loop["max_us"] > loop["budget_us"] or over > 0:
+            print(f"FAIL: RT loop over budget with {attached} clients attached", file=sys.stderr)
+            return 1
+
+    if samples == 0:
+        print(f"FAIL: never saw {args.clients} clients attached", file=sys.stderr)
+        return 2
+    received = sum(c.bytes for c in clients)
+    print(f"PASS: {samples} samples, {received / args.duration / 1024:.1f} KiB/s of telemetry received")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())